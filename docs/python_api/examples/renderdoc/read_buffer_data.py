@@ -0,0 +1,84 @@
+import renderdoc as rd
+
+# We'll need the struct module to read values out of the data
+import struct
+
+def sampleCode(controller):
+	# Find the largest buffer in the capture
+	buffers = sorted(controller.GetBuffers(), key=lambda b: b.length)
+
+	if len(buffers) == 0:
+		raise RuntimeError("Capture has no buffers")
+
+	buf = buffers[-1]
+
+	data = controller.GetBufferData(buf.resourceId, 0, 0)
+
+	print("Fetched %d bytes from %s" % (len(data), buf.resourceId))
+
+	# The data is returned as a ByteBuffer, which is not a bytes subclass
+	assert isinstance(data, rd.ByteBuffer)
+	assert not isinstance(data, bytes)
+
+	# Copying it to a bytes object gives identical contents
+	copy = data.tobytes()
+	assert type(copy) is bytes
+	assert len(copy) == len(data)
+
+	# It compares and hashes the same as the bytes, so it can be used as a dictionary key
+	assert data == copy and copy == data
+	assert hash(data) == hash(copy)
+	assert {copy: 'found'}[data] == 'found'
+
+	# Indexing, slicing and iterating behave like bytes
+	if len(data) > 0:
+		assert data[0] == copy[0] and data[-1] == copy[-1]
+	assert data[4:20] == copy[4:20] and type(data[4:20]) is bytes
+	assert list(data[:64]) == list(copy[:64])
+
+	# So do the string conversions
+	assert data.hex() == copy.hex()
+	assert data.decode('latin-1') == copy.decode('latin-1')
+
+	# The data can be read in place by anything accepting a bytes-like object, with no copy
+	view = memoryview(data)
+	assert view.readonly and view.nbytes == len(data)
+
+	if len(data) >= 16:
+		print("First 4 words: %s" % str(struct.unpack_from('4I', data, 0)))
+		assert struct.unpack_from('4I', data, 0) == struct.unpack_from('4I', copy, 0)
+
+	print("First 16 bytes: %s" % data[:16].hex())
+
+def loadCapture(filename):
+	# Open a capture file handle
+	cap = rd.OpenCaptureFile()
+
+	# Open a particular file - see also OpenBuffer to load from memory
+	status = cap.OpenFile(filename, '', None)
+
+	# Make sure the file opened successfully
+	if status != rd.ReplayStatus.Succeeded:
+		raise RuntimeError("Couldn't open file: " + str(status))
+
+	# Make sure we can replay
+	if not cap.LocalReplaySupport():
+		raise RuntimeError("Capture cannot be replayed")
+
+	# Initialise the replay
+	status,controller = cap.OpenCapture(None)
+
+	if status != rd.ReplayStatus.Succeeded:
+		raise RuntimeError("Couldn't initialise replay: " + str(status))
+
+	return (cap, controller)
+
+if 'pyrenderdoc' in globals():
+	pyrenderdoc.Replay().BlockInvoke(sampleCode)
+else:
+	cap,controller = loadCapture('test.rdc')
+
+	sampleCode(controller)
+
+	controller.Shutdown()
+	cap.Shutdown()
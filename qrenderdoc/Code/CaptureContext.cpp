@@ -817,6 +817,13 @@ void CaptureContext::SetEventID(const rdcarray<ICaptureViewer *> &exclude, uint3
   uint32_t prevEventID = m_EventID;
   m_EventID = eventId;
 
+  bool updateSelectedEvent = force || prevSelectedEventID != selectedEventID;
+  bool updateEvent = force || prevEventID != eventId;
+
+  // drop any work still pending for the previous event before we queue up the event change
+  if(updateEvent)
+    m_Renderer.EventChanged();
+
   m_Renderer.BlockInvoke([this, eventId, force](IReplayController *r) {
     r->SetFrameEvent(eventId, force);
     m_CurD3D11PipelineState = r->GetD3D11PipelineState();
@@ -826,9 +833,6 @@ void CaptureContext::SetEventID(const rdcarray<ICaptureViewer *> &exclude, uint3
     m_CurPipelineState = &r->GetPipelineState();
   });
 
-  bool updateSelectedEvent = force || prevSelectedEventID != selectedEventID;
-  bool updateEvent = force || prevEventID != eventId;
-
   RefreshUIStatus(exclude, updateSelectedEvent, updateEvent);
 }
 
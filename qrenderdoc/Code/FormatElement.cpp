@@ -772,6 +772,273 @@ QVariantList FormatElement::GetVariants(const byte *&data, const byte *end) cons
   return ret;
 }
 
+FormatDecoder::FormatDecoder(const FormatElement &el) : m_El(el)
+{
+  const ResourceFormat &f = el.format;
+
+  m_HexRegular = el.hex && f.type == ResourceFormatType::Regular;
+
+  switch(f.type)
+  {
+    case ResourceFormatType::R5G5B5A1:
+    case ResourceFormatType::R4G4B4A4: m_Count = 4; return;
+    case ResourceFormatType::R5G6B5:
+    case ResourceFormatType::R11G11B10: m_Count = 3; return;
+    case ResourceFormatType::R10G10B10A2: m_Count = (f.compCount / 4) * 4; return;
+    default: break;
+  }
+
+  m_Count = int(qMax(el.matrixdim, 1U) * f.compCount);
+
+  const uint8_t w = f.compByteWidth;
+
+  // these mirror the regular path in GetVariants. Anything not listed stays on the variant path
+  if(f.compType == CompType::Float || f.compType == CompType::Double)
+  {
+    if(w == 8)
+      m_Op = Op::F64;
+    else if(w == 4 && f.compType == CompType::Float)
+      m_Op = Op::F32;
+    else if(w == 2 && f.compType == CompType::Float)
+      m_Op = Op::F16;
+  }
+  else if(f.compType == CompType::SInt)
+  {
+    m_Op = w == 4 ? Op::S32 : w == 2 ? Op::S16 : w == 1 ? Op::S8 : Op::Variants;
+  }
+  else if(f.compType == CompType::UInt)
+  {
+    m_Op = w == 4 ? Op::U32 : w == 2 ? Op::U16 : w == 1 ? Op::U8 : Op::Variants;
+  }
+  else if(f.compType == CompType::SScaled)
+  {
+    m_Op = w == 4 ? Op::SScaled32 : w == 2 ? Op::SScaled16 : w == 1 ? Op::SScaled8 : Op::Variants;
+  }
+  else if(f.compType == CompType::UScaled)
+  {
+    m_Op = w == 4 ? Op::UScaled32 : w == 2 ? Op::UScaled16 : w == 1 ? Op::UScaled8 : Op::Variants;
+  }
+  else if(f.compType == CompType::Depth)
+  {
+    m_Op = w == 4 ? Op::F32 : w == 3 ? Op::UNorm24 : w == 2 ? Op::UNorm16 : Op::Variants;
+  }
+  else if(f.compType == CompType::UNorm)
+  {
+    m_Op = w == 4 ? Op::UNorm32 : w == 2 ? Op::UNorm16 : w == 1 ? Op::UNorm8 : Op::Variants;
+  }
+  else if(f.compType == CompType::SNorm)
+  {
+    m_Op = w == 2 ? Op::SNorm16 : w == 1 ? Op::SNorm8 : Op::Variants;
+  }
+
+  switch(m_Op)
+  {
+    case Op::Variants: break;
+    case Op::S8:
+    case Op::U8:
+    case Op::SScaled8:
+    case Op::UScaled8:
+    case Op::UNorm8:
+    case Op::SNorm8: m_Step = 1; break;
+    case Op::F16:
+    case Op::S16:
+    case Op::U16:
+    case Op::SScaled16:
+    case Op::UScaled16:
+    case Op::UNorm16:
+    case Op::SNorm16: m_Step = 2; break;
+    // 24-bit depth is read as a whole 32-bit value, the same as GetVariants
+    case Op::F32:
+    case Op::S32:
+    case Op::U32:
+    case Op::SScaled32:
+    case Op::UScaled32:
+    case Op::UNorm24:
+    case Op::UNorm32: m_Step = 4; break;
+    case Op::F64: m_Step = 8; break;
+  }
+
+  if(m_Op == Op::UNorm32)
+    qCritical() << "Unexpected 4-byte unorm/snorm value";
+}
+
+template <typename T>
+inline T readAt(const byte *data, uint32_t i)
+{
+  T ret;
+  memcpy(&ret, data + i * sizeof(T), sizeof(T));
+  return ret;
+}
+
+int FormatDecoder::Decode(const byte *data, const byte *end, DecodedValue *out) const
+{
+  if(m_Op == Op::Variants)
+  {
+    QVariantList list = m_El.GetVariants(data, end);
+
+    int count = qMin(list.count(), m_Count);
+
+    for(int i = 0; i < count; i++)
+    {
+      const QVariant &v = list[i];
+
+      QMetaType::Type vt = GetVariantMetatype(v);
+
+      if(vt == QMetaType::Double)
+        out[i] = DecodedValue(v.toDouble());
+      else if(vt == QMetaType::Float)
+        out[i] = DecodedValue(v.toFloat());
+      else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
+        out[i] = DecodedValue((int32_t)v.toInt());
+      else
+        out[i] = DecodedValue((uint32_t)v.toUInt());
+    }
+
+    return count;
+  }
+
+  if(data + m_Step * m_Count > end)
+    return 0;
+
+  const uint32_t count = (uint32_t)m_Count;
+
+  switch(m_Op)
+  {
+    case Op::Variants: break;
+    case Op::F16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue(RENDERDOC_HalfToFloat(readAt<uint16_t>(data, i)));
+      break;
+    case Op::F32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue(readAt<float>(data, i));
+      break;
+    case Op::F64:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue(readAt<double>(data, i));
+      break;
+    case Op::S8:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((int32_t)readAt<int8_t>(data, i));
+      break;
+    case Op::S16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((int32_t)readAt<int16_t>(data, i));
+      break;
+    case Op::S32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue(readAt<int32_t>(data, i));
+      break;
+    case Op::U8:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((uint32_t)readAt<uint8_t>(data, i));
+      break;
+    case Op::U16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((uint32_t)readAt<uint16_t>(data, i));
+      break;
+    case Op::U32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue(readAt<uint32_t>(data, i));
+      break;
+    case Op::SScaled8:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<int8_t>(data, i));
+      break;
+    case Op::SScaled16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<int16_t>(data, i));
+      break;
+    case Op::SScaled32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<int32_t>(data, i));
+      break;
+    case Op::UScaled8:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint8_t>(data, i));
+      break;
+    case Op::UScaled16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint16_t>(data, i));
+      break;
+    case Op::UScaled32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint32_t>(data, i));
+      break;
+    case Op::UNorm8:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint8_t>(data, i) / 255.0f);
+      break;
+    case Op::UNorm16:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint16_t>(data, i) / (float)0xffff);
+      break;
+    case Op::UNorm24:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)(readAt<uint32_t>(data, i) & 0x00ffffff) / (float)0x00ffffff);
+      break;
+    case Op::UNorm32:
+      for(uint32_t i = 0; i < count; i++)
+        out[i] = DecodedValue((float)readAt<uint32_t>(data, i) / (float)0xffffffff);
+      break;
+    case Op::SNorm8:
+      for(uint32_t i = 0; i < count; i++)
+      {
+        int8_t v = readAt<int8_t>(data, i);
+        out[i] = DecodedValue(v == -128 ? -1.0f : (float)v / 127.0f);
+      }
+      break;
+    case Op::SNorm16:
+      for(uint32_t i = 0; i < count; i++)
+      {
+        int16_t v = readAt<int16_t>(data, i);
+        out[i] = DecodedValue(v == -32768 ? -1.0f : (float)v / 32767.0f);
+      }
+      break;
+  }
+
+  if(m_El.format.bgraOrder && count >= 3)
+    qSwap(out[0], out[2]);
+
+  return m_Count;
+}
+
+QString FormatDecoder::Format(const DecodedValue &v) const
+{
+  switch(v.type)
+  {
+    case DecodedValue::Double:
+    case DecodedValue::Float:
+    {
+      double d = v.type == DecodedValue::Double ? v.d : v.f;
+      // pad with space on left if sign is missing, to better align
+      if(d < 0.0)
+        return Formatter::Format(d);
+      else if(d > 0.0)
+        return lit(" ") + Formatter::Format(d);
+      else if(qIsNaN(d))
+        return lit(" NaN");
+
+      // force negative and positive 0 together
+      return lit(" ") + Formatter::Format(0.0);
+    }
+    case DecodedValue::UInt:
+    {
+      if(m_HexRegular)
+        return Formatter::HexFormat(v.u, m_El.format.compByteWidth);
+      return Formatter::Format(v.u, m_El.hex);
+    }
+    case DecodedValue::Int:
+    {
+      if(v.i > 0)
+        return lit(" ") + Formatter::Format(v.i);
+      return Formatter::Format(v.i);
+    }
+  }
+
+  return QString();
+}
+
 ShaderVariable FormatElement::GetShaderVar(const byte *&data, const byte *end) const
 {
   QVariantList objs = GetVariants(data, end);
@@ -104,6 +104,8 @@ CaptureSettings::operator QVariant() const
   opts[lit("refAllResources")] = options.refAllResources;
   opts[lit("captureAllCmdLists")] = options.captureAllCmdLists;
   opts[lit("debugOutputMute")] = options.debugOutputMute;
+  opts[lit("lowOverheadIdle")] = options.lowOverheadIdle;
+  opts[lit("retainInitialContents")] = options.retainInitialContents;
   ret[lit("options")] = opts;
 
   return ret;
@@ -140,6 +142,8 @@ CaptureSettings::CaptureSettings(const QVariant &v)
   options.refAllResources = opts[lit("refAllResources")].toBool();
   options.captureAllCmdLists = opts[lit("captureAllCmdLists")].toBool();
   options.debugOutputMute = opts[lit("debugOutputMute")].toBool();
+  options.lowOverheadIdle = opts[lit("lowOverheadIdle")].toBool();
+  options.retainInitialContents = opts[lit("retainInitialContents")].toBool();
 }
 
 rdcstr configFilePath(const rdcstr &filename)
@@ -648,6 +648,73 @@ protected:
 DECLARE_REFLECTION_STRUCT(ICaptureViewer);
 DECLARE_REFLECTION_STRUCT(ICaptureViewer *);
 
+DOCUMENT(R"(Specifies the priority of a request made to the replay thread. Pending requests are
+processed highest priority first, and in the order they were made within the same priority.
+
+.. data:: Background
+
+  Work that the user isn't directly waiting on, such as prefetching or analysis. It will only be
+  processed when no other work is pending.
+
+.. data:: Normal
+
+  The default priority, used by any request that doesn't specify one.
+
+.. data:: Interactive
+
+  Work that the user is actively waiting on, such as the result of picking a pixel or vertex. It
+  will be processed before any other pending work.
+)");
+enum class ReplayPriority : int
+{
+  Background,
+  Normal,
+  Interactive,
+};
+
+DOCUMENT(R"(Statistics about the requests made to the replay thread, to identify what the UI is
+waiting on.
+)");
+struct ReplayQueueStats
+{
+  DOCUMENT("");
+  ReplayQueueStats() = default;
+
+  DOCUMENT("The number of requests currently waiting to be processed.");
+  uint32_t pending = 0;
+
+  DOCUMENT("The largest number of requests that have been waiting to be processed at once.");
+  uint32_t maxPending = 0;
+
+  DOCUMENT("The total number of requests that have been processed.");
+  uint64_t processed = 0;
+
+  DOCUMENT(R"(The number of requests that were replaced by a newer request with the same tag before
+they were processed.
+)");
+  uint64_t coalesced = 0;
+
+  DOCUMENT(R"(The number of requests that were dropped because the current event changed before they
+were processed.
+)");
+  uint64_t stale = 0;
+
+  DOCUMENT(R"(The average time in seconds that processed requests spent waiting before they were
+processed.
+)");
+  double averageWait = 0.0;
+
+  DOCUMENT("The longest time in seconds that any processed request spent waiting to be processed.");
+  double maxWait = 0.0;
+
+  DOCUMENT(R"(The tag of the request currently being processed. Empty if no request is being
+processed or if the current request is untagged.
+)");
+  rdcstr currentTag;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayQueueStats);
+
 DOCUMENT(R"(A manager for accessing the underlying replay information that isn't already abstracted
 in UI side structures. This manager controls and serialises access to the underlying
 :class:`~renderdoc.ReplayController`, as well as handling remote server connections.
@@ -795,6 +862,34 @@ This can be used to identify if a command is long-running to display a progress
 )");
   virtual float GetCurrentProcessingTime() = 0;
 
+  DOCUMENT(R"(Retrieve statistics about the requests that have been made to the replay thread.
+
+:return: The current statistics.
+:rtype: ReplayQueueStats
+)");
+  virtual ReplayQueueStats GetQueueStats() = 0;
+
+  DOCUMENT(R"(Make a tagged non-blocking invoke call onto the replay thread, with a given priority.
+
+This behaves the same as the other tagged :meth:`AsyncInvoke`, except that the request is processed
+ahead of any pending requests with a lower priority. If a request with the same tag is already
+pending, it is replaced by this request in place, taking the higher of the two priorities. This
+means windows that need the same work done can share a tag, and only one request is processed. Tags
+should identify the work requested, such as the type of request and the resource it targets, rather
+than the window making it.
+
+If ``currentEventOnly`` is set, the request will be dropped without being called if the current
+event changes before it's processed. This should be used for work that is only relevant to the event
+it was requested on, when the new event will request its own.
+
+:param str tag: The tag to identify this callback.
+:param ReplayPriority priority: The priority to process this callback with.
+:param bool currentEventOnly: ``True`` if this callback should be dropped on an event change.
+:param InvokeCallback method: The function to callback on the replay thread.
+)");
+  virtual void AsyncInvoke(const rdcstr &tag, ReplayPriority priority, bool currentEventOnly,
+                           InvokeCallback method) = 0;
+
   DOCUMENT(R"(Make a tagged non-blocking invoke call onto the replay thread.
 
 This tagged function is for cases when we might send a request - e.g. to pick a vertex or pixel -
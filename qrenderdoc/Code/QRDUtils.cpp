@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "QRDUtils.h"
+#include <QAbstractItemView>
 #include <QAbstractTextDocumentLayout>
 #include <QApplication>
 #include <QCollator>
@@ -360,6 +361,99 @@ bool RichResourceTextMouseEvent(const QWidget *owner, const QVariant &var, QRect
   return false;
 }
 
+RichTextViewDelegate::RichTextViewDelegate(QAbstractItemView *parent)
+    : ForwardingDelegate(parent), m_widget(parent)
+{
+}
+
+RichTextViewDelegate::~RichTextViewDelegate()
+{
+}
+
+QRect RichTextViewDelegate::textRect(const QStyleOptionViewItem &option,
+                                     const QModelIndex &index) const
+{
+  QRect rect = option.rect;
+
+  QIcon icon = index.data(Qt::DecorationRole).value<QIcon>();
+
+  // skip past any icon to get to where the text starts
+  if(!icon.isNull())
+  {
+    QIcon::Mode mode;
+    if((option.state & QStyle::State_Enabled) == 0)
+      mode = QIcon::Disabled;
+    else if(option.state & QStyle::State_Selected)
+      mode = QIcon::Selected;
+    else
+      mode = QIcon::Normal;
+    QIcon::State state = option.state & QStyle::State_Open ? QIcon::On : QIcon::Off;
+    rect.setX(rect.x() + icon.actualSize(option.decorationSize, mode, state).width());
+  }
+
+  return rect;
+}
+
+void RichTextViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const
+{
+  if(index.isValid())
+  {
+    QVariant v = index.data();
+
+    if(RichResourceTextCheck(v))
+    {
+      // draw the item without text, so we get the proper background/selection/etc.
+      QStyleOptionViewItem opt = option;
+      QStyledItemDelegate::initStyleOption(&opt, index);
+      opt.text.clear();
+      m_widget->style()->drawControl(QStyle::CE_ItemViewItem, &opt, painter, m_widget);
+
+      painter->save();
+
+      RichResourceTextPaint(m_widget, painter, textRect(opt, index), option.font, option.palette,
+                            option.state & QStyle::State_MouseOver,
+                            m_widget->viewport()->mapFromGlobal(QCursor::pos()), v);
+
+      painter->restore();
+      return;
+    }
+  }
+
+  return ForwardingDelegate::paint(painter, option, index);
+}
+
+QSize RichTextViewDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+  if(index.isValid())
+  {
+    QVariant v = index.data();
+
+    if(RichResourceTextCheck(v))
+      return QSize(RichResourceTextWidthHint(m_widget, v), option.fontMetrics.height());
+  }
+
+  return ForwardingDelegate::sizeHint(option, index);
+}
+
+bool RichTextViewDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                       const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+  if(event->type() == QEvent::MouseButtonRelease && index.isValid())
+  {
+    QVariant v = index.data();
+
+    if(RichResourceTextCheck(v))
+    {
+      // ignore the return value, we always consume clicks on this cell
+      RichResourceTextMouseEvent(m_widget, v, textRect(option, index), (QMouseEvent *)event);
+      return true;
+    }
+  }
+
+  return ForwardingDelegate::editorEvent(event, model, option, index);
+}
+
 #include "renderdoc_tostr.inl"
 
 QString ToQStr(const ResourceUsage usage, const GraphicsAPI apitype)
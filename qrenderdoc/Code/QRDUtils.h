@@ -100,6 +100,95 @@ public:
   bool hex, rgb;
 };
 
+// a single decoded component of a FormatElement, typed the same way as GetVariants would type it.
+struct DecodedValue
+{
+  enum Type : uint8_t
+  {
+    Float,
+    Double,
+    Int,
+    UInt,
+  };
+
+  DecodedValue() : type(UInt), u(0) {}
+  explicit DecodedValue(float v) : type(Float), f(v) {}
+  explicit DecodedValue(double v) : type(Double), d(v) {}
+  explicit DecodedValue(int32_t v) : type(Int), i(v) {}
+  explicit DecodedValue(uint32_t v) : type(UInt), u(v) {}
+  Type type;
+  union
+  {
+    float f;
+    double d;
+    int32_t i;
+    uint32_t u;
+  };
+
+  float toFloat() const
+  {
+    switch(type)
+    {
+      case Float: return f;
+      case Double: return (float)d;
+      case Int: return (float)i;
+      case UInt: return (float)u;
+    }
+    return 0.0f;
+  }
+};
+
+// a FormatElement compiled once into a flat plan of what to read and how to convert it, so that
+// many elements can be decoded and formatted without building a QVariantList for each one. Packed
+// and unusual formats fall back to GetVariants internally.
+struct FormatDecoder
+{
+  FormatDecoder() = default;
+  explicit FormatDecoder(const FormatElement &el);
+
+  // the number of components Decode will return for an in-bounds element
+  int numComponents() const { return m_Count; }
+  // decodes the element at data into out, which must have space for numComponents() values.
+  // Returns the number of values decoded, which is 0 if the element runs past end.
+  int Decode(const byte *data, const byte *end, DecodedValue *out) const;
+
+  // formats a decoded value for display, padding positive numbers to align with negative ones
+  QString Format(const DecodedValue &v) const;
+
+private:
+  enum class Op : uint8_t
+  {
+    Variants,
+    F16,
+    F32,
+    F64,
+    S8,
+    S16,
+    S32,
+    U8,
+    U16,
+    U32,
+    SScaled8,
+    SScaled16,
+    SScaled32,
+    UScaled8,
+    UScaled16,
+    UScaled32,
+    UNorm8,
+    UNorm16,
+    UNorm24,
+    UNorm32,
+    SNorm8,
+    SNorm16,
+  };
+
+  FormatElement m_El;
+  Op m_Op = Op::Variants;
+  int m_Count = 0;
+  uint32_t m_Step = 0;
+  bool m_HexRegular = false;
+};
+
 QString TypeString(const ShaderVariable &v);
 QString RowString(const ShaderVariable &v, uint32_t row, VarType type = VarType::Unknown);
 QString VarString(const ShaderVariable &v);
@@ -454,6 +543,29 @@ private:
   QAbstractItemDelegate *m_delegate = NULL;
 };
 
+class QAbstractItemView;
+
+// delegate for views with a custom model that handles painting and clicking on any display data
+// that is rich resource text. RDTreeWidget does this internally for its items.
+class RichTextViewDelegate : public ForwardingDelegate
+{
+  Q_OBJECT
+public:
+  explicit RichTextViewDelegate(QAbstractItemView *parent);
+  ~RichTextViewDelegate();
+
+  void paint(QPainter *painter, const QStyleOptionViewItem &option,
+             const QModelIndex &index) const override;
+  QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+  bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                   const QModelIndex &index) override;
+
+private:
+  QRect textRect(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+
+  QAbstractItemView *m_widget;
+};
+
 class QMenu;
 
 // helper for doing a manual blocking invoke of a dialog
@@ -236,6 +236,27 @@ float ReplayManager::GetCurrentProcessingTime()
   return m_CommandTimer.isValid() ? double(m_CommandTimer.elapsed()) / 1000.0 : 0.0;
 }
 
+ReplayQueueStats ReplayManager::GetQueueStats()
+{
+  QMutexLocker autolock(&m_RenderLock);
+
+  ReplayQueueStats ret = m_Stats;
+  ret.pending = (uint32_t)m_RenderQueue.count();
+  if(ret.processed > 0)
+    ret.averageWait = m_TotalWait / double(ret.processed);
+
+  return ret;
+}
+
+void ReplayManager::EventChanged()
+{
+  QMutexLocker autolock(&m_RenderLock);
+
+  // requests for the current event were stamped with the generation they were made in, so any
+  // made before this are dropped when they reach the front of the queue.
+  m_EventGeneration++;
+}
+
 void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayManager::InvokeCallback m)
 {
   QString qtag(tag);
@@ -246,9 +267,8 @@ void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayManager::InvokeCallback
     {
       if(m_RenderQueue[i]->tag == qtag)
       {
-        InvokeHandle *cmd = m_RenderQueue.takeAt(i);
-        if(cmd->selfdelete)
-          delete cmd;
+        m_Stats.coalesced++;
+        DropInvoke(m_RenderQueue.takeAt(i));
       }
       else
       {
@@ -263,6 +283,57 @@ void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayManager::InvokeCallback
   PushInvoke(cmd);
 }
 
+void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayPriority priority, bool currentEventOnly,
+                                ReplayManager::InvokeCallback m)
+{
+  if(m_Thread == NULL || !m_Thread->isRunning() || !m_Running)
+    return;
+
+  InvokeHandle *cmd = new InvokeHandle(m, QString(tag));
+  cmd->selfdelete = true;
+  cmd->priority = priority;
+  cmd->currentEventOnly = currentEventOnly;
+
+  QMutexLocker autolock(&m_RenderLock);
+
+  cmd->eventGeneration = m_EventGeneration;
+
+  for(int i = 0; i < m_RenderQueue.count(); i++)
+  {
+    InvokeHandle *existing = m_RenderQueue[i];
+
+    if(existing->tag != cmd->tag)
+      continue;
+
+    // take over the existing request's place in the queue, and its queued time so that the wait
+    // stats reflect how long the work has really been waiting.
+    cmd->queued = existing->queued;
+
+    // only keep the request for the current event if both requests were for it.
+    cmd->currentEventOnly = currentEventOnly && existing->currentEventOnly;
+
+    m_Stats.coalesced++;
+
+    if(existing->priority >= priority)
+    {
+      cmd->priority = existing->priority;
+      m_RenderQueue[i] = cmd;
+    }
+    else
+    {
+      m_RenderQueue.removeAt(i);
+      InsertInvoke(cmd);
+    }
+
+    DropInvoke(existing);
+    m_RenderCondition.wakeAll();
+    return;
+  }
+
+  InsertInvoke(cmd);
+  m_RenderCondition.wakeAll();
+}
+
 void ReplayManager::AsyncInvoke(ReplayManager::InvokeCallback m)
 {
   InvokeHandle *cmd = new InvokeHandle(m);
@@ -411,10 +482,31 @@ void ReplayManager::PushInvoke(ReplayManager::InvokeHandle *cmd)
   }
 
   QMutexLocker autolock(&m_RenderLock);
-  m_RenderQueue.enqueue(cmd);
+  InsertInvoke(cmd);
   m_RenderCondition.wakeAll();
 }
 
+void ReplayManager::InsertInvoke(ReplayManager::InvokeHandle *cmd)
+{
+  // requests go after every pending request with the same or higher priority. Since almost all
+  // requests are normal priority, searching from the back is quickest.
+  int i = m_RenderQueue.count();
+  while(i > 0 && m_RenderQueue[i - 1]->priority < cmd->priority)
+    i--;
+
+  m_RenderQueue.insert(i, cmd);
+
+  m_Stats.maxPending = qMax(m_Stats.maxPending, (uint32_t)m_RenderQueue.count());
+}
+
+void ReplayManager::DropInvoke(ReplayManager::InvokeHandle *cmd)
+{
+  if(cmd->selfdelete)
+    delete cmd;
+  else
+    cmd->processed.release();
+}
+
 void ReplayManager::run(int proxyRenderer, const QString &capturefile,
                         RENDERDOC_ProgressCallback progress)
 {
@@ -460,8 +552,25 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
       if(m_RenderQueue.isEmpty())
         m_RenderCondition.wait(&m_RenderLock, 10);
 
+      // skip past any requests for an event that's no longer current
+      while(!m_RenderQueue.isEmpty() && m_RenderQueue.head()->currentEventOnly &&
+            m_RenderQueue.head()->eventGeneration != m_EventGeneration)
+      {
+        m_Stats.stale++;
+        DropInvoke(m_RenderQueue.dequeue());
+      }
+
       if(!m_RenderQueue.isEmpty())
+      {
         cmd = m_RenderQueue.dequeue();
+
+        double wait = double(cmd->queued.elapsed()) / 1000.0;
+
+        m_Stats.processed++;
+        m_Stats.maxWait = qMax(m_Stats.maxWait, wait);
+        m_Stats.currentTag = cmd->tag;
+        m_TotalWait += wait;
+      }
     }
 
     if(cmd == NULL)
@@ -482,11 +591,13 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
       }
     }
 
+    {
+      QMutexLocker autolock(&m_RenderLock);
+      m_Stats.currentTag = rdcstr();
+    }
+
     // if it's a throwaway command, delete it
-    if(cmd->selfdelete)
-      delete cmd;
-    else
-      cmd->processed.release();
+    DropInvoke(cmd);
   }
 
   // clean up anything left in the queue
@@ -54,6 +54,12 @@ public:
   bool IsRunning();
   ReplayStatus GetCreateStatus() { return m_CreateStatus; }
   float GetCurrentProcessingTime();
+  ReplayQueueStats GetQueueStats();
+
+  // called when the current event changes, so that any pending requests that only apply to the
+  // previous event can be dropped.
+  void EventChanged();
+
   // this tagged version is for cases when we might send a request - e.g. to pick a vertex or pixel
   // - and want to pre-empt it with a new request before the first has returned. Either because some
   // other work is taking a while or because we're sending requests faster than they can be
@@ -61,6 +67,12 @@ public:
   // the manager processes only the request on the top of the queue, so when a new tagged invoke
   // comes in, we remove any other requests in the queue before it that have the same tag
   void AsyncInvoke(const rdcstr &tag, InvokeCallback m);
+  // this version replaces any pending request with the same tag in-place instead, so that requests
+  // from several windows for the same work are only processed once and don't lose their place in
+  // the queue. Requests are processed in priority order, and requests for the current event only
+  // are dropped if the event changes before they are processed.
+  void AsyncInvoke(const rdcstr &tag, ReplayPriority priority, bool currentEventOnly,
+                   InvokeCallback m);
   void AsyncInvoke(InvokeCallback m);
   void BlockInvoke(InvokeCallback m);
 
@@ -105,12 +117,21 @@ private:
       tag = t;
       method = m;
       selfdelete = false;
+      priority = ReplayPriority::Normal;
+      eventGeneration = 0;
+      currentEventOnly = false;
+      queued.start();
     }
 
     QString tag;
     InvokeCallback method;
     QSemaphore processed;
     bool selfdelete;
+
+    ReplayPriority priority;
+    uint32_t eventGeneration;
+    bool currentEventOnly;
+    QElapsedTimer queued;
   };
 
   void run(int proxyRenderer, const QString &capturefile, RENDERDOC_ProgressCallback progress);
@@ -126,6 +147,13 @@ private:
   IReplayController *m_Renderer = NULL;
 
   void PushInvoke(InvokeHandle *cmd);
+  void InsertInvoke(InvokeHandle *cmd);
+  void DropInvoke(InvokeHandle *cmd);
+
+  // protected by m_RenderLock
+  uint32_t m_EventGeneration = 0;
+  ReplayQueueStats m_Stats;
+  double m_TotalWait = 0.0;
 
   QMutex m_RemoteLock;
   RemoteHost *m_RemoteHost = NULL;
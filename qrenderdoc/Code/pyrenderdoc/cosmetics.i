@@ -152,6 +152,9 @@ fail:
 
 DEFINE_SAFE_EQUALITY(DrawcallDescription)
 DEFINE_SAFE_EQUALITY(CounterResult)
+DEFINE_SAFE_EQUALITY(CounterStatistics)
+DEFINE_SAFE_EQUALITY(ReplayProfileEntry)
+DEFINE_SAFE_EQUALITY(PipelineStateSnapshot)
 DEFINE_SAFE_EQUALITY(APIEvent)
 DEFINE_SAFE_EQUALITY(Bindpoint)
 DEFINE_SAFE_EQUALITY(BufferDescription)
@@ -172,6 +175,7 @@ DEFINE_SAFE_EQUALITY(ShaderResource)
 DEFINE_SAFE_EQUALITY(ShaderSampler)
 DEFINE_SAFE_EQUALITY(ShaderSourceFile)
 DEFINE_SAFE_EQUALITY(ShaderVariable)
+DEFINE_SAFE_EQUALITY(ShaderVariableChange)
 DEFINE_SAFE_EQUALITY(RegisterRange)
 DEFINE_SAFE_EQUALITY(LocalVariableMapping)
 DEFINE_SAFE_EQUALITY(SigParameter)
@@ -403,6 +403,209 @@ struct TypeConversion<rdcpair<A, B>, false>
   static PyObject *ConvertToPy(const rdcpair<A, B> &in) { return ConvertToPy(in, NULL); }
 };
 
+// python object that owns a bytebuf and exposes it through the buffer protocol. This lets
+// memoryview, numpy.frombuffer, struct.unpack_from etc read the data directly with no copy, while
+// indexing, slicing, len(), comparisons, hashing and the common read-only methods behave the same
+// as the bytes object we used to return. It isn't a bytes subclass since that would need a copy of
+// the data inside the bytes object itself.
+struct PyBytebufObject
+{
+  PyObject_HEAD;
+  bytebuf *buf;
+  // the contents can't change once created, so the hash is calculated once on first use
+  Py_hash_t hash;
+};
+
+inline void PyBytebuf_dealloc(PyObject *self)
+{
+  delete ((PyBytebufObject *)self)->buf;
+  Py_TYPE(self)->tp_free(self);
+}
+
+inline int PyBytebuf_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+  return PyBuffer_FillInfo(view, self, buf->data(), (Py_ssize_t)buf->size(), 1, flags);
+}
+
+inline Py_ssize_t PyBytebuf_length(PyObject *self)
+{
+  return (Py_ssize_t)((PyBytebufObject *)self)->buf->size();
+}
+
+inline PyObject *PyBytebuf_item(PyObject *self, Py_ssize_t idx)
+{
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+  if(idx < 0 || idx >= (Py_ssize_t)buf->size())
+  {
+    PyErr_SetString(PyExc_IndexError, "index out of range");
+    return NULL;
+  }
+
+  return PyLong_FromLong((long)buf->at((size_t)idx));
+}
+
+inline PyObject *PyBytebuf_subscript(PyObject *self, PyObject *key)
+{
+  // go through a memoryview to get python's index and slice handling for free. Slices are
+  // returned as bytes to match what indexing the old bytes object would give.
+  PyObject *view = PyMemoryView_FromObject(self);
+  if(!view)
+    return NULL;
+
+  PyObject *ret = PyObject_GetItem(view, key);
+  Py_DECREF(view);
+
+  if(ret && PyMemoryView_Check(ret))
+  {
+    PyObject *bytes = PyBytes_FromObject(ret);
+    Py_DECREF(ret);
+    ret = bytes;
+  }
+
+  return ret;
+}
+
+inline PyObject *PyBytebuf_richcompare(PyObject *self, PyObject *other, int op)
+{
+  if((op != Py_EQ && op != Py_NE) || !PyObject_CheckBuffer(other))
+    Py_RETURN_NOTIMPLEMENTED;
+
+  Py_buffer view;
+  if(PyObject_GetBuffer(other, &view, PyBUF_SIMPLE) != 0)
+  {
+    PyErr_Clear();
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+  bool equal = view.len == (Py_ssize_t)buf->size() &&
+               (buf->empty() || memcmp(view.buf, buf->data(), buf->size()) == 0);
+
+  PyBuffer_Release(&view);
+
+  if(equal == (op == Py_EQ))
+    Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+}
+
+inline PyObject *PyBytebuf_repr(PyObject *self)
+{
+  return PyUnicode_FromFormat("<renderdoc.ByteBuffer of %zd bytes>", PyBytebuf_length(self));
+}
+
+inline PyObject *PyBytebuf_tobytes(PyObject *self, PyObject *)
+{
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+  return PyBytes_FromStringAndSize((const char *)buf->data(), (Py_ssize_t)buf->size());
+}
+
+inline Py_hash_t PyBytebuf_hash(PyObject *self)
+{
+  PyBytebufObject *obj = (PyBytebufObject *)self;
+
+  // we compare equal to bytes with the same contents, so we must hash the same as them too
+  if(obj->hash == -1)
+  {
+    PyObject *bytes = PyBytebuf_tobytes(self, NULL);
+    if(!bytes)
+      return -1;
+
+    obj->hash = PyObject_Hash(bytes);
+    Py_DECREF(bytes);
+  }
+
+  return obj->hash;
+}
+
+inline PyObject *PyBytebuf_hex(PyObject *self, PyObject *)
+{
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+
+  PyObject *ret = PyUnicode_New((Py_ssize_t)buf->size() * 2, 127);
+  if(!ret)
+    return NULL;
+
+  const char digits[] = "0123456789abcdef";
+  Py_UCS1 *out = PyUnicode_1BYTE_DATA(ret);
+
+  for(size_t i = 0; i < buf->size(); i++)
+  {
+    *(out++) = digits[buf->at(i) >> 4];
+    *(out++) = digits[buf->at(i) & 0xf];
+  }
+
+  return ret;
+}
+
+inline PyObject *PyBytebuf_decode(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {(char *)"encoding", (char *)"errors", NULL};
+  const char *encoding = "utf-8";
+  const char *errors = "strict";
+
+  if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|ss:decode", kwlist, &encoding, &errors))
+    return NULL;
+
+  bytebuf *buf = ((PyBytebufObject *)self)->buf;
+  return PyUnicode_Decode((const char *)buf->data(), (Py_ssize_t)buf->size(), encoding, errors);
+}
+
+inline PyTypeObject *GetPyBytebufType()
+{
+  static PyBufferProcs buffer_procs = {&PyBytebuf_getbuffer, NULL};
+  static PySequenceMethods sequence_methods = {&PyBytebuf_length, NULL, NULL, &PyBytebuf_item};
+  static PyMappingMethods mapping_methods = {&PyBytebuf_length, &PyBytebuf_subscript, NULL};
+  static PyMethodDef methods[] = {
+      {"tobytes", NULL, METH_NOARGS,
+       "tobytes()\n\nCopy the data into a new ``bytes`` object.\n\n"
+       ":return: The copied data.\n:rtype: bytes"},
+      {"hex", NULL, METH_NOARGS,
+       "hex()\n\nFormat the data as a string of two lowercase hexadecimal digits per byte.\n\n"
+       ":return: The hexadecimal string.\n:rtype: str"},
+      {"decode", NULL, METH_VARARGS | METH_KEYWORDS,
+       "decode(encoding='utf-8', errors='strict')\n\nDecode the data into a string, the same as "
+       "``bytes.decode``.\n\n"
+       ":param str encoding: The encoding to decode with.\n"
+       ":param str errors: The error handling scheme to use.\n"
+       ":return: The decoded string.\n:rtype: str"},
+      {NULL}};
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+  if(type.tp_flags & Py_TPFLAGS_READY)
+    return &type;
+
+  methods[0].ml_meth = &PyBytebuf_tobytes;
+  methods[1].ml_meth = &PyBytebuf_hex;
+  methods[2].ml_meth = (PyCFunction)(void *)&PyBytebuf_decode;
+
+  type.tp_name = "renderdoc.ByteBuffer";
+  type.tp_basicsize = sizeof(PyBytebufObject);
+  type.tp_flags = Py_TPFLAGS_DEFAULT;
+  type.tp_doc =
+      "Read-only bytes data returned from renderdoc, such as buffer and texture contents.\n\n"
+      "This is not a ``bytes`` subclass, so that the data isn't copied when it's returned. It "
+      "supports the buffer protocol so it can be passed directly to :class:`memoryview`, "
+      "``struct.unpack_from``, ``numpy.frombuffer`` and anything else accepting a bytes-like "
+      "object. It also supports ``len()``, indexing, slicing, iteration, hashing and comparison "
+      "with bytes-like objects, the same as ``bytes``.\n\n"
+      "Anything needing a real ``bytes`` object, such as an ``isinstance(data, bytes)`` check, "
+      "can use :meth:`tobytes` to get a copy.";
+  type.tp_dealloc = &PyBytebuf_dealloc;
+  type.tp_repr = &PyBytebuf_repr;
+  type.tp_hash = &PyBytebuf_hash;
+  type.tp_richcompare = &PyBytebuf_richcompare;
+  type.tp_methods = methods;
+  type.tp_as_buffer = &buffer_procs;
+  type.tp_as_sequence = &sequence_methods;
+  type.tp_as_mapping = &mapping_methods;
+
+  if(PyType_Ready(&type) != 0)
+    return NULL;
+
+  return &type;
+}
+
 // specialisation for bytebuf
 template <>
 struct TypeConversion<bytebuf, false>
@@ -411,13 +614,23 @@ struct TypeConversion<bytebuf, false>
   // nicer failure error messages out with the index that failed
   static int ConvertFromPy(PyObject *in, bytebuf &out, int *failIdx)
   {
-    if(!PyBytes_Check(in))
+    // accept anything exposing contiguous bytes - bytes, bytearray, memoryview, numpy arrays, or
+    // our own ByteBuffer objects.
+    if(!PyObject_CheckBuffer(in))
       return SWIG_TypeError;
 
-    Py_ssize_t len = PyBytes_Size(in);
+    Py_buffer view;
+    if(PyObject_GetBuffer(in, &view, PyBUF_SIMPLE) != 0)
+    {
+      PyErr_Clear();
+      return SWIG_TypeError;
+    }
+
+    out.resize((size_t)view.len);
+    if(view.len > 0)
+      memcpy(out.data(), view.buf, out.size());
 
-    out.resize((size_t)len);
-    memcpy(out.data(), PyBytes_AsString(in), out.size());
+    PyBuffer_Release(&view);
 
     return SWIG_OK;
   }
@@ -425,13 +638,33 @@ struct TypeConversion<bytebuf, false>
   static int ConvertFromPy(PyObject *in, bytebuf &out) { return ConvertFromPy(in, out, NULL); }
   static PyObject *ConvertToPyInPlace(PyObject *list, const bytebuf &in, int *failIdx)
   {
-    // can't modify bytes objects
+    // ByteBuffer objects are read-only, like the bytes objects they replace
     return SWIG_Py_Void();
   }
 
+  // takes the storage from in without copying, leaving it empty. Used for bytebufs returned by
+  // value where nothing else can see the C++ object afterwards.
+  static PyObject *ConvertToPyMove(bytebuf &in)
+  {
+    PyTypeObject *type = GetPyBytebufType();
+    if(!type)
+      return NULL;
+
+    PyBytebufObject *ret = PyObject_New(PyBytebufObject, type);
+    if(!ret)
+      return NULL;
+
+    ret->buf = new bytebuf;
+    ret->buf->swap(in);
+    ret->hash = -1;
+
+    return (PyObject *)ret;
+  }
+
   static PyObject *ConvertToPy(const bytebuf &in, int *failIdx)
   {
-    return PyBytes_FromStringAndSize((const char *)in.data(), (Py_ssize_t)in.size());
+    bytebuf copy = in;
+    return ConvertToPyMove(copy);
   }
 
   static PyObject *ConvertToPy(const bytebuf &in) { return ConvertToPy(in, NULL); }
@@ -59,6 +59,17 @@
 %}
 %init %{
   PyDateTime_IMPORT;
+
+  // bytebufs are converted to our own type rather than a SWIG wrapped class, so add it to the
+  // module by hand so that it's documented and can be used with isinstance()
+  {
+    PyTypeObject *bytebufType = GetPyBytebufType();
+    if(bytebufType)
+    {
+      Py_INCREF(bytebufType);
+      PyModule_AddObject(m, "ByteBuffer", (PyObject *)bytebufType);
+    }
+  }
 %}
 
 %include "pyconversion.i"
@@ -144,6 +155,12 @@ SIMPLE_TYPEMAPS(rdcstr)
 SIMPLE_TYPEMAPS(rdcdatetime)
 SIMPLE_TYPEMAPS(bytebuf)
 
+// bytebufs returned by value (buffer and texture contents, section data) can be large. Nothing else
+// holds the result so move the storage into the python object instead of copying it.
+%typemap(out) bytebuf {
+  $result = TypeConversion<bytebuf>::ConvertToPyMove($1);
+}
+
 FIXED_ARRAY_TYPEMAPS(ResourceId)
 FIXED_ARRAY_TYPEMAPS(double)
 FIXED_ARRAY_TYPEMAPS(float)
@@ -245,6 +262,9 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, WindowingSystem)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, DrawcallDescription)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, GPUCounter)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, CounterResult)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, CounterStatistics)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ReplayProfileEntry)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PipelineStateSnapshot)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, APIEvent)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, Bindpoint)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, BufferDescription)
@@ -265,10 +285,12 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderResource)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderSampler)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderSourceFile)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderVariable)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderVariableChange)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, RegisterRange)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, LocalVariableMapping)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, SigParameter)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, TextureDescription)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, TextureSave)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderEntryPoint)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, Viewport)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, Scissor)
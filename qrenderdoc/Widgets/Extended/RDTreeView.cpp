@@ -236,6 +236,24 @@ QAbstractItemDelegate *RDTreeView::itemDelegate() const
   return m_userDelegate;
 }
 
+void RDTreeView::expandAllItems(const QModelIndex &index)
+{
+  expand(index);
+
+  int count = model()->rowCount(index);
+  for(int i = 0; i < count; i++)
+    expandAllItems(model()->index(i, 0, index));
+}
+
+void RDTreeView::collapseAllItems(const QModelIndex &index)
+{
+  collapse(index);
+
+  int count = model()->rowCount(index);
+  for(int i = 0; i < count; i++)
+    collapseAllItems(model()->index(i, 0, index));
+}
+
 void RDTreeView::saveInternalExpansion(uint key, int keyColumn, int role)
 {
   RDTreeViewExpansionState &state = m_Expansions[key];
@@ -400,9 +418,28 @@ void RDTreeView::fillBranchesRect(QPainter *painter, const QRect &rect, const QM
 
 void RDTreeView::drawBranches(QPainter *painter, const QRect &rect, const QModelIndex &index) const
 {
+  // gather any coloured lines from parents, from the top-most parent down
+  QVector<QColor> parentLines;
+  for(QModelIndex parent = index.parent(); parent.isValid(); parent = parent.parent())
+    parentLines.push_front(parent.data(TreeLineColorRole).value<QColor>());
+
   if(m_fillBranchRect)
+  {
     fillBranchesRect(painter, rect, index);
 
+    // fill in any custom background behind the lines for the whole row, since by default it
+    // doesn't show up behind the tree lines.
+    if(!selectionModel()->isSelected(index))
+    {
+      QVariant back = index.data(Qt::BackgroundRole);
+
+      if(back.isValid())
+        painter->fillRect(
+            QRect(rect.left(), rect.top(), (parentLines.count() + 1) * indentation(), rect.height()),
+            back.value<QBrush>());
+    }
+  }
+
   if(m_VisibleBranches)
   {
     QTreeView::drawBranches(painter, rect, index);
@@ -412,25 +449,46 @@ void RDTreeView::drawBranches(QPainter *painter, const QRect &rect, const QModel
     // draw only the expand item, not the branches
     QRect primitive(0, rect.top(), qMin(rect.width(), indentation()), rect.height());
 
-    // if root isn't decorated, skip
-    if(!rootIsDecorated() && !index.parent().isValid())
-      return;
+    // if root isn't decorated, skip. If no children, nothing to render
+    if((rootIsDecorated() || index.parent().isValid()) && model()->rowCount(index) > 0)
+    {
+      QStyleOptionViewItem opt = viewOptions();
+
+      opt.rect = primitive;
+
+      // unfortunately QStyle::State_Children doesn't render ONLY the
+      // open-toggle-button, but the vertical line upwards to a previous sibling.
+      // For consistency, draw one downwards too.
+      opt.state = QStyle::State_Children | QStyle::State_Sibling;
+      if(isExpanded(index))
+        opt.state |= QStyle::State_Open;
+
+      style()->drawPrimitive(QStyle::PE_IndicatorBranch, &opt, painter, this);
+    }
+  }
+
+  // we draw the coloured lines after the built-in branches so we paint on top of them, moving in
+  // from the left
+  QRect branchRect(rect.left(), rect.top(), indentation(), rect.height());
 
-    // if no children, nothing to render
-    if(model()->rowCount(index) == 0)
-      return;
+  QPen oldPen = painter->pen();
+  for(const QColor &col : parentLines)
+  {
+    if(col.isValid())
+    {
+      // draw a centred pen vertically down the middle of branchRect
+      painter->setPen(QPen(QBrush(col), 3.0f));
 
-    QStyleOptionViewItem opt = viewOptions();
+      QPoint topCentre = QRect(branchRect).center();
+      QPoint bottomCentre = topCentre;
 
-    opt.rect = primitive;
+      topCentre.setY(branchRect.top());
+      bottomCentre.setY(branchRect.bottom());
 
-    // unfortunately QStyle::State_Children doesn't render ONLY the
-    // open-toggle-button, but the vertical line upwards to a previous sibling.
-    // For consistency, draw one downwards too.
-    opt.state = QStyle::State_Children | QStyle::State_Sibling;
-    if(isExpanded(index))
-      opt.state |= QStyle::State_Open;
+      painter->drawLine(topCentre, bottomCentre);
+    }
 
-    style()->drawPrimitive(QStyle::PE_IndicatorBranch, &opt, painter, this);
+    branchRect.moveLeft(branchRect.left() + indentation());
   }
+  painter->setPen(oldPen);
 }
@@ -82,6 +82,11 @@ public:
   explicit RDTreeView(QWidget *parent = 0);
   virtual ~RDTreeView();
 
+  // models can return a QColor for this role on a parent item, and a vertical line in that colour
+  // will be drawn in the branch area alongside all of its children. This is the equivalent of
+  // RDTreeWidgetItem::setTreeColor for views with a custom model.
+  static const int TreeLineColorRole = Qt::UserRole + 20000;
+
   void showBranches() { m_VisibleBranches = true; }
   void hideBranches() { m_VisibleBranches = false; }
   void showGridLines() { m_VisibleGridLines = true; }
@@ -96,6 +101,9 @@ public:
   void setItemDelegate(QAbstractItemDelegate *delegate);
   QAbstractItemDelegate *itemDelegate() const;
 
+  void expandAllItems(const QModelIndex &index);
+  void collapseAllItems(const QModelIndex &index);
+
   void saveInternalExpansion(uint key, int keyColumn, int role = Qt::DisplayRole);
   bool hasInternalExpansion(uint key);
   void applyInternalExpansion(uint key, int keyColumn, int role = Qt::DisplayRole);
@@ -32,6 +32,7 @@
 #include <QMutexLocker>
 #include <QScrollBar>
 #include <QTimer>
+#include <QVarLengthArray>
 #include <QtMath>
 #include "Code/QRDUtils.h"
 #include "Code/Resources.h"
@@ -370,11 +371,21 @@ public:
     view = v;
     view->setModel(this);
   }
-  void beginReset() { emit beginResetModel(); }
+  // a fetch can be dropped if the event changes before it's processed, in which case the reset
+  // begun for it is ended by the fetch for the new event.
+  void beginReset()
+  {
+    if(m_Resetting)
+      return;
+
+    m_Resetting = true;
+    emit beginResetModel();
+  }
   void endReset()
   {
     cacheColumns();
     m_ColumnCount = columnLookup.count() + reservedColumnCount();
+    m_Resetting = false;
     emit endResetModel();
   }
   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
@@ -524,45 +535,38 @@ public:
             data += buffers[el.buffer]->stride * row;
             data += el.offset;
 
-            // only slightly wasteful, we need to fetch all variants together
-            // since some formats are packed and can't be read individually
-            QVariantList list = el.GetVariants(data, end);
+            const FormatDecoder &decoder = decoderForColumn(col);
 
-            if(!list.isEmpty())
-            {
-              QMetaType::Type vt = GetVariantMetatype(list[0]);
+            // we need to decode all components together since some formats are packed and can't
+            // be read individually
+            QVarLengthArray<DecodedValue, 16> values(decoder.numComponents());
+            int count = decoder.Decode(data, end, values.data());
 
+            if(count > 0)
+            {
               QColor rgb;
 
-              if(vt == QMetaType::Double)
-              {
-                double r = qBound(0.0, list[0].toDouble(), 1.0);
-                double g = list.size() > 1 ? qBound(0.0, list[1].toDouble(), 1.0) : 0.0;
-                double b = list.size() > 2 ? qBound(0.0, list[2].toDouble(), 1.0) : 0.0;
-
-                rgb = QColor::fromRgbF(r, g, b);
-              }
-              else if(vt == QMetaType::Float)
+              if(values[0].type == DecodedValue::Double || values[0].type == DecodedValue::Float)
               {
-                float r = qBound(0.0f, list[0].toFloat(), 1.0f);
-                float g = list.size() > 1 ? qBound(0.0f, list[1].toFloat(), 1.0f) : 0.0;
-                float b = list.size() > 2 ? qBound(0.0f, list[2].toFloat(), 1.0f) : 0.0;
+                float r = qBound(0.0f, values[0].toFloat(), 1.0f);
+                float g = count > 1 ? qBound(0.0f, values[1].toFloat(), 1.0f) : 0.0f;
+                float b = count > 2 ? qBound(0.0f, values[2].toFloat(), 1.0f) : 0.0f;
 
                 rgb = QColor::fromRgbF(r, g, b);
               }
-              else if(vt == QMetaType::UInt || vt == QMetaType::UShort || vt == QMetaType::UChar)
+              else if(values[0].type == DecodedValue::UInt)
               {
-                uint r = qBound(0U, list[0].toUInt(), 255U);
-                uint g = list.size() > 1 ? qBound(0U, list[1].toUInt(), 255U) : 0.0;
-                uint b = list.size() > 2 ? qBound(0U, list[2].toUInt(), 255U) : 0.0;
+                uint r = qBound(0U, values[0].u, 255U);
+                uint g = count > 1 ? qBound(0U, values[1].u, 255U) : 0U;
+                uint b = count > 2 ? qBound(0U, values[2].u, 255U) : 0U;
 
                 rgb = QColor::fromRgb(r, g, b);
               }
-              else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
+              else
               {
-                int r = qBound(0, list[0].toInt(), 255);
-                int g = list.size() > 1 ? qBound(0, list[1].toInt(), 255) : 0.0;
-                int b = list.size() > 2 ? qBound(0, list[2].toInt(), 255) : 0.0;
+                int r = qBound(0, values[0].i, 255);
+                int g = count > 1 ? qBound(0, values[1].i, 255) : 0;
+                int b = count > 2 ? qBound(0, values[2].i, 255) : 0;
 
                 rgb = QColor::fromRgb(r, g, b);
               }
@@ -577,97 +581,107 @@ public:
       }
 
       if(role == Qt::DisplayRole)
-      {
-        if(unclampedNumRows > 0 && row >= numRows - 2)
-        {
-          if(col < 2 && row == numRows - 1)
-            return QString::number(unclampedNumRows - numRows);
+        return displayData(row, col);
+    }
 
-          return lit("...");
-        }
+    return QVariant();
+  }
 
-        if(col >= 0 && col < m_ColumnCount && row < numRows)
-        {
-          if(col == 0)
-            return row;
+  // the display text for a cell. This is safe to call from any thread while the model isn't being
+  // modified, so it's also used directly when exporting.
+  QVariant displayData(uint32_t row, int col) const
+  {
+    if(unclampedNumRows > 0 && row >= numRows - 2)
+    {
+      if(col < 2 && row == numRows - 1)
+        return QString::number(unclampedNumRows - numRows);
 
-          uint32_t idx = row;
+      return lit("...");
+    }
 
-          if(indices && indices->data)
-          {
-            idx = CalcIndex(indices, row, baseVertex);
+    if(col >= 0 && col < m_ColumnCount && row < numRows)
+    {
+      if(col == 0)
+        return row;
 
-            if(primRestart && idx == primRestart)
-              return col == 1 ? lit("--") : lit(" Restart");
+      uint32_t idx = row;
 
-            if(idx == ~0U)
-              return outOfBounds();
-          }
+      if(indices && indices->data)
+      {
+        idx = CalcIndex(indices, row, baseVertex);
 
-          if(col == 1 && meshView)
-          {
-            // if we have separate displayIndices, fetch that for display instead
-            if(displayIndices && displayIndices->data)
-              idx = CalcIndex(displayIndices, row, displayBaseVertex);
+        if(primRestart && idx == primRestart)
+          return col == 1 ? lit("--") : lit(" Restart");
 
-            if(idx == ~0U)
-              return outOfBounds();
+        if(idx == ~0U)
+          return outOfBounds();
+      }
 
-            return idx;
-          }
+      if(col == 1 && meshView)
+      {
+        // if we have separate displayIndices, fetch that for display instead
+        if(displayIndices && displayIndices->data)
+          idx = CalcIndex(displayIndices, row, displayBaseVertex);
 
-          const FormatElement &el = elementForColumn(col);
+        if(idx == ~0U)
+          return outOfBounds();
 
-          if(useGenerics(col))
-            return interpretGeneric(col, el);
+        return idx;
+      }
 
-          uint32_t instIdx = 0;
-          if(el.instancerate > 0)
-            instIdx = curInstance / el.instancerate;
+      const FormatElement &el = elementForColumn(col);
 
-          if(el.buffer < buffers.size())
-          {
-            const byte *data = buffers[el.buffer]->data;
-            const byte *end = buffers[el.buffer]->end;
+      if(useGenerics(col))
+        return interpretGeneric(col, el);
 
-            if(!el.perinstance)
-              data += buffers[el.buffer]->stride * idx;
-            else
-              data += buffers[el.buffer]->stride * instIdx;
+      uint32_t instIdx = 0;
+      if(el.instancerate > 0)
+        instIdx = curInstance / el.instancerate;
 
-            data += el.offset;
+      if(el.buffer < buffers.size())
+      {
+        const byte *data = buffers[el.buffer]->data;
+        const byte *end = buffers[el.buffer]->end;
 
-            // only slightly wasteful, we need to fetch all variants together
-            // since some formats are packed and can't be read individually
-            QVariantList list = el.GetVariants(data, end);
+        if(!el.perinstance)
+          data += buffers[el.buffer]->stride * idx;
+        else
+          data += buffers[el.buffer]->stride * instIdx;
 
-            int comp = componentForIndex(col);
+        data += el.offset;
 
-            if(comp < list.count())
-            {
-              QString ret;
+        const FormatDecoder &decoder = decoderForColumn(col);
 
-              uint32_t rowdim = el.matrixdim;
-              uint32_t coldim = el.format.compCount;
+        // we need to decode all components together since some formats are packed and can't be
+        // read individually
+        QVarLengthArray<DecodedValue, 16> values(decoder.numComponents());
+        int count = decoder.Decode(data, end, values.data());
 
-              for(uint32_t r = 0; r < rowdim; r++)
-              {
-                if(r > 0)
-                  ret += lit("\n");
+        int comp = componentForIndex(col);
 
-                if(el.rowmajor)
-                  ret += interpretVariant(list[comp + r * coldim], el);
-                else
-                  ret += interpretVariant(list[r + comp * rowdim], el);
-              }
+        if(comp < count)
+        {
+          QString ret;
 
-              return ret;
-            }
+          uint32_t rowdim = el.matrixdim;
+          uint32_t coldim = el.format.compCount;
+
+          for(uint32_t r = 0; r < rowdim; r++)
+          {
+            if(r > 0)
+              ret += lit("\n");
+
+            if(el.rowmajor)
+              ret += decoder.Format(values[comp + r * coldim]);
+            else
+              ret += decoder.Format(values[r + comp * rowdim]);
           }
 
-          return outOfBounds();
+          return ret;
         }
       }
+
+      return outOfBounds();
     }
 
     return QVariant();
@@ -763,6 +777,11 @@ public:
     return columns[columnLookup[col - reservedColumnCount()]];
   }
 
+  const FormatDecoder &decoderForColumn(int col) const
+  {
+    return decoders[columnLookup[col - reservedColumnCount()]];
+  }
+
   bool useGenerics(int col) const
   {
     col = columnLookup[col - reservedColumnCount()];
@@ -779,6 +798,10 @@ private:
   QVector<int> columnLookup;
   QVector<int> componentLookup;
   int m_ColumnCount = 0;
+  bool m_Resetting = false;
+
+  // each column's format compiled for decoding, indexed the same as columns
+  QVector<FormatDecoder> decoders;
 
   int positionEl = -1;
   int secondaryEl = -1;
@@ -815,6 +838,8 @@ private:
     columnLookup.reserve(columns.count() * 4);
     componentLookup.clear();
     componentLookup.reserve(columns.count() * 4);
+    decoders.clear();
+    decoders.reserve(columns.count());
 
     for(int i = 0; i < columns.count(); i++)
     {
@@ -854,6 +879,8 @@ private:
         columnLookup.push_back(i);
         componentLookup.push_back((int)c);
       }
+
+      decoders.push_back(FormatDecoder(fmt));
     }
   }
 
@@ -861,90 +888,28 @@ private:
   QString interpretGeneric(int col, const FormatElement &el) const
   {
     int comp = componentForIndex(col);
+    const FormatDecoder &decoder = decoderForColumn(col);
 
     col = columnLookup[col - reservedColumnCount()];
 
     if(col < generics.size())
     {
       if(el.format.compType == CompType::Float)
-      {
-        return interpretVariant(QVariant(generics[col].floatValue[comp]), el);
-      }
+        return decoder.Format(DecodedValue(generics[col].floatValue[comp]));
       else if(el.format.compType == CompType::SInt)
-      {
-        return interpretVariant(QVariant(generics[col].intValue[comp]), el);
-      }
+        return decoder.Format(DecodedValue(generics[col].intValue[comp]));
       else if(el.format.compType == CompType::UInt)
-      {
-        return interpretVariant(QVariant(generics[col].uintValue[comp]), el);
-      }
+        return decoder.Format(DecodedValue(generics[col].uintValue[comp]));
     }
 
     return outOfBounds();
   }
-
-  QString interpretVariant(const QVariant &v, const FormatElement &el) const
-  {
-    QString ret;
-
-    QMetaType::Type vt = GetVariantMetatype(v);
-
-    if(vt == QMetaType::Double)
-    {
-      double d = v.toDouble();
-      // pad with space on left if sign is missing, to better align
-      if(d < 0.0)
-        ret = Formatter::Format(d);
-      else if(d > 0.0)
-        ret = lit(" ") + Formatter::Format(d);
-      else if(qIsNaN(d))
-        ret = lit(" NaN");
-      else
-        // force negative and positive 0 together
-        ret = lit(" ") + Formatter::Format(0.0);
-    }
-    else if(vt == QMetaType::Float)
-    {
-      float f = v.toFloat();
-      // pad with space on left if sign is missing, to better align
-      if(f < 0.0)
-        ret = Formatter::Format(f);
-      else if(f > 0.0)
-        ret = lit(" ") + Formatter::Format(f);
-      else if(qIsNaN(f))
-        ret = lit(" NaN");
-      else
-        // force negative and positive 0 together
-        ret = lit(" ") + Formatter::Format(0.0);
-    }
-    else if(vt == QMetaType::UInt || vt == QMetaType::UShort || vt == QMetaType::UChar)
-    {
-      uint u = v.toUInt();
-      if(el.hex && el.format.type == ResourceFormatType::Regular)
-        ret = Formatter::HexFormat(u, el.format.compByteWidth);
-      else
-        ret = Formatter::Format(u, el.hex);
-    }
-    else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
-    {
-      int i = v.toInt();
-      if(i > 0)
-        ret = lit(" ") + Formatter::Format(i);
-      else
-        ret = Formatter::Format(i);
-    }
-    else
-    {
-      ret = v.toString();
-    }
-
-    return ret;
-  }
 };
 
 struct CachedElData
 {
   const FormatElement *el = NULL;
+  FormatDecoder decoder;
 
   const byte *data = NULL;
   const byte *end = NULL;
@@ -968,6 +933,7 @@ void CacheDataForIteration(QVector<CachedElData> &cache, const QList<FormatEleme
     CachedElData d;
 
     d.el = &el;
+    d.decoder = FormatDecoder(el);
 
     d.byteSize = el.byteSize();
     d.nulls = QByteArray(d.byteSize, '\0');
@@ -992,11 +958,15 @@ void CacheDataForIteration(QVector<CachedElData> &cache, const QList<FormatEleme
   }
 }
 
+QList<BufferViewer *> BufferViewer::m_Viewers;
+
 BufferViewer::BufferViewer(ICaptureContext &ctx, bool meshview, QWidget *parent)
     : QFrame(parent), ui(new Ui::BufferViewer), m_Ctx(ctx)
 {
   ui->setupUi(this);
 
+  m_Viewers.push_back(this);
+
   m_ModelVSIn = new BufferItemModel(ui->vsinData, this);
   m_ModelVSOut = new BufferItemModel(ui->vsoutData, this);
   m_ModelGSOut = new BufferItemModel(ui->gsoutData, this);
@@ -1363,6 +1333,7 @@ BufferViewer::~BufferViewer()
     m_Ctx.BuiltinWindowClosed(this);
 
   m_Ctx.RemoveCaptureViewer(this);
+  m_Viewers.removeOne(this);
   delete ui;
 }
 
@@ -1394,9 +1365,10 @@ void BufferViewer::OnCaptureClosed()
 
 void BufferViewer::OnEventChanged(uint32_t eventId)
 {
-  int vsinHoriz = ui->vsinData->horizontalScrollBar()->value();
-  int vsoutHoriz = ui->vsoutData->horizontalScrollBar()->value();
-  int gsoutHoriz = ui->gsoutData->horizontalScrollBar()->value();
+  // restored once the fetched data arrives
+  m_FetchHoriz[0] = ui->vsinData->horizontalScrollBar()->value();
+  m_FetchHoriz[1] = ui->vsoutData->horizontalScrollBar()->value();
+  m_FetchHoriz[2] = ui->gsoutData->horizontalScrollBar()->value();
 
   QString highlightNames[6] = {
       m_ModelVSIn->posName(),        m_ModelVSIn->secondaryName(), m_ModelVSOut->posName(),
@@ -1497,81 +1469,104 @@ void BufferViewer::OnEventChanged(uint32_t eventId)
   // needs to happen here so the mesh config is accurate when highlighting data is cached.
   updatePreviewColumns();
 
-  m_Ctx.Replay().AsyncInvoke([this, vsinHoriz, vsoutHoriz, gsoutHoriz](IReplayController *r) {
+  // the data is only relevant to this event, and any event change makes a new fetch.
+  if(m_MeshView)
+  {
+    // there's only one mesh viewer, so its fetch is keyed on the request type alone
+    m_FetchKey = lit("MeshFetch");
+
+    m_Ctx.Replay().AsyncInvoke(m_FetchKey, ReplayPriority::Normal, true,
+                               [this](IReplayController *r) {
+                                 RT_FetchMeshData(r);
+                                 GUIInvoke::call(this, [this] { UI_SetFetchedData(NULL); });
+                               });
+    return;
+  }
 
-    BufferData *buf = NULL;
+  // raw fetches are keyed on what they fetch, so viewers showing the same data share one fetch and
+  // all receive its results.
+  ResourceId id = m_BufferID;
+  bool isBuffer = m_IsBuffer;
+  uint64_t offset = m_ByteOffset;
+  uint64_t len = m_ByteSize == UINT64_MAX ? 0 : m_ByteSize;
+  uint32_t arrayIdx = m_TexArrayIdx;
+  uint32_t mip = m_TexMip;
 
-    if(m_MeshView)
-    {
-      RT_FetchMeshData(r);
-    }
+  if(isBuffer)
+    m_FetchKey = QFormatStr("BufferData:%1:%2:%3").arg(ToQStr(id)).arg(offset).arg(len);
+  else
+    m_FetchKey = QFormatStr("TextureData:%1:%2:%3").arg(ToQStr(id)).arg(arrayIdx).arg(mip);
+
+  QString key = m_FetchKey;
+  QWidget *mainWindow = m_Ctx.GetMainWindow()->Widget();
+
+  m_Ctx.Replay().AsyncInvoke(key, ReplayPriority::Normal, true, [mainWindow, key, id, isBuffer,
+                                                                 offset, len, arrayIdx,
+                                                                 mip](IReplayController *r) {
+    bytebuf data;
+    if(isBuffer)
+      data = r->GetBufferData(id, offset, len);
     else
-    {
-      buf = new BufferData;
-      bytebuf data;
-      if(m_IsBuffer)
-      {
-        uint64_t len = m_ByteSize;
-        if(len == UINT64_MAX)
-          len = 0;
+      data = r->GetTextureData(id, arrayIdx, mip);
 
-        data = r->GetBufferData(m_BufferID, m_ByteOffset, len);
-      }
-      else
-      {
-        data = r->GetTextureData(m_BufferID, m_TexArrayIdx, m_TexMip);
-      }
+    GUIInvoke::call(mainWindow, [key, data] {
+      for(BufferViewer *b : m_Viewers)
+        if(b->m_FetchKey == key)
+          b->UI_SetFetchedData(&data);
+    });
+  });
+}
 
-      buf->data = new byte[data.size()];
-      memcpy(buf->data, data.data(), data.size());
-      buf->end = buf->data + data.size();
-    }
+void BufferViewer::UI_SetFetchedData(const bytebuf *data)
+{
+  m_FetchKey.clear();
 
-    GUIInvoke::call(this, [this, buf, vsinHoriz, vsoutHoriz, gsoutHoriz] {
+  if(data)
+  {
+    BufferData *buf = new BufferData;
+    buf->data = new byte[data->size()];
+    memcpy(buf->data, data->data(), data->size());
+    buf->end = buf->data + data->size();
 
-      if(buf)
-      {
-        // calculate tight stride
-        buf->stride = 0;
-        for(const FormatElement &el : m_ModelVSIn->columns)
-          buf->stride += el.byteSize();
+    // calculate tight stride
+    buf->stride = 0;
+    for(const FormatElement &el : m_ModelVSIn->columns)
+      buf->stride += el.byteSize();
 
-        buf->stride = qMax((size_t)1, buf->stride);
+    buf->stride = qMax((size_t)1, buf->stride);
 
-        uint32_t bufCount = uint32_t(buf->end - buf->data);
+    uint32_t bufCount = uint32_t(buf->end - buf->data);
 
-        m_ModelVSIn->numRows = uint32_t((bufCount + buf->stride - 1) / buf->stride);
-        m_ModelVSIn->unclampedNumRows = 0;
+    m_ModelVSIn->numRows = uint32_t((bufCount + buf->stride - 1) / buf->stride);
+    m_ModelVSIn->unclampedNumRows = 0;
 
-        // ownership passes to model
-        m_ModelVSIn->buffers.push_back(buf);
-      }
+    // ownership passes to model
+    m_ModelVSIn->buffers.push_back(buf);
+  }
 
-      updatePreviewColumns();
+  updatePreviewColumns();
 
-      INVOKE_MEMFN(RT_UpdateAndDisplay);
+  INVOKE_MEMFN(RT_UpdateAndDisplay);
 
-      m_ModelVSIn->endReset();
-      m_ModelVSOut->endReset();
-      m_ModelGSOut->endReset();
+  m_ModelVSIn->endReset();
+  m_ModelVSOut->endReset();
+  m_ModelGSOut->endReset();
 
-      ApplyRowAndColumnDims(m_ModelVSIn->columnCount(), ui->vsinData);
-      ApplyRowAndColumnDims(m_ModelVSOut->columnCount(), ui->vsoutData);
-      ApplyRowAndColumnDims(m_ModelGSOut->columnCount(), ui->gsoutData);
+  ApplyRowAndColumnDims(m_ModelVSIn->columnCount(), ui->vsinData);
+  ApplyRowAndColumnDims(m_ModelVSOut->columnCount(), ui->vsoutData);
+  ApplyRowAndColumnDims(m_ModelGSOut->columnCount(), ui->gsoutData);
 
-      int numRows = qMax(qMax(m_ModelVSIn->numRows, m_ModelVSOut->numRows), m_ModelGSOut->numRows);
+  int numRows = qMax(qMax(m_ModelVSIn->numRows, m_ModelVSOut->numRows), m_ModelGSOut->numRows);
 
-      ui->rowOffset->setMaximum(qMax(0, numRows - 1));
+  ui->rowOffset->setMaximum(qMax(0, numRows - 1));
 
-      ScrollToRow(m_ModelVSIn, ui->rowOffset->value());
-      ScrollToRow(m_ModelVSOut, ui->rowOffset->value());
-      ScrollToRow(m_ModelGSOut, ui->rowOffset->value());
+  ScrollToRow(m_ModelVSIn, ui->rowOffset->value());
+  ScrollToRow(m_ModelVSOut, ui->rowOffset->value());
+  ScrollToRow(m_ModelGSOut, ui->rowOffset->value());
 
-      ui->vsinData->horizontalScrollBar()->setValue(vsinHoriz);
-      ui->vsoutData->horizontalScrollBar()->setValue(vsoutHoriz);
-      ui->gsoutData->horizontalScrollBar()->setValue(gsoutHoriz);
-    });
-  });
+  ui->vsinData->horizontalScrollBar()->setValue(m_FetchHoriz[0]);
+  ui->vsoutData->horizontalScrollBar()->setValue(m_FetchHoriz[1]);
+  ui->gsoutData->horizontalScrollBar()->setValue(m_FetchHoriz[2]);
 }
 
 QVariant BufferViewer::persistData()
@@ -1931,26 +1926,12 @@ void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
           if(!el->perinstance)
             bytes += d.stride * idx;
 
-          QVariantList list = el->GetVariants(bytes, d.end);
+          QVarLengthArray<DecodedValue, 16> values(d.decoder.numComponents());
+          int count = qMin(d.decoder.Decode(bytes, d.end, values.data()), 4);
 
-          for(int comp = 0; comp < list.count(); comp++)
+          for(int comp = 0; comp < count; comp++)
           {
-            const QVariant &v = list[comp];
-
-            QMetaType::Type vt = GetVariantMetatype(v);
-
-            float fval = 0.0f;
-
-            if(vt == QMetaType::Double)
-              fval = (float)v.toDouble();
-            else if(vt == QMetaType::Float)
-              fval = v.toFloat();
-            else if(vt == QMetaType::UInt || vt == QMetaType::UShort || vt == QMetaType::UChar)
-              fval = (float)v.toUInt();
-            else if(vt == QMetaType::Int || vt == QMetaType::Short || vt == QMetaType::SChar)
-              fval = (float)v.toInt();
-            else
-              continue;
+            float fval = values[comp].toFloat();
 
             if(qIsFinite(fval))
             {
@@ -2672,7 +2653,8 @@ void BufferViewer::render_clicked(QMouseEvent *e)
 
   if((e->buttons() & Qt::RightButton) && m_Output)
   {
-    m_Ctx.Replay().AsyncInvoke(lit("PickVertex"), [this, curpos](IReplayController *r) {
+    m_Ctx.Replay().AsyncInvoke(lit("PickVertex"), ReplayPriority::Interactive, false,
+                               [this, curpos](IReplayController *r) {
       uint32_t instanceSelected = 0;
       uint32_t vertSelected = 0;
 
@@ -3273,31 +3255,73 @@ void BufferViewer::exportData(const BufferExport &params)
     else if(params.format == BufferExport::CSV)
     {
       // this works identically no matter whether we're mesh view or what, we just iterate the
-      // elements and call the model's data()
+      // elements and fetch the model's display data
 
       QTextStream s(f);
 
-      for(int i = 0; i < model->columnCount(); i++)
+      const int columnCount = model->columnCount();
+      const int rowCount = model->rowCount();
+
+      for(int i = 0; i < columnCount; i++)
       {
         s << model->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
 
-        if(i + 1 < model->columnCount())
+        if(i + 1 < columnCount)
           s << ", ";
       }
 
       s << "\n";
 
-      for(int row = 0; row < model->rowCount(); row++)
+      // format blocks of rows in parallel, then write them out in order. Each batch is bounded so
+      // we don't hold the text for the whole buffer in memory at once.
+      const int numThreads = qMax(1, QThread::idealThreadCount());
+      const int rowsPerBlock = 4096;
+
+      QVector<QString> blocks(numThreads);
+
+      for(int batch = 0; batch < rowCount; batch += rowsPerBlock * numThreads)
       {
-        for(int col = 0; col < model->columnCount(); col++)
+        QSemaphore done;
+        int numBlocks = 0;
+
+        for(int t = 0; t < numThreads; t++)
         {
-          s << model->data(model->index(row, col), Qt::DisplayRole).toString();
+          int begin = batch + t * rowsPerBlock;
+          int end = qMin(rowCount, begin + rowsPerBlock);
 
-          if(col + 1 < model->columnCount())
-            s << ", ";
+          if(begin >= end)
+            break;
+
+          QString *block = &blocks[t];
+
+          LambdaThread *th = new LambdaThread([model, begin, end, columnCount, block, &done]() {
+            block->clear();
+
+            for(int row = begin; row < end; row++)
+            {
+              for(int col = 0; col < columnCount; col++)
+              {
+                *block += model->displayData(row, col).toString();
+
+                if(col + 1 < columnCount)
+                  *block += lit(", ");
+              }
+
+              *block += lit("\n");
+            }
+
+            done.release();
+          });
+          th->selfDelete(true);
+          th->start();
+
+          numBlocks++;
         }
 
-        s << "\n";
+        done.acquire(numBlocks);
+
+        for(int t = 0; t < numBlocks; t++)
+          s << blocks[t];
       }
     }
 
@@ -143,6 +143,7 @@ private:
 
   void RT_UpdateAndDisplay(IReplayController *);
   void RT_FetchMeshData(IReplayController *r);
+  void UI_SetFetchedData(const bytebuf *data);
 
   MeshDisplay m_Config;
 
@@ -201,6 +202,13 @@ private:
   uint64_t m_ByteSize = UINT64_MAX;
   ResourceId m_BufferID;
 
+  // the key of the fetch this viewer is waiting on, shared by any other viewers waiting on the same
+  // data. Empty once the results have arrived.
+  QString m_FetchKey;
+  int m_FetchHoriz[3] = {};
+
+  static QList<BufferViewer *> m_Viewers;
+
   CameraWrapper *m_CurrentCamera = NULL;
   ArcballWrapper *m_Arcball = NULL;
   FlycamWrapper *m_Flycam = NULL;
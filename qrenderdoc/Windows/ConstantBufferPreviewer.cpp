@@ -125,54 +125,101 @@ void ConstantBufferPreviewer::OnEventChanged(uint32_t eventId)
     return;
   }
 
+  // the contents are only relevant to this event, and a new fetch will be made on any event change
+  // so we don't need to process any fetches that haven't started by then. Requests are keyed on
+  // what they fetch, so previews showing the same data share one fetch and all receive its results.
+  m_FetchWasEmpty = wasEmpty;
+
+  QWidget *mainWindow = m_Ctx.GetMainWindow()->Widget();
+
   if(!m_formatOverride.empty())
   {
-    m_Ctx.Replay().AsyncInvoke([this, offs, size, wasEmpty](IReplayController *r) {
-      bytebuf data = r->GetBufferData(m_cbuffer, offs, size);
-      rdcarray<ShaderVariable> vars = applyFormatOverride(data);
-      GUIInvoke::call(this, [this, vars, wasEmpty] {
-        RDTreeViewExpansionState state;
-        ui->variables->saveExpansionExternal(state, 0, 0);
-        setVariables(vars);
-        if(wasEmpty)
-        {
-          for(int i = 0; i < 3; i++)
-            ui->variables->resizeColumnToContents(i);
-        }
-        ui->variables->applyExternalExpansion(state, 0, 0);
-      });
-    });
+    ResourceId cbuffer = m_cbuffer;
+
+    m_FetchKey = QFormatStr("CBufferData:%1:%2:%3").arg(ToQStr(cbuffer)).arg(offs).arg(size);
+
+    QString key = m_FetchKey;
+
+    m_Ctx.Replay().AsyncInvoke(key, ReplayPriority::Normal, true,
+                               [mainWindow, key, cbuffer, offs, size](IReplayController *r) {
+                                 bytebuf data = r->GetBufferData(cbuffer, offs, size);
+                                 GUIInvoke::call(mainWindow, [key, data] {
+                                   for(ConstantBufferPreviewer *c : m_Previews)
+                                     if(c->m_FetchKey == key)
+                                       c->setFetchedData(data);
+                                 });
+                               });
   }
   else
   {
-    m_Ctx.Replay().AsyncInvoke([this, entryPoint, offs, prevShader, wasEmpty](IReplayController *r) {
+    ResourceId shader = m_shader;
+    ResourceId cbuffer = m_cbuffer;
+    uint32_t slot = m_slot;
+
+    m_FetchKey = QFormatStr("CBufferVariables:%1:%2:%3:%4:%5")
+                     .arg(ToQStr(shader))
+                     .arg(entryPoint)
+                     .arg(slot)
+                     .arg(ToQStr(cbuffer))
+                     .arg(offs);
+
+    QString key = m_FetchKey;
+
+    m_Ctx.Replay().AsyncInvoke(key, ReplayPriority::Normal, true, [mainWindow, key, shader,
+                                                                   entryPoint, slot, cbuffer,
+                                                                   offs](IReplayController *r) {
       rdcarray<ShaderVariable> vars = r->GetCBufferVariableContents(
-          m_shader, entryPoint.toUtf8().data(), m_slot, m_cbuffer, offs);
-      GUIInvoke::call(this, [this, vars, prevShader, wasEmpty] {
-
-        // save this state to reapply if we don't already have an internal expansion for the new
-        // shader, since this means two shaders with the same or similar constants will preserve
-        // expansion across selections.
-        RDTreeViewExpansionState state;
-        if(!ui->variables->hasInternalExpansion(ToQStr(m_shader)))
-          ui->variables->saveExpansionExternal(state, 0, 0);
-
-        setVariables(vars);
-        if(wasEmpty)
-        {
-          for(int i = 0; i < 3; i++)
-            ui->variables->resizeColumnToContents(i);
-        }
-
-        if(ui->variables->hasInternalExpansion(ToQStr(m_shader)))
-          ui->variables->applyInternalExpansion(ToQStr(m_shader), 0);
-        else
-          ui->variables->applyExternalExpansion(state, 0, 0);
+          shader, entryPoint.toUtf8().data(), slot, cbuffer, offs);
+      GUIInvoke::call(mainWindow, [key, vars] {
+        for(ConstantBufferPreviewer *c : m_Previews)
+          if(c->m_FetchKey == key)
+            c->setFetchedVariables(vars);
       });
     });
   }
 }
 
+void ConstantBufferPreviewer::setFetchedData(const bytebuf &data)
+{
+  m_FetchKey.clear();
+
+  rdcarray<ShaderVariable> vars = applyFormatOverride(data);
+
+  RDTreeViewExpansionState state;
+  ui->variables->saveExpansionExternal(state, 0, 0);
+  setVariables(vars);
+  if(m_FetchWasEmpty)
+  {
+    for(int i = 0; i < 3; i++)
+      ui->variables->resizeColumnToContents(i);
+  }
+  ui->variables->applyExternalExpansion(state, 0, 0);
+}
+
+void ConstantBufferPreviewer::setFetchedVariables(const rdcarray<ShaderVariable> &vars)
+{
+  m_FetchKey.clear();
+
+  // save this state to reapply if we don't already have an internal expansion for the new
+  // shader, since this means two shaders with the same or similar constants will preserve
+  // expansion across selections.
+  RDTreeViewExpansionState state;
+  if(!ui->variables->hasInternalExpansion(ToQStr(m_shader)))
+    ui->variables->saveExpansionExternal(state, 0, 0);
+
+  setVariables(vars);
+  if(m_FetchWasEmpty)
+  {
+    for(int i = 0; i < 3; i++)
+      ui->variables->resizeColumnToContents(i);
+  }
+
+  if(ui->variables->hasInternalExpansion(ToQStr(m_shader)))
+    ui->variables->applyInternalExpansion(ToQStr(m_shader), 0);
+  else
+    ui->variables->applyExternalExpansion(state, 0, 0);
+}
+
 void ConstantBufferPreviewer::on_setFormat_toggled(bool checked)
 {
   if(!checked)
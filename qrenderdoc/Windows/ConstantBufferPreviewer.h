@@ -80,10 +80,17 @@ private:
 
   void addVariables(RDTreeWidgetItem *root, const rdcarray<ShaderVariable> &vars);
   void setVariables(const rdcarray<ShaderVariable> &vars);
+  void setFetchedData(const bytebuf &data);
+  void setFetchedVariables(const rdcarray<ShaderVariable> &vars);
 
   void updateLabels();
 
   static QList<ConstantBufferPreviewer *> m_Previews;
 
   QList<FormatElement> m_formatOverride;
+
+  // the key of the fetch this preview is waiting on, shared by any other previews waiting on the
+  // same data. Empty once the results have arrived.
+  QString m_FetchKey;
+  bool m_FetchWasEmpty = false;
 };
@@ -38,23 +38,9 @@
 #include "Code/Resources.h"
 #include "Widgets/Extended/RDHeaderView.h"
 #include "Widgets/Extended/RDListWidget.h"
+#include "Widgets/Extended/RDTreeView.h"
 #include "ui_EventBrowser.h"
 
-struct EventItemTag
-{
-  EventItemTag() = default;
-  EventItemTag(uint32_t eventId) : EID(eventId), lastEID(eventId) {}
-  EventItemTag(uint32_t eventId, uint32_t lastEventID) : EID(eventId), lastEID(lastEventID) {}
-  uint32_t EID = 0;
-  uint32_t lastEID = 0;
-  double duration = -1.0;
-  bool current = false;
-  bool find = false;
-  bool bookmark = false;
-};
-
-Q_DECLARE_METATYPE(EventItemTag);
-
 enum
 {
   COL_NAME,
@@ -64,6 +50,499 @@ enum
   COL_COUNT,
 };
 
+// internal IDs used for the two virtual rows that don't correspond to a drawcall. Any other
+// internal ID is the pointer to the DrawcallDescription for that row, which can never have these
+// values. The drawcall array is owned by the replay controller and is immutable for the lifetime of
+// the capture, so the pointers are stable.
+static const quintptr FrameRootTag = 1;
+static const quintptr FrameStartTag = 2;
+
+// model that sits directly on top of the drawcall tree, rather than creating an item per drawcall up
+// front. Rows are only created by the view as they become visible, and we keep a flat lookup from
+// eventId to node so that selecting an event doesn't have to search the tree.
+class EventItemModel : public QAbstractItemModel
+{
+public:
+  EventItemModel(RDTreeView *view, ICaptureContext &ctx)
+      : QAbstractItemModel(view), m_View(view), m_Ctx(ctx)
+  {
+  }
+
+  void ResetModel()
+  {
+    beginResetModel();
+
+    m_Loaded = m_Ctx.IsCaptureLoaded();
+    m_Draws = &m_Ctx.CurDrawcalls();
+
+    m_Names.clear();
+    m_Durations.clear();
+    m_Find.clear();
+    m_Bookmarks.clear();
+    m_Current = 0;
+
+    m_EIDLookup.clear();
+    m_FrameLastEID = 0;
+
+    if(m_Loaded)
+    {
+      m_EIDLookup.push_back(FrameStartTag);
+      BuildEIDLookup(*m_Draws);
+
+      if(!m_Draws->empty())
+        m_FrameLastEID = GetLastEID(&m_Draws->back());
+    }
+
+    endResetModel();
+  }
+
+  void SetHeaders(const QStringList &headers) { m_Headers = headers; }
+  QString HeaderText(int column) const { return m_Headers[column]; }
+  void SetHeaderText(int column, const QString &text)
+  {
+    m_Headers[column] = text;
+    emit headerDataChanged(Qt::Horizontal, column, column);
+  }
+
+  // returns the node that should be selected for the given event, the same as searching the tree
+  // for the first node whose last EID is at or after eventId, preferring exact matches on leaves.
+  QModelIndex GetIndexForEID(uint32_t eventId) const
+  {
+    if(eventId >= (uint32_t)m_EIDLookup.count())
+      return QModelIndex();
+
+    return IndexForTag(m_EIDLookup[eventId]);
+  }
+
+  uint32_t GetEID(const QModelIndex &idx) const
+  {
+    const DrawcallDescription *draw = GetDraw(idx);
+    return draw ? draw->eventId : 0;
+  }
+
+  uint32_t GetLastEID(const QModelIndex &idx) const
+  {
+    if(idx.internalId() == FrameRootTag)
+      return m_FrameLastEID;
+
+    const DrawcallDescription *draw = GetDraw(idx);
+    return draw ? GetLastEID(draw) : 0;
+  }
+
+  QString GetName(const QModelIndex &idx) const
+  {
+    quintptr id = idx.internalId();
+
+    if(id == FrameRootTag)
+      return QFormatStr("Frame #%1").arg(m_Ctx.FrameInfo().frameNumber);
+    else if(id == FrameStartTag)
+      return EventBrowser::tr("Frame Start");
+
+    const DrawcallDescription *draw = GetDraw(idx);
+    return draw ? QString(draw->name) : QString();
+  }
+
+  double GetDuration(const DrawcallDescription *draw) const
+  {
+    return m_Durations.value((quintptr)draw, -1.0);
+  }
+
+  void SetCurrent(const QModelIndex &idx)
+  {
+    quintptr prev = m_Current;
+    m_Current = idx.isValid() ? idx.internalId() : 0;
+
+    RefreshNode(prev, Qt::DecorationRole);
+    RefreshNode(m_Current, Qt::DecorationRole);
+  }
+
+  void SetBookmark(const QModelIndex &idx, bool bookmark)
+  {
+    if(!idx.isValid())
+      return;
+
+    if(bookmark)
+      m_Bookmarks.insert(idx.internalId());
+    else
+      m_Bookmarks.remove(idx.internalId());
+
+    RefreshNode(idx.internalId(), Qt::DecorationRole);
+  }
+
+  void SetFindResults(const QSet<quintptr> &results)
+  {
+    m_Find = results;
+    RefreshAll(Qt::DecorationRole);
+  }
+
+  void SetTimeUnit(TimeUnit unit)
+  {
+    m_TimeUnit = unit;
+    RefreshAll(Qt::DisplayRole);
+  }
+
+  void SetTimes(const rdcarray<CounterResult> &results)
+  {
+    m_Durations.clear();
+
+    if(m_Loaded && !results.empty())
+    {
+      QHash<uint32_t, double> times;
+      times.reserve(results.count());
+      for(const CounterResult &r : results)
+        times[r.eventId] = r.value.d;
+
+      m_Durations[FrameRootTag] = CalcDurations(*m_Draws, times);
+    }
+
+    RefreshAll(Qt::DisplayRole);
+  }
+
+  QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
+  {
+    if(row < 0 || column < 0 || row >= rowCount(parent) || column >= columnCount())
+      return QModelIndex();
+
+    if(!parent.isValid())
+      return createIndex(row, column, FrameRootTag);
+
+    // the frame root's children are the virtual frame start, then the top-level drawcalls
+    if(parent.internalId() == FrameRootTag)
+    {
+      if(row == 0)
+        return createIndex(row, column, FrameStartTag);
+
+      return createIndex(row, column, (quintptr)&m_Draws->at(row - 1));
+    }
+
+    const DrawcallDescription *draw = GetDraw(parent);
+
+    return createIndex(row, column, (quintptr)&draw->children[row]);
+  }
+
+  QModelIndex parent(const QModelIndex &index) const override
+  {
+    if(!index.isValid() || index.internalId() == FrameRootTag)
+      return QModelIndex();
+
+    const DrawcallDescription *draw = GetDraw(index);
+
+    // the frame start and top-level drawcalls are children of the frame root
+    if(draw == NULL || draw->parent == NULL)
+      return createIndex(0, 0, FrameRootTag);
+
+    return IndexForDraw(draw->parent);
+  }
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override
+  {
+    if(!m_Loaded)
+      return 0;
+
+    if(!parent.isValid())
+      return 1;
+
+    if(parent.internalId() == FrameRootTag)
+      return m_Draws->count() + 1;
+
+    const DrawcallDescription *draw = GetDraw(parent);
+
+    return draw ? draw->children.count() : 0;
+  }
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override { return COL_COUNT; }
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+  {
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole && section < m_Headers.count())
+      return m_Headers[section];
+
+    return QVariant();
+  }
+
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+  {
+    if(!index.isValid())
+      return QVariant();
+
+    quintptr id = index.internalId();
+    const DrawcallDescription *draw = GetDraw(index);
+
+    if(role == Qt::DisplayRole)
+    {
+      switch(index.column())
+      {
+        case COL_NAME:
+        {
+          if(draw == NULL)
+            return GetName(index);
+
+          // the rich text is only created when a row is first displayed, and then cached
+          auto it = m_Names.find(id);
+          if(it == m_Names.end())
+          {
+            QVariant name = QString(draw->name);
+            RichResourceTextInitialise(name);
+            it = m_Names.insert(id, name);
+          }
+
+          return it.value();
+        }
+        case COL_EID:
+        case COL_DRAW:
+        {
+          if(id == FrameRootTag)
+            return QVariant();
+          else if(id == FrameStartTag)
+            return lit("0");
+
+          if(index.column() == COL_EID)
+          {
+            uint32_t lastEID = draw->children.empty() ? 0 : GetLastEID(draw);
+
+            if(lastEID > draw->eventId)
+              return QFormatStr("%1-%2").arg(draw->eventId).arg(lastEID);
+
+            return QString::number(draw->eventId);
+          }
+          else
+          {
+            if(!draw->children.empty() && GetLastEID(draw) > draw->eventId)
+            {
+              const DrawcallDescription *last = draw;
+              while(!last->children.empty())
+                last = &last->children.back();
+
+              return QFormatStr("%1-%2").arg(draw->drawcallId).arg(last->drawcallId);
+            }
+
+            return QString::number(draw->drawcallId);
+          }
+        }
+        case COL_DURATION:
+        {
+          if(m_Durations.isEmpty())
+            return draw ? lit("---") : QString();
+
+          double secs = m_Durations.value(id, -1.0);
+
+          if(secs < 0.0)
+            return QString();
+
+          if(m_TimeUnit == TimeUnit::Milliseconds)
+            secs *= 1000.0;
+          else if(m_TimeUnit == TimeUnit::Microseconds)
+            secs *= 1000000.0;
+          else if(m_TimeUnit == TimeUnit::Nanoseconds)
+            secs *= 1000000000.0;
+
+          return Formatter::Format(secs);
+        }
+        default: break;
+      }
+    }
+    else if(role == Qt::DecorationRole)
+    {
+      if(index.column() != COL_NAME)
+        return QVariant();
+
+      if(id == m_Current)
+        return Icons::flag_green();
+      else if(m_Bookmarks.contains(id))
+        return Icons::asterisk_orange();
+      else if(m_Find.contains(id))
+        return Icons::find();
+    }
+    else if(role == Qt::TextAlignmentRole)
+    {
+      if(index.column() == COL_DURATION)
+      {
+        Qt::Alignment align = Qt::AlignRight | Qt::AlignCenter;
+        return QVariant(align);
+      }
+    }
+    else if(role == RDTreeView::TreeLineColorRole || role == Qt::BackgroundRole ||
+            role == Qt::ForegroundRole)
+    {
+      QColor col = GetMarkerColor(draw);
+
+      if(!col.isValid())
+        return QVariant();
+
+      if(role == RDTreeView::TreeLineColorRole)
+        return col;
+
+      if(!m_Ctx.Config().EventBrowser_ColorEventRow)
+        return QVariant();
+
+      // the background colour only applies if not selected
+      if(role == Qt::BackgroundRole)
+      {
+        if(m_View->selectionModel()->isSelected(index))
+          return QVariant();
+
+        return QBrush(col);
+      }
+
+      return QBrush(contrastingColor(col, m_View->palette().color(QPalette::Text)));
+    }
+
+    return QVariant();
+  }
+
+private:
+  RDTreeView *m_View;
+  ICaptureContext &m_Ctx;
+
+  bool m_Loaded = false;
+  const rdcarray<DrawcallDescription> *m_Draws = NULL;
+
+  QStringList m_Headers;
+  TimeUnit m_TimeUnit = TimeUnit::Count;
+
+  uint32_t m_FrameLastEID = 0;
+  QVector<quintptr> m_EIDLookup;
+
+  mutable QHash<quintptr, QVariant> m_Names;
+  QHash<quintptr, double> m_Durations;
+
+  quintptr m_Current = 0;
+  QSet<quintptr> m_Bookmarks;
+  QSet<quintptr> m_Find;
+
+  const DrawcallDescription *GetDraw(const QModelIndex &idx) const
+  {
+    quintptr id = idx.internalId();
+
+    if(!idx.isValid() || id == FrameRootTag || id == FrameStartTag)
+      return NULL;
+
+    return (const DrawcallDescription *)id;
+  }
+
+  const rdcarray<DrawcallDescription> &GetSiblings(const DrawcallDescription *draw) const
+  {
+    return draw->parent ? draw->parent->children : *m_Draws;
+  }
+
+  QModelIndex IndexForDraw(const DrawcallDescription *draw, int column = 0) const
+  {
+    int row = int(draw - GetSiblings(draw).data());
+
+    // top-level drawcalls come after the virtual frame start row
+    if(draw->parent == NULL)
+      row++;
+
+    return createIndex(row, column, (quintptr)draw);
+  }
+
+  QModelIndex IndexForTag(quintptr id) const
+  {
+    if(id == 0)
+      return QModelIndex();
+    else if(id == FrameRootTag)
+      return createIndex(0, 0, FrameRootTag);
+    else if(id == FrameStartTag)
+      return createIndex(0, 0, FrameStartTag);
+
+    return IndexForDraw((const DrawcallDescription *)id);
+  }
+
+  // the last EID covered by a node is that of its last child. Set markers without children cover
+  // up to the next drawcall, since they have no event of their own to select.
+  uint32_t GetLastEID(const DrawcallDescription *draw) const
+  {
+    while(!draw->children.empty())
+      draw = &draw->children.back();
+
+    if(draw->flags & DrawFlags::SetMarker)
+    {
+      const rdcarray<DrawcallDescription> &siblings = GetSiblings(draw);
+      size_t idx = draw - siblings.data();
+
+      if(idx + 1 < siblings.size())
+        return siblings[idx + 1].eventId;
+    }
+
+    return draw->eventId;
+  }
+
+  void BuildEIDLookup(const rdcarray<DrawcallDescription> &draws)
+  {
+    for(const DrawcallDescription &d : draws)
+    {
+      if(!d.children.empty())
+      {
+        BuildEIDLookup(d.children);
+        continue;
+      }
+
+      uint32_t lastEID = GetLastEID(&d);
+
+      // events between the previous leaf and this one select this leaf.
+      while((uint32_t)m_EIDLookup.count() <= lastEID)
+        m_EIDLookup.push_back((quintptr)&d);
+
+      // where a set marker and the following drawcall share a last EID, prefer the drawcall for
+      // the exact match.
+      if((uint32_t)m_EIDLookup.count() == lastEID + 1)
+        m_EIDLookup[lastEID] = (quintptr)&d;
+    }
+  }
+
+  // parent nodes take the value of the sum of their children
+  double CalcDurations(const rdcarray<DrawcallDescription> &draws,
+                       const QHash<uint32_t, double> &times)
+  {
+    double total = 0.0;
+
+    for(const DrawcallDescription &d : draws)
+    {
+      double duration = 0.0;
+
+      if(d.children.empty())
+        duration = times.value(d.eventId, -1.0);
+      else
+        duration = CalcDurations(d.children, times);
+
+      m_Durations[(quintptr)&d] = duration;
+
+      if(duration > 0.0)
+        total += duration;
+    }
+
+    return total;
+  }
+
+  QColor GetMarkerColor(const DrawcallDescription *draw) const
+  {
+    if(draw == NULL || !m_Ctx.Config().EventBrowser_ApplyColors)
+      return QColor();
+
+    // if alpha isn't 0, assume the colour is valid
+    if((draw->flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && draw->markerColor[3] > 0.0f)
+      return QColor::fromRgb(qRgb(draw->markerColor[0] * 255.0f, draw->markerColor[1] * 255.0f,
+                                  draw->markerColor[2] * 255.0f));
+
+    return QColor();
+  }
+
+  void RefreshNode(quintptr id, int role)
+  {
+    QModelIndex idx = IndexForTag(id);
+
+    if(idx.isValid())
+      emit dataChanged(idx, index(idx.row(), COL_COUNT - 1, idx.parent()), {role});
+  }
+
+  // we don't track which nodes have been populated by the view, so on a bulk change we just notify
+  // across the whole top-level row, which makes views repaint all visible rows.
+  void RefreshAll(int role)
+  {
+    if(m_Loaded)
+      emit dataChanged(index(0, 0), index(0, COL_COUNT - 1), {role});
+  }
+};
+
 static bool textEditControl(QWidget *sender)
 {
   if(qobject_cast<QLineEdit *>(sender) || qobject_cast<QTextEdit *>(sender) ||
@@ -90,9 +569,13 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   ui->find->setFont(Formatter::PreferredFont());
   ui->events->setFont(Formatter::PreferredFont());
 
-  ui->events->setColumns(
+  m_Model = new EventItemModel(ui->events, m_Ctx);
+  m_Model->SetHeaders(
       {tr("Name"), lit("EID"), lit("Draw #"), lit("Duration - replaced in UpdateDurationColumn")});
 
+  ui->events->setModel(m_Model);
+  ui->events->setItemDelegate(new RichTextViewDelegate(ui->events));
+
   ui->events->setHeader(new RDHeaderView(Qt::Horizontal, this));
   ui->events->header()->setStretchLastSection(true);
   ui->events->header()->setDefaultAlignment(Qt::AlignLeft | Qt::AlignVCenter);
@@ -103,8 +586,6 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   ui->events->header()->setSectionResizeMode(COL_DRAW, QHeaderView::Interactive);
   ui->events->header()->setSectionResizeMode(COL_DURATION, QHeaderView::Interactive);
 
-  ui->events->setColumnAlignment(COL_DURATION, Qt::AlignRight | Qt::AlignCenter);
-
   ui->events->header()->setMinimumSectionSize(40);
 
   ui->events->header()->setSectionsMovable(true);
@@ -134,7 +615,9 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
 
   QObject::connect(ui->closeFind, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
   QObject::connect(ui->closeJump, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
-  QObject::connect(ui->events, &RDTreeWidget::keyPress, this, &EventBrowser::events_keyPress);
+  QObject::connect(ui->events, &RDTreeView::keyPress, this, &EventBrowser::events_keyPress);
+  QObject::connect(ui->events->selectionModel(), &QItemSelectionModel::currentChanged, this,
+                   &EventBrowser::events_currentChanged);
   ui->jumpStrip->hide();
   ui->findStrip->hide();
   ui->bookmarkStrip->hide();
@@ -182,7 +665,7 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
                                         [this](QWidget *) { on_HideFindJump(); });
 
   ui->events->setContextMenuPolicy(Qt::CustomContextMenu);
-  QObject::connect(ui->events, &RDTreeWidget::customContextMenuRequested, this,
+  QObject::connect(ui->events, &RDTreeView::customContextMenuRequested, this,
                    &EventBrowser::events_contextMenu);
 
   ui->events->header()->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -199,6 +682,8 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
 
 EventBrowser::~EventBrowser()
 {
+  CancelFindIcons();
+
   // unregister any shortcuts we registered
   Qt::Key keys[] = {
       Qt::Key_1, Qt::Key_2, Qt::Key_3, Qt::Key_4, Qt::Key_5,
@@ -226,21 +711,9 @@ EventBrowser::~EventBrowser()
 
 void EventBrowser::OnCaptureLoaded()
 {
-  RDTreeWidgetItem *frame = new RDTreeWidgetItem(
-      {QFormatStr("Frame #%1").arg(m_Ctx.FrameInfo().frameNumber), QString(), QString(), QString()});
-
-  RDTreeWidgetItem *framestart =
-      new RDTreeWidgetItem({tr("Frame Start"), lit("0"), lit("0"), QString()});
-  framestart->setTag(QVariant::fromValue(EventItemTag(0, 0)));
+  m_Model->ResetModel();
 
-  frame->addChild(framestart);
-
-  QPair<uint32_t, uint32_t> lastEIDDraw = AddDrawcalls(frame, m_Ctx.CurDrawcalls());
-  frame->setTag(QVariant::fromValue(EventItemTag(0, lastEIDDraw.first)));
-
-  ui->events->addTopLevelItem(frame);
-
-  ui->events->expandItem(frame);
+  ui->events->expand(m_Model->index(0, 0));
 
   clearBookmarks();
   repopulateBookmarks();
@@ -258,7 +731,11 @@ void EventBrowser::OnCaptureClosed()
 {
   clearBookmarks();
 
-  ui->events->clear();
+  ClearFindIcons();
+
+  m_Times.clear();
+
+  m_Model->ResetModel();
 
   ui->find->setEnabled(false);
   ui->gotoEID->setEnabled(false);
@@ -276,132 +753,6 @@ void EventBrowser::OnEventChanged(uint32_t eventId)
   highlightBookmarks();
 }
 
-QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
-                                                     const rdcarray<DrawcallDescription> &draws)
-{
-  uint lastEID = 0, lastDraw = 0;
-
-  for(int32_t i = 0; i < draws.count(); i++)
-  {
-    const DrawcallDescription &d = draws[i];
-
-    QVariant name = QString(d.name);
-
-    RichResourceTextInitialise(name);
-
-    RDTreeWidgetItem *child = new RDTreeWidgetItem(
-        {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
-
-    QPair<uint32_t, uint32_t> last = AddDrawcalls(child, d.children);
-    lastEID = last.first;
-    lastDraw = last.second;
-
-    if(lastEID > d.eventId)
-    {
-      child->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(lastEID));
-      child->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(lastDraw));
-    }
-
-    if(lastEID == 0)
-    {
-      lastEID = d.eventId;
-      lastDraw = d.drawcallId;
-
-      if((draws[i].flags & DrawFlags::SetMarker) && i + 1 < draws.count())
-        lastEID = draws[i + 1].eventId;
-    }
-
-    child->setTag(QVariant::fromValue(EventItemTag(draws[i].eventId, lastEID)));
-
-    if(m_Ctx.Config().EventBrowser_ApplyColors)
-    {
-      // if alpha isn't 0, assume the colour is valid
-      if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
-      {
-        QColor col = QColor::fromRgb(
-            qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
-
-        child->setTreeColor(col, 3.0f);
-
-        if(m_Ctx.Config().EventBrowser_ColorEventRow)
-        {
-          QColor textCol = ui->events->palette().color(QPalette::Text);
-
-          child->setBackgroundColor(col);
-          child->setForegroundColor(contrastingColor(col, textCol));
-        }
-      }
-    }
-
-    parent->addChild(child);
-  }
-
-  return qMakePair(lastEID, lastDraw);
-}
-
-void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results)
-{
-  if(node == NULL)
-    return;
-
-  // parent nodes take the value of the sum of their children
-  double duration = 0.0;
-
-  // look up leaf nodes in the dictionary
-  if(node->childCount() == 0)
-  {
-    uint32_t eid = node->tag().value<EventItemTag>().EID;
-
-    duration = -1.0;
-
-    for(const CounterResult &r : results)
-    {
-      if(r.eventId == eid)
-        duration = r.value.d;
-    }
-
-    double secs = duration;
-
-    if(m_TimeUnit == TimeUnit::Milliseconds)
-      secs *= 1000.0;
-    else if(m_TimeUnit == TimeUnit::Microseconds)
-      secs *= 1000000.0;
-    else if(m_TimeUnit == TimeUnit::Nanoseconds)
-      secs *= 1000000000.0;
-
-    node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-    EventItemTag tag = node->tag().value<EventItemTag>();
-    tag.duration = duration;
-    node->setTag(QVariant::fromValue(tag));
-
-    return;
-  }
-
-  for(int i = 0; i < node->childCount(); i++)
-  {
-    SetDrawcallTimes(node->child(i), results);
-
-    double nd = node->child(i)->tag().value<EventItemTag>().duration;
-
-    if(nd > 0.0)
-      duration += nd;
-  }
-
-  double secs = duration;
-
-  if(m_TimeUnit == TimeUnit::Milliseconds)
-    secs *= 1000.0;
-  else if(m_TimeUnit == TimeUnit::Microseconds)
-    secs *= 1000000.0;
-  else if(m_TimeUnit == TimeUnit::Nanoseconds)
-    secs *= 1000000000.0;
-
-  node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-  EventItemTag tag = node->tag().value<EventItemTag>();
-  tag.duration = duration;
-  node->setTag(QVariant::fromValue(tag));
-}
-
 void EventBrowser::on_find_clicked()
 {
   ui->jumpStrip->hide();
@@ -418,10 +769,10 @@ void EventBrowser::on_gotoEID_clicked()
 
 void EventBrowser::on_bookmark_clicked()
 {
-  RDTreeWidgetItem *n = ui->events->currentItem();
+  QModelIndex idx = ui->events->currentIndex();
 
-  if(n)
-    toggleBookmark(n->tag().value<EventItemTag>().lastEID);
+  if(idx.isValid())
+    toggleBookmark(m_Model->GetLastEID(idx));
 }
 
 void EventBrowser::on_timeDraws_clicked()
@@ -434,44 +785,33 @@ void EventBrowser::on_timeDraws_clicked()
 
     m_Times = r->FetchCounters({GPUCounter::EventGPUDuration});
 
-    GUIInvoke::call(this, [this]() {
-      SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
-      ui->events->update();
-    });
+    GUIInvoke::call(this, [this]() { m_Model->SetTimes(m_Times); });
   });
 }
 
-void EventBrowser::on_events_currentItemChanged(RDTreeWidgetItem *current, RDTreeWidgetItem *previous)
+void EventBrowser::events_currentChanged(const QModelIndex &current, const QModelIndex &previous)
 {
-  if(previous)
-  {
-    EventItemTag tag = previous->tag().value<EventItemTag>();
-    tag.current = false;
-    previous->setTag(QVariant::fromValue(tag));
-    RefreshIcon(previous, tag);
-  }
+  m_Model->SetCurrent(current);
 
-  if(!current)
+  if(!current.isValid())
     return;
 
-  EventItemTag tag = current->tag().value<EventItemTag>();
-  tag.current = true;
-  current->setTag(QVariant::fromValue(tag));
-  RefreshIcon(current, tag);
+  uint32_t EID = m_Model->GetEID(current);
+  uint32_t lastEID = m_Model->GetLastEID(current);
 
-  m_Ctx.SetEventID({this}, tag.EID, tag.lastEID);
+  m_Ctx.SetEventID({this}, EID, lastEID);
 
-  const DrawcallDescription *draw = m_Ctx.GetDrawcall(tag.lastEID);
+  const DrawcallDescription *draw = m_Ctx.GetDrawcall(lastEID);
 
   ui->stepPrev->setEnabled(draw && draw->previous);
   ui->stepNext->setEnabled(draw && draw->next);
 
   // special case for the first draw in the frame
-  if(tag.lastEID == 0)
+  if(lastEID == 0)
     ui->stepNext->setEnabled(true);
 
   // special case for the first 'virtual' draw at EID 0
-  if(m_Ctx.GetFirstDrawcall() && tag.lastEID == m_Ctx.GetFirstDrawcall()->eventId)
+  if(m_Ctx.GetFirstDrawcall() && lastEID == m_Ctx.GetFirstDrawcall()->eventId)
     ui->stepPrev->setEnabled(true);
 
   highlightBookmarks();
@@ -500,14 +840,7 @@ void EventBrowser::on_jumpToEID_returnPressed()
 
 void EventBrowser::findHighlight_timeout()
 {
-  ClearFindIcons();
-
-  int results = SetFindIcons(ui->findEvent->text());
-
-  if(results > 0)
-    ui->findEvent->setPalette(palette());
-  else
-    ui->findEvent->setPalette(m_redPalette);
+  SetFindIcons(ui->findEvent->text());
 }
 
 void EventBrowser::on_findEvent_textEdited(const QString &arg1)
@@ -624,7 +957,7 @@ void EventBrowser::on_exportDraws_clicked()
 
         if(!m_Times.empty())
         {
-          line += QFormatStr(" | %1").arg(ui->events->headerText(COL_DURATION));
+          line += QFormatStr(" | %1").arg(m_Model->HeaderText(COL_DURATION));
         }
 
         stream << line << "\n";
@@ -676,7 +1009,7 @@ void EventBrowser::on_colSelect_clicked()
   {
     int logIdx = ui->events->header()->logicalIndex(visIdx);
 
-    QListWidgetItem *item = new QListWidgetItem(ui->events->headerText(logIdx), &list);
+    QListWidgetItem *item = new QListWidgetItem(m_Model->HeaderText(logIdx), &list);
 
     item->setData(Qt::UserRole, logIdx);
 
@@ -749,13 +1082,7 @@ double EventBrowser::GetDrawTime(const DrawcallDescription &drawcall)
     return total;
   }
 
-  for(const CounterResult &r : m_Times)
-  {
-    if(r.eventId == drawcall.eventId)
-      return r.value.d;
-  }
-
-  return -1.0;
+  return m_Model->GetDuration(&drawcall);
 }
 
 void EventBrowser::GetMaxNameLength(int &maxNameLength, int indent, bool firstchild,
@@ -841,7 +1168,7 @@ QVariant EventBrowser::persistData()
       ui->events->header()->hideSection(i);
 
     // name is just informative
-    col[lit("name")] = ui->events->headerText(i);
+    col[lit("name")] = m_Model->HeaderText(i);
     col[lit("index")] = ui->events->header()->visualIndex(i);
     col[lit("hidden")] = hidden;
     col[lit("size")] = size;
@@ -918,7 +1245,11 @@ void EventBrowser::events_keyPress(QKeyEvent *event)
 
 void EventBrowser::events_contextMenu(const QPoint &pos)
 {
-  RDTreeWidgetItem *item = ui->events->itemAt(pos);
+  QModelIndex item = ui->events->indexAt(pos);
+
+  // only the first column has children
+  if(item.isValid())
+    item = item.sibling(item.row(), 0);
 
   QMenu contextMenu(this);
 
@@ -936,8 +1267,8 @@ void EventBrowser::events_contextMenu(const QPoint &pos)
   collapseAll.setIcon(Icons::arrow_in());
   selectCols.setIcon(Icons::timeline_marker());
 
-  expandAll.setEnabled(item && item->childCount() > 0);
-  collapseAll.setEnabled(item && item->childCount() > 0);
+  expandAll.setEnabled(item.isValid() && m_Model->rowCount(item) > 0);
+  collapseAll.setEnabled(item.isValid() && m_Model->rowCount(item) > 0);
 
   QObject::connect(&expandAll, &QAction::triggered,
                    [this, item]() { ui->events->expandAllItems(item); });
@@ -995,16 +1326,7 @@ void EventBrowser::repopulateBookmarks()
 
       highlightBookmarks();
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = true;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      m_Model->SetBookmark(m_Model->GetIndexForEID(EID), true);
 
       m_BookmarkStripLayout->removeItem(m_BookmarkSpacer);
       m_BookmarkStripLayout->addWidget(but);
@@ -1020,16 +1342,7 @@ void EventBrowser::repopulateBookmarks()
       delete m_BookmarkButtons[EID];
       m_BookmarkButtons.remove(EID);
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = false;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      m_Model->SetBookmark(m_Model->GetIndexForEID(EID), false);
     }
   }
 
@@ -1067,70 +1380,22 @@ void EventBrowser::highlightBookmarks()
   }
 }
 
-bool EventBrowser::hasBookmark(RDTreeWidgetItem *node)
-{
-  if(node)
-    return hasBookmark(node->tag().value<EventItemTag>().EID);
-
-  return false;
-}
-
 bool EventBrowser::hasBookmark(uint32_t EID)
 {
   return m_Ctx.GetBookmarks().contains(EventBookmark(EID));
 }
 
-void EventBrowser::RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag)
-{
-  if(tag.current)
-    item->setIcon(COL_NAME, Icons::flag_green());
-  else if(tag.bookmark)
-    item->setIcon(COL_NAME, Icons::asterisk_orange());
-  else if(tag.find)
-    item->setIcon(COL_NAME, Icons::find());
-  else
-    item->setIcon(COL_NAME, QIcon());
-}
-
-bool EventBrowser::FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId)
-{
-  // do a reverse search to find the last match (in case of 'set' markers that
-  // inherit the event of the next real draw).
-  for(int i = parent->childCount() - 1; i >= 0; i--)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    uint nEID = n->tag().value<EventItemTag>().lastEID;
-    uint fEID = found ? found->tag().value<EventItemTag>().lastEID : 0;
-
-    if(nEID >= eventId && (found == NULL || nEID <= fEID))
-      found = n;
-
-    if(nEID == eventId && n->childCount() == 0)
-      return true;
-
-    if(n->childCount() > 0)
-    {
-      bool exact = FindEventNode(found, n, eventId);
-      if(exact)
-        return true;
-    }
-  }
-
-  return false;
-}
-
-void EventBrowser::ExpandNode(RDTreeWidgetItem *node)
+void EventBrowser::ExpandNode(QModelIndex idx)
 {
-  RDTreeWidgetItem *n = node;
-  while(node != NULL)
+  QModelIndex n = idx;
+  while(idx.isValid())
   {
-    ui->events->expandItem(node);
-    node = node->parent();
+    ui->events->expand(idx);
+    idx = idx.parent();
   }
 
-  if(n)
-    ui->events->scrollToItem(n);
+  if(n.isValid())
+    ui->events->scrollTo(n);
 }
 
 bool EventBrowser::SelectEvent(uint32_t eventId)
@@ -1138,12 +1403,12 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   if(!m_Ctx.IsCaptureLoaded())
     return false;
 
-  RDTreeWidgetItem *found = NULL;
-  FindEventNode(found, ui->events->topLevelItem(0), eventId);
-  if(found != NULL)
+  QModelIndex found = m_Model->GetIndexForEID(eventId);
+  if(found.isValid())
   {
-    ui->events->setCurrentItem(found);
-    ui->events->setSelectedItem(found);
+    ui->events->setCurrentIndex(found);
+    ui->events->selectionModel()->select(
+        found, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
 
     ExpandNode(found);
     return true;
@@ -1152,107 +1417,134 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   return false;
 }
 
-void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
+void EventBrowser::ClearFindIcons()
 {
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
+  CancelFindIcons();
 
-    EventItemTag tag = n->tag().value<EventItemTag>();
-    tag.find = false;
-    n->setTag(QVariant::fromValue(tag));
-    RefreshIcon(n, tag);
-
-    if(n->childCount() > 0)
-      ClearFindIcons(n);
-  }
+  m_FindFilter = QString();
+  m_FindResults.clear();
+  m_Model->SetFindResults(m_FindResults);
 }
 
-void EventBrowser::ClearFindIcons()
+void EventBrowser::CancelFindIcons()
 {
-  if(m_Ctx.IsCaptureLoaded())
-    ClearFindIcons(ui->events->topLevelItem(0));
+  // bump the generation so any in-flight search aborts at the next node it checks, and any
+  // results that are already on their way back are ignored
+  m_FindGeneration.fetchAndAddOrdered(1);
 }
 
-int EventBrowser::SetFindIcons(RDTreeWidgetItem *parent, QString filter)
+// returns false if the search was superseded before it finished
+static bool FindMatches(QSet<quintptr> &results, const rdcarray<DrawcallDescription> &draws,
+                        const QString &filter, const QAtomicInt &generation, int expected)
 {
-  int results = 0;
-
-  for(int i = 0; i < parent->childCount(); i++)
+  for(const DrawcallDescription &d : draws)
   {
-    RDTreeWidgetItem *n = parent->child(i);
+    if(generation.loadAcquire() != expected)
+      return false;
 
-    if(n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-    {
-      EventItemTag tag = n->tag().value<EventItemTag>();
-      tag.find = true;
-      n->setTag(QVariant::fromValue(tag));
-      RefreshIcon(n, tag);
-      results++;
-    }
+    if(QString(d.name).contains(filter, Qt::CaseInsensitive))
+      results.insert((quintptr)&d);
 
-    if(n->childCount() > 0)
-    {
-      results += SetFindIcons(n, filter);
-    }
+    if(!d.children.empty() && !FindMatches(results, d.children, filter, generation, expected))
+      return false;
   }
 
-  return results;
+  return true;
 }
 
-int EventBrowser::SetFindIcons(QString filter)
+void EventBrowser::SetFindIcons(QString filter)
 {
-  if(filter.isEmpty())
-    return 0;
-
-  return SetFindIcons(ui->events->topLevelItem(0), filter);
-}
+  CancelFindIcons();
 
-RDTreeWidgetItem *EventBrowser::FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after)
-{
-  for(int i = 0; i < parent->childCount(); i++)
+  if(filter.isEmpty() || !m_Ctx.IsCaptureLoaded())
   {
-    RDTreeWidgetItem *n = parent->child(i);
+    ClearFindIcons();
+    return;
+  }
+
+  // if the new filter is a refinement of the one we already have results for, every match must be
+  // in the existing results so we only need to re-check those rather than the whole frame.
+  bool refine = !m_FindFilter.isEmpty() && filter.contains(m_FindFilter, Qt::CaseInsensitive);
+
+  QSet<quintptr> previous = refine ? m_FindResults : QSet<quintptr>();
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+  int generation = m_FindGeneration.loadAcquire();
+
+  // the search runs on the replay thread so that the drawcalls are guaranteed to stay alive while
+  // we walk them, but it's tagged so that if the user types faster than we can search only the
+  // latest search is queued.
+  m_Ctx.Replay().AsyncInvoke(lit("EventBrowserFind"), [this, filter, refine, previous,
+                                                        generation](IReplayController *r) {
+    if(m_FindGeneration.loadAcquire() != generation)
+      return;
 
-    if(eid > after && n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-      return n;
+    QSet<quintptr> results;
 
-    if(n->childCount() > 0)
+    if(tr("Frame Start").contains(filter, Qt::CaseInsensitive))
+      results.insert(FrameStartTag);
+
+    if(refine)
     {
-      RDTreeWidgetItem *found = FindNode(n, filter, after);
+      for(quintptr id : previous)
+      {
+        if(m_FindGeneration.loadAcquire() != generation)
+          return;
 
-      if(found != NULL)
-        return found;
+        if(id == FrameStartTag)
+          continue;
+
+        const DrawcallDescription *d = (const DrawcallDescription *)id;
+
+        if(QString(d->name).contains(filter, Qt::CaseInsensitive))
+          results.insert(id);
+      }
     }
-  }
+    else
+    {
+      if(!FindMatches(results, r->GetDrawcalls(), filter, m_FindGeneration, generation))
+        return;
+    }
+
+    GUIInvoke::call(this, [this, filter, results, generation]() {
+      // ignore results if another search has started since
+      if(m_FindGeneration.loadAcquire() != generation)
+        return;
 
-  return NULL;
+      m_FindFilter = filter;
+      m_FindResults = results;
+      m_Model->SetFindResults(m_FindResults);
+
+      if(!m_FindResults.isEmpty())
+        ui->findEvent->setPalette(palette());
+      else
+        ui->findEvent->setPalette(m_redPalette);
+    });
+  });
 }
 
-int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward)
+int EventBrowser::FindEvent(QModelIndex parent, QString filter, uint32_t after, bool forward)
 {
-  if(parent == NULL)
+  if(!parent.isValid())
     return -1;
 
-  for(int i = forward ? 0 : parent->childCount() - 1; i >= 0 && i < parent->childCount();
-      i += forward ? 1 : -1)
+  int count = m_Model->rowCount(parent);
+
+  for(int i = forward ? 0 : count - 1; i >= 0 && i < count; i += forward ? 1 : -1)
   {
-    auto n = parent->child(i);
+    QModelIndex n = m_Model->index(i, 0, parent);
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+    uint32_t eid = m_Model->GetLastEID(n);
 
     bool matchesAfter = (forward && eid > after) || (!forward && eid < after);
 
     if(matchesAfter)
     {
-      QString name = n->text(COL_NAME);
+      QString name = m_Model->GetName(n);
       if(name.contains(filter, Qt::CaseInsensitive))
         return (int)eid;
     }
 
-    if(n->childCount() > 0)
+    if(m_Model->rowCount(n) > 0)
     {
       int found = FindEvent(n, filter, after, forward);
 
@@ -1269,7 +1561,7 @@ int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
   if(!m_Ctx.IsCaptureLoaded())
     return 0;
 
-  return FindEvent(ui->events->topLevelItem(0), filter, after, forward);
+  return FindEvent(m_Model->index(0, 0), filter, after, forward);
 }
 
 void EventBrowser::Find(bool forward)
@@ -1279,9 +1571,9 @@ void EventBrowser::Find(bool forward)
 
   uint32_t curEID = m_Ctx.CurSelectedEvent();
 
-  RDTreeWidgetItem *node = ui->events->selectedItem();
-  if(node)
-    curEID = node->tag().value<EventItemTag>().lastEID;
+  QModelIndex node = ui->events->currentIndex();
+  if(node.isValid())
+    curEID = m_Model->GetLastEID(node);
 
   int eid = FindEvent(ui->findEvent->text(), curEID, forward);
   if(eid >= 0)
@@ -1311,8 +1603,6 @@ void EventBrowser::UpdateDurationColumn()
 
   m_TimeUnit = m_Ctx.Config().EventBrowser_TimeUnit;
 
-  ui->events->setHeaderText(COL_DURATION, tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit)));
-
-  if(!m_Times.empty())
-    SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+  m_Model->SetHeaderText(COL_DURATION, tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit)));
+  m_Model->SetTimeUnit(m_TimeUnit);
 }
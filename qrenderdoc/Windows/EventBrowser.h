@@ -24,8 +24,11 @@
 
 #pragma once
 
+#include <QAtomicInt>
 #include <QFrame>
 #include <QIcon>
+#include <QModelIndex>
+#include <QSet>
 #include "Code/Interface/QRDInterface.h"
 
 namespace Ui
@@ -35,11 +38,10 @@ class EventBrowser;
 
 class QSpacerItem;
 class QToolButton;
-class RDTreeWidgetItem;
 class QTimer;
 class QTextStream;
 class FlowLayout;
-struct EventItemTag;
+class EventItemModel;
 
 class EventBrowser : public QFrame, public IEventBrowser, public ICaptureViewer
 {
@@ -75,7 +77,6 @@ private slots:
   void on_findEvent_returnPressed();
   void on_findEvent_keyPress(QKeyEvent *event);
   void on_findEvent_textEdited(const QString &arg1);
-  void on_events_currentItemChanged(RDTreeWidgetItem *current, RDTreeWidgetItem *previous);
   void on_findNext_clicked();
   void on_findPrev_clicked();
   void on_stepNext_clicked();
@@ -85,6 +86,7 @@ private slots:
 
   // manual slots
   void findHighlight_timeout();
+  void events_currentChanged(const QModelIndex &current, const QModelIndex &previous);
   void events_keyPress(QKeyEvent *event);
   void events_contextMenu(const QPoint &pos);
 
@@ -95,27 +97,18 @@ public slots:
   void jumpToBookmark(int idx);
 
 private:
-  QPair<uint32_t, uint32_t> AddDrawcalls(RDTreeWidgetItem *parent,
-                                         const rdcarray<DrawcallDescription> &draws);
-  void SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results);
+  void ExpandNode(QModelIndex idx);
 
-  void ExpandNode(RDTreeWidgetItem *node);
-
-  bool FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId);
   bool SelectEvent(uint32_t eventId);
 
-  void ClearFindIcons(RDTreeWidgetItem *parent);
   void ClearFindIcons();
-
-  int SetFindIcons(RDTreeWidgetItem *parent, QString filter);
-  int SetFindIcons(QString filter);
+  void CancelFindIcons();
+  void SetFindIcons(QString filter);
 
   void repopulateBookmarks();
   void highlightBookmarks();
-  bool hasBookmark(RDTreeWidgetItem *node);
 
-  RDTreeWidgetItem *FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after);
-  int FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward);
+  int FindEvent(QModelIndex parent, QString filter, uint32_t after, bool forward);
   int FindEvent(QString filter, uint32_t after, bool forward);
   void Find(bool forward);
 
@@ -134,11 +127,18 @@ private:
 
   QTimer *m_FindHighlight;
 
+  // the generation of the background search for find highlights. It's incremented whenever a
+  // search is superseded, so that the in-flight search can abort early.
+  QAtomicInt m_FindGeneration;
+  // the filter that the current find highlights are for, and the matching nodes
+  QString m_FindFilter;
+  QSet<quintptr> m_FindResults;
+
   FlowLayout *m_BookmarkStripLayout;
   QSpacerItem *m_BookmarkSpacer;
   QMap<uint32_t, QToolButton *> m_BookmarkButtons;
 
-  void RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag);
+  EventItemModel *m_Model;
 
   Ui::EventBrowser *ui;
   ICaptureContext &m_Ctx;
@@ -1579,6 +1579,19 @@ void MainWindow::messageCheck()
     {
       statusProgress->setVisible(true);
       statusProgress->setMaximum(0);
+
+      ReplayQueueStats stats = m_Ctx.Replay().GetQueueStats();
+
+      QString current = stats.currentTag;
+      if(current.isEmpty())
+        current = tr("untagged request");
+
+      statusProgress->setToolTip(
+          tr("Processing %1, %2 request(s) waiting.\nLongest wait %3s, average wait %4s.")
+              .arg(current)
+              .arg(stats.pending)
+              .arg(Formatter::Format(stats.maxWait))
+              .arg(Formatter::Format(stats.averageWait)));
     }
     else
     {
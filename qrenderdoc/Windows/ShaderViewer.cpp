@@ -284,6 +284,7 @@ void ShaderViewer::debugShader(const ShaderBindpointMapping *bind, const ShaderR
   m_ShaderDetails = shader;
   m_Pipeline = pipeline;
   m_Trace = trace;
+  m_CurrentStateStep = -1;
   m_Stage = ShaderStage::Vertex;
   m_DebugContext = debugContext;
 
@@ -1666,7 +1667,7 @@ void ShaderViewer::updateDebugging()
       ui->debugToggle->setText(tr("Debug in HLSL"));
   }
 
-  const ShaderDebugState &state = m_Trace->states[m_CurrentStep];
+  const ShaderDebugState &state = GetCurrentState();
 
   uint32_t nextInst = state.nextInstruction;
   bool done = false;
@@ -2358,9 +2359,40 @@ void ShaderViewer::updateDebugging()
   updateVariableTooltip();
 }
 
+const ShaderDebugState &ShaderViewer::GetCurrentState()
+{
+  // traces only store full states periodically, so reconstruct the current one once per step
+  if(m_CurrentStateStep == m_CurrentStep)
+    return m_CurrentState;
+
+  int interval = qMax(1, (int)m_Trace->keyframeInterval);
+
+  if(m_CurrentStateStep >= 0 && m_CurrentStep == m_CurrentStateStep + 1 &&
+     (m_CurrentStep % interval) != 0)
+  {
+    // stepping forward by one, apply this step's changes on top of the previous state
+    const ShaderDebugState &cur = m_Trace->states[m_CurrentStep];
+
+    m_CurrentState.ApplyChanges(cur.changes);
+    m_CurrentState.changes = cur.changes;
+    m_CurrentState.locals = cur.locals;
+    m_CurrentState.modified = cur.modified;
+    m_CurrentState.nextInstruction = cur.nextInstruction;
+    m_CurrentState.flags = cur.flags;
+  }
+  else
+  {
+    m_CurrentState = m_Trace->GetState(m_CurrentStep);
+  }
+
+  m_CurrentStateStep = m_CurrentStep;
+
+  return m_CurrentState;
+}
+
 const ShaderVariable *ShaderViewer::GetRegisterVariable(const RegisterRange &r)
 {
-  const ShaderDebugState &state = m_Trace->states[m_CurrentStep];
+  const ShaderDebugState &state = GetCurrentState();
 
   const ShaderVariable *var = NULL;
   switch(r.type)
@@ -2963,7 +2995,7 @@ const rdcarray<ShaderVariable> *ShaderViewer::GetVariableList(VariableCategory v
   if(!m_Trace || m_CurrentStep < 0 || m_CurrentStep >= m_Trace->states.count())
     return vars;
 
-  const ShaderDebugState &state = m_Trace->states[m_CurrentStep];
+  const ShaderDebugState &state = GetCurrentState();
 
   arrayIdx = qMax(0, arrayIdx);
 
@@ -3022,7 +3054,7 @@ void ShaderViewer::updateVariableTooltip()
   if(!m_Trace || m_CurrentStep < 0 || m_CurrentStep >= m_Trace->states.count())
     return;
 
-  const ShaderDebugState &state = m_Trace->states[m_CurrentStep];
+  const ShaderDebugState &state = GetCurrentState();
 
   if(m_TooltipVarCat == VariableCategory::ByString)
   {
@@ -222,6 +222,8 @@ private:
 
   ShaderDebugTrace *m_Trace = NULL;
   int m_CurrentStep;
+  ShaderDebugState m_CurrentState;
+  int m_CurrentStateStep = -1;
   QList<int> m_Breakpoints;
 
   static const int CURRENT_MARKER = 0;
@@ -251,6 +253,7 @@ private:
 
   void updateDebugging();
 
+  const ShaderDebugState &GetCurrentState();
   const ShaderVariable *GetRegisterVariable(const RegisterRange &r);
 
   void ensureLineScrolled(ScintillaEdit *s, int i);
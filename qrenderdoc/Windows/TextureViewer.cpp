@@ -1349,7 +1349,10 @@ void TextureViewer::UI_OnTextureSelectionChanged(bool newdraw)
   if(ui->autoFit->isChecked())
     AutoFitRange();
 
-  m_Ctx.Replay().AsyncInvoke([this](IReplayController *r) {
+  // only the latest selection needs to be displayed. There's only one texture viewer, so the
+  // request is keyed on its type alone.
+  m_Ctx.Replay().AsyncInvoke(lit("TextureDisplay"), ReplayPriority::Normal, false,
+                             [this](IReplayController *r) {
     RT_UpdateVisualRange(r);
 
     RT_UpdateAndDisplay(r);
@@ -1967,17 +1970,25 @@ void TextureViewer::InitResourcePreview(ResourcePreview *prev, ResourceId id, Co
 
     WId handle = prev->thumbWinId();
 
+    // only the latest resource for each thumbnail needs to be set, so that moving quickly through
+    // events doesn't queue up every intermediate thumbnail.
+    rdcstr tag = QFormatStr("TextureThumb%1").arg((uintptr_t)handle);
+
     if(m_Ctx.GetTexture(id))
     {
-      m_Ctx.Replay().AsyncInvoke([this, handle, id, typeHint](IReplayController *) {
-        m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle), id, typeHint);
-      });
+      m_Ctx.Replay().AsyncInvoke(tag, ReplayPriority::Normal, false,
+                                 [this, handle, id, typeHint](IReplayController *) {
+                                   m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle), id,
+                                                          typeHint);
+                                 });
     }
     else
     {
-      m_Ctx.Replay().AsyncInvoke([this, handle](IReplayController *) {
-        m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle), ResourceId(), CompType::Typeless);
-      });
+      m_Ctx.Replay().AsyncInvoke(tag, ReplayPriority::Normal, false,
+                                 [this, handle](IReplayController *) {
+                                   m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle),
+                                                          ResourceId(), CompType::Typeless);
+                                 });
     }
 
     prev->setProperty("f", QVariant::fromValue(follow));
@@ -1992,9 +2003,11 @@ void TextureViewer::InitResourcePreview(ResourcePreview *prev, ResourceId id, Co
     prev->setSelected(true);
 
     WId handle = prev->thumbWinId();
-    m_Ctx.Replay().AsyncInvoke([this, handle](IReplayController *) {
-      m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle), ResourceId(), CompType::Typeless);
-    });
+    m_Ctx.Replay().AsyncInvoke(QFormatStr("TextureThumb%1").arg((uintptr_t)handle),
+                               ReplayPriority::Normal, false, [this, handle](IReplayController *) {
+                                 m_Output->AddThumbnail(m_Ctx.CreateWindowingData(handle),
+                                                        ResourceId(), CompType::Typeless);
+                               });
   }
   else
   {
@@ -2208,12 +2221,12 @@ void TextureViewer::render_mouseMove(QMouseEvent *e)
         m_PickedPoint.setX(qBound(0, m_PickedPoint.x(), (int)texptr->width - 1));
         m_PickedPoint.setY(qBound(0, m_PickedPoint.y(), (int)texptr->height - 1));
 
-        m_Ctx.Replay().AsyncInvoke(lit("PickPixelClick"),
+        m_Ctx.Replay().AsyncInvoke(lit("PickPixelClick"), ReplayPriority::Interactive, false,
                                    [this](IReplayController *r) { RT_PickPixelsAndUpdate(r); });
       }
       else if(e->buttons() == Qt::NoButton)
       {
-        m_Ctx.Replay().AsyncInvoke(lit("PickPixelHover"),
+        m_Ctx.Replay().AsyncInvoke(lit("PickPixelHover"), ReplayPriority::Interactive, false,
                                    [this](IReplayController *r) { RT_PickHoverAndUpdate(r); });
       }
     }
@@ -3134,7 +3147,9 @@ void TextureViewer::AutoFitRange()
   if(!m_Ctx.IsCaptureLoaded() || GetCurrentTexture() == NULL || m_Output == NULL)
     return;
 
-  m_Ctx.Replay().AsyncInvoke([this](IReplayController *r) {
+  // the range is only relevant to this event, and any event change re-fits it
+  m_Ctx.Replay().AsyncInvoke(lit("TextureAutoFit"), ReplayPriority::Normal, true,
+                             [this](IReplayController *r) {
     PixelValue min, max;
     std::tie(min, max) = m_Output->GetMinMax();
 
@@ -195,6 +195,40 @@ typedef enum RENDERDOC_CaptureOption {
   // 0 - API debugging is displayed as normal
   eRENDERDOC_Option_DebugOutputMute = 11,
 
+  // Defer command buffer serialisation until a capture has been triggered, to reduce overheads
+  // while the application runs uncaptured.
+  //
+  // When enabled, command buffers recorded while no capture is pending are only tracked, not
+  // serialised. Triggering a capture arms recording and the capture begins on the first frame
+  // where every submitted command buffer was fully recorded, so captures are delayed by at least
+  // one frame. Command buffers that are recorded once and re-submitted every frame will never be
+  // fully recorded and prevent a capture from starting.
+  //
+  // Captures begun with StartFrameCapture can't be delayed, so they disable this option for the
+  // rest of the run. If that first capture submits command buffers recorded before it began,
+  // EndFrameCapture discards it and returns 0.
+  //
+  // Currently only supported by Vulkan, other APIs ignore this option.
+  //
+  // Default - disabled
+  //
+  // 1 - Command buffers are only serialised once a capture has been triggered
+  // 0 - Command buffers are always serialised so captures can begin immediately
+  eRENDERDOC_Option_LowOverheadIdle = 12,
+
+  // Keep the initial contents of resources in memory after a capture, so that later captures can
+  // re-use them for resources that haven't changed instead of reading them back again. Each
+  // capture still contains all of its initial contents.
+  //
+  // This holds a copy of the initial contents in memory between captures, which can be large.
+  // Currently only supported by Vulkan, other APIs ignore this option.
+  //
+  // Default - disabled
+  //
+  // 1 - Initial contents are kept between captures and re-used where possible
+  // 0 - Initial contents are read back for every capture and freed afterwards
+  eRENDERDOC_Option_RetainInitialContents = 13,
+
 } RENDERDOC_CaptureOption;
 
 // Sets an option that controls how RenderDoc behaves on capture.
@@ -463,6 +497,20 @@ typedef void(RENDERDOC_CC *pRENDERDOC_TriggerCapture)();
 // capture the next N frames on whichever window and API is currently considered active
 typedef void(RENDERDOC_CC *pRENDERDOC_TriggerMultiFrameCapture)(uint32_t numFrames);
 
+// automatically capture the frame after one that takes unusually long, to catch hitches.
+//
+// thresholdMs - any frame taking longer than this many milliseconds is a hitch. 0 to disable.
+// medianMultiplier - any frame taking longer than this multiple of the median time of recent
+//                    frames is a hitch. 0 to disable.
+// cooldownFrames - how many frames to wait after triggering a capture before triggering another.
+// maxCaptures - how many captures to trigger before disarming, or 0 for no limit.
+//
+// Passing 0 for both thresholdMs and medianMultiplier disables the trigger.
+typedef void(RENDERDOC_CC *pRENDERDOC_SetFrameTimeCaptureTrigger)(float thresholdMs,
+                                                                  float medianMultiplier,
+                                                                  uint32_t cooldownFrames,
+                                                                  uint32_t maxCaptures);
+
 // When choosing either a device pointer or a window handle to capture, you can pass NULL.
 // Passing NULL specifies a 'wildcard' match against anything. This allows you to specify
 // any API rendering to a specific window, or a specific API instance rendering to any window,
@@ -516,6 +564,7 @@ typedef enum RENDERDOC_Version {
   eRENDERDOC_API_Version_1_1_1 = 10101,    // RENDERDOC_API_1_1_1 = 1 01 01
   eRENDERDOC_API_Version_1_1_2 = 10102,    // RENDERDOC_API_1_1_2 = 1 01 02
   eRENDERDOC_API_Version_1_2_0 = 10200,    // RENDERDOC_API_1_2_0 = 1 02 00
+  eRENDERDOC_API_Version_1_3_0 = 10300,    // RENDERDOC_API_1_3_0 = 1 03 00
 } RENDERDOC_Version;
 
 // API version changelog:
@@ -533,8 +582,12 @@ typedef enum RENDERDOC_Version {
 //         branch.
 // 1.2.0 - Added feature: SetCaptureFileComments() to add comments to a capture file that will be
 //         displayed in the UI program on load.
+// 1.3.0 - Added feature: SetFrameTimeCaptureTrigger() to automatically capture after frames that
+//         take unusually long. Added option: eRENDERDOC_Option_LowOverheadIdle to defer command
+//         buffer serialisation until a capture is triggered. Added option:
+//         eRENDERDOC_Option_RetainInitialContents to re-use initial contents between captures.
 
-typedef struct RENDERDOC_API_1_2_0
+typedef struct RENDERDOC_API_1_3_0
 {
   pRENDERDOC_GetAPIVersion GetAPIVersion;
 
@@ -597,14 +650,18 @@ typedef struct RENDERDOC_API_1_2_0
 
   // new function in 1.2.0
   pRENDERDOC_SetCaptureFileComments SetCaptureFileComments;
-} RENDERDOC_API_1_2_0;
-
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_0_0;
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_0_1;
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_0_2;
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_1_0;
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_1_1;
-typedef RENDERDOC_API_1_2_0 RENDERDOC_API_1_1_2;
+
+  // new function in 1.3.0
+  pRENDERDOC_SetFrameTimeCaptureTrigger SetFrameTimeCaptureTrigger;
+} RENDERDOC_API_1_3_0;
+
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_0_0;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_0_1;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_0_2;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_1_0;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_1_1;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_1_2;
+typedef RENDERDOC_API_1_3_0 RENDERDOC_API_1_2_0;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // RenderDoc API entry point
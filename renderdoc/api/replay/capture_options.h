@@ -193,6 +193,42 @@ Default - enabled
 ``False`` - API debugging is displayed as normal.
 )");
   bool debugOutputMute;
+
+  DOCUMENT(R"(Defer command buffer serialisation until a capture has been triggered, to reduce
+overheads while the application runs uncaptured.
+
+Command buffers recorded while no capture is pending are only tracked, not serialised. Triggering a
+capture arms recording and the capture begins on the first frame where every submitted command
+buffer was fully recorded, so captures are delayed by at least one frame.
+
+.. note:: Command buffers that are recorded once and re-submitted every frame will never be fully
+  recorded, and will prevent a capture from starting. Captures started by the application through
+  the in-application API disable this option for the rest of the run, and fail if they submit
+  command buffers recorded before they began. Currently only Vulkan supports this option.
+
+Default - disabled
+
+``True`` - Command buffers are only serialised once a capture has been triggered.
+
+``False`` - Command buffers are always serialised so captures can begin immediately.
+)");
+  bool lowOverheadIdle;
+
+  DOCUMENT(R"(Keep the initial contents of resources in memory after a capture, so that later
+captures can re-use them for resources that haven't changed instead of reading them back again.
+
+Each capture still contains all of its initial contents, only the readback is skipped.
+
+.. note:: This holds a copy of the initial contents in memory between captures, which can be large.
+  Currently only Vulkan supports this option, for images and device memory that isn't mapped.
+
+Default - disabled
+
+``True`` - Initial contents are kept between captures and re-used where possible.
+
+``False`` - Initial contents are read back for every capture and freed afterwards.
+)");
+  bool retainInitialContents;
 };
 
 DECLARE_REFLECTION_STRUCT(CaptureOptions);
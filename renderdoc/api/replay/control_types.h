@@ -471,6 +471,52 @@ struct NewChildData
 
 DECLARE_REFLECTION_STRUCT(NewChildData);
 
+DOCUMENT(R"(Settings for automatically triggering a capture when a frame takes unusually long, to
+catch intermittent hitches that are hard to capture by hand.
+
+A frame is considered a hitch if it takes longer than :data:`thresholdMs`, or longer than
+:data:`medianMultiplier` times the median time of recent frames. The capture is taken on the frame
+after the hitch.
+)");
+struct FrameTimeTrigger
+{
+  DOCUMENT(R"(Any frame taking longer than this many milliseconds triggers a capture. If set to
+``0`` the absolute threshold is not used.
+)");
+  float thresholdMs = 0.0f;
+  DOCUMENT(R"(Any frame taking longer than this multiple of the rolling median frame time triggers a
+capture. If set to ``0`` the median is not used.
+)");
+  float medianMultiplier = 0.0f;
+  DOCUMENT("How many frames to wait after a triggered capture before another can be triggered.");
+  uint32_t cooldownFrames = 60;
+  DOCUMENT(R"(The maximum number of captures to trigger before disarming. If set to ``0`` there is
+no limit.
+)");
+  uint32_t maxCaptures = 1;
+};
+
+DECLARE_REFLECTION_STRUCT(FrameTimeTrigger);
+
+DOCUMENT("Statistics from the target about its :class:`FrameTimeTrigger`.");
+struct FrameTimeTriggerStats
+{
+  DOCUMENT("How many frames have been checked since the trigger was configured.");
+  uint32_t framesObserved = 0;
+  DOCUMENT("How many captures have been triggered since the trigger was configured.");
+  uint32_t capturesTriggered = 0;
+  DOCUMENT("The current median frame time in milliseconds.");
+  float medianFrameTime = 0.0f;
+  DOCUMENT("The time in milliseconds of the frame that most recently triggered a capture.");
+  float lastTriggerFrameTime = 0.0f;
+  DOCUMENT("The median frame time in milliseconds when a capture was most recently triggered.");
+  float lastTriggerMedian = 0.0f;
+  DOCUMENT("``True`` if the trigger is enabled and has not reached its capture limit.");
+  bool armed = false;
+};
+
+DECLARE_REFLECTION_STRUCT(FrameTimeTriggerStats);
+
 DOCUMENT("A message from a target control connection.");
 struct TargetControlMessage
 {
@@ -491,6 +537,8 @@ When valid, will be in the range of 0.0 to 1.0 (0 - 100%). If not valid when a c
 or has finished, it will be -1.0
 )");
   float capProgress = -1.0f;
+  DOCUMENT("The :class:`frame time trigger statistics <FrameTimeTriggerStats>`.");
+  FrameTimeTriggerStats frameTimeTrigger;
 };
 
 DECLARE_REFLECTION_STRUCT(TargetControlMessage);
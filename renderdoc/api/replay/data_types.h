@@ -1231,6 +1231,127 @@ struct CounterResult
 
 DECLARE_REFLECTION_STRUCT(CounterResult);
 
+DOCUMENT(R"(Statistics for a counter at an event, gathered over several replays of the capture.
+
+Values are converted to ``float`` regardless of the counter's result type. Durations are in seconds.
+)");
+struct CounterStatistics
+{
+  DOCUMENT("");
+  CounterStatistics() = default;
+
+  DOCUMENT("Compares two ``CounterStatistics`` objects for less-than.");
+  bool operator<(const CounterStatistics &o) const
+  {
+    if(!(eventId == o.eventId))
+      return eventId < o.eventId;
+    if(!(counter == o.counter))
+      return counter < o.counter;
+
+    // don't compare values, just consider equal
+    return false;
+  }
+
+  DOCUMENT("Compares two ``CounterStatistics`` objects for equality.");
+  bool operator==(const CounterStatistics &o) const
+  {
+    // don't compare values, just consider equal by eventId/counterID
+    return eventId == o.eventId && counter == o.counter;
+  }
+
+  DOCUMENT("The :data:`eventId <APIEvent.eventId>` that produced these values.");
+  uint32_t eventId = 0;
+
+  DOCUMENT("The :data:`counter <GPUCounter>` that produced these values.");
+  GPUCounter counter = GPUCounter::EventGPUDuration;
+
+  DOCUMENT("The number of measured runs that produced a valid value.");
+  uint32_t runs = 0;
+
+  DOCUMENT("The smallest value measured.");
+  double minimum = 0.0;
+
+  DOCUMENT("The median of the values measured.");
+  double median = 0.0;
+
+  DOCUMENT("The mean of the values measured.");
+  double mean = 0.0;
+
+  DOCUMENT("The sample standard deviation of the values measured, or 0 if only one was measured.");
+  double stddev = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(CounterStatistics);
+
+DOCUMENT(R"(The CPU time spent replaying either one type of chunk, or one event, as recorded by the
+replay profiler.
+)");
+struct ReplayProfileEntry
+{
+  DOCUMENT("");
+  ReplayProfileEntry() = default;
+
+  DOCUMENT("Compares two ``ReplayProfileEntry`` objects for less-than.");
+  bool operator<(const ReplayProfileEntry &o) const
+  {
+    if(!(eventId == o.eventId))
+      return eventId < o.eventId;
+    return name < o.name;
+  }
+
+  DOCUMENT("Compares two ``ReplayProfileEntry`` objects for equality.");
+  bool operator==(const ReplayProfileEntry &o) const
+  {
+    return eventId == o.eventId && name == o.name;
+  }
+
+  DOCUMENT("The name of the chunk type, or empty if this entry is for an event.");
+  rdcstr name;
+
+  DOCUMENT(R"(The :data:`eventId <APIEvent.eventId>` this entry is for, or 0 if this entry is for a
+chunk type.
+)");
+  uint32_t eventId = 0;
+
+  DOCUMENT("The number of chunks that were replayed.");
+  uint32_t count = 0;
+
+  DOCUMENT("The total CPU time in seconds spent replaying the chunks.");
+  double totalTime = 0.0;
+
+  DOCUMENT("The longest CPU time in seconds spent replaying any single chunk.");
+  double maxTime = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayProfileEntry);
+
+DOCUMENT(R"(A summary of the CPU time spent replaying the capture, as recorded by the replay profiler
+since it was enabled.
+)");
+struct ReplayProfile
+{
+  DOCUMENT("");
+  ReplayProfile() = default;
+
+  DOCUMENT(R"(The time spent on each type of chunk, sorted with the most expensive first.
+
+:type: ``list`` of :class:`ReplayProfileEntry`
+)");
+  rdcarray<ReplayProfileEntry> chunks;
+
+  DOCUMENT(R"(The time spent on each event, sorted by :data:`eventId <APIEvent.eventId>`. Applying
+the initial contents of resources before a replay is listed as event 0.
+
+:type: ``list`` of :class:`ReplayProfileEntry`
+)");
+  rdcarray<ReplayProfileEntry> events;
+
+  DOCUMENT("The total CPU time in seconds spent on all recorded chunks.");
+  double totalTime = 0.0;
+};
+
+DECLARE_REFLECTION_STRUCT(ReplayProfile);
+
 DOCUMENT("The contents of an RGBA pixel.");
 union PixelValue
 {
@@ -29,6 +29,66 @@
 #include "gl_pipestate.h"
 #include "vk_pipestate.h"
 
+DOCUMENT(R"(The pipeline state at one event, as returned by
+:meth:`ReplayController.GetPipelineStateSnapshots`.
+
+Snapshots are cheap to copy and hold on to. The states they point to are owned by the controller
+and are shared between consecutive events whose state is identical, rather than being duplicated.
+They stay valid until the next call to :meth:`ReplayController.GetPipelineStateSnapshots` or until
+the controller is shut down.
+
+Only the state for the capture's API is set, the others are ``None``.
+)");
+struct PipelineStateSnapshot
+{
+  DOCUMENT("");
+  PipelineStateSnapshot() = default;
+  PipelineStateSnapshot(const PipelineStateSnapshot &) = default;
+
+  DOCUMENT("Compares two ``PipelineStateSnapshot`` objects for less-than.");
+  bool operator<(const PipelineStateSnapshot &o) const { return eventId < o.eventId; }
+  DOCUMENT("Compares two ``PipelineStateSnapshot`` objects for equality.");
+  bool operator==(const PipelineStateSnapshot &o) const
+  {
+    return eventId == o.eventId && d3d11 == o.d3d11 && d3d12 == o.d3d12 && gl == o.gl &&
+           vulkan == o.vulkan;
+  }
+
+  DOCUMENT("The :data:`eventId <APIEvent.eventId>` this snapshot was taken at.");
+  uint32_t eventId = 0;
+
+  DOCUMENT(R"(``True`` if the state differs from the previous snapshot in the list. When it doesn't,
+both snapshots point to the same state.
+
+The first snapshot in a list is always considered changed.
+)");
+  bool changed = true;
+
+  DOCUMENT(R"(The D3D11 pipeline state.
+
+:type: D3D11State
+)");
+  const D3D11Pipe::State *d3d11 = NULL;
+
+  DOCUMENT(R"(The D3D12 pipeline state.
+
+:type: D3D12State
+)");
+  const D3D12Pipe::State *d3d12 = NULL;
+
+  DOCUMENT(R"(The OpenGL pipeline state.
+
+:type: GLState
+)");
+  const GLPipe::State *gl = NULL;
+
+  DOCUMENT(R"(The Vulkan pipeline state.
+
+:type: VKState
+)");
+  const VKPipe::State *vulkan = NULL;
+};
+
 DOCUMENT(R"(An API-agnostic view of the common aspects of the pipeline state. This allows simple
 access to e.g. find out the bound resources or vertex buffers, or certain pipeline state which is
 available on all APIs.
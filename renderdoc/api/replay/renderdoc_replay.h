@@ -828,6 +828,21 @@ capture's API.
 )");
   virtual const PipeState &GetPipelineState() = 0;
 
+  DOCUMENT(R"(Retrieve the pipeline state at each of a list of events in one call.
+
+This is cheaper than calling :meth:`SetFrameEvent` and copying the state for each event: no output
+is updated between events, and events whose state is identical to the previous one share a single
+copy of it. See :class:`PipelineStateSnapshot` for how long the returned states stay valid.
+
+Afterwards the current event is restored, as if by ``SetFrameEvent(current, True)``.
+
+:param List[int] eventIds: The events to fetch the state at, typically in ascending order.
+:return: The pipeline state at each event, in the same order as ``eventIds``.
+:rtype: ``list`` of :class:`PipelineStateSnapshot`
+)");
+  virtual rdcarray<PipelineStateSnapshot> GetPipelineStateSnapshots(
+      const rdcarray<uint32_t> &eventIds) = 0;
+
   DOCUMENT(R"(Retrieve the list of possible disassembly targets for :meth:`DisassembleShader`. The
 values are implementation dependent but will always include a default target first which is the
 native disassembly of the shader. Further options may be available for additional diassembly views
@@ -954,6 +969,48 @@ textures are bound as outputs.
 )");
   virtual rdcarray<CounterResult> FetchCounters(const rdcarray<GPUCounter> &counters) = 0;
 
+  DOCUMENT(R"(Retrieve statistics for a specified set of counters, over several replays.
+
+Since the timing of individual events can vary significantly between replays, this replays the
+capture ``warmupRuns`` times with results discarded, then ``measuredRuns`` times gathering the
+counters each time. The results of the measured runs are then combined for each event.
+
+:param list counters: The list of :class:`GPUCounter` to fetch results for.
+:param int warmupRuns: The number of runs to discard before measuring.
+:param int measuredRuns: The number of runs to measure. Must be at least 1.
+:return: The list of counter statistics generated.
+:rtype: ``list`` of :class:`CounterStatistics`
+)");
+  virtual rdcarray<CounterStatistics> FetchCounterStatistics(const rdcarray<GPUCounter> &counters,
+                                                             uint32_t warmupRuns,
+                                                             uint32_t measuredRuns) = 0;
+
+  DOCUMENT(R"(Enable or disable the replay profiler, which records the CPU time spent on each chunk
+whenever the capture is replayed. Enabling it discards anything that was previously recorded.
+
+This is intended for diagnosing slow replays, and adds a small overhead to replaying. It records
+only local replays, not replays on a remote server.
+
+:param bool enabled: ``True`` to enable the profiler, ``False`` to disable it.
+)");
+  virtual void SetReplayProfiling(bool enabled) = 0;
+
+  DOCUMENT(R"(Retrieve a summary of what the replay profiler has recorded.
+
+:return: The CPU time spent on each chunk type and each event.
+:rtype: ReplayProfile
+)");
+  virtual ReplayProfile GetReplayProfile() = 0;
+
+  DOCUMENT(R"(Export everything the replay profiler has recorded to a JSON file that can be loaded
+by chrome's profiler at chrome://tracing, in the same format as the ``chrome.json`` capture export.
+
+:param str path: The path to save on the local disk.
+:return: The status of the export operation, whether it succeeded or failed (and how it failed).
+:rtype: ReplayStatus
+)");
+  virtual ReplayStatus ExportReplayProfile(const char *path) = 0;
+
   DOCUMENT(R"(Retrieve a list of which counters are available in the current capture analysis
 implementation.
 
@@ -1122,6 +1179,20 @@ texture to something compatible with the target file format.
 )");
   virtual bool SaveTexture(const TextureSave &saveData, const char *path) = 0;
 
+  DOCUMENT(R"(Save a list of textures to files on disk, as with :meth:`SaveTexture`.
+
+This is more efficient than saving each texture individually, as the conversion and encoding of
+each texture to its file format is overlapped with reading back the next texture's contents.
+
+:param list saveData: The list of :class:`TextureSave` configurations, one for each texture.
+:param list paths: The list of ``str`` paths to save to, one for each texture in
+  :paramref:`SaveTextures.saveData`.
+:return: ``True`` if every texture was saved successfully, ``False`` if any failed.
+:rtype: ``bool``
+)");
+  virtual bool SaveTextures(const rdcarray<TextureSave> &saveData,
+                            const rdcarray<rdcstr> &paths) = 0;
+
   DOCUMENT(R"(Retrieve the generated data from one of the geometry processing shader stages.
 
 :param int instance: The index of the instance to retrieve data for, or 0 for non-instanced draws.
@@ -1243,6 +1314,16 @@ target control connection.
 )");
   virtual void DeleteCapture(uint32_t captureId) = 0;
 
+  DOCUMENT(R"(Configure the target to automatically capture the frame after one that takes
+unusually long. Statistics are reported back with
+:attr:`TargetControlMessageType.FrameTimeTriggerStats` messages.
+
+Setting both thresholds to ``0`` disables the trigger. Reconfiguring resets the statistics.
+
+:param FrameTimeTrigger trigger: The settings for the trigger.
+)");
+  virtual void SetFrameTimeTrigger(const FrameTimeTrigger &trigger) = 0;
+
   DOCUMENT(R"(Query to see if a message has been received from the remote system.
 
 The details of the types of messages that can be received are listed under
@@ -1592,6 +1673,21 @@ representation back to native RDC.
   virtual ReplayStatus Convert(const char *filename, const char *filetype, const SDFile *file,
                                RENDERDOC_ProgressCallback progress) = 0;
 
+  DOCUMENT(R"(Sets a trained compression dictionary to use when :meth:`Convert` writes an ``rdc``.
+
+Any zstd compressed sections of the given type in the converted file will be compressed with the
+dictionary. This mostly helps when archiving many captures of the same program, which share a lot
+of common data. See :func:`TrainCompressionDictionary`.
+
+:param SectionType section: The type of section to use the dictionary for.
+:param bytes dictionary: The dictionary to use, or an empty buffer to remove any set dictionary.
+:param bool embed: ``True`` if the dictionary should be embedded in the converted capture. If
+  ``False`` only its ID is stored, and the dictionary must be available as described in
+  :func:`GetCompressionDictionaryFilename` to read the capture.
+)");
+  virtual void SetCompressionDictionary(SectionType section, const bytebuf &dictionary,
+                                        bool embed) = 0;
+
   DOCUMENT(R"(Returns the human-readable error string for the last error received.
 
 The error string is not reset by calling this function so it's safe to call multiple times. However
@@ -1868,6 +1964,33 @@ can only be shut-down, it is not re-usable.
 )");
 extern "C" RENDERDOC_API ICaptureFile *RENDERDOC_CC RENDERDOC_OpenCaptureFile();
 
+DOCUMENT(R"(Trains a zstd compression dictionary from a section of a set of captures.
+
+The section data is streamed from each capture, so the captures don't need to fit in memory. The
+dictionary can then be used with :meth:`CaptureFile.SetCompressionDictionary`.
+
+:param List[str] captures: The filenames of the captures to train on.
+:param SectionType section: The type of section to train on.
+:param int maxSize: The maximum size of the dictionary in bytes.
+:param bytes dictionary: The trained dictionary.
+:return: The status of the training, whether it succeeded or failed (and how it failed).
+:rtype: ReplayStatus
+)");
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_TrainCompressionDictionary(const rdcarray<rdcstr> &captures, SectionType section,
+                                     uint32_t maxSize, bytebuf &dictionary);
+
+DOCUMENT(R"(Returns the filename a compression dictionary is found by when it's referenced.
+
+Captures that reference a dictionary instead of embedding it look for this filename in each of the
+directories in the ``capture.compressionDictionaryPaths`` config setting, separated by ``;``.
+
+:param bytes dictionary: The dictionary.
+:param str name: The filename of the dictionary, in the form ``<ID>.rdcdict``.
+)");
+extern "C" RENDERDOC_API void RENDERDOC_CC
+RENDERDOC_GetCompressionDictionaryFilename(const bytebuf &dictionary, rdcstr &name);
+
 //////////////////////////////////////////////////////////////////////////
 // Target Control
 //////////////////////////////////////////////////////////////////////////
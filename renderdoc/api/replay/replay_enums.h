@@ -76,6 +76,14 @@ version of RenderDoc that addes a new section type. They should be considered eq
   This section contains a .rgp profile from AMD's RGP tool, which can be extracted and loaded.
 
   The name for this section will be "amd/rgp/profile".
+
+.. data:: BlobStore
+
+  This section contains large binary blobs referenced from the frame capture, such as initial
+  contents data. Each distinct blob is stored once and compressed individually, and the frame
+  capture refers to it by hash wherever it was serialised.
+
+  The name for this section will be "renderdoc/internal/blobs".
 )");
 enum class SectionType : uint32_t
 {
@@ -87,6 +95,7 @@ enum class SectionType : uint32_t
   Notes,
   ResourceRenames,
   AMDRGPProfile,
+  BlobStore,
   Count,
 };
 
@@ -3094,6 +3103,10 @@ DOCUMENT(R"(The type of message received from or sent to an application target c
 .. data:: CaptureProgress
 
   Progress update on an on-going frame capture.
+
+.. data:: FrameTimeTriggerStats
+
+  Updated statistics from the target's frame time capture trigger.
 )");
 enum class TargetControlMessageType : uint32_t
 {
@@ -3106,6 +3119,7 @@ enum class TargetControlMessageType : uint32_t
   RegisterAPI,
   NewChild,
   CaptureProgress,
+  FrameTimeTriggerStats,
 };
 
 DECLARE_REFLECTION_ENUM(TargetControlMessageType);
@@ -3269,6 +3283,11 @@ DOCUMENT(R"(A set of flags describing the properties of a section in a renderdoc
 .. data:: ZstdCompressed
 
   This section is compressed with Zstd on disk.
+
+.. data:: ZstdDictionary
+
+  This section is compressed with Zstd using the trained dictionary for its section type, which is
+  either embedded in the capture's header or referenced by ID.
 )");
 enum class SectionFlags : uint32_t
 {
@@ -3276,6 +3295,7 @@ enum class SectionFlags : uint32_t
   ASCIIStored = 0x1,
   LZ4Compressed = 0x2,
   ZstdCompressed = 0x4,
+  ZstdDictionary = 0x8,
 };
 
 BITMASK_OPERATORS(SectionFlags);
@@ -378,8 +378,53 @@ The oldest/outer function is first in the list, the newest/inner function is las
 };
 DECLARE_REFLECTION_STRUCT(LineColumnInfo);
 
+DOCUMENT(R"(Records the new value of a single register that was written by one step of shader
+debugging.
+)");
+struct ShaderVariableChange
+{
+  DOCUMENT("");
+  bool operator==(const ShaderVariableChange &o) const
+  {
+    return type == o.type && index == o.index && element == o.element && value == o.value;
+  }
+  bool operator<(const ShaderVariableChange &o) const
+  {
+    if(!(type == o.type))
+      return type < o.type;
+    if(!(index == o.index))
+      return index < o.index;
+    if(!(element == o.element))
+      return element < o.element;
+    if(!(value == o.value))
+      return value < o.value;
+    return false;
+  }
+
+  DOCUMENT("The :class:`RegisterType` of the register that was written.");
+  RegisterType type = RegisterType::Undefined;
+
+  DOCUMENT(R"(The index of the register within its type. For indexable temporaries this is the index
+of the array.
+)");
+  uint32_t index = 0;
+
+  DOCUMENT("For indexable temporaries, the element within the array that was written.");
+  uint32_t element = 0;
+
+  DOCUMENT("The new value of the whole register, as a :class:`ShaderVariable`.");
+  ShaderVariable value;
+};
+
+DECLARE_REFLECTION_STRUCT(ShaderVariableChange);
+
 DOCUMENT(R"(This stores the current state of shader debugging at one particular step in the shader,
 with all mutable variable contents.
+
+To save memory, traces only store the full variable contents on periodic keyframe states. Other
+states list only the registers that changed in :data:`changes`. Use
+:meth:`ShaderDebugTrace.GetState` to fetch the complete state at any step, or :meth:`ApplyChanges`
+to step an existing state forward.
 )");
 struct ShaderDebugState
 {
@@ -387,7 +432,8 @@ struct ShaderDebugState
   bool operator==(const ShaderDebugState &o) const
   {
     return registers == o.registers && outputs == o.outputs && indexableTemps == o.indexableTemps &&
-           locals == o.locals && nextInstruction == o.nextInstruction && flags == o.flags;
+           changes == o.changes && locals == o.locals && nextInstruction == o.nextInstruction &&
+           flags == o.flags;
   }
   bool operator<(const ShaderDebugState &o) const
   {
@@ -397,6 +443,8 @@ struct ShaderDebugState
       return outputs < o.outputs;
     if(!(indexableTemps == o.indexableTemps))
       return indexableTemps < o.indexableTemps;
+    if(!(changes == o.changes))
+      return changes < o.changes;
     if(!(locals == o.locals))
       return locals < o.locals;
     if(!(nextInstruction == o.nextInstruction))
@@ -405,14 +453,56 @@ struct ShaderDebugState
       return flags < o.flags;
     return false;
   }
-  DOCUMENT("The temporary variables for this shader as a list of :class:`ShaderVariable`.");
+  DOCUMENT(R"(The temporary variables for this shader as a list of :class:`ShaderVariable`.
+
+Only filled in on keyframe states, or states returned from :meth:`ShaderDebugTrace.GetState`.
+)");
   rdcarray<ShaderVariable> registers;
-  DOCUMENT("The output variables for this shader as a list of :class:`ShaderVariable`.");
+  DOCUMENT(R"(The output variables for this shader as a list of :class:`ShaderVariable`.
+
+Only filled in on keyframe states, or states returned from :meth:`ShaderDebugTrace.GetState`.
+)");
   rdcarray<ShaderVariable> outputs;
 
-  DOCUMENT("Indexable temporary variables for this shader as a list of :class:`ShaderVariable`.");
+  DOCUMENT(R"(Indexable temporary variables for this shader as a list of :class:`ShaderVariable`.
+
+Only filled in on keyframe states, or states returned from :meth:`ShaderDebugTrace.GetState`.
+)");
   rdcarray<ShaderVariable> indexableTemps;
 
+  DOCUMENT(R"(A list of :class:`ShaderVariableChange` with the new values of each register that was
+written by this step.
+
+Empty on keyframe states, since they already contain the full variable contents.
+)");
+  rdcarray<ShaderVariableChange> changes;
+
+  DOCUMENT(R"(Apply a list of register changes to the variable contents of this state. Applying the
+next step's :data:`changes` to the full state at one step gives the full state at the next.
+
+:param List[ShaderVariableChange] changeList: The changes to apply, in the order they happened.
+)");
+  inline void ApplyChanges(const rdcarray<ShaderVariableChange> &changeList)
+  {
+    for(const ShaderVariableChange &c : changeList)
+    {
+      if(c.type == RegisterType::Temporary && c.index < registers.size())
+      {
+        registers[c.index] = c.value;
+      }
+      else if(c.type == RegisterType::Output && c.index < outputs.size())
+      {
+        outputs[c.index] = c.value;
+      }
+      else if(c.type == RegisterType::IndexedTemporary && c.index < indexableTemps.size())
+      {
+        rdcarray<ShaderVariable> &members = indexableTemps[c.index].members;
+        if(c.element < members.size())
+          members[c.element] = c.value;
+      }
+    }
+  }
+
   DOCUMENT(R"(An optional list of :class:`ShaderVariableRef` indicating which high-level locals map
 to which registers, and their type
 )");
@@ -448,10 +538,18 @@ Each entry in this list corresponds to a constant block with the same index in t
   rdcarray<ShaderVariable> constantBlocks;
 
   DOCUMENT(R"(A list of :class:`ShaderDebugState` states representing the state after each
-instruction was executed
+instruction was executed.
+
+Only every :data:`keyframeInterval` th state contains the full variable contents, the rest only
+contain the registers that changed. Use :meth:`GetState` to fetch the full state at any step.
 )");
   rdcarray<ShaderDebugState> states;
 
+  DOCUMENT(R"(The number of steps between keyframe states in :data:`states` that contain the full
+variable contents. The first state is always a keyframe.
+)");
+  uint32_t keyframeInterval = 1;
+
   DOCUMENT("A flag indicating whether this trace has locals information");
   bool hasLocals = false;
 
@@ -459,6 +557,42 @@ instruction was executed
 corresponds to
 )");
   rdcarray<LineColumnInfo> lineInfo;
+
+  DOCUMENT(R"(Fetch the full state of the shader after a given step. If :data:`keyframeInterval` is
+greater than 1 this is reconstructed from the nearest full state before it.
+
+:param int step: The index of the step in :data:`states`.
+:return: The state at that step with all variable contents filled in, or an empty state if the step
+  is out of range.
+:rtype: ShaderDebugState
+)");
+  inline ShaderDebugState GetState(int32_t step) const
+  {
+    ShaderDebugState ret;
+
+    if(step < 0 || step >= states.count())
+      return ret;
+
+    int32_t interval = keyframeInterval > 0 ? (int32_t)keyframeInterval : 1;
+    int32_t keyframe = step - (step % interval);
+
+    ret.registers = states[keyframe].registers;
+    ret.outputs = states[keyframe].outputs;
+    ret.indexableTemps = states[keyframe].indexableTemps;
+
+    for(int32_t s = keyframe + 1; s <= step; s++)
+      ret.ApplyChanges(states[s].changes);
+
+    const ShaderDebugState &cur = states[step];
+
+    ret.changes = cur.changes;
+    ret.locals = cur.locals;
+    ret.modified = cur.modified;
+    ret.nextInstruction = cur.nextInstruction;
+    ret.flags = cur.flags;
+
+    return ret;
+  }
 };
 
 DECLARE_REFLECTION_STRUCT(ShaderDebugTrace);
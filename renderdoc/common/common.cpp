@@ -27,7 +27,9 @@
 #include <stdarg.h>
 #include <string.h>
 #include <string>
+#include <vector>
 #include "common/threading.h"
+#include "common/timing.h"
 #include "os/os_specific.h"
 #include "strings/string_utils.h"
 
@@ -223,6 +225,36 @@ bool FindDiffRange(void *a, void *b, size_t bufSize, size_t &diffStart, size_t &
   return diffStart < bufSize;
 }
 
+void Threading::ParallelForRange(uint32_t count, uint32_t minPerThread,
+                                 const std::function<void(uint32_t, uint32_t)> &work)
+{
+  uint32_t numThreads = RDCMIN(Threading::NumberOfCores(), count / RDCMAX(1U, minPerThread));
+
+  if(numThreads <= 1)
+  {
+    work(0, count);
+    return;
+  }
+
+  uint32_t perThread = (count + numThreads - 1) / numThreads;
+
+  std::vector<Threading::ThreadHandle> threads;
+
+  for(uint32_t begin = perThread; begin < count; begin += perThread)
+  {
+    uint32_t end = RDCMIN(count, begin + perThread);
+    threads.push_back(Threading::CreateThread([&work, begin, end]() { work(begin, end); }));
+  }
+
+  work(0, perThread);
+
+  for(Threading::ThreadHandle t : threads)
+  {
+    Threading::JoinThread(t);
+    Threading::CloseThread(t);
+  }
+}
+
 uint32_t CalcNumMips(int w, int h, int d)
 {
   int mipLevels = 1;
@@ -296,6 +328,190 @@ uint64_t Log2Floor(uint64_t value)
 static string logfile;
 static bool logfileOpened = false;
 
+// Bounded multi-producer single-consumer queue of formatted log lines. Producers claim a slot with
+// a compare-exchange and never block - if the ring is full or the line doesn't fit in a slot, Push
+// fails with the reason and the caller decides what to do. Only one thread may Drain at once.
+class LogRing
+{
+public:
+  static const int32_t SlotCount = 512;
+  static const size_t SlotSize = 480;
+
+  enum class PushResult
+  {
+    Queued,
+    Full,
+    Unqueueable,
+  };
+
+  LogRing()
+  {
+    m_Enqueue = 0;
+    m_Dequeue = 0;
+    for(int32_t i = 0; i < SlotCount; i++)
+      m_Slots[i].seq = i;
+  }
+
+  PushResult Push(LogType type, const char *fullMsg, const char *msg)
+  {
+    size_t len = strlen(fullMsg);
+
+    // msg is expected to be a suffix of fullMsg, so we only need to store the offset
+    if(len >= SlotSize || msg < fullMsg || msg > fullMsg + len)
+      return PushResult::Unqueueable;
+
+    int32_t pos = Load(&m_Enqueue);
+
+    for(;;)
+    {
+      Slot &slot = m_Slots[uint32_t(pos) % SlotCount];
+      int32_t diff = int32_t(uint32_t(Load(&slot.seq)) - uint32_t(pos));
+
+      if(diff == 0)
+      {
+        int32_t prev = Atomic::CmpExch32(&m_Enqueue, pos, int32_t(uint32_t(pos) + 1));
+
+        if(prev == pos)
+        {
+          slot.type = type;
+          slot.msgOffset = uint32_t(msg - fullMsg);
+          memcpy(slot.text, fullMsg, len + 1);
+
+          // publish the slot to the consumer
+          Atomic::CmpExch32(&slot.seq, pos, int32_t(uint32_t(pos) + 1));
+          return PushResult::Queued;
+        }
+
+        pos = prev;
+      }
+      else if(diff < 0)
+      {
+        // the consumer hasn't freed this slot yet, the ring is full
+        return PushResult::Full;
+      }
+      else
+      {
+        pos = Load(&m_Enqueue);
+      }
+    }
+  }
+
+  template <typename Callback>
+  void Drain(Callback callback)
+  {
+    for(;;)
+    {
+      Slot &slot = m_Slots[uint32_t(m_Dequeue) % SlotCount];
+      int32_t ready = int32_t(uint32_t(m_Dequeue) + 1);
+
+      if(Load(&slot.seq) != ready)
+        return;
+
+      callback(slot.type, slot.text, slot.text + slot.msgOffset);
+
+      // hand the slot back to producers for the next lap around the ring
+      Atomic::CmpExch32(&slot.seq, ready, int32_t(uint32_t(m_Dequeue) + SlotCount));
+      m_Dequeue = ready;
+    }
+  }
+
+private:
+  // the compare-exchange is a full barrier, and the exchange is a no-op whatever the value is.
+  static int32_t Load(volatile int32_t *val) { return Atomic::CmpExch32(val, 0, 0); }
+
+  struct Slot
+  {
+    volatile int32_t seq;
+    LogType type;
+    uint32_t msgOffset;
+    char text[SlotSize];
+  };
+
+  volatile int32_t m_Enqueue;
+  int32_t m_Dequeue;
+  Slot m_Slots[SlotCount];
+};
+
+static LogRing logRing;
+
+// set while the background flusher is running and producers can queue non-error messages
+static volatile int32_t logFlusherRunning = 0;
+static volatile int32_t logFlusherShutdown = 0;
+// number of producers between checking logFlusherRunning and finishing their push. Closing the log
+// waits for this to reach 0 before the final drain so no line is queued after it.
+static volatile int32_t logPushesInFlight = 0;
+static volatile int64_t logDroppedMessages = 0;
+static Threading::ThreadHandle logFlusherThread = 0;
+
+// how often the background thread writes out queued messages
+static const uint32_t logFlushIntervalMS = 10;
+
+static Threading::CriticalSection &logOutputLock()
+{
+  static Threading::CriticalSection lock;
+  return lock;
+}
+
+static bool log_output_enabled = false;
+
+static void rdclog_write(LogType type, const char *fullMsg, const char *msg)
+{
+#if ENABLED(OUTPUT_LOG_TO_DEBUG_OUT)
+  OSUtility::WriteOutput(OSUtility::Output_DebugMon, fullMsg);
+#endif
+#if ENABLED(OUTPUT_LOG_TO_STDOUT)
+  // don't output debug messages to stdout/stderr
+  if(type != LogType::Debug && log_output_enabled)
+    OSUtility::WriteOutput(OSUtility::Output_StdOut, msg);
+#endif
+#if ENABLED(OUTPUT_LOG_TO_STDERR)
+  // don't output debug messages to stdout/stderr
+  if(type != LogType::Debug && log_output_enabled)
+    OSUtility::WriteOutput(OSUtility::Output_StdErr, msg);
+#endif
+#if ENABLED(OUTPUT_LOG_TO_DISK)
+  if(logfileOpened)
+  {
+    // strlen used as byte length - str is UTF-8 so this is NOT number of characters
+    FileIO::logfile_append(fullMsg, strlen(fullMsg));
+  }
+#endif
+}
+
+// must be called with logOutputLock held
+static void rdclog_drain()
+{
+  logRing.Drain(&rdclog_write);
+
+  int64_t dropped = Atomic::ExchAdd64(&logDroppedMessages, 0);
+  if(dropped > 0)
+  {
+    Atomic::ExchAdd64(&logDroppedMessages, -dropped);
+
+    char msg[128] = {0};
+    StringFormat::snprintf(msg, 127, "RDOC %06u: Dropped %lld debug messages, log was too busy\n",
+                           Process::GetCurrentPID(), dropped);
+    rdclog_write(LogType::Warning, msg, msg);
+  }
+}
+
+static void rdclog_flusherthread()
+{
+  Threading::KeepModuleAlive();
+
+  while(Atomic::CmpExch32(&logFlusherShutdown, 0, 0) == 0)
+  {
+    {
+      SCOPED_LOCK(logOutputLock());
+      rdclog_drain();
+    }
+
+    Threading::Sleep(logFlushIntervalMS);
+  }
+
+  Threading::ReleaseModuleExitThread();
+}
+
 const char *rdclog_getfilename()
 {
   return logfile.c_str();
@@ -303,6 +519,11 @@ const char *rdclog_getfilename()
 
 void rdclog_filename(const char *filename)
 {
+  SCOPED_LOCK(logOutputLock());
+
+  // write out anything queued for the previous file
+  rdclog_drain();
+
   string previous = logfile;
 
   logfile = "";
@@ -328,9 +549,14 @@ void rdclog_filename(const char *filename)
       FileIO::Delete(previous.c_str());
     }
   }
-}
 
-static bool log_output_enabled = false;
+  if(logfileOpened && logFlusherThread == 0)
+  {
+    logFlusherShutdown = 0;
+    logFlusherThread = Threading::CreateThread(&rdclog_flusherthread);
+    Atomic::CmpExch32(&logFlusherRunning, 0, 1);
+  }
+}
 
 void rdclog_enableoutput()
 {
@@ -339,44 +565,72 @@ void rdclog_enableoutput()
 
 void rdclog_closelog(const char *filename)
 {
+  // stop queueing, anything logged from here on is written directly
+  Atomic::CmpExch32(&logFlusherRunning, 1, 0);
+
+  // wait for any producer that saw the flusher running to finish its push, so that the drain below
+  // is the last one needed. This must happen before taking the lock, since a producer may fall
+  // back to a synchronous write if the ring is full.
+  while(Atomic::CmpExch32(&logPushesInFlight, 0, 0) != 0)
+    Threading::Sleep(0);
+
+  SCOPED_LOCK(logOutputLock());
+
+  rdclog_drain();
+
+  if(logFlusherThread)
+  {
+    // as with other threads, we can't join here as we may be in the middle of module unloading.
+    // The thread exits by itself when it next wakes up.
+    Atomic::CmpExch32(&logFlusherShutdown, 0, 1);
+    Threading::CloseThread(logFlusherThread);
+    logFlusherThread = 0;
+  }
+
   log_output_enabled = false;
   FileIO::logfile_close(filename);
 }
 
 void rdclog_flush()
 {
+  SCOPED_LOCK(logOutputLock());
+  rdclog_drain();
 }
 
 void rdclogprint_int(LogType type, const char *fullMsg, const char *msg)
 {
-  static Threading::CriticalSection lock;
+  // errors and fatal messages are always written immediately, since we might be about to crash.
+  if(type < LogType::Error)
+  {
+    Atomic::Inc32(&logPushesInFlight);
 
-  SCOPED_LOCK(lock);
+    LogRing::PushResult result = LogRing::PushResult::Unqueueable;
+    if(Atomic::CmpExch32(&logFlusherRunning, 0, 0) != 0)
+      result = logRing.Push(type, fullMsg, msg);
 
-#if ENABLED(OUTPUT_LOG_TO_DEBUG_OUT)
-  OSUtility::WriteOutput(OSUtility::Output_DebugMon, fullMsg);
-#endif
-#if ENABLED(OUTPUT_LOG_TO_STDOUT)
-  // don't output debug messages to stdout/stderr
-  if(type != LogType::Debug && log_output_enabled)
-    OSUtility::WriteOutput(OSUtility::Output_StdOut, msg);
-#endif
-#if ENABLED(OUTPUT_LOG_TO_STDERR)
-  // don't output debug messages to stdout/stderr
-  if(type != LogType::Debug && log_output_enabled)
-    OSUtility::WriteOutput(OSUtility::Output_StdErr, msg);
-#endif
-#if ENABLED(OUTPUT_LOG_TO_DISK)
-  if(logfileOpened)
-  {
-    // strlen used as byte length - str is UTF-8 so this is NOT number of characters
-    FileIO::logfile_append(fullMsg, strlen(fullMsg));
+    Atomic::Dec32(&logPushesInFlight);
+
+    if(result == LogRing::PushResult::Queued)
+      return;
+
+    // if the ring is full we drop debug messages rather than stall the calling thread on the
+    // output. Anything more important, or a line too long to queue, is written synchronously.
+    if(result == LogRing::PushResult::Full && type == LogType::Debug)
+    {
+      Atomic::Inc64(&logDroppedMessages);
+      return;
+    }
   }
-#endif
+
+  SCOPED_LOCK(logOutputLock());
+
+  // write anything queued first so that the log stays in order
+  rdclog_drain();
+
+  rdclog_write(type, fullMsg, msg);
 }
 
 const int rdclog_outBufSize = 4 * 1024;
-static char rdclog_outputBuffer[rdclog_outBufSize + 3];
 
 static void write_newline(char *output)
 {
@@ -413,9 +667,8 @@ void rdclog_int(LogType type, const char *project, const char *file, unsigned in
       "Debug  ", "Log    ", "Warning", "Error  ", "Fatal  ",
   };
 
-  static Threading::CriticalSection lock;
-
-  SCOPED_LOCK(lock);
+  // formatted on the stack so that threads logging concurrently don't have to serialise here
+  char rdclog_outputBuffer[rdclog_outBufSize + 3];
 
   rdclog_outputBuffer[rdclog_outBufSize] = rdclog_outputBuffer[0] = 0;
 
@@ -524,3 +777,239 @@ void rdclog_int(LogType type, const char *project, const char *file, unsigned in
 
   SAFE_DELETE_ARRAY(oversizedBuffer);
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Log ring buffer", "[log]")
+{
+  LogRing *ring = new LogRing();
+
+  SECTION("Messages are drained in order")
+  {
+    char msg[64];
+    for(int i = 0; i < 10; i++)
+    {
+      StringFormat::snprintf(msg, 63, "PREFIX - message %d\n", i);
+      CHECK((ring->Push(LogType::Comment, msg, msg + 9) == LogRing::PushResult::Queued));
+    }
+
+    int count = 0;
+    ring->Drain([&count](LogType type, const char *fullMsg, const char *shortMsg) {
+      CHECK(int(type) == int(LogType::Comment));
+      CHECK(string(fullMsg) == StringFormat::Fmt("PREFIX - message %d\n", count));
+      CHECK(string(shortMsg) == StringFormat::Fmt("message %d\n", count));
+      count++;
+    });
+
+    CHECK(count == 10);
+  };
+
+  SECTION("Full ring rejects messages until drained")
+  {
+    for(int32_t i = 0; i < LogRing::SlotCount; i++)
+      CHECK((ring->Push(LogType::Debug, "msg\n", "msg\n") == LogRing::PushResult::Queued));
+
+    CHECK((ring->Push(LogType::Debug, "msg\n", "msg\n") == LogRing::PushResult::Full));
+
+    int count = 0;
+    ring->Drain([&count](LogType, const char *, const char *) { count++; });
+
+    CHECK(count == int(LogRing::SlotCount));
+    CHECK((ring->Push(LogType::Debug, "msg\n", "msg\n") == LogRing::PushResult::Queued));
+  };
+
+  SECTION("Oversized messages are rejected")
+  {
+    string big(LogRing::SlotSize + 10, 'a');
+
+    CHECK((ring->Push(LogType::Debug, big.c_str(), big.c_str()) ==
+           LogRing::PushResult::Unqueueable));
+  };
+
+  SECTION("Multiple producers with a concurrent consumer")
+  {
+    const int numThreads = 4;
+    const int numMessages = 50000;
+
+    std::vector<Threading::ThreadHandle> threads;
+
+    for(int t = 0; t < numThreads; t++)
+    {
+      threads.push_back(Threading::CreateThread([ring, t, numMessages]() {
+        char msg[64];
+        for(int i = 0; i < numMessages; i++)
+        {
+          StringFormat::snprintf(msg, 63, "%d %d\n", t, i);
+
+          // keep retrying so that every message is delivered and we can verify ordering
+          while(ring->Push(LogType::Debug, msg, msg) != LogRing::PushResult::Queued)
+            Threading::Sleep(0);
+        }
+      }));
+    }
+
+    int lastSeen[numThreads];
+    for(int t = 0; t < numThreads; t++)
+      lastSeen[t] = -1;
+
+    int received = 0;
+    bool inOrder = true;
+
+    while(received < numThreads * numMessages)
+    {
+      ring->Drain([&](LogType, const char *fullMsg, const char *) {
+        int t = 0, i = 0;
+        sscanf(fullMsg, "%d %d", &t, &i);
+
+        if(t < 0 || t >= numThreads || i != lastSeen[t] + 1)
+          inOrder = false;
+        else
+          lastSeen[t] = i;
+
+        received++;
+      });
+    }
+
+    for(Threading::ThreadHandle th : threads)
+    {
+      Threading::JoinThread(th);
+      Threading::CloseThread(th);
+    }
+
+    CHECK(inOrder);
+    CHECK(received == numThreads * numMessages);
+
+    for(int t = 0; t < numThreads; t++)
+      CHECK(lastSeen[t] == numMessages - 1);
+  };
+
+  delete ring;
+};
+
+TEST_CASE("Frame time spike detection", "[timing]")
+{
+  FrameTimeSpikeDetector detector;
+
+  SECTION("Disabled by default")
+  {
+    CHECK(!detector.IsArmed());
+    CHECK(!detector.AddFrame(1000.0));
+    CHECK(detector.GetFramesObserved() == 0);
+  };
+
+  SECTION("Absolute threshold")
+  {
+    detector.Configure(33.0, 0.0, 0, 0);
+
+    CHECK(detector.IsArmed());
+    CHECK(!detector.AddFrame(16.0));
+    CHECK(!detector.AddFrame(33.0));
+    CHECK(detector.AddFrame(34.0));
+    CHECK(detector.AddFrame(50.0));
+    CHECK(!detector.AddFrame(16.0));
+
+    CHECK(detector.GetFramesObserved() == 5);
+    CHECK(detector.GetSpikeCount() == 2);
+    CHECK(detector.GetLastSpikeFrameTime() == 50.0);
+  };
+
+  SECTION("Median multiplier needs enough history")
+  {
+    detector.Configure(0.0, 3.0, 0, 0);
+
+    for(uint32_t i = 0; i < FrameTimeSpikeDetector::MinHistory - 1; i++)
+      CHECK(!detector.AddFrame(i == 0 ? 1000.0 : 10.0));
+
+    CHECK(!detector.AddFrame(25.0));
+    CHECK(!detector.AddFrame(30.0));
+    CHECK(detector.AddFrame(31.0));
+
+    CHECK(detector.GetMedianFrameTime() == 10.0);
+    CHECK(detector.GetLastSpikeMedian() == 10.0);
+  };
+
+  SECTION("Median follows recent frames")
+  {
+    detector.Configure(0.0, 2.0, 0, 0);
+
+    for(uint32_t i = 0; i < FrameTimeSpikeDetector::HistorySize; i++)
+      detector.AddFrame(10.0);
+
+    CHECK(detector.AddFrame(25.0));
+
+    // the frame rate drops for a while and the slower frames become the norm
+    for(uint32_t i = 0; i < FrameTimeSpikeDetector::HistorySize; i++)
+      detector.AddFrame(20.0);
+
+    CHECK(detector.GetMedianFrameTime() == 20.0);
+    CHECK(!detector.AddFrame(25.0));
+    CHECK(detector.AddFrame(45.0));
+  };
+
+  SECTION("Cooldown and capture limit")
+  {
+    detector.Configure(33.0, 0.0, 3, 2);
+
+    CHECK(detector.AddFrame(50.0));
+    CHECK(!detector.AddFrame(50.0));
+    CHECK(!detector.AddFrame(50.0));
+    CHECK(!detector.AddFrame(50.0));
+    CHECK(detector.AddFrame(50.0));
+
+    CHECK(!detector.IsArmed());
+    CHECK(!detector.AddFrame(50.0));
+    CHECK(detector.GetSpikeCount() == 2);
+
+    // reconfiguring re-arms and resets the statistics
+    detector.Configure(33.0, 0.0, 3, 2);
+    CHECK(detector.IsArmed());
+    CHECK(detector.GetSpikeCount() == 0);
+    CHECK(detector.AddFrame(50.0));
+  };
+};
+
+static std::string ProfileChunkName(uint32_t idx)
+{
+  return StringFormat::Fmt("Chunk%u", idx);
+}
+
+TEST_CASE("Replay profiler keeps a bounded number of samples", "[timing]")
+{
+  ReplayProfiler *profiler = new ReplayProfiler();
+
+  profiler->SetEnabled(true);
+
+  const uint32_t extra = 100;
+  const uint32_t total = uint32_t(ReplayProfiler::MaxSamples) + extra;
+
+  for(uint32_t i = 0; i < total; i++)
+    profiler->End(1, i % 4, i, &ProfileChunkName);
+
+  std::vector<ReplayProfiler::Sample> samples = profiler->GetSamples();
+
+  REQUIRE(samples.size() == size_t(ReplayProfiler::MaxSamples));
+  CHECK(profiler->GetDroppedSamples() == extra);
+
+  // the oldest samples are the ones overwritten, and the rest stay in order
+  CHECK(samples.front().eventId == extra);
+  CHECK(samples.back().eventId == total - 1);
+
+  // totals still cover every sample
+  uint64_t count = 0;
+  for(auto it = profiler->GetChunkTotals().begin(); it != profiler->GetChunkTotals().end(); ++it)
+    count += it->second.count;
+
+  CHECK(count == total);
+  CHECK(profiler->GetEventTotals().size() == total);
+  CHECK(profiler->GetChunkName(3) == "Chunk3");
+
+  profiler->SetEnabled(true);
+
+  CHECK(profiler->GetSamples().empty());
+  CHECK(profiler->GetChunkTotals().empty());
+
+  delete profiler;
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -43,6 +43,12 @@
 #define RDOC_X64 OPTION_OFF
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RDOC_SSE2 OPTION_ON
+#else
+#define RDOC_SSE2 OPTION_OFF
+#endif
+
 #if defined(RELEASE) || defined(_RELEASE)
 #define RDOC_RELEASE OPTION_ON
 #define RDOC_DEVEL OPTION_OFF
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <functional>
 #include "os/os_specific.h"
 
 namespace Threading
@@ -55,6 +56,12 @@ public:
 private:
   RWLock *m_RW;
 };
+
+// splits [0, count) into contiguous ranges and processes each on its own thread, up to one thread
+// per core. The calling thread processes the first range itself, and small counts are processed
+// entirely inline.
+void ParallelForRange(uint32_t count, uint32_t minPerThread,
+                      const std::function<void(uint32_t, uint32_t)> &work);
 };
 
 #define SCOPED_LOCK(cs) Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cs);
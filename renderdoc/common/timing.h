@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <stdarg.h>
 #include <stdint.h>
 #include <string>
@@ -58,13 +59,14 @@ public:
   void InitTimers()
   {
     m_HighPrecisionTimer.Restart();
-    m_TotalTime = m_AvgFrametime = m_MinFrametime = m_MaxFrametime = 0.0;
+    m_TotalTime = m_AvgFrametime = m_MinFrametime = m_MaxFrametime = m_LastFrametime = 0.0;
   }
 
   void UpdateTimers()
   {
-    m_FrameTimes.push_back(m_HighPrecisionTimer.GetMilliseconds());
-    m_TotalTime += m_FrameTimes.back();
+    m_LastFrametime = m_HighPrecisionTimer.GetMilliseconds();
+    m_FrameTimes.push_back(m_LastFrametime);
+    m_TotalTime += m_LastFrametime;
     m_HighPrecisionTimer.Restart();
 
     // update every second
@@ -94,6 +96,7 @@ public:
   double GetAvgFrameTime() const { return m_AvgFrametime; }
   double GetMinFrameTime() const { return m_MinFrametime; }
   double GetMaxFrameTime() const { return m_MaxFrametime; }
+  double GetLastFrameTime() const { return m_LastFrametime; }
 private:
   PerformanceTimer m_HighPrecisionTimer;
   vector<double> m_FrameTimes;
@@ -101,6 +104,110 @@ private:
   double m_AvgFrametime;
   double m_MinFrametime;
   double m_MaxFrametime;
+  double m_LastFrametime;
+};
+
+// watches a stream of frame times and picks out frames slow enough to be worth capturing. A frame
+// is a spike if it's over an absolute limit, or over a multiple of the median of recent frames.
+// After a spike no more are reported for a cooldown period, and optionally only up to a maximum
+// number in total.
+class FrameTimeSpikeDetector
+{
+public:
+  // number of recent frames the median is taken over
+  static const uint32_t HistorySize = 64;
+  // the median isn't trusted until at least this many frames have been seen
+  static const uint32_t MinHistory = 16;
+
+  FrameTimeSpikeDetector() { Configure(0.0, 0.0, 0, 0); }
+  // a threshold or multiplier of 0 disables that test, and maxSpikes of 0 means no limit.
+  void Configure(double thresholdMs, double medianMultiplier, uint32_t cooldownFrames,
+                 uint32_t maxSpikes)
+  {
+    m_Threshold = thresholdMs;
+    m_MedianMultiplier = medianMultiplier;
+    m_CooldownFrames = cooldownFrames;
+    m_MaxSpikes = maxSpikes;
+
+    m_HistoryCount = m_HistoryPos = 0;
+    m_Cooldown = 0;
+    m_FramesObserved = m_SpikeCount = 0;
+    m_Median = m_LastSpikeTime = m_LastSpikeMedian = 0.0;
+  }
+
+  bool IsArmed() const
+  {
+    return (m_Threshold > 0.0 || m_MedianMultiplier > 0.0) &&
+           (m_MaxSpikes == 0 || m_SpikeCount < m_MaxSpikes);
+  }
+
+  // returns true if this frame time is a spike that should be acted on
+  bool AddFrame(double frametime)
+  {
+    if(!IsArmed())
+      return false;
+
+    m_FramesObserved++;
+
+    // take the median before adding this frame, so a spike can't raise the bar it's tested against
+    if(m_HistoryCount > 0)
+    {
+      double sorted[HistorySize];
+      std::copy(m_History, m_History + m_HistoryCount, sorted);
+      std::nth_element(sorted, sorted + m_HistoryCount / 2, sorted + m_HistoryCount);
+      m_Median = sorted[m_HistoryCount / 2];
+    }
+
+    bool spike = false;
+    if(m_Threshold > 0.0 && frametime > m_Threshold)
+      spike = true;
+    if(m_MedianMultiplier > 0.0 && m_HistoryCount >= MinHistory &&
+       frametime > m_Median * m_MedianMultiplier)
+      spike = true;
+
+    m_History[m_HistoryPos] = frametime;
+    m_HistoryPos = (m_HistoryPos + 1) % HistorySize;
+    if(m_HistoryCount < HistorySize)
+      m_HistoryCount++;
+
+    if(m_Cooldown > 0)
+    {
+      m_Cooldown--;
+      return false;
+    }
+
+    if(!spike)
+      return false;
+
+    m_SpikeCount++;
+    m_Cooldown = m_CooldownFrames;
+    m_LastSpikeTime = frametime;
+    m_LastSpikeMedian = m_Median;
+
+    return true;
+  }
+
+  uint32_t GetFramesObserved() const { return m_FramesObserved; }
+  uint32_t GetSpikeCount() const { return m_SpikeCount; }
+  double GetMedianFrameTime() const { return m_Median; }
+  double GetLastSpikeFrameTime() const { return m_LastSpikeTime; }
+  double GetLastSpikeMedian() const { return m_LastSpikeMedian; }
+private:
+  double m_Threshold;
+  double m_MedianMultiplier;
+  uint32_t m_CooldownFrames;
+  uint32_t m_MaxSpikes;
+
+  double m_History[HistorySize];
+  uint32_t m_HistoryCount;
+  uint32_t m_HistoryPos;
+  uint32_t m_Cooldown;
+
+  uint32_t m_FramesObserved;
+  uint32_t m_SpikeCount;
+  double m_Median;
+  double m_LastSpikeTime;
+  double m_LastSpikeMedian;
 };
 
 class ScopedTimer
@@ -136,4 +243,115 @@ private:
   PerformanceTimer m_Timer;
 };
 
+// records the CPU time spent on each chunk while replaying, when enabled. This is only intended
+// for diagnosing slow replays. Totals per chunk type and per event cover everything replayed since
+// profiling was enabled, but only the most recent MaxSamples individual samples are kept so that
+// long replays or replay loops don't grow without bound.
+class ReplayProfiler
+{
+public:
+  typedef std::string (*ChunkNameFunc)(uint32_t idx);
+
+  static const size_t MaxSamples = 1024 * 1024;
+
+  struct Sample
+  {
+    uint32_t chunkID;
+    uint32_t eventId;
+    uint64_t startTick;
+    uint64_t endTick;
+  };
+
+  struct Totals
+  {
+    uint32_t count;
+    uint64_t ticks;
+    uint64_t maxTicks;
+  };
+
+  void SetEnabled(bool enabled)
+  {
+    m_Enabled = enabled;
+
+    if(enabled)
+    {
+      m_Samples.clear();
+      m_NextSample = 0;
+      m_DroppedSamples = 0;
+      m_ChunkTotals.clear();
+      m_EventTotals.clear();
+      m_ChunkNames.clear();
+    }
+  }
+
+  bool IsEnabled() const { return m_Enabled; }
+  // returns the tick to pass to End(), or 0 if profiling isn't enabled
+  uint64_t Begin() const { return m_Enabled ? Timing::GetTick() : 0; }
+  void End(uint64_t startTick, uint32_t chunkID, uint32_t eventId, ChunkNameFunc getName)
+  {
+    if(!m_Enabled || startTick == 0)
+      return;
+
+    Sample sample = {chunkID, eventId, startTick, Timing::GetTick()};
+
+    // once the ring is full, overwrite the oldest sample
+    if(m_Samples.size() < MaxSamples)
+    {
+      m_Samples.push_back(sample);
+    }
+    else
+    {
+      m_Samples[m_NextSample] = sample;
+      m_NextSample = (m_NextSample + 1) % MaxSamples;
+      m_DroppedSamples++;
+    }
+
+    uint64_t ticks = sample.endTick - sample.startTick;
+
+    Totals *totals[] = {&m_ChunkTotals[chunkID], &m_EventTotals[eventId]};
+
+    for(Totals *t : totals)
+    {
+      t->count++;
+      t->ticks += ticks;
+      t->maxTicks = RDCMAX(t->maxTicks, ticks);
+    }
+
+    if(m_ChunkNames.find(chunkID) == m_ChunkNames.end())
+      m_ChunkNames[chunkID] = getName(chunkID);
+  }
+
+  // the most recent samples, oldest first
+  std::vector<Sample> GetSamples() const
+  {
+    std::vector<Sample> ret;
+    ret.reserve(m_Samples.size());
+    ret.insert(ret.end(), m_Samples.begin() + m_NextSample, m_Samples.end());
+    ret.insert(ret.end(), m_Samples.begin(), m_Samples.begin() + m_NextSample);
+    return ret;
+  }
+
+  // the number of samples that were overwritten and are no longer returned by GetSamples()
+  uint64_t GetDroppedSamples() const { return m_DroppedSamples; }
+  const std::map<uint32_t, Totals> &GetChunkTotals() const { return m_ChunkTotals; }
+  const std::map<uint32_t, Totals> &GetEventTotals() const { return m_EventTotals; }
+  std::string GetChunkName(uint32_t chunkID) const
+  {
+    auto it = m_ChunkNames.find(chunkID);
+    return it == m_ChunkNames.end() ? std::string() : it->second;
+  }
+
+private:
+  bool m_Enabled = false;
+  std::vector<Sample> m_Samples;
+  size_t m_NextSample = 0;
+  uint64_t m_DroppedSamples = 0;
+  std::map<uint32_t, Totals> m_ChunkTotals;
+  std::map<uint32_t, Totals> m_EventTotals;
+  std::map<uint32_t, std::string> m_ChunkNames;
+};
+
+// exports the recorded samples in the same format as the chrome.json capture export
+ReplayStatus exportChromeReplayProfile(const char *filename, const ReplayProfiler &profiler);
+
 #define SCOPED_TIMER(...) ScopedTimer CONCAT(timer, __LINE__)(__FILE__, __LINE__, __VA_ARGS__);
@@ -540,6 +540,24 @@ void RenderDoc::Tick()
 
   m_FrameTimer.UpdateTimers();
 
+  // frames that are being captured, or that ran the end of a capture, are slow because of the
+  // capture itself so they aren't given to the frame time trigger.
+  static bool prev_capturing = false;
+  bool capturing = IsFrameCapturing();
+
+  if(!capturing && !prev_capturing)
+  {
+    SCOPED_LOCK(m_FrameTimeTriggerLock);
+    if(m_FrameTimeTrigger.AddFrame(m_FrameTimer.GetLastFrameTime()))
+    {
+      RDCLOG("Frame took %.2lf ms (median %.2lf ms), triggering capture",
+             m_FrameTimeTrigger.GetLastSpikeFrameTime(), m_FrameTimeTrigger.GetLastSpikeMedian());
+      m_Cap = RDCMAX(m_Cap, 1U);
+    }
+  }
+
+  prev_capturing = capturing;
+
   if(!prev_focus && cur_focus)
   {
     m_Cap = 0;
@@ -669,6 +687,32 @@ string RenderDoc::GetOverlayText(RDCDriver driver, uint32_t frameNumber, int fla
   return overlayText;
 }
 
+void RenderDoc::SetFrameTimeTrigger(const FrameTimeTrigger &trigger)
+{
+  RDCLOG("Frame time capture trigger set to %.2f ms / %.2fx median, %u frame cooldown, %u captures",
+         trigger.thresholdMs, trigger.medianMultiplier, trigger.cooldownFrames,
+         trigger.maxCaptures);
+
+  SCOPED_LOCK(m_FrameTimeTriggerLock);
+  m_FrameTimeTrigger.Configure(trigger.thresholdMs, trigger.medianMultiplier,
+                               trigger.cooldownFrames, trigger.maxCaptures);
+}
+
+FrameTimeTriggerStats RenderDoc::GetFrameTimeTriggerStats()
+{
+  FrameTimeTriggerStats ret;
+
+  SCOPED_LOCK(m_FrameTimeTriggerLock);
+  ret.framesObserved = m_FrameTimeTrigger.GetFramesObserved();
+  ret.capturesTriggered = m_FrameTimeTrigger.GetSpikeCount();
+  ret.medianFrameTime = (float)m_FrameTimeTrigger.GetMedianFrameTime();
+  ret.lastTriggerFrameTime = (float)m_FrameTimeTrigger.GetLastSpikeFrameTime();
+  ret.lastTriggerMedian = (float)m_FrameTimeTrigger.GetLastSpikeMedian();
+  ret.armed = m_FrameTimeTrigger.IsArmed();
+
+  return ret;
+}
+
 bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
 {
   bool ret = m_Cap > 0;
@@ -1066,6 +1110,9 @@ void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
 
   if(rdc)
   {
+    // add any large byte buffers that were stored out of line
+    rdc->WriteBlobStore();
+
     // add the resolve database if we were capturing callstacks.
     if(m_Options.captureCallstacks)
     {
@@ -513,6 +513,8 @@ public:
   uint32_t GetOverlayBits() { return m_Overlay; }
   void MaskOverlayBits(uint32_t And, uint32_t Or) { m_Overlay = (m_Overlay & And) | Or; }
   void QueueCapture(uint32_t frameNumber) { m_QueuedFrameCaptures.insert(frameNumber); }
+  void SetFrameTimeTrigger(const FrameTimeTrigger &trigger);
+  FrameTimeTriggerStats GetFrameTimeTriggerStats();
   void SetFocusKeys(RENDERDOC_InputButton *keys, int num)
   {
     m_FocusKeys.resize(num);
@@ -538,6 +540,7 @@ public:
 
   string GetOverlayText(RDCDriver driver, uint32_t frameNumber, int flags);
 
+  ReplayProfiler &GetReplayProfiler() { return m_ReplayProfiler; }
 private:
   RenderDoc();
   ~RenderDoc();
@@ -554,6 +557,10 @@ private:
   GlobalEnvironment m_GlobalEnv;
 
   FrameTimer m_FrameTimer;
+  ReplayProfiler m_ReplayProfiler;
+
+  Threading::CriticalSection m_FrameTimeTriggerLock;
+  FrameTimeSpikeDetector m_FrameTimeTrigger;
 
   string m_LoggingFilename;
 
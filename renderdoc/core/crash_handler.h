@@ -123,8 +123,9 @@ public:
 
     _CrtSetReportMode(_CRT_ASSERT, 0);
     m_ExHandler = new google_breakpad::ExceptionHandler(
-        dumpFolder.c_str(), NULL, NULL, NULL, google_breakpad::ExceptionHandler::HANDLER_ALL,
-        dumpType, L"\\\\.\\pipe\\RenderDocBreakpadServer", &custom);
+        dumpFolder.c_str(), &FlushLogFilter, NULL, NULL,
+        google_breakpad::ExceptionHandler::HANDLER_ALL, dumpType,
+        L"\\\\.\\pipe\\RenderDocBreakpadServer", &custom);
 
     m_ExHandler->set_handle_debug_exceptions(true);
 
@@ -133,6 +134,14 @@ public:
   }
 
   virtual ~CrashHandler() { SAFE_DELETE(m_ExHandler); }
+  // write out any log messages still queued before the dump is taken
+  static bool FlushLogFilter(void *context, EXCEPTION_POINTERS *exinfo,
+                             MDRawAssertionInfo *assertion)
+  {
+    rdclog_flush();
+    return true;
+  }
+
   void WriteMinidump() { m_ExHandler->WriteMinidump(); }
   void WriteMinidump(void *data)
   {
@@ -1183,6 +1183,106 @@ ShaderDebugTrace ReplayProxy::DebugThread(uint32_t eventId, const uint32_t group
   PROXY_FUNCTION(DebugThread, eventId, groupid, threadid);
 }
 
+// size of the blocks compared when sending the pipeline state. Small enough that a handful of
+// changed bindings don't resend much, large enough that the list of changed blocks stays short.
+static const size_t PipelineStateBlockSize = 256;
+
+// build the list of blocks in cur that differ from prev, and the contents of those blocks.
+static void DeltaEncodeBlocks(const bytebuf &prev, const bytebuf &cur,
+                              std::vector<uint32_t> &changedBlocks, bytebuf &blockData)
+{
+  changedBlocks.clear();
+  blockData.clear();
+
+  for(size_t offs = 0; offs < cur.size(); offs += PipelineStateBlockSize)
+  {
+    size_t len = RDCMIN(PipelineStateBlockSize, cur.size() - offs);
+
+    if(offs + len <= prev.size() && memcmp(prev.data() + offs, cur.data() + offs, len) == 0)
+      continue;
+
+    changedBlocks.push_back(uint32_t(offs / PipelineStateBlockSize));
+    blockData.append(cur.data() + offs, len);
+  }
+}
+
+// patch data up to date in place, given the blocks from DeltaEncodeBlocks and the new total size.
+static bool DeltaDecodeBlocks(bytebuf &data, uint64_t size,
+                              const std::vector<uint32_t> &changedBlocks, const bytebuf &blockData)
+{
+  data.resize((size_t)size);
+
+  size_t readOffs = 0;
+
+  for(uint32_t block : changedBlocks)
+  {
+    size_t offs = block * PipelineStateBlockSize;
+
+    if(offs >= data.size())
+      return false;
+
+    size_t len = RDCMIN(PipelineStateBlockSize, data.size() - offs);
+
+    if(readOffs + len > blockData.size())
+      return false;
+
+    memcpy(data.data() + offs, blockData.data() + readOffs, len);
+    readOffs += len;
+  }
+
+  return readOffs == blockData.size();
+}
+
+void ReplayProxy::EncodePipelineState(bytebuf &data)
+{
+  WriteSerialiser ser(new StreamWriter(StreamWriter::DefaultScratchSize), Ownership::Stream);
+
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+  {
+    SERIALISE_ELEMENT(m_D3D11PipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+  {
+    SERIALISE_ELEMENT(m_D3D12PipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+  {
+    SERIALISE_ELEMENT(m_GLPipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+  {
+    SERIALISE_ELEMENT(m_VulkanPipelineState);
+  }
+
+  data.resize((size_t)ser.GetWriter()->GetOffset());
+  memcpy(data.data(), ser.GetWriter()->GetData(), data.size());
+}
+
+void ReplayProxy::DecodePipelineState(const bytebuf &data)
+{
+  ReadSerialiser ser(new StreamReader(data.data(), data.size()), Ownership::Stream);
+
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+  {
+    SERIALISE_ELEMENT(m_D3D11PipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+  {
+    SERIALISE_ELEMENT(m_D3D12PipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+  {
+    SERIALISE_ELEMENT(m_GLPipelineState);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+  {
+    SERIALISE_ELEMENT(m_VulkanPipelineState);
+  }
+
+  if(ser.IsErrored())
+    m_IsErrored = true;
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 void ReplayProxy::Proxied_SavePipelineState(ParamSerialiser &paramser, ReturnSerialiser &retser)
 {
@@ -1210,23 +1310,41 @@ void ReplayProxy::Proxied_SavePipelineState(ParamSerialiser &paramser, ReturnSer
   {
     ReturnSerialiser &ser = retser;
     PACKET_HEADER(packet);
-    if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
-    {
-      SERIALISE_ELEMENT(m_D3D11PipelineState);
-    }
-    else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
-    {
-      SERIALISE_ELEMENT(m_D3D12PipelineState);
-    }
-    else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+
+    // consecutive events usually have nearly identical state, so rather than sending the whole
+    // thing we only send the blocks of the serialised state that changed since the last call.
+    uint64_t stateSize = 0;
+    std::vector<uint32_t> changedBlocks;
+    bytebuf blockData;
+
+    if(ser.IsWriting())
     {
-      SERIALISE_ELEMENT(m_GLPipelineState);
+      bytebuf stateData;
+      EncodePipelineState(stateData);
+
+      stateSize = stateData.size();
+      DeltaEncodeBlocks(m_PipelineStateData, stateData, changedBlocks, blockData);
+
+      m_PipelineStateData.swap(stateData);
     }
-    else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+
+    SERIALISE_ELEMENT(stateSize);
+    SERIALISE_ELEMENT(changedBlocks);
+    SERIALISE_ELEMENT(blockData);
+    ser.EndChunk();
+
+    if(retser.IsReading() && !ser.IsErrored())
     {
-      SERIALISE_ELEMENT(m_VulkanPipelineState);
+      if(DeltaDecodeBlocks(m_PipelineStateData, stateSize, changedBlocks, blockData))
+      {
+        DecodePipelineState(m_PipelineStateData);
+      }
+      else
+      {
+        RDCERR("Invalid pipeline state delta received");
+        m_IsErrored = true;
+      }
     }
-    ser.EndChunk();
 
     if(retser.IsReading())
     {
@@ -2108,3 +2226,104 @@ bool ReplayProxy::Tick(int type)
 
   return true;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Pipeline state block deltas", "[replayproxy]")
+{
+  bytebuf prev, cur;
+  prev.resize(PipelineStateBlockSize * 4 + 17);
+  for(size_t i = 0; i < prev.size(); i++)
+    prev[i] = byte(i & 0xff);
+
+  std::vector<uint32_t> changedBlocks;
+  bytebuf blockData;
+
+  SECTION("Identical data sends nothing")
+  {
+    cur = prev;
+    DeltaEncodeBlocks(prev, cur, changedBlocks, blockData);
+
+    CHECK(changedBlocks.empty());
+    CHECK(blockData.empty());
+
+    bytebuf patched = prev;
+    CHECK(DeltaDecodeBlocks(patched, cur.size(), changedBlocks, blockData));
+    CHECK(patched == cur);
+  };
+
+  SECTION("Only changed blocks are sent")
+  {
+    cur = prev;
+    cur[PipelineStateBlockSize + 3] ^= 0xff;
+    cur[cur.size() - 1] ^= 0xff;
+
+    DeltaEncodeBlocks(prev, cur, changedBlocks, blockData);
+
+    REQUIRE(changedBlocks.size() == 2);
+    CHECK(changedBlocks[0] == 1);
+    CHECK(changedBlocks[1] == 4);
+    CHECK(blockData.size() == PipelineStateBlockSize + 17);
+
+    bytebuf patched = prev;
+    CHECK(DeltaDecodeBlocks(patched, cur.size(), changedBlocks, blockData));
+    CHECK(patched == cur);
+  };
+
+  SECTION("Growing and shrinking")
+  {
+    cur = prev;
+    cur.resize(prev.size() + PipelineStateBlockSize * 2);
+    for(size_t i = prev.size(); i < cur.size(); i++)
+      cur[i] = byte(0x5a);
+
+    DeltaEncodeBlocks(prev, cur, changedBlocks, blockData);
+
+    bytebuf patched = prev;
+    CHECK(DeltaDecodeBlocks(patched, cur.size(), changedBlocks, blockData));
+    CHECK(patched == cur);
+
+    cur.resize(PipelineStateBlockSize * 2 + 5);
+
+    DeltaEncodeBlocks(prev, cur, changedBlocks, blockData);
+
+    // truncating doesn't need any data, only the new size
+    CHECK(changedBlocks.empty());
+
+    patched = prev;
+    CHECK(DeltaDecodeBlocks(patched, cur.size(), changedBlocks, blockData));
+    CHECK(patched == cur);
+  };
+
+  SECTION("Starting from nothing")
+  {
+    cur = prev;
+
+    DeltaEncodeBlocks(bytebuf(), cur, changedBlocks, blockData);
+
+    CHECK(changedBlocks.size() == 5);
+    CHECK(blockData == cur);
+
+    bytebuf patched;
+    CHECK(DeltaDecodeBlocks(patched, cur.size(), changedBlocks, blockData));
+    CHECK(patched == cur);
+  };
+
+  SECTION("Malformed deltas are rejected")
+  {
+    changedBlocks = {7};
+    blockData.resize(PipelineStateBlockSize);
+
+    bytebuf patched = prev;
+    CHECK_FALSE(DeltaDecodeBlocks(patched, prev.size(), changedBlocks, blockData));
+
+    changedBlocks = {0};
+    blockData.resize(3);
+
+    patched = prev;
+    CHECK_FALSE(DeltaDecodeBlocks(patched, prev.size(), changedBlocks, blockData));
+  };
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
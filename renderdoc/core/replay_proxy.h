@@ -660,4 +660,11 @@ private:
   D3D12Pipe::State m_D3D12PipelineState;
   GLPipe::State m_GLPipelineState;
   VKPipe::State m_VulkanPipelineState;
+
+  // the pipeline state as last sent or received, serialised flat. Both sides keep this in sync so
+  // that only the blocks that changed between events need to be sent.
+  bytebuf m_PipelineStateData;
+
+  void EncodePipelineState(bytebuf &data);
+  void DecodePipelineState(const bytebuf &data);
 };
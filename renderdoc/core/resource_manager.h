@@ -386,6 +386,10 @@ public:
   // That means this resource should be included in the final serialise out
   inline void MarkResourceFrameReferenced(ResourceId id, FrameRefType refType);
 
+  // as above, but for a batch of resources at once under a single lock
+  inline void MarkResourcesFrameReferenced(
+      const std::vector<std::pair<ResourceId, FrameRefType> > &refs);
+
   ///////////////////////////////////////////
   // Replay-side methods
 
@@ -428,14 +432,25 @@ protected:
 
   virtual bool Force_InitialState(WrappedResourceType res, bool prepare) = 0;
   virtual bool AllowDeletedResource_InitialState() { return false; }
+  virtual bool AllowRetain_InitialState(WrappedResourceType res) { return false; }
   virtual bool Need_InitialStateChunk(WrappedResourceType res) = 0;
   virtual bool Prepare_InitialState(WrappedResourceType res) = 0;
-  virtual uint32_t GetSize_InitialState(ResourceId id, WrappedResourceType res) = 0;
+  // blobs is the blob store the chunk will be serialised with, if any. Byte buffers moved there
+  // don't count towards the chunk's size.
+  virtual uint32_t GetSize_InitialState(ResourceId id, WrappedResourceType res,
+                                        const BlobStore *blobs) = 0;
   virtual bool Serialise_InitialState(WriteSerialiser &ser, ResourceId id,
                                       WrappedResourceType res) = 0;
   virtual void Create_InitialState(ResourceId id, WrappedResourceType live, bool hasData) = 0;
   virtual void Apply_InitialState(WrappedResourceType live, InitialContentData initial) = 0;
 
+  // returns if the resource has been marked dirty, pending dirty or clean, or was written in a
+  // frame, since the last capture started. Only tracked while initial contents are retained.
+  bool HasChangedSinceCapture(ResourceId res);
+  // returns the resource whose contents also change when this one is written, such as the memory
+  // an image is bound to. Changes are tracked on the whole chain so aliased contents aren't kept.
+  virtual ResourceId GetBackingResource(ResourceId res) { return ResourceId(); }
+
   // very coarse lock, protects EVERYTHING. This could certainly be improved and it may be a
   // bottleneck
   // for performance. Given that the main use cases are write-rarely read-often the lock should be
@@ -466,6 +481,33 @@ protected:
   // Some initial contents may not need the delayed readback.
   map<ResourceId, Chunk *> m_InitialChunks;
 
+  // used during capture - with the retainInitialContents capture option, the initial contents
+  // chunks of one capture are kept and re-used in the next for any resource that hasn't changed in
+  // between, skipping the readback. The chunks are only kept in memory, each capture still
+  // contains all of its initial contents.
+  struct RetainedInitialChunk
+  {
+    Chunk *chunk;
+    // large byte buffers in the chunk are stored here, and added to each capture's blob store
+    // along with the chunk
+    BlobStore *blobs;
+
+    void Free()
+    {
+      delete chunk;
+      delete blobs;
+    }
+  };
+
+  void MarkChangedSinceCapture(ResourceId res);
+  bool WriteRetainedChunk(WriteSerialiser &ser, const RetainedInitialChunk &retained);
+
+  bool m_RetainInitialContents = false;
+  set<ResourceId> m_ChangedResources;
+  map<ResourceId, RetainedInitialChunk> m_RetainedInitialChunks;
+  // the retained chunks being re-used by the current capture, in place of prepared contents
+  map<ResourceId, RetainedInitialChunk> m_ReusedInitialChunks;
+
   // used during capture or replay - map of resources currently alive with their real IDs, used in
   // capture and replay.
   map<ResourceId, WrappedResourceType> m_CurrentResourceMap;
@@ -495,6 +537,11 @@ void ResourceManager<Configuration>::Shutdown()
 {
   FreeInitialContents();
 
+  for(auto it = m_RetainedInitialChunks.begin(); it != m_RetainedInitialChunks.end(); ++it)
+    it->second.Free();
+
+  m_RetainedInitialChunks.clear();
+
   while(!m_LiveResourceMap.empty())
   {
     auto it = m_LiveResourceMap.begin();
@@ -539,6 +586,29 @@ void ResourceManager<Configuration>::MarkResourceFrameReferenced(ResourceId id,
   }
 }
 
+template <typename Configuration>
+void ResourceManager<Configuration>::MarkResourcesFrameReferenced(
+    const std::vector<std::pair<ResourceId, FrameRefType> > &refs)
+{
+  SCOPED_LOCK(m_Lock);
+
+  for(const std::pair<ResourceId, FrameRefType> &ref : refs)
+  {
+    if(ref.first == ResourceId())
+      continue;
+
+    bool newRef = MarkReferenced(m_FrameReferencedResources, ref.first, ref.second);
+
+    if(newRef)
+    {
+      RecordType *record = GetResourceRecord(ref.first);
+
+      if(record)
+        record->AddRef();
+    }
+  }
+}
+
 template <typename Configuration>
 void ResourceManager<Configuration>::MarkDirtyResource(ResourceId res)
 {
@@ -548,6 +618,9 @@ void ResourceManager<Configuration>::MarkDirtyResource(ResourceId res)
     return;
 
   m_DirtyResources.insert(res);
+
+  if(m_RetainInitialContents)
+    MarkChangedSinceCapture(res);
 }
 
 template <typename Configuration>
@@ -559,6 +632,9 @@ void ResourceManager<Configuration>::MarkPendingDirty(ResourceId res)
     return;
 
   m_PendingDirtyResources.insert(res);
+
+  if(m_RetainInitialContents)
+    MarkChangedSinceCapture(res);
 }
 
 template <typename Configuration>
@@ -593,6 +669,27 @@ void ResourceManager<Configuration>::MarkCleanResource(ResourceId res)
   {
     m_DirtyResources.erase(res);
   }
+
+  if(m_RetainInitialContents)
+    MarkChangedSinceCapture(res);
+}
+
+template <typename Configuration>
+void ResourceManager<Configuration>::MarkChangedSinceCapture(ResourceId res)
+{
+  SCOPED_LOCK(m_Lock);
+
+  // follow the backing resources until one is already marked, which also stops any cycles
+  while(res != ResourceId() && m_ChangedResources.insert(res).second)
+    res = GetBackingResource(res);
+}
+
+template <typename Configuration>
+bool ResourceManager<Configuration>::HasChangedSinceCapture(ResourceId res)
+{
+  SCOPED_LOCK(m_Lock);
+
+  return m_ChangedResources.find(res) != m_ChangedResources.end();
 }
 
 template <typename Configuration>
@@ -721,6 +818,31 @@ void ResourceManager<Configuration>::FreeInitialContents()
     if(!m_InitialContents.empty())
       m_InitialContents.erase(m_InitialContents.begin());
   }
+
+  // if a capture was discarded the prepared chunks were never written
+  for(auto it = m_InitialChunks.begin(); it != m_InitialChunks.end(); ++it)
+    delete it->second;
+
+  m_InitialChunks.clear();
+
+  for(auto it = m_ReusedInitialChunks.begin(); it != m_ReusedInitialChunks.end(); ++it)
+    it->second.Free();
+
+  m_ReusedInitialChunks.clear();
+}
+
+template <typename Configuration>
+bool ResourceManager<Configuration>::WriteRetainedChunk(WriteSerialiser &ser,
+                                                        const RetainedInitialChunk &retained)
+{
+  // the chunk only references its byte buffers by hash, so they have to be in the store the
+  // capture is written with. This can only fail on a hash collision with different contents.
+  if(!retained.blobs->IsEmpty() &&
+     (ser.GetBlobStore() == NULL || !ser.GetBlobStore()->Merge(*retained.blobs)))
+    return false;
+
+  retained.chunk->Write(ser);
+  return true;
 }
 
 template <typename Configuration>
@@ -848,7 +970,14 @@ void ResourceManager<Configuration>::PrepareInitialContents()
   SCOPED_LOCK(m_Lock);
 
   RDCDEBUG("Preparing up to %u potentially dirty resources", (uint32_t)m_DirtyResources.size());
-  uint32_t prepared = 0;
+  uint32_t prepared = 0, reused = 0;
+
+  // only re-use the previous capture's chunks if we were tracking changes since then
+  bool reuse = m_RetainInitialContents;
+
+  m_RetainInitialContents = RenderDoc::Inst().GetCaptureOptions().retainInitialContents;
+
+  reuse &= m_RetainInitialContents;
 
   float num = float(m_DirtyResources.size());
   float idx = 0.0f;
@@ -871,6 +1000,20 @@ void ResourceManager<Configuration>::PrepareInitialContents()
 
     prepared++;
 
+    auto retained = m_RetainedInitialChunks.find(id);
+    if(reuse && retained != m_RetainedInitialChunks.end() && !HasChangedSinceCapture(id) &&
+       AllowRetain_InitialState(res))
+    {
+#if ENABLED(VERBOSE_DIRTY_RESOURCES)
+      RDCDEBUG("Re-using retained initial contents for Resource %llu", id);
+#endif
+
+      m_ReusedInitialChunks[id] = retained->second;
+      m_RetainedInitialChunks.erase(retained);
+      reused++;
+      continue;
+    }
+
 #if ENABLED(VERBOSE_DIRTY_RESOURCES)
     RDCDEBUG("Prepare Resource %llu", id);
 #endif
@@ -878,7 +1021,14 @@ void ResourceManager<Configuration>::PrepareInitialContents()
     Prepare_InitialState(res);
   }
 
-  RDCDEBUG("Prepared %u dirty resources", prepared);
+  RDCDEBUG("Prepared %u dirty resources, %u re-used from the previous capture", prepared, reused);
+
+  // anything not re-used is out of date, and changes are now tracked against this capture
+  for(auto it = m_RetainedInitialChunks.begin(); it != m_RetainedInitialChunks.end(); ++it)
+    it->second.Free();
+
+  m_RetainedInitialChunks.clear();
+  m_ChangedResources.clear();
 
   prepared = 0;
 
@@ -910,6 +1060,23 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
   float num = float(m_DirtyResources.size());
   float idx = 0.0f;
 
+  // chunks to retain are serialised separately so they can be kept. Each keeps its own blob store
+  // since the next capture's store won't have the same blobs.
+  WriteSerialiser retainSer(new StreamWriter(1024), Ownership::Stream);
+
+  if(m_RetainInitialContents)
+  {
+    retainSer.SetChunkMetadataRecording(ser.GetChunkMetadataRecording());
+    retainSer.SetUserData(ser.GetUserData());
+
+    // anything written in the frame will have changed by the next capture
+    for(auto it = m_FrameReferencedResources.begin(); it != m_FrameReferencedResources.end(); ++it)
+    {
+      if(it->second != eFrameRef_Read && it->second != eFrameRef_ReadOnly)
+        MarkChangedSinceCapture(it->first);
+    }
+  }
+
   for(auto it = m_DirtyResources.begin(); it != m_DirtyResources.end(); ++it)
   {
     ResourceId id = *it;
@@ -972,15 +1139,66 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
       continue;
     }
 
+    bool retain = m_RetainInitialContents && isAlive && !HasChangedSinceCapture(id) &&
+                  AllowRetain_InitialState(res);
+
+    auto reusedChunk = m_ReusedInitialChunks.find(id);
+    if(reusedChunk != m_ReusedInitialChunks.end())
+    {
+      RetainedInitialChunk reused = reusedChunk->second;
+      m_ReusedInitialChunks.erase(reusedChunk);
+
+      bool written = WriteRetainedChunk(ser, reused);
+
+      if(!written)
+        RDCERR("Couldn't write retained initial contents for %llu, blob hash collision", id);
+
+      if(retain && written)
+        m_RetainedInitialChunks[id] = reused;
+      else
+        reused.Free();
+
+      continue;
+    }
+
     auto preparedChunk = m_InitialChunks.find(id);
     if(preparedChunk != m_InitialChunks.end())
     {
       preparedChunk->second->Write(ser);
+      delete preparedChunk->second;
       m_InitialChunks.erase(preparedChunk);
+      continue;
     }
-    else
+
+    if(retain)
+    {
+      RetainedInitialChunk retained;
+      retained.blobs = new BlobStore;
+
+      retainSer.SetBlobStore(ser.GetBlobStore() ? retained.blobs : NULL);
+
+      {
+        uint32_t size = GetSize_InitialState(id, res, retainSer.GetBlobStore());
+
+        ScopedChunk scope(retainSer, SystemChunk::InitialContents, size);
+
+        Serialise_InitialState(retainSer, id, res);
+
+        retained.chunk = scope.Get();
+      }
+
+      if(WriteRetainedChunk(ser, retained))
+      {
+        m_RetainedInitialChunks[id] = retained;
+        continue;
+      }
+
+      // serialise it straight to the capture instead, without keeping it
+      retained.Free();
+    }
+
     {
-      uint32_t size = GetSize_InitialState(id, res);
+      uint32_t size = GetSize_InitialState(id, res, ser.GetBlobStore());
 
       SCOPED_SERIALISE_CHUNK(SystemChunk::InitialContents, size);
 
@@ -988,6 +1206,12 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
     }
   }
 
+  // any re-used chunks that weren't written are for resources that were skipped
+  for(auto it = m_ReusedInitialChunks.begin(); it != m_ReusedInitialChunks.end(); ++it)
+    it->second.Free();
+
+  m_ReusedInitialChunks.clear();
+
   RDCDEBUG("Serialised %u dirty resources, skipped %u unreferenced", dirty, skipped);
 
   dirty = 0;
@@ -1005,11 +1229,12 @@ void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser
       if(preparedChunk != m_InitialChunks.end())
       {
         preparedChunk->second->Write(ser);
+        delete preparedChunk->second;
         m_InitialChunks.erase(preparedChunk);
       }
       else
       {
-        uint32_t size = GetSize_InitialState(it->first, it->second);
+        uint32_t size = GetSize_InitialState(it->first, it->second, ser.GetBlobStore());
 
         SCOPED_SERIALISE_CHUNK(SystemChunk::InitialContents, size);
 
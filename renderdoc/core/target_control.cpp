@@ -30,7 +30,10 @@
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
 
-static const uint32_t TargetControlProtocolVersion = 2;
+static const uint32_t TargetControlProtocolVersion = 3;
+
+// the first version that knows about the frame time trigger packets
+static const uint32_t FrameTimeTriggerProtocolVersion = 3;
 
 enum PacketType : uint32_t
 {
@@ -45,6 +48,8 @@ enum PacketType : uint32_t
   ePacket_QueueCapture,
   ePacket_NewChild,
   ePacket_CaptureProgress,
+  ePacket_FrameTimeTrigger,
+  ePacket_FrameTimeTriggerStats,
 };
 
 DECLARE_REFLECTION_ENUM(PacketType);
@@ -64,6 +69,9 @@ std::string DoStringise(const PacketType &el)
     STRINGISE_ENUM_NAMED(ePacket_DeleteCapture, "Delete Capture");
     STRINGISE_ENUM_NAMED(ePacket_QueueCapture, "Queue Capture");
     STRINGISE_ENUM_NAMED(ePacket_NewChild, "New Child");
+    STRINGISE_ENUM_NAMED(ePacket_CaptureProgress, "Capture Progress");
+    STRINGISE_ENUM_NAMED(ePacket_FrameTimeTrigger, "Frame Time Trigger");
+    STRINGISE_ENUM_NAMED(ePacket_FrameTimeTriggerStats, "Frame Time Trigger Stats");
   }
   END_ENUM_STRINGISE();
 }
@@ -118,6 +126,7 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
   std::vector<pair<uint32_t, uint32_t> > children;
   std::map<RDCDriver, bool> drivers;
   float prevCaptureProgress = captureProgress;
+  FrameTimeTriggerStats prevTriggerStats;
 
   while(client)
   {
@@ -134,6 +143,7 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
     std::vector<CaptureData> caps = RenderDoc::Inst().GetCaptures();
     std::vector<pair<uint32_t, uint32_t> > childprocs = RenderDoc::Inst().GetChildProcesses();
+    FrameTimeTriggerStats triggerStats = RenderDoc::Inst().GetFrameTimeTriggerStats();
 
     if(curdrivers != drivers)
     {
@@ -227,6 +237,23 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
         }
       }
     }
+    else if(version >= FrameTimeTriggerProtocolVersion &&
+            (triggerStats.armed != prevTriggerStats.armed ||
+             triggerStats.capturesTriggered != prevTriggerStats.capturesTriggered ||
+             (triggerStats.armed && curtime > pingtime)))
+    {
+      // send immediately when a capture is triggered or the trigger changes state, otherwise only
+      // while armed in place of the regular ping.
+      curtime = 0;
+
+      prevTriggerStats = triggerStats;
+
+      WRITE_DATA_SCOPE();
+      {
+        SCOPED_SERIALISE_CHUNK(ePacket_FrameTimeTriggerStats);
+        SERIALISE_ELEMENT(triggerStats);
+      }
+    }
 
     if(curtime > pingtime)
     {
@@ -268,6 +295,15 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
         for(uint32_t f = 0; f < numFrames; f++)
           RenderDoc::Inst().QueueCapture(frameNum + f);
       }
+      else if(type == ePacket_FrameTimeTrigger)
+      {
+        FrameTimeTrigger trigger;
+
+        READ_DATA_SCOPE();
+        SERIALISE_ELEMENT(trigger);
+
+        RenderDoc::Inst().SetFrameTimeTrigger(trigger);
+      }
       else if(type == ePacket_DeleteCapture)
       {
         uint32_t id;
@@ -460,6 +496,7 @@ public:
     reader.SetStreamingMode(true);
 
     m_PID = 0;
+    m_Version = 0;
 
     {
       WRITE_DATA_SCOPE();
@@ -507,6 +544,8 @@ public:
 
     reader.EndChunk();
 
+    m_Version = version;
+
     if(type == ePacket_Handshake)
     {
       RDCLOG("Got remote handshake: %s [%u]", m_Target.c_str(), m_PID);
@@ -579,6 +618,25 @@ public:
       SAFE_DELETE(m_Socket);
   }
 
+  void SetFrameTimeTrigger(const FrameTimeTrigger &trigger)
+  {
+    // older targets would treat an unknown packet as an error and drop the connection
+    if(m_Version < FrameTimeTriggerProtocolVersion)
+    {
+      RDCWARN("Target doesn't support frame time triggered captures");
+      return;
+    }
+
+    WRITE_DATA_SCOPE();
+    SCOPED_SERIALISE_CHUNK(ePacket_FrameTimeTrigger);
+
+    FrameTimeTrigger settings = trigger;
+    SERIALISE_ELEMENT(settings);
+
+    if(ser.IsErrored())
+      SAFE_DELETE(m_Socket);
+  }
+
   TargetControlMessage ReceiveMessage()
   {
     TargetControlMessage msg;
@@ -653,6 +711,16 @@ public:
       reader.EndChunk();
       return msg;
     }
+    else if(type == ePacket_FrameTimeTriggerStats)
+    {
+      msg.type = TargetControlMessageType::FrameTimeTriggerStats;
+
+      READ_DATA_SCOPE();
+      SERIALISE_ELEMENT(msg.frameTimeTrigger).Named("Frame Time Trigger Stats");
+
+      reader.EndChunk();
+      return msg;
+    }
     else if(type == ePacket_NewCapture)
     {
       msg.type = TargetControlMessageType::NewCapture;
@@ -764,6 +832,7 @@ private:
   ReadSerialiser reader;
   std::string m_Target, m_API, m_BusyClient;
   uint32_t m_PID;
+  uint32_t m_Version;
 
   std::map<uint32_t, std::string> m_CaptureCopies;
 };
@@ -52,7 +52,6 @@ DECLARE_EMBED(glsl_gl_texsample_h);
 DECLARE_EMBED(glsl_vk_texsample_h);
 DECLARE_EMBED(glsl_quadresolve_frag);
 DECLARE_EMBED(glsl_quadwrite_frag);
-DECLARE_EMBED(glsl_mesh_comp);
 DECLARE_EMBED(glsl_array2ms_comp);
 DECLARE_EMBED(glsl_ms2array_comp);
 DECLARE_EMBED(glsl_deptharr2ms_frag);
@@ -467,6 +467,10 @@ bool D3D11InitParams::IsSupportedVersion(uint64_t ver)
   if(ver == CurrentVersion)
     return true;
 
+  // 0x10 -> 0x11 - large byte buffers can be stored as references into the blob store section
+  if(ver == 0x10)
+    return true;
+
   // 0x0F -> 0x10 - serialised the number of subresources in resource initial states after
   // multiplying on sample count rather than before
   if(ver == 0x0F)
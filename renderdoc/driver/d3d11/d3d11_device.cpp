@@ -992,6 +992,7 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
   ser.SetStringDatabase(&m_StringDB);
   ser.SetUserData(GetResourceManager());
+  ser.SetBlobStore(rdc->GetBlobStore());
 
   ser.ConfigureStructuredExport(&GetChunkName, storeStructuredBuffers);
 
@@ -1732,8 +1733,14 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
 
       GetResourceManager()->InsertReferencedChunks(ser);
 
+      // initial contents are large and often duplicated, so store their data in the blob store
+      if(rdc)
+        ser.SetBlobStore(rdc->GetBlobStore());
+
       GetResourceManager()->InsertInitialContentsChunks(ser);
 
+      ser.SetBlobStore(NULL);
+
       RDCDEBUG("Creating Capture Scope");
 
       GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -257,7 +257,8 @@ bool WrappedID3D11Device::Prepare_InitialState(ID3D11DeviceChild *res)
   return true;
 }
 
-uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceChild *res)
+uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceChild *res,
+                                                   const BlobStore *blobs)
 {
   // This function provides an upper bound on how much data Serialise_InitialState will write, so
   // that the chunk can be pre-allocated and not require seeking to fix-up the length.
@@ -282,7 +283,7 @@ uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceCh
     buf->GetDesc(&desc);
 
     // buffer width plus alignment
-    ret += desc.ByteWidth;
+    ret += (uint32_t)BlobStore::GetSerialisedSize(blobs, desc.ByteWidth);
     ret += (uint32_t)WriteSerialiser::GetChunkAlignment();
   }
   else if(type == Resource_Texture1D)
@@ -303,7 +304,7 @@ uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceCh
 
       const UINT RowPitch = GetByteSize(desc.Width, 1, 1, desc.Format, mip);
 
-      ret += RowPitch;
+      ret += (uint32_t)BlobStore::GetSerialisedSize(blobs, RowPitch);
       ret += (uint32_t)WriteSerialiser::GetChunkAlignment();
     }
   }
@@ -339,7 +340,7 @@ uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceCh
         if(stage)
         {
           pitch = GetResourcePitchForSubresource(m_pImmediateContext->GetReal(), stage, sub);
-          ret += pitch.m_RowPitch * numRows;
+          ret += (uint32_t)BlobStore::GetSerialisedSize(blobs, pitch.m_RowPitch * numRows);
         }
 
         ret += (uint32_t)WriteSerialiser::GetChunkAlignment();
@@ -368,7 +369,8 @@ uint32_t WrappedID3D11Device::GetSize_InitialState(ResourceId id, ID3D11DeviceCh
       if(stage)
       {
         pitch = GetResourcePitchForSubresource(m_pImmediateContext->GetReal(), stage, sub);
-        ret += pitch.m_DepthPitch * RDCMAX(1U, desc.Depth >> mip);
+        ret += (uint32_t)BlobStore::GetSerialisedSize(
+            blobs, pitch.m_DepthPitch * RDCMAX(1U, desc.Depth >> mip));
       }
 
       ret += (uint32_t)WriteSerialiser::GetChunkAlignment();
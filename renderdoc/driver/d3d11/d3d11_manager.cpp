@@ -87,9 +87,10 @@ bool D3D11ResourceManager::Prepare_InitialState(ID3D11DeviceChild *res)
   return m_Device->Prepare_InitialState(res);
 }
 
-uint32_t D3D11ResourceManager::GetSize_InitialState(ResourceId id, ID3D11DeviceChild *res)
+uint32_t D3D11ResourceManager::GetSize_InitialState(ResourceId id, ID3D11DeviceChild *res,
+                                                    const BlobStore *blobs)
 {
-  return m_Device->GetSize_InitialState(id, res);
+  return m_Device->GetSize_InitialState(id, res, blobs);
 }
 
 bool D3D11ResourceManager::Serialise_InitialState(WriteSerialiser &ser, ResourceId id,
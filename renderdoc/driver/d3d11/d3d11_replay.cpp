@@ -2839,9 +2839,9 @@ uint32_t D3D11Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
+    HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1,
+                                      cfg.position.vertexByteStride, cfg.position.format, dataEnd,
+                                      &vbData[minIndex], valid);
 
     D3D11_BOX box;
     box.top = 0;
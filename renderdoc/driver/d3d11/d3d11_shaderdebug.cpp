@@ -72,6 +72,10 @@ struct DebugHit
 // over this number of cycles and things get problematic
 #define SHADER_DEBUG_WARN_THRESHOLD 100000
 
+// number of steps between keyframe states in a trace that store the full variable contents. The
+// other states only store the registers that were changed
+#define SHADER_DEBUG_KEYFRAME_INTERVAL 64
+
 bool PromptDebugTimeout(DXBC::ProgramType prog, uint32_t cycleCounter)
 {
   string msg = StringFormat::Fmt(
@@ -91,6 +95,26 @@ bool PromptDebugTimeout(DXBC::ProgramType prog, uint32_t cycleCounter)
   return false;
 }
 
+// append a state to the trace, only storing the full variable contents on keyframes
+static void AddTraceState(ShaderDebugTrace &trace, const ShaderDebug::State &state)
+{
+  if(trace.states.size() % trace.keyframeInterval == 0)
+  {
+    trace.states.push_back(state);
+    // the full contents make the changes that led to them redundant
+    trace.states.back().changes.clear();
+    return;
+  }
+
+  ShaderDebugState delta;
+  delta.changes = state.changes;
+  delta.locals = state.locals;
+  delta.modified = state.modified;
+  delta.nextInstruction = state.nextInstruction;
+  delta.flags = state.flags;
+  trace.states.push_back(delta);
+}
+
 // apply coarse/fine derivatives to select threads within a quad to ensure all values are correct
 static void ApplyDerivatives(ShaderDebug::GlobalState &global, ShaderDebugTrace traces[4],
                              const DataOutput &initialValue, float *data, float signmul,
@@ -967,12 +991,12 @@ ShaderDebugTrace D3D11Replay::DebugVertex(uint32_t eventId, uint32_t vertid, uin
 
   State last;
 
-  vector<ShaderDebugState> states;
+  ret.keyframeInterval = SHADER_DEBUG_KEYFRAME_INTERVAL;
 
   if(dxbc->m_DebugInfo)
     dxbc->m_DebugInfo->GetLocals(0, dxbc->GetInstruction(0).offset, initialState.locals);
 
-  states.push_back((State)initialState);
+  AddTraceState(ret, initialState);
 
   D3D11MarkerRegion simloop("Simulation Loop");
 
@@ -981,7 +1005,7 @@ ShaderDebugTrace D3D11Replay::DebugVertex(uint32_t eventId, uint32_t vertid, uin
     if(initialState.Finished())
       break;
 
-    initialState = initialState.GetNext(global, NULL);
+    initialState.StepNext(global, NULL);
 
     if(dxbc->m_DebugInfo)
     {
@@ -989,7 +1013,7 @@ ShaderDebugTrace D3D11Replay::DebugVertex(uint32_t eventId, uint32_t vertid, uin
       dxbc->m_DebugInfo->GetLocals(initialState.nextInstruction, op.offset, initialState.locals);
     }
 
-    states.push_back((State)initialState);
+    AddTraceState(ret, initialState);
 
     if(cycleCounter == SHADER_DEBUG_WARN_THRESHOLD)
     {
@@ -998,8 +1022,6 @@ ShaderDebugTrace D3D11Replay::DebugVertex(uint32_t eventId, uint32_t vertid, uin
     }
   }
 
-  ret.states = states;
-
   ret.hasLocals = dxbc->m_DebugInfo && dxbc->m_DebugInfo->HasLocals();
 
   ret.lineInfo.resize(dxbc->GetNumInstructions());
@@ -2140,12 +2162,12 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position, uint prim
   SAFE_DELETE_ARRAY(initialData);
   SAFE_DELETE_ARRAY(evalData);
 
-  vector<ShaderDebugState> states;
+  traces[destIdx].keyframeInterval = SHADER_DEBUG_KEYFRAME_INTERVAL;
 
   if(dxbc->m_DebugInfo)
     dxbc->m_DebugInfo->GetLocals(0, dxbc->GetInstruction(0).offset, quad[destIdx].locals);
 
-  states.push_back((State)quad[destIdx]);
+  AddTraceState(traces[destIdx], quad[destIdx]);
 
   // ping pong between so that we can have 'current' quad to update into new one
   State quad2[4];
@@ -2187,7 +2209,7 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position, uint prim
         dxbc->m_DebugInfo->GetLocals(s.nextInstruction, op.offset, s.locals);
       }
 
-      states.push_back(s);
+      AddTraceState(traces[destIdx], s);
     }
 
     // we need to make sure that control flow which converges stays in lockstep so that
@@ -2278,8 +2300,6 @@ void ExtractInputsPS(PSInput IN, float4 debug_pixelPos : SV_Position, uint prim
     }
   } while(!finished);
 
-  traces[destIdx].states = states;
-
   traces[destIdx].hasLocals = dxbc->m_DebugInfo && dxbc->m_DebugInfo->HasLocals();
 
   traces[destIdx].lineInfo.resize(dxbc->GetNumInstructions());
@@ -2344,19 +2364,19 @@ ShaderDebugTrace D3D11Replay::DebugThread(uint32_t eventId, const uint32_t group
     initialState.semantics.ThreadID[i] = threadid[i];
   }
 
-  vector<ShaderDebugState> states;
+  ret.keyframeInterval = SHADER_DEBUG_KEYFRAME_INTERVAL;
 
   if(dxbc->m_DebugInfo)
     dxbc->m_DebugInfo->GetLocals(0, dxbc->GetInstruction(0).offset, initialState.locals);
 
-  states.push_back((State)initialState);
+  AddTraceState(ret, initialState);
 
   for(int cycleCounter = 0;; cycleCounter++)
   {
     if(initialState.Finished())
       break;
 
-    initialState = initialState.GetNext(global, NULL);
+    initialState.StepNext(global, NULL);
 
     if(dxbc->m_DebugInfo)
     {
@@ -2364,7 +2384,7 @@ ShaderDebugTrace D3D11Replay::DebugThread(uint32_t eventId, const uint32_t group
       dxbc->m_DebugInfo->GetLocals(initialState.nextInstruction, op.offset, initialState.locals);
     }
 
-    states.push_back((State)initialState);
+    AddTraceState(ret, initialState);
 
     if(cycleCounter == SHADER_DEBUG_WARN_THRESHOLD)
     {
@@ -2373,8 +2393,6 @@ ShaderDebugTrace D3D11Replay::DebugThread(uint32_t eventId, const uint32_t group
     }
   }
 
-  ret.states = states;
-
   ret.hasLocals = dxbc->m_DebugInfo && dxbc->m_DebugInfo->HasLocals();
 
   ret.lineInfo.resize(dxbc->GetNumInstructions());
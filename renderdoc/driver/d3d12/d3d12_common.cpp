@@ -159,7 +159,7 @@ bool D3D12InitParams::IsSupportedVersion(uint64_t ver)
     return true;
 
   // see header for explanation of version changes
-  if(ver == 0x4)
+  if(ver == 0x4 || ver == 0x5)
     return true;
 
   return false;
@@ -1672,8 +1672,14 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->InsertReferencedChunks(ser);
 
+    // initial contents are large and often duplicated, so store their data in the blob store
+    if(rdc)
+      ser.SetBlobStore(rdc->GetBlobStore());
+
     GetResourceManager()->InsertInitialContentsChunks(ser);
 
+    ser.SetBlobStore(NULL);
+
     RDCDEBUG("Creating Capture Scope");
 
     GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -2629,6 +2635,7 @@ ReplayStatus WrappedID3D12Device::ReadLogInitialisation(RDCFile *rdc, bool store
 
   ser.SetStringDatabase(&m_StringDB);
   ser.SetUserData(GetResourceManager());
+  ser.SetBlobStore(rdc->GetBlobStore());
 
   ser.ConfigureStructuredExport(&GetChunkName, storeStructuredBuffers);
 
@@ -248,7 +248,8 @@ bool D3D12ResourceManager::Prepare_InitialState(ID3D12DeviceChild *res)
   return false;
 }
 
-uint32_t D3D12ResourceManager::GetSize_InitialState(ResourceId id, ID3D12DeviceChild *res)
+uint32_t D3D12ResourceManager::GetSize_InitialState(ResourceId id, ID3D12DeviceChild *res,
+                                                    const BlobStore *blobs)
 {
   D3D12ResourceRecord *record = GetResourceRecord(id);
   D3D12InitialContents initContents = GetInitialContents(id);
@@ -276,7 +277,7 @@ uint32_t D3D12ResourceManager::GetSize_InitialState(ResourceId id, ID3D12DeviceC
     }
 
     return (uint32_t)WriteSerialiser::GetChunkAlignment() + 16 +
-           uint32_t(buf ? buf->GetDesc().Width : 0);
+           (uint32_t)BlobStore::GetSerialisedSize(blobs, buf ? buf->GetDesc().Width : 0);
   }
   else
   {
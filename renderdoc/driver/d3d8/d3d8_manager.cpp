@@ -61,7 +61,8 @@ bool D3D8ResourceManager::Prepare_InitialState(IUnknown *res)
   return false;
 }
 
-uint32_t D3D8ResourceManager::GetSize_InitialState(ResourceId id, IUnknown *res)
+uint32_t D3D8ResourceManager::GetSize_InitialState(ResourceId id, IUnknown *res,
+                                                   const BlobStore *blobs)
 {
   // TODO
   return 128;
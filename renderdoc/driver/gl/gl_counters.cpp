@@ -248,9 +248,19 @@ void GLReplay::FillTimers(GLCounterContext &ctx, const DrawcallDescription &draw
 
       for(uint32_t c = 0; c < counters.size(); c++)
       {
-        m_pDriver->glGenQueries(1, &queries->obj[(uint32_t)counters[c]]);
+        uint32_t q = (uint32_t)counters[c];
+
+        // re-use a query object from a previous fetch if there is one
+        if(!DebugData.counterQueries[q].empty())
+        {
+          queries->obj[q] = DebugData.counterQueries[q].back();
+          DebugData.counterQueries[q].pop_back();
+          continue;
+        }
+
+        m_pDriver->glGenQueries(1, &queries->obj[q]);
         if(m_pDriver->glGetError())
-          queries->obj[(uint32_t)counters[c]] = 0;
+          queries->obj[q] = 0;
       }
     }
 
@@ -439,10 +449,12 @@ vector<CounterResult> GLReplay::FetchCounters(const vector<GPUCounter> &allCount
 
   m_pDriver->glBindBuffer(eGL_QUERY_BUFFER, prevbind);
 
+  // keep the query objects to re-use next time, since counters are often fetched repeatedly
   for(size_t i = 0; i < ctx.queries.size(); i++)
     for(uint32_t c = 0; c < counters.size(); c++)
       if(ctx.queries[i].obj[(uint32_t)counters[c]])
-        m_pDriver->glDeleteQueries(1, &ctx.queries[i].obj[(uint32_t)counters[c]]);
+        DebugData.counterQueries[(uint32_t)counters[c]].push_back(
+            ctx.queries[i].obj[(uint32_t)counters[c]]);
 
   return ret;
 }
@@ -1815,6 +1815,8 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
     if(bbim == NULL)
       bbim = SaveBackbufferImage();
 
+    bbim->WaitForEncode();
+
     RDCFile *rdc =
         RenderDoc::Inst().CreateRDC(GetDriverType(), m_CapturedFrames.back().frameNumber,
                                     bbim->jpgbuf, bbim->len, bbim->thwidth, bbim->thheight);
@@ -1871,8 +1873,14 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
 
       GetResourceManager()->InsertReferencedChunks(ser);
 
+      // initial contents are large and often duplicated, so store their data in the blob store
+      if(rdc)
+        ser.SetBlobStore(rdc->GetBlobStore());
+
       GetResourceManager()->InsertInitialContentsChunks(ser);
 
+      ser.SetBlobStore(NULL);
+
       RDCDEBUG("Creating Capture Scope");
 
       GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -2024,7 +2032,7 @@ void WrappedOpenGL::FirstFrame(void *ctx, void *wndHandle)
 
 WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
 {
-  const uint16_t maxSize = 2048;
+  const uint16_t maxSize = 1024;
 
   byte *thpixels = NULL;
   uint16_t thwidth = 0;
@@ -2058,6 +2066,60 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     thwidth = (uint16_t)m_InitParams.width;
     thheight = (uint16_t)m_InitParams.height;
 
+    uint16_t resample_width = RDCMIN(maxSize, thwidth);
+    resample_width &= ~3;    // JPEG encoder gives shear distortion if width is not divisible by 4.
+
+    // if we can, downscale and flip with a filtered blit on the GPU so that only the thumbnail
+    // sized image is read back. Multisampled backbuffers can't be blitted with scaling.
+    bool gpuResample = thwidth != resample_width && m_InitParams.multiSamples <= 1 &&
+                       GL.glBlitFramebuffer && GL.glGenFramebuffers && GL.glGenRenderbuffers &&
+                       GL.glBindRenderbuffer && GL.glRenderbufferStorage &&
+                       GL.glFramebufferRenderbuffer && GL.glDeleteFramebuffers &&
+                       GL.glDeleteRenderbuffers;
+
+    GLuint thumbFB = 0;
+    GLuint thumbRB = 0;
+    GLint prevDrawBuf = 0;
+    GLint prevRenderbuf = 0;
+    GLboolean prevFBSRGB = GL_FALSE;
+
+    if(gpuResample)
+    {
+      uint16_t srcwidth = thwidth;
+      uint16_t srcheight = thheight;
+
+      thwidth = resample_width;
+      thheight = uint16_t(float(thwidth) * float(srcheight) / float(srcwidth));
+
+      GL.glGetIntegerv(eGL_DRAW_FRAMEBUFFER_BINDING, &prevDrawBuf);
+      GL.glGetIntegerv(eGL_RENDERBUFFER_BINDING, &prevRenderbuf);
+      if(HasExt[EXT_framebuffer_sRGB])
+        prevFBSRGB = GL.glIsEnabled(eGL_FRAMEBUFFER_SRGB);
+
+      GL.glGenRenderbuffers(1, &thumbRB);
+      GL.glBindRenderbuffer(eGL_RENDERBUFFER, thumbRB);
+      GL.glRenderbufferStorage(eGL_RENDERBUFFER, eGL_RGBA8, thwidth, thheight);
+
+      GL.glGenFramebuffers(1, &thumbFB);
+      GL.glBindFramebuffer(eGL_DRAW_FRAMEBUFFER, thumbFB);
+      GL.glFramebufferRenderbuffer(eGL_DRAW_FRAMEBUFFER, eGL_COLOR_ATTACHMENT0, eGL_RENDERBUFFER,
+                                   thumbRB);
+
+      // the blit must copy the raw backbuffer values, like a readback would
+      if(prevFBSRGB)
+        GL.glDisable(eGL_FRAMEBUFFER_SRGB);
+
+      // GL's origin is bottom-left so flip vertically unless the backbuffer is already flipped
+      GLint dstY0 = m_InitParams.isYFlipped ? 0 : thheight;
+      GLint dstY1 = m_InitParams.isYFlipped ? thheight : 0;
+
+      SafeBlitFramebuffer(0, 0, srcwidth, srcheight, 0, dstY0, thwidth, dstY1, GL_COLOR_BUFFER_BIT,
+                          eGL_LINEAR);
+
+      GL.glBindFramebuffer(eGL_READ_FRAMEBUFFER, thumbFB);
+      GL.glReadBuffer(eGL_COLOR_ATTACHMENT0);
+    }
+
     thpixels = new byte[thwidth * thheight * 4];
 
     // GLES only supports GL_RGBA
@@ -2075,7 +2137,7 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     }
 
     // flip the image in-place
-    if(!m_InitParams.isYFlipped)
+    if(!gpuResample && !m_InitParams.isYFlipped)
     {
       for(uint16_t y = 0; y <= thheight / 2; y++)
       {
@@ -2099,6 +2161,17 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
       }
     }
 
+    if(gpuResample)
+    {
+      GL.glBindFramebuffer(eGL_DRAW_FRAMEBUFFER, prevDrawBuf);
+      GL.glBindRenderbuffer(eGL_RENDERBUFFER, prevRenderbuf);
+      if(prevFBSRGB)
+        GL.glEnable(eGL_FRAMEBUFFER_SRGB);
+
+      GL.glDeleteFramebuffers(1, &thumbFB);
+      GL.glDeleteRenderbuffers(1, &thumbRB);
+    }
+
     GL.glBindBuffer(eGL_PIXEL_PACK_BUFFER, packBufBind);
     GL.glBindFramebuffer(eGL_READ_FRAMEBUFFER, prevBuf);
     GL.glReadBuffer(prevReadBuf);
@@ -2107,9 +2180,7 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     GL.glPixelStorei(eGL_PACK_SKIP_PIXELS, prevPackSkipPixels);
     GL.glPixelStorei(eGL_PACK_ALIGNMENT, prevPackAlignment);
 
-    // scale down if necessary using simple point sampling
-    uint16_t resample_width = RDCMIN(maxSize, thwidth);
-    resample_width &= ~3;    // JPEG encoder gives shear distortion if width is not divisible by 4.
+    // otherwise scale down if necessary using simple point sampling
     if(thwidth != resample_width)
     {
       float widthf = float(thwidth);
@@ -2145,7 +2216,10 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     }
   }
 
-  byte *jpgbuf = NULL;
+  BackbufferImage *bbim = new BackbufferImage();
+  bbim->thwidth = thwidth;
+  bbim->thheight = thheight;
+
   int len = thwidth * thheight;
 
   if(len > 0)
@@ -2153,30 +2227,38 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     // jpge::compress_image_to_jpeg_file_in_memory requires at least 1024 bytes
     len = len >= 1024 ? len : 1024;
 
-    jpgbuf = new byte[len];
+    bbim->jpgbuf = new byte[len];
+    bbim->len = len;
 
-    jpge::params p;
-    p.m_quality = 80;
+    // encode off this thread, the image isn't needed until the capture file is written
+    bbim->encodeThread = Threading::CreateThread([bbim, thpixels]() {
+      jpge::params p;
+      p.m_quality = 80;
 
-    bool success =
-        jpge::compress_image_to_jpeg_file_in_memory(jpgbuf, len, thwidth, thheight, 3, thpixels, p);
+      int jpglen = (int)bbim->len;
 
-    if(!success)
-    {
-      RDCERR("Failed to compress to jpg");
-      SAFE_DELETE_ARRAY(jpgbuf);
-      thwidth = 0;
-      thheight = 0;
-    }
-  }
+      bool success = jpge::compress_image_to_jpeg_file_in_memory(
+          bbim->jpgbuf, jpglen, bbim->thwidth, bbim->thheight, 3, thpixels, p);
 
-  SAFE_DELETE_ARRAY(thpixels);
+      if(success)
+      {
+        bbim->len = (size_t)jpglen;
+      }
+      else
+      {
+        RDCERR("Failed to compress to jpg");
+        SAFE_DELETE_ARRAY(bbim->jpgbuf);
+        bbim->thwidth = 0;
+        bbim->thheight = 0;
+      }
 
-  BackbufferImage *bbim = new BackbufferImage();
-  bbim->jpgbuf = jpgbuf;
-  bbim->len = len;
-  bbim->thwidth = thwidth;
-  bbim->thheight = thheight;
+      delete[] thpixels;
+    });
+  }
+  else
+  {
+    SAFE_DELETE_ARRAY(thpixels);
+  }
 
   return bbim;
 }
@@ -2607,6 +2689,7 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   ser.SetStringDatabase(&m_StringDB);
   ser.SetUserData(GetResourceManager());
+  ser.SetBlobStore(rdc->GetBlobStore());
 
   ser.ConfigureStructuredExport(&GetChunkName, storeStructuredBuffers);
 
@@ -4309,6 +4392,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
   uint64_t startOffset = ser.GetReader()->GetOffset();
 
+  ReplayProfiler &profiler = RenderDoc::Inst().GetReplayProfiler();
+
   for(;;)
   {
     if(IsActiveReplaying(m_State) && m_CurEventID > endEventID)
@@ -4319,6 +4404,9 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    uint64_t profileStart = profiler.Begin();
+    uint32_t profileEventID = m_CurEventID;
+
     GLChunk chunktype = ser.ReadChunk<GLChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -4330,6 +4418,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
     ser.EndChunk();
 
+    profiler.End(profileStart, (uint32_t)chunktype, profileEventID, &GetChunkName);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -4792,8 +4882,15 @@ void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, Replay
 
   if(!partial)
   {
-    GLMarkerRegion apply("!!!!RenderDoc Internal: ApplyInitialContents");
-    GetResourceManager()->ApplyInitialContents();
+    ReplayProfiler &profiler = RenderDoc::Inst().GetReplayProfiler();
+    uint64_t profileStart = profiler.Begin();
+
+    {
+      GLMarkerRegion apply("!!!!RenderDoc Internal: ApplyInitialContents");
+      GetResourceManager()->ApplyInitialContents();
+    }
+
+    profiler.End(profileStart, (uint32_t)SystemChunk::InitialContents, 0, &GetChunkName);
 
     m_WasActiveFeedback = false;
   }
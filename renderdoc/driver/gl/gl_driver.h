@@ -54,7 +54,7 @@ struct GLInitParams
   bool isYFlipped;
 
   // check if a frame capture section version is supported
-  static const uint64_t CurrentVersion = 0x1D;
+  static const uint64_t CurrentVersion = 0x1E;
   static bool IsSupportedVersion(uint64_t ver);
 };
 
@@ -388,6 +388,8 @@ private:
 
     ResourceId m_ContextDataResourceID;
     GLResourceRecord *m_ContextDataRecord;
+
+    GLShadowState m_ShadowState;
   };
 
   struct ClientMemoryData
@@ -446,12 +448,27 @@ private:
 
   struct BackbufferImage
   {
-    BackbufferImage() : jpgbuf(NULL), len(0), thwidth(0), thheight(0) {}
-    ~BackbufferImage() { SAFE_DELETE_ARRAY(jpgbuf); }
+    BackbufferImage() : jpgbuf(NULL), len(0), thwidth(0), thheight(0), encodeThread(0) {}
+    ~BackbufferImage()
+    {
+      WaitForEncode();
+      SAFE_DELETE_ARRAY(jpgbuf);
+    }
+    // the JPEG is encoded on a worker thread, this must be called before using the results
+    void WaitForEncode()
+    {
+      if(encodeThread)
+      {
+        Threading::JoinThread(encodeThread);
+        Threading::CloseThread(encodeThread);
+        encodeThread = 0;
+      }
+    }
     byte *jpgbuf;
     size_t len;
     uint16_t thwidth;
     uint16_t thheight;
+    Threading::ThreadHandle encodeThread;
   };
 
   BackbufferImage *SaveBackbufferImage();
@@ -489,6 +506,7 @@ public:
   GLInitParams &GetInitParams() { return m_InitParams; }
   ContextPair &GetCtx();
   GLResourceRecord *GetContextRecord();
+  GLShadowState &GetShadowState() { return GetCtxData().m_ShadowState; }
 
   void *ShareCtx(void *ctx) { return ctx ? m_ContextData[ctx].shareGroup : NULL; }
   void SetStructuredExport(uint64_t sectionVersion)
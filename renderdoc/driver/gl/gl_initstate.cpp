@@ -981,13 +981,14 @@ bool GLResourceManager::Force_InitialState(GLResource res, bool prepare)
   return false;
 }
 
-uint32_t GLResourceManager::GetSize_InitialState(ResourceId resid, GLResource res)
+uint32_t GLResourceManager::GetSize_InitialState(ResourceId resid, GLResource res,
+                                                const BlobStore *blobs)
 {
   if(res.Namespace == eResBuffer)
   {
     // buffers just have their contents, no metadata needed
-    return GetInitialContents(resid).bufferLength + (uint32_t)WriteSerialiser::GetChunkAlignment() +
-           16;
+    return (uint32_t)BlobStore::GetSerialisedSize(blobs, GetInitialContents(resid).bufferLength) +
+           (uint32_t)WriteSerialiser::GetChunkAlignment() + 16;
   }
   else if(res.Namespace == eResProgram)
   {
@@ -1056,7 +1057,8 @@ uint32_t GLResourceManager::GetSize_InitialState(ResourceId resid, GLResource re
         targetcount = 6;
 
       for(int t = 0; t < targetcount; t++)
-        ret += (uint32_t)WriteSerialiser::GetChunkAlignment() + size;
+        ret += (uint32_t)WriteSerialiser::GetChunkAlignment() +
+               (uint32_t)BlobStore::GetSerialisedSize(blobs, size);
     }
 
     return ret;
@@ -2227,6 +2229,8 @@ void GLResourceManager::Apply_InitialState(GLResource live, GLInitialContents in
 
       GL.glBindVertexArray(live.name);
 
+      m_Driver->GetShadowState().DirtyVertexArray(live.name);
+
       for(GLuint i = 0; i < 16; i++)
       {
         const VertexAttribInitialData &attrib = data.VertexAttribs[i];
@@ -34,6 +34,8 @@ void GLReplay::ClearPostVSCache()
 {
   WrappedOpenGL &drv = *m_pDriver;
 
+  m_MeshPick.Invalidate();
+
   for(auto it = m_PostVSData.begin(); it != m_PostVSData.end(); ++it)
   {
     drv.glDeleteBuffers(1, &it->second.vsout.buf);
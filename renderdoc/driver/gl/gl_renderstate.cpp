@@ -26,6 +26,10 @@
 #include "gl_renderstate.h"
 #include "gl_driver.h"
 
+// enable this to cross-check state read from the shadow against real queries, to catch any path
+// that changes state on the driver without updating the shadow.
+#define VALIDATE_SHADOW_STATE OPTION_OFF
+
 struct EnableDisableCap
 {
   GLenum cap;
@@ -710,6 +714,112 @@ bool GLRenderState::CheckEnableDisableParam(GLenum pname)
   return true;
 }
 
+GLShadowState::GLShadowState()
+{
+  EnabledValid = false;
+  RDCEraseEl(Enabled);
+}
+
+void GLShadowState::SetEnabled(GLenum cap, bool enabled)
+{
+  if(!EnabledValid)
+    return;
+
+  for(GLuint i = 0; i < GLRenderState::eEnabled_Count; i++)
+  {
+    if(enable_disable_cap[i].cap == cap)
+    {
+      // unsupported caps are rejected by the driver and always read back as disabled
+      Enabled[i] = enabled && GLRenderState::CheckEnableDisableParam(cap);
+      return;
+    }
+  }
+}
+
+GLint GLShadowState::GetLimit(GLenum pname)
+{
+  auto it = m_Limits.find(pname);
+  if(it != m_Limits.end())
+    return it->second;
+
+  GLint value = 0;
+  GL.glGetIntegerv(pname, &value);
+  m_Limits[pname] = value;
+  return value;
+}
+
+void GLVertexArrayShadow::Fetch(GLuint numAttribs, GLuint numBindings)
+{
+  attribs.resize(numAttribs);
+  bindings.resize(numBindings);
+
+  for(GLuint i = 0; i < numBindings; i++)
+  {
+    Binding &b = bindings[i];
+
+    b.buffer = GetBoundVertexBuffer(i);
+    GL.glGetIntegeri_v(eGL_VERTEX_BINDING_STRIDE, i, &b.stride);
+    GL.glGetIntegeri_v(eGL_VERTEX_BINDING_OFFSET, i, &b.offset);
+    GL.glGetIntegeri_v(eGL_VERTEX_BINDING_DIVISOR, i, &b.divisor);
+  }
+
+  for(GLuint i = 0; i < numAttribs; i++)
+  {
+    Attrib &a = attribs[i];
+
+    a.type = eGL_FLOAT;
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_ENABLED, &a.enabled);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_BINDING, &a.binding);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_RELATIVE_OFFSET, &a.relativeOffset);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_SIZE, &a.size);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_TYPE, (GLint *)&a.type);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &a.normalized);
+    GL.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_INTEGER, &a.integer);
+  }
+}
+
+const GLVertexArrayShadow &GLShadowState::GetVertexArray(GLuint vao)
+{
+  GLuint numAttribs = (GLuint)GetLimit(eGL_MAX_VERTEX_ATTRIBS);
+  GLuint numBindings = (GLuint)GetLimit(HasExt[ARB_vertex_attrib_binding]
+                                            ? eGL_MAX_VERTEX_ATTRIB_BINDINGS
+                                            : eGL_MAX_VERTEX_ATTRIBS);
+
+  auto it = m_VertexArrays.find(vao);
+  if(it == m_VertexArrays.end())
+  {
+    GLVertexArrayShadow &ret = m_VertexArrays[vao];
+    ret.Fetch(numAttribs, numBindings);
+    return ret;
+  }
+
+#if ENABLED(VALIDATE_SHADOW_STATE)
+  GLVertexArrayShadow real;
+  real.Fetch(numAttribs, numBindings);
+
+  if(memcmp(real.attribs.data(), it->second.attribs.data(),
+            numAttribs * sizeof(GLVertexArrayShadow::Attrib)) != 0 ||
+     memcmp(real.bindings.data(), it->second.bindings.data(),
+            numBindings * sizeof(GLVertexArrayShadow::Binding)) != 0)
+  {
+    RDCERR("Shadowed state for VAO %u doesn't match driver - missing DirtyVertexArray()", vao);
+    it->second = real;
+  }
+#endif
+
+  return it->second;
+}
+
+void GLShadowState::DirtyVertexArray(GLuint vao)
+{
+  m_VertexArrays.erase(vao);
+}
+
+void GLShadowState::DirtyVertexArrays()
+{
+  m_VertexArrays.clear();
+}
+
 void GLRenderState::FetchState(WrappedOpenGL *driver)
 {
   ContextPair &ctx = driver->GetCtx();
@@ -720,21 +830,49 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
     return;
   }
 
-  for(GLuint i = 0; i < eEnabled_Count; i++)
+  GLShadowState &shadow = driver->GetShadowState();
+
+  if(shadow.EnabledValid)
   {
-    if(!CheckEnableDisableParam(enable_disable_cap[i].cap))
+    memcpy(Enabled, shadow.Enabled, sizeof(Enabled));
+
+#if ENABLED(VALIDATE_SHADOW_STATE)
+    for(GLuint i = 0; i < eEnabled_Count; i++)
     {
-      Enabled[i] = false;
-      continue;
+      if(!CheckEnableDisableParam(enable_disable_cap[i].cap))
+        continue;
+
+      bool real = (GL.glIsEnabled(enable_disable_cap[i].cap) == GL_TRUE);
+
+      if(real != Enabled[i])
+      {
+        RDCERR("Shadowed %s is %s but driver reports %s", enable_disable_cap[i].name,
+               Enabled[i] ? "enabled" : "disabled", real ? "enabled" : "disabled");
+        Enabled[i] = shadow.Enabled[i] = real;
+      }
+    }
+#endif
+  }
+  else
+  {
+    for(GLuint i = 0; i < eEnabled_Count; i++)
+    {
+      if(!CheckEnableDisableParam(enable_disable_cap[i].cap))
+      {
+        Enabled[i] = false;
+        continue;
+      }
+
+      Enabled[i] = (GL.glIsEnabled(enable_disable_cap[i].cap) == GL_TRUE);
     }
 
-    Enabled[i] = (GL.glIsEnabled(enable_disable_cap[i].cap) == GL_TRUE);
+    memcpy(shadow.Enabled, Enabled, sizeof(Enabled));
+    shadow.EnabledValid = true;
   }
 
   GL.glGetIntegerv(eGL_ACTIVE_TEXTURE, (GLint *)&ActiveTexture);
 
-  GLuint maxTextures = 0;
-  GL.glGetIntegerv(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, (GLint *)&maxTextures);
+  GLuint maxTextures = (GLuint)shadow.GetLimit(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
 
   RDCCOMPILE_ASSERT(
       sizeof(Tex1D) == sizeof(Tex2D) && sizeof(Tex2D) == sizeof(Tex3D) &&
@@ -812,8 +950,7 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
 
   if(HasExt[ARB_shader_image_load_store])
   {
-    GLuint maxImages = 0;
-    GL.glGetIntegerv(eGL_MAX_IMAGE_UNITS, (GLint *)&maxImages);
+    GLuint maxImages = (GLuint)shadow.GetLimit(eGL_MAX_IMAGE_UNITS);
 
     for(GLuint i = 0; i < RDCMIN(maxImages, (GLuint)ARRAY_COUNT(Images)); i++)
     {
@@ -853,8 +990,7 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
   // no way to query for the type so we just have to hope for the best and hope most people are
   // sane and don't use these except for a default "all 0s" attrib.
 
-  GLuint maxNumAttribs = 0;
-  GL.glGetIntegerv(eGL_MAX_VERTEX_ATTRIBS, (GLint *)&maxNumAttribs);
+  GLuint maxNumAttribs = (GLuint)shadow.GetLimit(eGL_MAX_VERTEX_ATTRIBS);
   for(GLuint i = 0; i < RDCMIN(maxNumAttribs, (GLuint)ARRAY_COUNT(GenericVertexAttribs)); i++)
     GL.glGetVertexAttribfv(i, eGL_CURRENT_VERTEX_ATTRIB, &GenericVertexAttribs[i].x);
 
@@ -1013,8 +1149,7 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
     if(idxBufs[b].binding == eGL_TRANSFORM_FEEDBACK_BUFFER_BINDING && !HasExt[ARB_transform_feedback2])
       continue;
 
-    GLint maxCount = 0;
-    GL.glGetIntegerv(idxBufs[b].maxcount, &maxCount);
+    GLint maxCount = shadow.GetLimit(idxBufs[b].maxcount);
     for(int i = 0; i < idxBufs[b].count && i < maxCount; i++)
     {
       // buffers are always shared
@@ -1026,8 +1161,7 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
     }
   }
 
-  GLuint maxDraws = 0;
-  GL.glGetIntegerv(eGL_MAX_DRAW_BUFFERS, (GLint *)&maxDraws);
+  GLuint maxDraws = (GLuint)shadow.GetLimit(eGL_MAX_DRAW_BUFFERS);
 
   if(HasExt[ARB_draw_buffers_blend])
   {
@@ -1068,8 +1202,7 @@ void GLRenderState::FetchState(WrappedOpenGL *driver)
 
   if(HasExt[ARB_viewport_array])
   {
-    GLuint maxViews = 0;
-    GL.glGetIntegerv(eGL_MAX_VIEWPORTS, (GLint *)&maxViews);
+    GLuint maxViews = (GLuint)shadow.GetLimit(eGL_MAX_VIEWPORTS);
 
     for(GLuint i = 0; i < RDCMIN(maxViews, (GLuint)ARRAY_COUNT(Viewports)); i++)
       GL.glGetFloati_v(eGL_VIEWPORT, i, &Viewports[i].x);
@@ -1296,19 +1429,28 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
   if(!ContextPresent || ctx.ctx == NULL)
     return;
 
+  GLShadowState &shadow = driver->GetShadowState();
+
   for(GLuint i = 0; i < eEnabled_Count; i++)
   {
     if(!CheckEnableDisableParam(enable_disable_cap[i].cap))
+    {
+      shadow.Enabled[i] = false;
       continue;
+    }
 
     if(Enabled[i])
       GL.glEnable(enable_disable_cap[i].cap);
     else
       GL.glDisable(enable_disable_cap[i].cap);
+
+    shadow.Enabled[i] = Enabled[i];
   }
 
-  GLuint maxTextures = 0;
-  GL.glGetIntegerv(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, (GLint *)&maxTextures);
+  // every capability we track has now been set, so the shadow is known to be correct
+  shadow.EnabledValid = true;
+
+  GLuint maxTextures = (GLuint)shadow.GetLimit(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
 
   for(GLuint i = 0; i < RDCMIN(maxTextures, (GLuint)ARRAY_COUNT(Tex2D)); i++)
   {
@@ -1348,8 +1490,7 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
 
   if(HasExt[ARB_shader_image_load_store])
   {
-    GLuint maxImages = 0;
-    GL.glGetIntegerv(eGL_MAX_IMAGE_UNITS, (GLint *)&maxImages);
+    GLuint maxImages = (GLuint)shadow.GetLimit(eGL_MAX_IMAGE_UNITS);
 
     for(GLuint i = 0; i < RDCMIN(maxImages, (GLuint)ARRAY_COUNT(Images)); i++)
     {
@@ -1374,8 +1515,7 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
 
   // See FetchState(). The spec says that you have to SET the right format for the shader too,
   // but we couldn't query for the format so we can't set it here.
-  GLuint maxNumAttribs = 0;
-  GL.glGetIntegerv(eGL_MAX_VERTEX_ATTRIBS, (GLint *)&maxNumAttribs);
+  GLuint maxNumAttribs = (GLuint)shadow.GetLimit(eGL_MAX_VERTEX_ATTRIBS);
   for(GLuint i = 0; i < RDCMIN(maxNumAttribs, (GLuint)ARRAY_COUNT(GenericVertexAttribs)); i++)
     GL.glVertexAttrib4fv(i, &GenericVertexAttribs[i].x);
 
@@ -1472,8 +1612,7 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
     if(idxBufs[b].binding == eGL_TRANSFORM_FEEDBACK_BUFFER && !HasExt[ARB_transform_feedback2])
       continue;
 
-    GLint maxCount = 0;
-    GL.glGetIntegerv(idxBufs[b].maxcount, &maxCount);
+    GLint maxCount = shadow.GetLimit(idxBufs[b].maxcount);
     for(int i = 0; i < idxBufs[b].count && i < maxCount; i++)
     {
       if(idxBufs[b].bufs[i].res.name == 0 ||
@@ -1485,8 +1624,7 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
     }
   }
 
-  GLuint maxDraws = 0;
-  GL.glGetIntegerv(eGL_MAX_DRAW_BUFFERS, (GLint *)&maxDraws);
+  GLuint maxDraws = (GLuint)shadow.GetLimit(eGL_MAX_DRAW_BUFFERS);
 
   if(HasExt[ARB_draw_buffers_blend])
   {
@@ -1526,8 +1664,7 @@ void GLRenderState::ApplyState(WrappedOpenGL *driver)
 
   if(HasExt[ARB_viewport_array])
   {
-    GLuint maxViews = 0;
-    GL.glGetIntegerv(eGL_MAX_VIEWPORTS, (GLint *)&maxViews);
+    GLuint maxViews = (GLuint)shadow.GetLimit(eGL_MAX_VIEWPORTS);
 
     GL.glViewportArrayv(0, RDCMIN(maxViews, (GLuint)ARRAY_COUNT(Viewports)), &Viewports[0].x);
 
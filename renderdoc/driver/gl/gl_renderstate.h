@@ -300,7 +300,69 @@ struct GLRenderState
   PixelUnpackState Unpack;
 
 private:
-  bool CheckEnableDisableParam(GLenum pname);
+  friend struct GLShadowState;
+
+  static bool CheckEnableDisableParam(GLenum pname);
+};
+
+// vertex input state of one vertex array object, laid out as the per-attribute and per-binding
+// queries return it.
+struct GLVertexArrayShadow
+{
+  struct Attrib
+  {
+    GLint enabled;
+    GLint binding;
+    GLint relativeOffset;
+    GLint size;
+    GLenum type;
+    GLint normalized;
+    GLint integer;
+  };
+
+  struct Binding
+  {
+    GLuint buffer;
+    GLint stride;
+    GLint offset;
+    GLint divisor;
+  };
+
+  std::vector<Attrib> attribs;
+  std::vector<Binding> bindings;
+
+  // queries the state of the currently bound VAO
+  void Fetch(GLuint numAttribs, GLuint numBindings);
+};
+
+// shadow copy of parts of a context's state that we can track as it's set, so that FetchState
+// doesn't have to query it back from the driver every time. One of these is kept per context.
+struct GLShadowState
+{
+  GLShadowState();
+
+  // must be called wherever a capability is enabled or disabled on the real driver, other than
+  // from GLRenderState itself.
+  void SetEnabled(GLenum cap, bool enabled);
+
+  // implementation limits never change for a context, so they're only queried once
+  GLint GetLimit(GLenum pname);
+
+  // returns the vertex input state of vao, which must be currently bound. It's queried the first
+  // time and then cached until DirtyVertexArray is called for that VAO, which must happen wherever
+  // a replayed chunk or the initial state modifies it.
+  const GLVertexArrayShadow &GetVertexArray(GLuint vao);
+  void DirtyVertexArray(GLuint vao);
+  // for changes that can touch any VAO, like buffer deletion unbinding the deleted buffers
+  void DirtyVertexArrays();
+
+  // false until Enabled has been seeded by a real query or a full ApplyState
+  bool EnabledValid;
+  bool Enabled[GLRenderState::eEnabled_Count];
+
+private:
+  std::map<GLenum, GLint> m_Limits;
+  std::map<GLuint, GLVertexArrayShadow> m_VertexArrays;
 };
 
 DECLARE_REFLECTION_STRUCT(GLRenderState::Image);
@@ -677,6 +677,28 @@ string GLReplay::DisassembleShader(ResourceId pipeline, const ShaderReflection *
   return StringFormat::Fmt("; Invalid disassembly target %s", target.c_str());
 }
 
+// looks up the texture bound to a unit in already-fetched state, instead of querying it again
+static GLuint GetBoundTexture(const GLRenderState &rs, GLenum binding, GLint unit)
+{
+  switch(binding)
+  {
+    case eGL_TEXTURE_BINDING_1D: return rs.Tex1D[unit].name;
+    case eGL_TEXTURE_BINDING_1D_ARRAY: return rs.Tex1DArray[unit].name;
+    case eGL_TEXTURE_BINDING_2D: return rs.Tex2D[unit].name;
+    case eGL_TEXTURE_BINDING_2D_ARRAY: return rs.Tex2DArray[unit].name;
+    case eGL_TEXTURE_BINDING_2D_MULTISAMPLE: return rs.Tex2DMS[unit].name;
+    case eGL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY: return rs.Tex2DMSArray[unit].name;
+    case eGL_TEXTURE_BINDING_RECTANGLE: return rs.TexRect[unit].name;
+    case eGL_TEXTURE_BINDING_3D: return rs.Tex3D[unit].name;
+    case eGL_TEXTURE_BINDING_CUBE_MAP: return rs.TexCube[unit].name;
+    case eGL_TEXTURE_BINDING_CUBE_MAP_ARRAY: return rs.TexCubeArray[unit].name;
+    case eGL_TEXTURE_BINDING_BUFFER: return rs.TexBuffer[unit].name;
+    default: break;
+  }
+
+  return 0;
+}
+
 void GLReplay::SavePipelineState()
 {
   GLPipe::State &pipe = m_CurPipelineState;
@@ -702,58 +724,47 @@ void GLReplay::SavePipelineState()
                                       : rs.PrimitiveRestartIndex;
 
   // Vertex buffers and attributes
-  GLint numVBufferBindings = 16;
-  drv.glGetIntegerv(eGL_MAX_VERTEX_ATTRIB_BINDINGS, &numVBufferBindings);
+  GLShadowState &shadow = drv.GetShadowState();
 
-  GLint numVAttribBindings = 16;
-  drv.glGetIntegerv(eGL_MAX_VERTEX_ATTRIBS, &numVAttribBindings);
+  const GLVertexArrayShadow &vao = shadow.GetVertexArray(rs.VAO.name);
 
-  pipe.vertexInput.vertexBuffers.resize(numVBufferBindings);
-  pipe.vertexInput.attributes.resize(numVAttribBindings);
+  pipe.vertexInput.vertexBuffers.resize(vao.bindings.size());
+  pipe.vertexInput.attributes.resize(vao.attribs.size());
 
-  for(GLuint i = 0; i < (GLuint)numVBufferBindings; i++)
+  for(size_t i = 0; i < vao.bindings.size(); i++)
   {
-    GLuint buffer = GetBoundVertexBuffer(i);
+    const GLVertexArrayShadow::Binding &b = vao.bindings[i];
 
     pipe.vertexInput.vertexBuffers[i].resourceId =
-        rm->GetOriginalID(rm->GetID(BufferRes(ctx, buffer)));
-
-    drv.glGetIntegeri_v(eGL_VERTEX_BINDING_STRIDE, i,
-                        (GLint *)&pipe.vertexInput.vertexBuffers[i].byteStride);
-    drv.glGetIntegeri_v(eGL_VERTEX_BINDING_OFFSET, i,
-                        (GLint *)&pipe.vertexInput.vertexBuffers[i].byteOffset);
-    drv.glGetIntegeri_v(eGL_VERTEX_BINDING_DIVISOR, i,
-                        (GLint *)&pipe.vertexInput.vertexBuffers[i].instanceDivisor);
+        rm->GetOriginalID(rm->GetID(BufferRes(ctx, b.buffer)));
+    pipe.vertexInput.vertexBuffers[i].byteStride = (uint32_t)b.stride;
+    pipe.vertexInput.vertexBuffers[i].byteOffset = (uint32_t)b.offset;
+    pipe.vertexInput.vertexBuffers[i].instanceDivisor = (uint32_t)b.divisor;
   }
 
-  for(GLuint i = 0; i < (GLuint)numVAttribBindings; i++)
+  for(size_t i = 0; i < vao.attribs.size(); i++)
   {
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_ENABLED,
-                            (GLint *)&pipe.vertexInput.attributes[i].enabled);
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_BINDING,
-                            (GLint *)&pipe.vertexInput.attributes[i].vertexBufferSlot);
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_RELATIVE_OFFSET,
-                            (GLint *)&pipe.vertexInput.attributes[i].byteOffset);
-
-    GLenum type = eGL_FLOAT;
-    GLint normalized = 0;
+    const GLVertexArrayShadow::Attrib &a = vao.attribs[i];
 
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_TYPE, (GLint *)&type);
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &normalized);
+    pipe.vertexInput.attributes[i].enabled = (a.enabled != 0);
+    pipe.vertexInput.attributes[i].vertexBufferSlot = (uint32_t)a.binding;
+    pipe.vertexInput.attributes[i].byteOffset = (uint32_t)a.relativeOffset;
 
-    GLint integer = 0;
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_INTEGER, &integer);
+    GLenum type = a.type;
+    GLint normalized = a.normalized;
+    GLint integer = a.integer;
 
+    // the generic values are part of the context, not the VAO, and FetchState has them already
     RDCEraseEl(pipe.vertexInput.attributes[i].genericValue);
-    drv.glGetVertexAttribfv(i, eGL_CURRENT_VERTEX_ATTRIB,
-                            pipe.vertexInput.attributes[i].genericValue.floatValue);
+    if(i < ARRAY_COUNT(rs.GenericVertexAttribs))
+      memcpy(pipe.vertexInput.attributes[i].genericValue.floatValue, &rs.GenericVertexAttribs[i],
+             sizeof(rs.GenericVertexAttribs[i]));
 
     ResourceFormat fmt;
 
     fmt.type = ResourceFormatType::Regular;
     fmt.compCount = 4;
-    GLint compCount;
-    drv.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_SIZE, (GLint *)&compCount);
+    GLint compCount = a.size;
 
     fmt.compCount = (uint8_t)compCount;
 
@@ -852,13 +863,11 @@ void GLReplay::SavePipelineState()
 
   // Shader stages & Textures
 
-  GLint numTexUnits = 8;
-  drv.glGetIntegerv(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &numTexUnits);
+  GLint numTexUnits = shadow.GetLimit(eGL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
   pipe.textures.resize(numTexUnits);
   pipe.samplers.resize(numTexUnits);
 
-  GLenum activeTexture = eGL_TEXTURE0;
-  drv.glGetIntegerv(eGL_ACTIVE_TEXTURE, (GLint *)&activeTexture);
+  GLenum activeTexture = rs.ActiveTexture;
 
   pipe.vertexShader.stage = ShaderStage::Vertex;
   pipe.tessControlShader.stage = ShaderStage::Tess_Control;
@@ -1003,8 +1012,7 @@ void GLReplay::SavePipelineState()
     else
       pipe.transformFeedback.feedbackResourceId = ResourceId();
 
-    GLint maxCount = 0;
-    drv.glGetIntegerv(eGL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS, &maxCount);
+    GLint maxCount = shadow.GetLimit(eGL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS);
 
     for(int i = 0; i < (int)ARRAY_COUNT(pipe.transformFeedback.bufferResourceId) && i < maxCount; i++)
     {
@@ -1126,6 +1134,8 @@ void GLReplay::SavePipelineState()
 
       if(binding == eGL_TEXTURE_CUBE_MAP_ARRAY && !HasExt[ARB_texture_cube_map_array])
         tex = 0;
+      else if(unit < (GLint)ARRAY_COUNT(rs.Tex2D))
+        tex = GetBoundTexture(rs, binding, unit);
       else
         drv.glGetIntegerv(binding, (GLint *)&tex);
 
@@ -1207,7 +1217,9 @@ void GLReplay::SavePipelineState()
         }
 
         GLuint samp = 0;
-        if(HasExt[ARB_sampler_objects])
+        if(unit < (GLint)ARRAY_COUNT(rs.Samplers))
+          samp = rs.Samplers[unit].name;
+        else if(HasExt[ARB_sampler_objects])
           drv.glGetIntegerv(eGL_SAMPLER_BINDING, (GLint *)&samp);
 
         pipe.samplers[unit].resourceId = rm->GetOriginalID(rm->GetID(SamplerRes(ctx, samp)));
@@ -1552,8 +1564,7 @@ void GLReplay::SavePipelineState()
   GLuint curReadFBO = 0;
   drv.glGetIntegerv(eGL_READ_FRAMEBUFFER_BINDING, (GLint *)&curReadFBO);
 
-  GLint numCols = 8;
-  drv.glGetIntegerv(eGL_MAX_COLOR_ATTACHMENTS, &numCols);
+  GLint numCols = shadow.GetLimit(eGL_MAX_COLOR_ATTACHMENTS);
 
   bool rbCol[32] = {false};
   bool rbDepth = false;
@@ -314,13 +314,6 @@ private:
     GLuint customTex;
     ResourceId CustomShaderTexID;
 
-    static const int maxMeshPicks = 500;
-
-    GLuint meshPickProgram;
-    GLuint pickIBBuf, pickVBBuf;
-    uint32_t pickIBSize, pickVBSize;
-    GLuint pickResultBuf;
-
     GLuint MS2Array, Array2MS;
     GLuint DepthMS2Array, DepthArray2MS;
 
@@ -348,6 +341,10 @@ private:
 
     GLuint feedbackObj;
     std::vector<GLuint> feedbackQueries;
+
+    // query objects used by FetchCounters that are free to re-use. Separate per counter since a
+    // query object's target is fixed once it's first used.
+    std::vector<GLuint> counterQueries[ENUM_ARRAY_SIZE(GPUCounter)];
     GLuint feedbackBuffer;
     uint64_t feedbackBufferSize = 32 * 1024 * 1024;
 
@@ -372,6 +369,7 @@ private:
   GPUVendor m_Vendor = GPUVendor::Unknown;
 
   HighlightCache m_HighlightCache;
+  MeshPickCache m_MeshPick;
 
   // eventId -> data
   map<uint32_t, GLPostVSData> m_PostVSData;
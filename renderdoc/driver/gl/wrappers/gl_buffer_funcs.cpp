@@ -3042,6 +3042,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribOffsetEXT(
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     // some intel drivers don't properly update query states (like GL_VERTEX_ATTRIB_ARRAY_SIZE)
     // unless the VAO is also bound when performing EXT_dsa functions :(
     GLuint prevVAO = 0;
@@ -3168,6 +3170,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribIOffsetEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     // some intel drivers don't properly update query states (like GL_VERTEX_ATTRIB_ARRAY_SIZE)
     // unless the VAO is also bound when performing EXT_dsa functions :(
     GLuint prevVAO = 0;
@@ -3294,6 +3298,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribLOffsetEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     // some intel drivers don't properly update query states (like GL_VERTEX_ATTRIB_ARRAY_SIZE)
     // unless the VAO is also bound when performing EXT_dsa functions :(
     GLuint prevVAO = 0;
@@ -3415,6 +3421,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribBindingEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GL.glVertexArrayVertexAttribBindingEXT(vaobj.name, attribindex, bindingindex);
   }
   return true;
@@ -3500,6 +3508,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribFormatEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GL.glVertexArrayVertexAttribFormatEXT(vaobj.name, attribindex, size, type, normalized,
                                           relativeoffset);
   }
@@ -3590,6 +3600,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribIFormatEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GL.glVertexArrayVertexAttribIFormatEXT(vaobj.name, attribindex, size, type, relativeoffset);
   }
 
@@ -3677,6 +3689,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribLFormatEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GL.glVertexArrayVertexAttribLFormatEXT(vaobj.name, attribindex, size, type, relativeoffset);
   }
 
@@ -3761,6 +3775,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexAttribDivisorEXT(SerialiserType
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     // at the time of writing, AMD driver seems to not have this entry point
     if(GL.glVertexArrayVertexAttribDivisorEXT)
     {
@@ -3851,6 +3867,8 @@ bool WrappedOpenGL::Serialise_glEnableVertexArrayAttribEXT(SerialiserType &ser,
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GLint prevVAO = 0;
     GL.glGetIntegerv(eGL_VERTEX_ARRAY_BINDING, &prevVAO);
 
@@ -3934,6 +3952,8 @@ bool WrappedOpenGL::Serialise_glDisableVertexArrayAttribEXT(SerialiserType &ser,
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GLint prevVAO = 0;
     GL.glGetIntegerv(eGL_VERTEX_ARRAY_BINDING, &prevVAO);
 
@@ -4255,6 +4275,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayBindVertexBufferEXT(SerialiserType &s
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     if(buffer.name)
     {
       m_Buffers[GetResourceManager()->GetID(buffer)].curType = eGL_ARRAY_BUFFER;
@@ -4392,6 +4414,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexBuffers(SerialiserType &ser, GL
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     // use ARB_direct_state_access functions here as we use EXT_direct_state_access elsewhere. If
     // we are running without ARB_dsa support, these functions are emulated in the obvious way. This
     // is necessary since these functions can be serialised even if ARB_dsa was not used originally,
@@ -4520,6 +4544,8 @@ bool WrappedOpenGL::Serialise_glVertexArrayVertexBindingDivisorEXT(SerialiserTyp
     if(vaobj.name == 0)
       vaobj.name = m_Fake_VAO0;
 
+    GetShadowState().DirtyVertexArray(vaobj.name);
+
     GL.glVertexArrayVertexBindingDivisorEXT(vaobj.name, bindingindex, divisor);
   }
 
@@ -4616,6 +4642,9 @@ void WrappedOpenGL::glDeleteBuffers(GLsizei n, const GLuint *buffers)
     }
   }
 
+  // deleting a buffer unbinds it from the current VAO
+  GetShadowState().DirtyVertexArrays();
+
   GL.glDeleteBuffers(n, buffers);
 }
 
@@ -4633,6 +4662,9 @@ void WrappedOpenGL::glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
     }
   }
 
+  for(GLsizei i = 0; i < n; i++)
+    GetShadowState().DirtyVertexArray(arrays[i]);
+
   GL.glDeleteVertexArrays(n, arrays);
 }
 
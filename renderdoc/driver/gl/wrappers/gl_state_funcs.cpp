@@ -1041,6 +1041,7 @@ bool WrappedOpenGL::Serialise_glDisable(SerialiserType &ser, GLenum cap)
   if(IsReplayingAndReading())
   {
     GL.glDisable(cap);
+    GetShadowState().SetEnabled(cap, false);
   }
 
   return true;
@@ -1050,6 +1051,8 @@ void WrappedOpenGL::glDisable(GLenum cap)
 {
   SERIALISE_TIME_CALL(GL.glDisable(cap));
 
+  GetShadowState().SetEnabled(cap, false);
+
   if(IsActiveCapturing(m_State))
   {
     // Skip some compatibility caps purely for the sake of avoiding debug message spam.
@@ -1081,6 +1084,7 @@ bool WrappedOpenGL::Serialise_glEnable(SerialiserType &ser, GLenum cap)
   if(IsReplayingAndReading())
   {
     GL.glEnable(cap);
+    GetShadowState().SetEnabled(cap, true);
   }
 
   return true;
@@ -1090,6 +1094,8 @@ void WrappedOpenGL::glEnable(GLenum cap)
 {
   SERIALISE_TIME_CALL(GL.glEnable(cap));
 
+  GetShadowState().SetEnabled(cap, true);
+
   if(IsActiveCapturing(m_State))
   {
     USE_SCRATCH_SERIALISER();
@@ -639,11 +639,16 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
   RegisterRange range;
   range.index = uint16_t(indices[0]);
 
+  // the register location for recording this write in the trace. Unlike range this is always set,
+  // even for outputs found by semantic, and identifies the array element for indexable temps.
+  ShaderVariableChange change;
+  change.index = indices[0];
+
   switch(dstoper.type)
   {
     case TYPE_TEMP:
     {
-      range.type = RegisterType::Temporary;
+      range.type = change.type = RegisterType::Temporary;
       RDCASSERT(indices[0] < (uint32_t)registers.size());
       if(indices[0] < (uint32_t)registers.size())
         v = &registers[(size_t)indices[0]];
@@ -651,7 +656,8 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
     }
     case TYPE_INDEXABLE_TEMP:
     {
-      range.type = RegisterType::IndexedTemporary;
+      range.type = change.type = RegisterType::IndexedTemporary;
+      change.element = indices[1];
       RDCASSERT(dstoper.indices.size() == 2);
 
       if(dstoper.indices.size() == 2)
@@ -670,7 +676,7 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
     }
     case TYPE_OUTPUT:
     {
-      range.type = RegisterType::Output;
+      range.type = change.type = RegisterType::Output;
       RDCASSERT(indices[0] < (uint32_t)outputs.size());
       if(indices[0] < (uint32_t)outputs.size())
         v = &outputs[(size_t)indices[0]];
@@ -715,6 +721,8 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
         if(dxbc->m_OutputSig[i].systemValue == builtin)
         {
           v = &outputs[i];
+          change.type = RegisterType::Output;
+          change.index = (uint32_t)i;
           break;
         }
       }
@@ -730,6 +738,8 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
           if(outputs[i].name == name)
           {
             v = &outputs[i];
+            change.type = RegisterType::Output;
+            change.index = (uint32_t)i;
             break;
           }
         }
@@ -750,6 +760,8 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
         if(outputs[i].name == name)
         {
           v = &outputs[i];
+          change.type = RegisterType::Output;
+          change.index = (uint32_t)i;
           break;
         }
       }
@@ -780,12 +792,15 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
     if(op.saturate)
       right = sat(right, OperationType(op.operation));
 
+    bool anyChanged = false;
+
     if(dstoper.comps[0] != 0xff && dstoper.comps[1] == 0xff && dstoper.comps[2] == 0xff &&
        dstoper.comps[3] == 0xff)
     {
       RDCASSERT(dstoper.comps[0] != 0xff);
 
       bool changed = AssignValue(*v, dstoper.comps[0], right, 0);
+      anyChanged |= changed;
 
       if(changed && range.type != RegisterType::Undefined)
       {
@@ -803,6 +818,7 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
         {
           RDCASSERT(dstoper.comps[i] < v->columns);
           bool changed = AssignValue(*v, dstoper.comps[i], right, dstoper.comps[i]);
+          anyChanged |= changed;
           compsWritten++;
 
           if(changed && range.type != RegisterType::Undefined)
@@ -816,6 +832,7 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
       if(compsWritten == 0)
       {
         bool changed = AssignValue(*v, 0, right, 0);
+        anyChanged |= changed;
 
         if(changed && range.type != RegisterType::Undefined)
         {
@@ -824,6 +841,27 @@ void State::SetDst(const ASMOperand &dstoper, const ASMOperation &op, const Shad
         }
       }
     }
+
+    if(anyChanged && change.type != RegisterType::Undefined)
+    {
+      change.value = *v;
+
+      // an instruction with several destinations could write the same register twice, only keep
+      // the final value
+      bool found = false;
+      for(ShaderVariableChange &c : changes)
+      {
+        if(c.type == change.type && c.index == change.index && c.element == change.element)
+        {
+          c.value = change.value;
+          found = true;
+          break;
+        }
+      }
+
+      if(!found)
+        changes.push_back(change);
+    }
   }
 }
 
@@ -1199,11 +1237,19 @@ static uint32_t PopCount(uint32_t x)
 State State::GetNext(GlobalState &global, State quad[4]) const
 {
   State s = *this;
+  s.StepNext(global, quad);
+  return s;
+}
+
+void State::StepNext(GlobalState &global, State quad[4])
+{
+  State &s = *this;
 
   s.modified.clear();
+  s.changes.clear();
 
   if(s.nextInstruction >= s.dxbc->GetNumInstructions())
-    return s;
+    return;
 
   const ASMOperation &op = s.dxbc->GetInstruction((size_t)s.nextInstruction);
 
@@ -1872,7 +1918,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create constant buf HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       context->CSSetConstantBuffers(0, 1, &constBuf);
@@ -1898,7 +1944,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create UAV buf HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       bdesc.BindFlags = 0;
@@ -1910,7 +1956,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create copy buf HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
@@ -1926,7 +1972,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create uav HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       context->CSSetUnorderedAccessViews(0, 1, &uav, NULL);
@@ -1940,7 +1986,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to map results HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       ShaderVariable calcResultA("calcA", 0.0f, 0.0f, 0.0f, 0.0f);
@@ -3888,7 +3934,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
 
           s.SetDst(op.operands[0], op, fetch);
 
-          return s;
+          return;
         }
         if(decl.declaration == OPCODE_DCL_RESOURCE && decl.operand.type == TYPE_RESOURCE &&
            decl.operand.indices.size() == 1 && decl.operand.indices[0] == op.operands[2].indices[0])
@@ -4507,7 +4553,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create RT tex HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       tdesc.BindFlags = 0;
@@ -4519,7 +4565,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create copy tex HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       D3D11_RENDER_TARGET_VIEW_DESC rtDesc;
@@ -4533,7 +4579,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to create rt rtv HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       context->OMSetRenderTargetsAndUnorderedAccessViews(1, &rtv, NULL, 0, 0, NULL, NULL);
@@ -4547,7 +4593,7 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       if(FAILED(hr))
       {
         RDCERR("Failed to map results HRESULT: %s", ToStr(hr).c_str());
-        return s;
+        return;
       }
 
       ShaderVariable lookupResult("tex", 0.0f, 0.0f, 0.0f, 0.0f);
@@ -4837,8 +4883,6 @@ State State::GetNext(GlobalState &global, State quad[4]) const
       break;
     }
   }
-
-  return s;
 }
 
 };    // namespace ShaderDebug
@@ -193,6 +193,9 @@ public:
   bool Finished() const;
 
   State GetNext(GlobalState &global, State quad[4]) const;
+  // steps this state forward by one instruction in place, avoiding the copy in GetNext. The quad
+  // is only read for derivatives, and must not contain this state.
+  void StepNext(GlobalState &global, State quad[4]);
 
 private:
   // index in the pixel quad
@@ -240,6 +240,14 @@ bool VkInitParams::IsSupportedVersion(uint64_t ver)
   if(ver == CurrentVersion)
     return true;
 
+  // 0xF -> 0x10 - large byte buffers can be stored as references into the blob store section
+  if(ver == 0xF)
+    return true;
+
+  // 0xE -> 0xF - image and memory initial contents store constant-value ranges as fills
+  if(ver == 0xE)
+    return true;
+
   // 0xD -> 0xE - fixed serialisation directly of size_t members in VkDescriptorUpdateTemplateEntry
   if(ver == 0xD)
     return true;
@@ -767,6 +775,17 @@ void ReplacePresentableImageLayout(VkImageLayout &layout)
     layout = VK_IMAGE_LAYOUT_GENERAL;
 }
 
+void ReplaceDiscardingAttachmentOps(VkAttachmentDescription &att)
+{
+  att.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  att.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+  if(att.loadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE)
+    att.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  if(att.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE)
+    att.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+}
+
 int SampleCount(VkSampleCountFlagBits countFlag)
 {
   switch(countFlag)
@@ -103,6 +103,10 @@ VkAccessFlags MakeAccessMask(VkImageLayout layout);
 
 void ReplacePresentableImageLayout(VkImageLayout &layout);
 
+// patch an attachment of a render pass created on replay so that its contents are never
+// discarded: every attachment is stored at the end, and DONT_CARE loads become LOAD.
+void ReplaceDiscardingAttachmentOps(VkAttachmentDescription &att);
+
 void DoPipelineBarrier(VkCommandBuffer cmd, uint32_t count, VkImageMemoryBarrier *barriers);
 void DoPipelineBarrier(VkCommandBuffer cmd, uint32_t count, VkBufferMemoryBarrier *barriers);
 void DoPipelineBarrier(VkCommandBuffer cmd, uint32_t count, VkMemoryBarrier *barriers);
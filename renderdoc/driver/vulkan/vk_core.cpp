@@ -1001,7 +1001,9 @@ void WrappedVulkan::FirstFrame(VkSwapchainKHR swap)
   SwapchainInfo *swapdesc = GetRecord(swap)->swapInfo;
 
   // if we have to capture the first frame, begin capturing immediately
-  if(IsBackgroundCapturing(m_State) && RenderDoc::Inst().ShouldTriggerCapture(0))
+  if(IsBackgroundCapturing(m_State) &&
+     m_IdleRecording.FrameBoundary(RenderDoc::Inst().GetCaptureOptions().lowOverheadIdle,
+                                   RenderDoc::Inst().ShouldTriggerCapture(0)))
   {
     RenderDoc::Inst().StartFrameCapture(LayerDisp(m_Instance), swapdesc ? swapdesc->wndHandle : NULL);
 
@@ -1079,6 +1081,10 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
 
   m_AppControlledCapture = true;
 
+  // captures started by the application can't wait for idle-recorded command buffers to settle
+  if(m_IdleRecording.CaptureStarted())
+    RDCLOG("Application started a capture, low overhead idle recording is now disabled");
+
   m_SubmitCounter = 0;
 
   m_FrameCounter = RDCMAX((uint32_t)m_CapturedFrames.size(), m_FrameCounter);
@@ -1091,6 +1097,10 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
 
   GetResourceManager()->ClearReferencedResources();
 
+  m_CaptureGeneration++;
+  if(m_CaptureGeneration == 0)
+    m_CaptureGeneration++;
+
   GetResourceManager()->MarkResourceFrameReferenced(GetResID(m_Instance), eFrameRef_Read);
   GetResourceManager()->MarkResourceFrameReferenced(GetResID(m_Device), eFrameRef_Read);
   GetResourceManager()->MarkResourceFrameReferenced(GetResID(m_Queue), eFrameRef_Read);
@@ -1134,6 +1144,8 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->PrepareInitialContents();
 
+    m_IdleCaptureDiscarded = false;
+
     RDCDEBUG("Attempting capture");
     m_FrameCaptureRecord->DeleteChunks();
 
@@ -1242,12 +1254,56 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
     }
   }
 
+  // a command buffer recorded while idle was submitted in the frame so commands are missing, throw
+  // the capture away. If we triggered it, try again once recording has settled. The application
+  // chose when to capture so we can't retry, but idle recording was disabled when the capture
+  // started so its captures succeed once those command buffers are re-recorded.
+  if(m_IdleCaptureDiscarded)
+  {
+    if(m_AppControlledCapture)
+    {
+      RDCERR("Capture of frame %u failed, command buffers recorded before the application started "
+             "it were submitted. Low overhead idle recording is now disabled, later captures will "
+             "succeed once those command buffers are re-recorded.",
+             m_FrameCounter);
+    }
+    else
+    {
+      RDCERR("Discarding capture of frame %u, command buffers recorded before it was triggered "
+             "were submitted",
+             m_FrameCounter);
+
+      m_IdleRecording.CaptureDiscarded();
+    }
+
+    m_CapturedFrames.pop_back();
+
+    SAFE_DELETE(m_HeaderChunk);
+    m_FrameCaptureRecord->DeleteChunks();
+
+    for(size_t i = 0; i < m_CmdBufferRecords.size(); i++)
+      m_CmdBufferRecords[i]->Delete(GetResourceManager());
+
+    m_CmdBufferRecords.clear();
+
+    GetResourceManager()->ClearReferencedResources();
+
+    GetResourceManager()->FreeInitialContents();
+
+    GetResourceManager()->FlushPendingDirty();
+
+    FreeAllMemory(MemoryScope::InitialContents);
+
+    return false;
+  }
+
   byte *thpixels = NULL;
+  int thchannels = 3;
   uint16_t thwidth = 0;
   uint16_t thheight = 0;
 
   // gather backbuffer screenshot
-  const uint32_t maxSize = 2048;
+  const uint32_t maxSize = 1024;
 
   if(swap != VK_NULL_HANDLE)
   {
@@ -1260,13 +1316,41 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     const SwapchainInfo &swapInfo = *swaprecord->swapInfo;
 
+    ResourceFormat fmt = MakeResourceFormat(swapInfo.format);
+
+    {
+      float aspect = float(swapInfo.extent.width) / float(swapInfo.extent.height);
+
+      thwidth = (uint16_t)RDCMIN(maxSize, swapInfo.extent.width);
+      thwidth &= ~0x7;    // align down to multiple of 8
+      thheight = uint16_t(float(thwidth) / aspect);
+    }
+
+    // where the format allows, downscale the backbuffer with a filtered blit on the GPU and only
+    // read back the thumbnail. Blitting float or sRGB data into an sRGB image applies the same
+    // clamp and sRGB curve that we'd otherwise do on the CPU.
+    VkFormat thumbFormat = (fmt.compType == CompType::Float || fmt.srgbCorrected)
+                               ? VK_FORMAT_R8G8B8A8_SRGB
+                               : VK_FORMAT_R8G8B8A8_UNORM;
+
+    const VkFormatFeatureFlags blitSrcFeatures =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    bool gpuResample =
+        thwidth > 0 && thheight > 0 && fmt.compType != CompType::UInt &&
+        fmt.compType != CompType::SInt &&
+        (GetFormatProperties(swapInfo.format).optimalTilingFeatures & blitSrcFeatures) ==
+            blitSrcFeatures &&
+        (GetFormatProperties(thumbFormat).optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+
     // since this happens during capture, we don't want to start serialising extra image creates,
     // so we manually create & then just wrap.
     VkImage readbackIm = VK_NULL_HANDLE;
+    VkBuffer readbackBuf = VK_NULL_HANDLE;
 
     VkResult vkr = VK_SUCCESS;
 
-    // create identical image
+    // create identical image to read back, or a thumbnail sized image to blit into
     VkImageCreateInfo imInfo = {
         VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         NULL,
@@ -1284,21 +1368,69 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
         NULL,
         VK_IMAGE_LAYOUT_UNDEFINED,
     };
-    vt->CreateImage(Unwrap(device), &imInfo, NULL, &readbackIm);
+
+    if(gpuResample)
+    {
+      imInfo.format = thumbFormat;
+      imInfo.extent.width = thwidth;
+      imInfo.extent.height = thheight;
+      imInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+      imInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
+    vkr = vt->CreateImage(Unwrap(device), &imInfo, NULL, &readbackIm);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
     GetResourceManager()->WrapResource(Unwrap(device), readbackIm);
 
-    VkImageSubresource subr = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0};
     VkSubresourceLayout layout = {0};
-    vt->GetImageSubresourceLayout(Unwrap(device), Unwrap(readbackIm), &subr, &layout);
+    MemoryAllocation readbackMem;
 
-    MemoryAllocation readbackMem =
-        AllocateMemoryForResource(readbackIm, MemoryScope::InitialContents, MemoryType::Readback);
+    if(gpuResample)
+    {
+      MemoryAllocation thumbMem =
+          AllocateMemoryForResource(readbackIm, MemoryScope::InitialContents, MemoryType::GPULocal);
 
-    vkr = vt->BindImageMemory(Unwrap(device), Unwrap(readbackIm), Unwrap(readbackMem.mem),
-                              readbackMem.offs);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      vkr = vt->BindImageMemory(Unwrap(device), Unwrap(readbackIm), Unwrap(thumbMem.mem),
+                                thumbMem.offs);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      // the thumbnail is copied tightly packed into a buffer to read back
+      layout.rowPitch = thwidth * 4U;
+      layout.size = layout.rowPitch * thheight;
+
+      VkBufferCreateInfo bufInfo = {
+          VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+          NULL,
+          0,
+          layout.size,
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      };
+
+      vkr = vt->CreateBuffer(Unwrap(device), &bufInfo, NULL, &readbackBuf);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      GetResourceManager()->WrapResource(Unwrap(device), readbackBuf);
+
+      readbackMem = AllocateMemoryForResource(readbackBuf, MemoryScope::InitialContents,
+                                              MemoryType::Readback);
+
+      vkr = vt->BindBufferMemory(Unwrap(device), Unwrap(readbackBuf), Unwrap(readbackMem.mem),
+                                 readbackMem.offs);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
+    else
+    {
+      VkImageSubresource subr = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0};
+      vt->GetImageSubresourceLayout(Unwrap(device), Unwrap(readbackIm), &subr, &layout);
+
+      readbackMem =
+          AllocateMemoryForResource(readbackIm, MemoryScope::InitialContents, MemoryType::Readback);
+
+      vkr = vt->BindImageMemory(Unwrap(device), Unwrap(readbackIm), Unwrap(readbackMem.mem),
+                                readbackMem.offs);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
     VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
                                           VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
@@ -1358,21 +1490,71 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
       SubmitAndFlushExtQueue(swapQueueIndex);
     }
 
-    vt->CmdCopyImage(Unwrap(cmd), Unwrap(backbuffer), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                     Unwrap(readbackIm), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &cpy);
+    if(gpuResample)
+    {
+      VkImageBlit blit = {
+          {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+          {
+              {0, 0, 0}, {(int32_t)swapInfo.extent.width, (int32_t)swapInfo.extent.height, 1},
+          },
+          {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+          {
+              {0, 0, 0}, {(int32_t)thwidth, (int32_t)thheight, 1},
+          },
+      };
+
+      vt->CmdBlitImage(Unwrap(cmd), Unwrap(backbuffer), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       Unwrap(readbackIm), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                       VK_FILTER_LINEAR);
+
+      readBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      readBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+      readBarrier.oldLayout = readBarrier.newLayout;
+      readBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+      DoPipelineBarrier(cmd, 1, &readBarrier);
+
+      VkBufferImageCopy bufcpy = {
+          0, 0, 0, {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1}, {0, 0, 0}, {thwidth, thheight, 1},
+      };
+
+      vt->CmdCopyImageToBuffer(Unwrap(cmd), Unwrap(readbackIm),
+                               VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Unwrap(readbackBuf), 1,
+                               &bufcpy);
+
+      VkBufferMemoryBarrier bufBarrier = {
+          VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+          NULL,
+          VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_ACCESS_HOST_READ_BIT,
+          VK_QUEUE_FAMILY_IGNORED,
+          VK_QUEUE_FAMILY_IGNORED,
+          Unwrap(readbackBuf),
+          0,
+          VK_WHOLE_SIZE,
+      };
+
+      DoPipelineBarrier(cmd, 1, &bufBarrier);
+    }
+    else
+    {
+      vt->CmdCopyImage(Unwrap(cmd), Unwrap(backbuffer), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       Unwrap(readbackIm), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &cpy);
+
+      readBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      readBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+      readBarrier.oldLayout = readBarrier.newLayout;
+      readBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+      DoPipelineBarrier(cmd, 1, &readBarrier);
+    }
 
     // barrier to switch backbuffer back to present layout
     std::swap(bbBarrier.oldLayout, bbBarrier.newLayout);
     std::swap(bbBarrier.srcAccessMask, bbBarrier.dstAccessMask);
     std::swap(bbBarrier.srcQueueFamilyIndex, bbBarrier.dstQueueFamilyIndex);
 
-    readBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    readBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
-    readBarrier.oldLayout = readBarrier.newLayout;
-    readBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-
     DoPipelineBarrier(cmd, 1, &bbBarrier);
-    DoPipelineBarrier(cmd, 1, &readBarrier);
 
     vkr = vt->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
@@ -1402,10 +1584,19 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     RDCASSERT(pData != NULL);
 
-    // point sample info into raw buffer
+    if(gpuResample)
+    {
+      // already downscaled and converted, the encoder ignores the alpha channel. Take a copy since
+      // the readback memory is freed before the encode finishes.
+      thchannels = 4;
+      thpixels = new byte[4U * thwidth * thheight];
+      memcpy(thpixels, pData, 4U * thwidth * thheight);
+    }
+    else
     {
-      ResourceFormat fmt = MakeResourceFormat(imInfo.format);
+      thpixels = new byte[3U * thwidth * thheight];
 
+      // point sample info into raw buffer
       byte *data = (byte *)pData;
 
       data += layout.offset;
@@ -1413,14 +1604,6 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
       float widthf = float(imInfo.extent.width);
       float heightf = float(imInfo.extent.height);
 
-      float aspect = widthf / heightf;
-
-      thwidth = (uint16_t)RDCMIN(maxSize, imInfo.extent.width);
-      thwidth &= ~0x7;    // align down to multiple of 8
-      thheight = uint16_t(float(thwidth) / aspect);
-
-      thpixels = new byte[3U * thwidth * thheight];
-
       uint32_t stride = fmt.compByteWidth * fmt.compCount;
 
       bool buf1010102 = false;
@@ -1526,22 +1709,72 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
     // delete all
     vt->DestroyImage(Unwrap(device), Unwrap(readbackIm), NULL);
     GetResourceManager()->ReleaseWrappedResource(readbackIm);
+
+    if(readbackBuf != VK_NULL_HANDLE)
+    {
+      vt->DestroyBuffer(Unwrap(device), Unwrap(readbackBuf), NULL);
+      GetResourceManager()->ReleaseWrappedResource(readbackBuf);
+    }
   }
 
   byte *jpgbuf = NULL;
-  int len = thwidth * thheight;
+  int len = 0;
 
-  if(wnd)
+  // the thumbnail is encoded on a worker thread while we gather the frame's chunks. It has to be
+  // ready before the capture file is created, as it's written into the header.
+  Threading::ThreadHandle jpgThread = 0;
+
+  if(wnd && thpixels)
   {
+    // jpge::compress_image_to_jpeg_file_in_memory requires at least 1024 bytes
+    len = RDCMAX(thwidth * thheight, 1024);
     jpgbuf = new byte[len];
 
-    jpge::params p;
-    p.m_quality = 80;
+    // the worker owns the pixels, and only writes the encoded length which isn't read until it has
+    // been joined below.
+    jpgThread =
+        Threading::CreateThread([jpgbuf, &len, thwidth, thheight, thchannels, thpixels]() {
+          jpge::params p;
+          p.m_quality = 80;
 
-    bool success =
-        jpge::compress_image_to_jpeg_file_in_memory(jpgbuf, len, thwidth, thheight, 3, thpixels, p);
+          if(!jpge::compress_image_to_jpeg_file_in_memory(jpgbuf, len, thwidth, thheight,
+                                                          thchannels, thpixels, p))
+            len = 0;
 
-    if(!success)
+          delete[] thpixels;
+        });
+
+    thpixels = NULL;
+  }
+
+  SAFE_DELETE_ARRAY(thpixels);
+
+  // don't need to lock access to m_CmdBufferRecords as we are no longer
+  // in capframe (the transition is thread-protected) so nothing will be
+  // pushed to the vector
+
+  RDCDEBUG("Gathering %u command buffer records", (uint32_t)m_CmdBufferRecords.size());
+
+  std::map<int32_t, Chunk *> recordlist;
+
+  // ensure all command buffer records within the frame evne if recorded before, but
+  // otherwise order must be preserved (vs. queue submits and desc set updates)
+  for(size_t i = 0; i < m_CmdBufferRecords.size(); i++)
+  {
+    m_CmdBufferRecords[i]->Insert(recordlist);
+
+    RDCDEBUG("Adding %u chunks to file serialiser from command buffer %llu",
+             (uint32_t)recordlist.size(), m_CmdBufferRecords[i]->GetResourceID());
+  }
+
+  m_FrameCaptureRecord->Insert(recordlist);
+
+  if(jpgThread)
+  {
+    Threading::JoinThread(jpgThread);
+    Threading::CloseThread(jpgThread);
+
+    if(len == 0)
     {
       RDCERR("Failed to compress to jpg");
       SAFE_DELETE_ARRAY(jpgbuf);
@@ -1554,7 +1787,6 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
                                              jpgbuf, len, thwidth, thheight);
 
   SAFE_DELETE_ARRAY(jpgbuf);
-  SAFE_DELETE_ARRAY(thpixels);
 
   StreamWriter *captureWriter = NULL;
 
@@ -1591,8 +1823,14 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->InsertReferencedChunks(ser);
 
+    // initial contents are large and often duplicated, so store their data in the blob store
+    if(rdc)
+      ser.SetBlobStore(rdc->GetBlobStore());
+
     GetResourceManager()->InsertInitialContentsChunks(ser);
 
+    ser.SetBlobStore(NULL);
+
     RDCDEBUG("Creating Capture Scope");
 
     GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -1605,30 +1843,8 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     m_HeaderChunk->Write(ser);
 
-    // don't need to lock access to m_CmdBufferRecords as we are no longer
-    // in capframe (the transition is thread-protected) so nothing will be
-    // pushed to the vector
-
     {
-      RDCDEBUG("Flushing %u command buffer records to file serialiser",
-               (uint32_t)m_CmdBufferRecords.size());
-
-      std::map<int32_t, Chunk *> recordlist;
-
-      // ensure all command buffer records within the frame evne if recorded before, but
-      // otherwise order must be preserved (vs. queue submits and desc set updates)
-      for(size_t i = 0; i < m_CmdBufferRecords.size(); i++)
-      {
-        m_CmdBufferRecords[i]->Insert(recordlist);
-
-        RDCDEBUG("Adding %u chunks to file serialiser from command buffer %llu",
-                 (uint32_t)recordlist.size(), m_CmdBufferRecords[i]->GetResourceID());
-      }
-
-      m_FrameCaptureRecord->Insert(recordlist);
-
-      RDCDEBUG("Flushing %u chunks to file serialiser from context record",
-               (uint32_t)recordlist.size());
+      RDCDEBUG("Flushing %u chunks to file serialiser", (uint32_t)recordlist.size());
 
       float num = float(recordlist.size());
       float idx = 0.0f;
@@ -1720,6 +1936,7 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   ser.SetStringDatabase(&m_StringDB);
   ser.SetUserData(GetResourceManager());
+  ser.SetBlobStore(rdc->GetBlobStore());
 
   ser.ConfigureStructuredExport(&GetChunkName, storeStructuredBuffers);
 
@@ -1933,6 +2150,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
   uint64_t startOffset = ser.GetReader()->GetOffset();
 
+  ReplayProfiler &profiler = RenderDoc::Inst().GetReplayProfiler();
+
   for(;;)
   {
     if(IsActiveReplaying(m_State) && m_RootEventID > endEventID)
@@ -1944,6 +2163,9 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    uint64_t profileStart = profiler.Begin();
+    uint32_t profileEventID = m_RootEventID;
+
     VulkanChunk chunktype = ser.ReadChunk<VulkanChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -1957,6 +2179,8 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     ser.EndChunk();
 
+    profiler.End(profileStart, (uint32_t)chunktype, profileEventID, &GetChunkName);
+
     if(ser.GetReader()->IsErrored())
       return ReplayStatus::APIDataCorrupted;
 
@@ -2678,12 +2902,17 @@ void WrappedVulkan::ReplayLog(uint32_t startEventID, uint32_t endEventID, Replay
 
   if(!partial)
   {
+    ReplayProfiler &profiler = RenderDoc::Inst().GetReplayProfiler();
+    uint64_t profileStart = profiler.Begin();
+
     VkMarkerRegion::Begin("!!!!RenderDoc Internal: ApplyInitialContents");
     ApplyInitialContents();
     VkMarkerRegion::End();
 
     SubmitCmds();
     FlushQ();
+
+    profiler.End(profileStart, (uint32_t)SystemChunk::InitialContents, 0, &GetChunkName);
   }
 
   m_State = CaptureState::ActiveReplaying;
@@ -3041,6 +3270,44 @@ bool WrappedVulkan::IsPartialCmdBuf(ResourceId cmdid)
   return false;
 }
 
+static bool ContainsSubresource(const ImageRegionState &state, VkImageAspectFlags aspect,
+                                uint32_t mip, uint32_t slice)
+{
+  const VkImageSubresourceRange &range = state.subresourceRange;
+
+  return (range.aspectMask & aspect) && mip >= range.baseMipLevel &&
+         mip < range.baseMipLevel + range.levelCount && slice >= range.baseArrayLayer &&
+         slice < range.baseArrayLayer + range.layerCount;
+}
+
+VkImageLayout WrappedVulkan::GetCurrentImageLayout(VkCommandBuffer cmd, ResourceId image,
+                                                   VkImageAspectFlags aspect, uint32_t mip,
+                                                   uint32_t slice)
+{
+  // barriers recorded so far in this command buffer take precedence, as they haven't been applied
+  // to the global layouts until the command buffer is submitted
+  const std::vector<std::pair<ResourceId, ImageRegionState>> &barriers =
+      m_BakedCmdBufferInfo[GetResID(cmd)].imgbarriers;
+
+  for(auto it = barriers.begin(); it != barriers.end(); ++it)
+  {
+    if(it->first == image && it->second.newLayout != UNKNOWN_PREV_IMG_LAYOUT &&
+       ContainsSubresource(it->second, aspect, mip, slice))
+      return it->second.newLayout;
+  }
+
+  auto it = m_ImageLayouts.find(image);
+  if(it != m_ImageLayouts.end())
+  {
+    for(const ImageRegionState &state : it->second.subresourceStates)
+      if(ContainsSubresource(state, aspect, mip, slice))
+        return state.newLayout;
+  }
+
+  RDCWARN("Couldn't find current layout of image %llu", image);
+  return VK_IMAGE_LAYOUT_GENERAL;
+}
+
 VkCommandBuffer WrappedVulkan::RerecordCmdBuf(ResourceId cmdid, PartialReplayIndex partialType)
 {
   if(m_OutsideCmdBuffer != VK_NULL_HANDLE)
@@ -55,7 +55,7 @@ struct VkInitParams
   uint32_t GetSerialiseSize();
 
   // check if a frame capture section version is supported
-  static const uint64_t CurrentVersion = 0xE;
+  static const uint64_t CurrentVersion = 0x10;
   static bool IsSupportedVersion(uint64_t ver);
 };
 
@@ -267,6 +267,16 @@ private:
 
   Threading::CriticalSection m_CapTransitionLock;
 
+  // incremented at the start of each frame capture, so descriptor sets can tell if their bound
+  // resources have already been marked as referenced in this capture. 0 is never used.
+  uint32_t m_CaptureGeneration = 0;
+
+  // decides when command buffers can skip serialisation with the low overhead idle option
+  IdleCmdRecording m_IdleRecording;
+  // set if a command buffer recorded while idle was submitted during the active capture, so it's
+  // missing commands and must be thrown away. Protected by m_CapTransitionLock
+  bool m_IdleCaptureDiscarded = false;
+
   VulkanDrawcallCallback *m_DrawcallCallback;
 
   SDFile *m_StructuredFile;
@@ -507,6 +517,9 @@ private:
       ResourceId renderPass;
       ResourceId framebuffer;
       uint32_t subpass = 0;
+
+      // only tracked during active replay, for drawcall callbacks that temporarily rebind state
+      std::vector<VkRect2D> scissors;
     } state;
 
     std::vector<std::pair<ResourceId, ImageRegionState>> imgbarriers;
@@ -810,8 +823,8 @@ public:
   VulkanReplay *GetReplay() { return &m_Replay; }
   // replay interface
   bool Prepare_InitialState(WrappedVkRes *res);
-  uint32_t GetSize_InitialState(ResourceId id, WrappedVkRes *res);
-  uint32_t GetSize_SparseInitialState(ResourceId id, WrappedVkRes *res);
+  uint32_t GetSize_InitialState(ResourceId id, WrappedVkRes *res, const BlobStore *blobs);
+  uint32_t GetSize_SparseInitialState(ResourceId id, WrappedVkRes *res, const BlobStore *blobs);
   template <typename SerialiserType>
   bool Serialise_InitialState(SerialiserType &ser, ResourceId resid, WrappedVkRes *res);
   void Create_InitialState(ResourceId id, WrappedVkRes *live, bool hasData);
@@ -877,6 +890,15 @@ public:
   void FlushQ();
 
   VulkanRenderState &GetRenderState() { return m_RenderState; }
+  // the tracked state of the command buffer currently being replayed. Unlike the render state
+  // above this is valid for all command buffers, so it can be used by drawcall callbacks.
+  typedef BakedCmdBufferInfo::CmdBufferState CmdBufferState;
+  const CmdBufferState &GetCurrentCmdBufferState()
+  {
+    return m_BakedCmdBufferInfo[m_LastCmdBufferID].state;
+  }
+  VkImageLayout GetCurrentImageLayout(VkCommandBuffer cmd, ResourceId image,
+                                      VkImageAspectFlags aspect, uint32_t mip, uint32_t slice);
   void SetDrawcallCB(VulkanDrawcallCallback *cb) { m_DrawcallCallback = cb; }
   static bool IsSupportedExtension(const char *extName);
   static void FilterToSupportedExtensions(std::vector<VkExtensionProperties> &exts,
@@ -445,6 +445,21 @@ struct VulkanGPUTimerCallback : public VulkanDrawcallCallback
   vector<pair<uint32_t, uint32_t> > m_AliasEvents;
 };
 
+void VulkanReplay::CounterQueryPools::Destroy(WrappedVulkan *driver)
+{
+  VkDevice dev = driver->GetDev();
+
+  if(timeStamp != VK_NULL_HANDLE)
+    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), timeStamp, NULL);
+  if(occlusion != VK_NULL_HANDLE)
+    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), occlusion, NULL);
+  if(pipeStats != VK_NULL_HANDLE)
+    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), pipeStats, NULL);
+
+  timeStamp = occlusion = pipeStats = VK_NULL_HANDLE;
+  size = 0;
+}
+
 vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &counters)
 {
   uint32_t maxEID = m_pDriver->GetMaxEID();
@@ -500,10 +515,23 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
       VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL,   0,
       VK_QUERY_TYPE_PIPELINE_STATISTICS,        maxEID, pipeStatsFlags};
 
-  VkQueryPool timeStampPool;
-  VkResult vkr =
-      ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &timeStampPoolCreateInfo, NULL, &timeStampPool);
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  VkResult vkr = VK_SUCCESS;
+
+  // the pools are sized by the number of events, so if they're too small recreate them all
+  if(m_CounterPools.size < maxEID)
+  {
+    m_CounterPools.Destroy(m_pDriver);
+    m_CounterPools.size = maxEID;
+  }
+
+  if(m_CounterPools.timeStamp == VK_NULL_HANDLE)
+  {
+    vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &timeStampPoolCreateInfo, NULL,
+                                        &m_CounterPools.timeStamp);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  VkQueryPool timeStampPool = m_CounterPools.timeStamp;
 
   bool occlNeeded = false;
   bool statsNeeded = false;
@@ -531,15 +559,27 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
   VkQueryPool occlusionPool = VK_NULL_HANDLE;
   if(availableFeatures.occlusionQueryPrecise && occlNeeded)
   {
-    vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &occlusionPoolCreateInfo, NULL, &occlusionPool);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    if(m_CounterPools.occlusion == VK_NULL_HANDLE)
+    {
+      vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &occlusionPoolCreateInfo, NULL,
+                                          &m_CounterPools.occlusion);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
+
+    occlusionPool = m_CounterPools.occlusion;
   }
 
   VkQueryPool pipeStatsPool = VK_NULL_HANDLE;
   if(availableFeatures.pipelineStatisticsQuery && statsNeeded)
   {
-    vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &pipeStatsPoolCreateInfo, NULL, &pipeStatsPool);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    if(m_CounterPools.pipeStats == VK_NULL_HANDLE)
+    {
+      vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &pipeStatsPoolCreateInfo, NULL,
+                                          &m_CounterPools.pipeStats);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
+
+    pipeStatsPool = m_CounterPools.pipeStats;
   }
 
   VkCommandBuffer cmd = m_pDriver->GetNextCmd();
@@ -577,8 +617,6 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
       VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
   RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), timeStampPool, NULL);
-
   vector<uint64_t> m_OcclusionData;
   m_OcclusionData.resize(cb.m_Results.size());
   if(occlusionPool != VK_NULL_HANDLE)
@@ -588,8 +626,6 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
         sizeof(uint64_t) * m_OcclusionData.size(), &m_OcclusionData[0], sizeof(uint64_t),
         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), occlusionPool, NULL);
   }
 
   vector<uint64_t> m_PipeStatsData;
@@ -601,8 +637,6 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
         sizeof(uint64_t) * m_PipeStatsData.size(), &m_PipeStatsData[0], sizeof(uint64_t) * 11,
         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), pipeStatsPool, NULL);
   }
 
   for(size_t i = 0; i < cb.m_Results.size(); i++)
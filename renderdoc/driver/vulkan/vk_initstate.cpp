@@ -41,6 +41,147 @@
 // command buffer that stalls the GPU).
 // See INITSTATEBATCH
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, VkInitialContentsFill &el)
+{
+  SERIALISE_MEMBER(offset);
+  SERIALISE_MEMBER(size);
+  SERIALISE_MEMBER(value);
+}
+
+// image and memory contents are checked for constant values in pages of this size. Freshly
+// allocated or cleared resources are common and are then stored as fills instead of data.
+static const VkDeviceSize initialContentsFillPageSize = 4096;
+
+// find the constant-value pages in some contents, merging adjacent pages with the same value.
+// Returns the total number of bytes covered by fills.
+static VkDeviceSize FindInitialContentsFills(const byte *data, VkDeviceSize size,
+                                             std::vector<VkInitialContentsFill> &fills)
+{
+  VkDeviceSize filled = 0;
+
+  fills.clear();
+
+  const VkDeviceSize pageSize = initialContentsFillPageSize;
+
+  // only whole pages are considered, any trailing partial page is left as data
+  for(VkDeviceSize offs = 0; offs + pageSize <= size; offs += pageSize)
+  {
+    const uint32_t *dwords = (const uint32_t *)(data + offs);
+    const uint32_t value = dwords[0];
+
+    bool constant = true;
+    for(VkDeviceSize i = 1; constant && i < pageSize / sizeof(uint32_t); i++)
+      constant = (dwords[i] == value);
+
+    if(!constant)
+      continue;
+
+    filled += pageSize;
+
+    if(!fills.empty() && fills.back().value == value &&
+       fills.back().offset + fills.back().size == offs)
+      fills.back().size += pageSize;
+    else
+      fills.push_back({offs, pageSize, value});
+  }
+
+  return filled;
+}
+
+// scan freshly read back contents for fills once, and cache them on the initial contents so that
+// GetSize_InitialState and Serialise_InitialState don't each have to map and scan them again.
+static void CacheInitialContentsFills(VkDevice d, VkInitialContents &initial)
+{
+  byte *data = NULL;
+  VkResult vkr = ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(initial.mem.mem), initial.mem.offs,
+                                       initial.mem.size, 0, (void **)&data);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  std::vector<VkInitialContentsFill> fills;
+  FindInitialContentsFills(data, initial.mem.size, fills);
+
+  ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(initial.mem.mem));
+
+  if(!fills.empty())
+  {
+    initial.numFills = (uint32_t)fills.size();
+    initial.fills = new VkInitialContentsFill[fills.size()];
+    memcpy(initial.fills, fills.data(), sizeof(VkInitialContentsFill) * fills.size());
+  }
+
+  initial.contentsSize = initial.mem.size;
+}
+
+static bool ValidInitialContentsFills(const std::vector<VkInitialContentsFill> &fills,
+                                      VkDeviceSize size)
+{
+  VkDeviceSize end = 0;
+
+  for(const VkInitialContentsFill &fill : fills)
+  {
+    if(fill.offset < end || fill.size > size || fill.offset > size - fill.size ||
+       (fill.offset & 3) || (fill.size & 3))
+      return false;
+
+    end = fill.offset + fill.size;
+  }
+
+  return true;
+}
+
+// returns the ranges between fills. dstOffset is the offset in the contents, and srcOffset is the
+// offset in the packed data without the fills.
+static std::vector<VkBufferCopy> GetInitialContentsCopies(const VkInitialContentsFill *fills,
+                                                          size_t numFills, VkDeviceSize size)
+{
+  std::vector<VkBufferCopy> ret;
+
+  VkBufferCopy copy = {};
+
+  for(size_t i = 0; i <= numFills; i++)
+  {
+    VkDeviceSize end = i < numFills ? fills[i].offset : size;
+
+    copy.size = end - copy.dstOffset;
+
+    if(copy.size > 0)
+    {
+      ret.push_back(copy);
+      copy.srcOffset += copy.size;
+    }
+
+    if(i < numFills)
+      copy.dstOffset = fills[i].offset + fills[i].size;
+  }
+
+  return ret;
+}
+
+static void ExpandInitialContents(const byte *packed,
+                                  const std::vector<VkInitialContentsFill> &fills,
+                                  VkDeviceSize size, byte *contents)
+{
+  std::vector<VkBufferCopy> copies = GetInitialContentsCopies(fills.data(), fills.size(), size);
+
+  for(const VkBufferCopy &copy : copies)
+    memcpy(contents + copy.dstOffset, packed + copy.srcOffset, (size_t)copy.size);
+
+  for(const VkInitialContentsFill &fill : fills)
+  {
+    byte *dst = contents + fill.offset;
+
+    if(fill.value == 0)
+    {
+      memset(dst, 0, (size_t)fill.size);
+      continue;
+    }
+
+    for(VkDeviceSize i = 0; i < fill.size; i += sizeof(uint32_t))
+      memcpy(dst + i, &fill.value, sizeof(uint32_t));
+  }
+}
+
 bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 {
   ResourceId id = GetResourceManager()->GetID(res);
@@ -421,7 +562,10 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
       GetResourceManager()->ReleaseWrappedResource(arrayIm);
     }
 
-    GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
+    VkInitialContents initial(type, readbackmem);
+    CacheInitialContentsFills(d, initial);
+
+    GetResourceManager()->SetInitialContents(id, initial);
 
     return true;
   }
@@ -511,7 +655,10 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     GetResourceManager()->ReleaseWrappedResource(srcBuf);
     GetResourceManager()->ReleaseWrappedResource(dstBuf);
 
-    GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
+    VkInitialContents initial(type, readbackmem);
+    CacheInitialContentsFills(d, initial);
+
+    GetResourceManager()->SetInitialContents(id, initial);
 
     return true;
   }
@@ -523,7 +670,8 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
   return false;
 }
 
-uint32_t WrappedVulkan::GetSize_InitialState(ResourceId id, WrappedVkRes *res)
+uint32_t WrappedVulkan::GetSize_InitialState(ResourceId id, WrappedVkRes *res,
+                                             const BlobStore *blobs)
 {
   VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
   VkResourceType type = IdentifyTypeByPtr(record->Resource);
@@ -544,15 +692,23 @@ uint32_t WrappedVulkan::GetSize_InitialState(ResourceId id, WrappedVkRes *res)
   else if(type == eResBuffer)
   {
     // buffers only have initial states when they're sparse
-    return GetSize_SparseInitialState(id, res);
+    return GetSize_SparseInitialState(id, res, blobs);
   }
   else if(type == eResImage || type == eResDeviceMemory)
   {
     if(initContents.tag == VkInitialContents::Sparse)
-      return GetSize_SparseInitialState(id, res);
+      return GetSize_SparseInitialState(id, res, blobs);
 
     // the size primarily comes from the buffer, the size of which we conveniently have stored.
-    return uint32_t(128 + initContents.mem.size + WriteSerialiser::GetChunkAlignment());
+    // Constant-value ranges are stored as fills instead, which were found when it was read back.
+    VkDeviceSize dataSize = initContents.mem.size;
+
+    for(uint32_t i = 0; i < initContents.numFills; i++)
+      dataSize -= initContents.fills[i].size;
+
+    return uint32_t(128 + BlobStore::GetSerialisedSize(blobs, dataSize) +
+                    initContents.numFills * sizeof(VkInitialContentsFill) +
+                    WriteSerialiser::GetChunkAlignment());
   }
 
   RDCERR("Unhandled resource type %s", ToStr(type).c_str());
@@ -889,10 +1045,6 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, W
     // Serialise this separately so that it can be used on reading to prepare the upload memory
     SERIALISE_ELEMENT(ContentsSize);
 
-    // the memory/buffer that we allocated on read, to upload the initial contents.
-    MemoryAllocation uploadMemory;
-    VkBuffer uploadBuf = VK_NULL_HANDLE;
-
     // during writing, we already have the memory copied off - we just need to map it.
     if(ser.IsWriting())
     {
@@ -901,14 +1053,93 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, W
                                   initContents.mem.size, 0, (void **)&Contents);
       RDCASSERTEQUAL(vkr, VK_SUCCESS);
     }
-    else if(IsReplayingAndReading() && !ser.IsErrored())
+
+    // ranges with a constant value are serialised as fills, and the contents only contain the data
+    // between them packed together.
+    std::vector<VkInitialContentsFill> Fills;
+    VkDeviceSize filledSize = 0;
+
+    if(ser.IsWriting())
+    {
+      Fills.assign(initContents.fills, initContents.fills + initContents.numFills);
+
+      for(const VkInitialContentsFill &fill : Fills)
+        filledSize += fill.size;
+    }
+
+    if(ser.VersionAtLeast(0xF))
+    {
+      SERIALISE_ELEMENT(Fills);
+    }
+
+    if(ser.IsReading())
+    {
+      if(!ValidInitialContentsFills(Fills, ContentsSize))
+      {
+        RDCERR("Invalid fills in initial contents for %s %llu", ToStr(type).c_str(), id);
+        return false;
+      }
+
+      for(const VkInitialContentsFill &fill : Fills)
+        filledSize += fill.size;
+    }
+
+    uint64_t PackedSize = ContentsSize - filledSize;
+
+    // on writing, or when reading image contents that need expanding on the CPU, the packed data
+    bytebuf packedContents;
+
+    if(ser.IsWriting() && !Fills.empty())
+    {
+      packedContents.resize((size_t)PackedSize);
+
+      std::vector<VkBufferCopy> copies =
+          GetInitialContentsCopies(Fills.data(), Fills.size(), ContentsSize);
+
+      for(const VkBufferCopy &copy : copies)
+        memcpy(packedContents.data() + copy.srcOffset, Contents + copy.dstOffset,
+               (size_t)copy.size);
+
+      Contents = packedContents.data();
+    }
+
+    // images that were entirely zero are cleared instead of uploaded, as long as the format can be
+    // cleared. Other images are expanded on the CPU into the upload buffer, and device memory has
+    // the fills applied on the GPU.
+    bool clearImage = false;
+    byte *uploadContents = NULL;
+    VkDeviceSize uploadSize = ContentsSize;
+
+    if(IsReplayingAndReading() && !Fills.empty())
+    {
+      if(type == eResImage)
+      {
+        VkFormat fmt = m_CreationInfo.m_Image[GetResourceManager()->GetLiveID(id)].format;
+
+        clearImage = (Fills.size() == 1 && Fills[0].size == ContentsSize && Fills[0].value == 0 &&
+                      !IsDepthOrStencilFormat(fmt) && !IsBlockFormat(fmt));
+
+        if(!clearImage)
+          packedContents.resize((size_t)PackedSize);
+      }
+      else
+      {
+        uploadSize = PackedSize;
+      }
+    }
+
+    // the memory/buffer that we allocated on read, to upload the initial contents.
+    MemoryAllocation uploadMemory;
+    VkBuffer uploadBuf = VK_NULL_HANDLE;
+
+    if(IsReplayingAndReading() && !ser.IsErrored() && !clearImage && uploadSize > 0)
     {
       // create a buffer with memory attached, which we will fill with the initial contents
       VkBufferCreateInfo bufInfo = {
           VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
           NULL,
           0,
-          ContentsSize,
+          uploadSize,
           VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
       };
 
@@ -924,12 +1155,17 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, W
       mappedMem = uploadMemory;
 
       ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mappedMem.mem), mappedMem.offs, mappedMem.size, 0,
-                            (void **)&Contents);
+                            (void **)&uploadContents);
+
+      Contents = packedContents.empty() ? uploadContents : packedContents.data();
     }
 
     // not using SERIALISE_ELEMENT_ARRAY so we can deliberately avoid allocation - we serialise
     // directly into upload memory
-    ser.Serialise("Contents", Contents, ContentsSize, SerialiserFlags::NoFlags);
+    ser.Serialise("Contents", Contents, PackedSize, SerialiserFlags::NoFlags);
+
+    if(uploadContents && !packedContents.empty() && !ser.IsErrored())
+      ExpandInitialContents(packedContents.data(), Fills, ContentsSize, uploadContents);
 
     // unmap the resource we mapped before - we need to do this on read and on write.
     if(!IsStructuredExporting(m_State) && mappedMem.mem != VK_NULL_HANDLE)
@@ -948,8 +1184,21 @@ bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, W
         VkInitialContents initialContents(type, uploadMemory);
         initialContents.buf = uploadBuf;
 
+        if(!Fills.empty())
+        {
+          initialContents.numFills = (uint32_t)Fills.size();
+          initialContents.fills = new VkInitialContentsFill[Fills.size()];
+          memcpy(initialContents.fills, Fills.data(), sizeof(VkInitialContentsFill) * Fills.size());
+          initialContents.contentsSize = ContentsSize;
+        }
+
         GetResourceManager()->SetInitialContents(id, initialContents);
       }
+      else if(clearImage)
+      {
+        GetResourceManager()->SetInitialContents(
+            id, VkInitialContents(type, VkInitialContents::ClearColorImage));
+      }
       else
       {
         VkInitialContents initial(type, uploadMemory);
@@ -1806,10 +2055,53 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live, VkInitialContents ini
 
     VkBufferCopy region = {0, dstMemOffs, datasize};
 
-    if(dstBuf != VK_NULL_HANDLE)
-      ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(srcBuf), Unwrap(dstBuf), 1, &region);
-    else
+    if(dstBuf == VK_NULL_HANDLE)
+    {
       RDCERR("Whole memory buffer not present for %llu", id);
+    }
+    else if(initial.numFills > 0)
+    {
+      // copy the packed data between the fills, then fill the constant ranges
+      VkDeviceSize memSize = m_CreationInfo.m_Memory[id].size;
+
+      std::vector<VkBufferCopy> copies =
+          GetInitialContentsCopies(initial.fills, initial.numFills, initial.contentsSize);
+
+      // the contents can be padded past the end of the memory
+      for(size_t i = 0; i < copies.size();)
+      {
+        if(copies[i].dstOffset >= memSize)
+        {
+          copies.erase(copies.begin() + i);
+          continue;
+        }
+
+        copies[i].size = RDCMIN(copies[i].size, memSize - copies[i].dstOffset);
+        i++;
+      }
+
+      if(!copies.empty())
+        ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(srcBuf), Unwrap(dstBuf),
+                                    (uint32_t)copies.size(), copies.data());
+
+      for(uint32_t i = 0; i < initial.numFills; i++)
+      {
+        const VkInitialContentsFill &fill = initial.fills[i];
+
+        if(fill.offset >= memSize)
+          break;
+
+        VkDeviceSize size = fill.size;
+        if(fill.offset + size > memSize)
+          size = VK_WHOLE_SIZE;
+
+        ObjDisp(cmd)->CmdFillBuffer(Unwrap(cmd), Unwrap(dstBuf), fill.offset, size, fill.value);
+      }
+    }
+    else
+    {
+      ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(srcBuf), Unwrap(dstBuf), 1, &region);
+    }
 
     vkr = ObjDisp(cmd)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
@@ -1823,3 +2115,87 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live, VkInitialContents ini
     RDCERR("Unhandled resource type %d", type);
   }
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#undef None
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Find and expand constant initial contents ranges", "[vulkan][initstate]")
+{
+  const VkDeviceSize page = initialContentsFillPageSize;
+
+  // zero, zero, varying, constant pattern, zero, then a trailing partial page of zeroes
+  bytebuf contents;
+  contents.resize(size_t(page * 5 + 6));
+
+  for(VkDeviceSize i = 0; i < page; i++)
+    contents[size_t(page * 2 + i)] = byte(i * 13);
+
+  const uint32_t pattern = 0xdeadbeef;
+  for(VkDeviceSize i = 0; i < page; i += sizeof(uint32_t))
+    memcpy(&contents[size_t(page * 3 + i)], &pattern, sizeof(pattern));
+
+  std::vector<VkInitialContentsFill> fills;
+  VkDeviceSize filled = FindInitialContentsFills(contents.data(), contents.size(), fills);
+
+  CHECK(filled == page * 4);
+  REQUIRE(fills.size() == 3);
+
+  CHECK(fills[0].offset == 0);
+  CHECK(fills[0].size == page * 2);
+  CHECK(fills[0].value == 0);
+
+  CHECK(fills[1].offset == page * 3);
+  CHECK(fills[1].size == page);
+  CHECK(fills[1].value == pattern);
+
+  CHECK(fills[2].offset == page * 4);
+  CHECK(fills[2].size == page);
+  CHECK(fills[2].value == 0);
+
+  CHECK(ValidInitialContentsFills(fills, contents.size()));
+
+  std::vector<VkBufferCopy> copies =
+      GetInitialContentsCopies(fills.data(), fills.size(), contents.size());
+
+  REQUIRE(copies.size() == 2);
+  CHECK(copies[0].srcOffset == 0);
+  CHECK(copies[0].dstOffset == page * 2);
+  CHECK(copies[0].size == page);
+  CHECK(copies[1].srcOffset == page);
+  CHECK(copies[1].dstOffset == page * 5);
+  CHECK(copies[1].size == 6);
+
+  bytebuf packed;
+  packed.resize(size_t(contents.size() - filled));
+
+  for(const VkBufferCopy &copy : copies)
+    memcpy(packed.data() + copy.srcOffset, contents.data() + copy.dstOffset, (size_t)copy.size);
+
+  bytebuf expanded;
+  expanded.resize(contents.size());
+  memset(expanded.data(), 0xcc, expanded.size());
+
+  ExpandInitialContents(packed.data(), fills, contents.size(), expanded.data());
+
+  CHECK(expanded == contents);
+
+  SECTION("Invalid fills are rejected")
+  {
+    std::vector<VkInitialContentsFill> invalid = fills;
+    invalid[1].offset = page;
+    CHECK_FALSE(ValidInitialContentsFills(invalid, contents.size()));
+
+    invalid = fills;
+    invalid[2].size = page * 4;
+    CHECK_FALSE(ValidInitialContentsFills(invalid, contents.size()));
+
+    invalid = fills;
+    invalid[2].offset += 2;
+    CHECK_FALSE(ValidInitialContentsFills(invalid, contents.size()));
+  }
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
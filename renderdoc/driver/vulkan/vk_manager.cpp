@@ -581,6 +581,53 @@ bool VulkanResourceManager::Force_InitialState(WrappedVkRes *res, bool prepare)
   return false;
 }
 
+bool VulkanResourceManager::AllowRetain_InitialState(WrappedVkRes *res)
+{
+  VkResourceType type = IdentifyTypeByPtr(res);
+
+  // descriptor set updates don't mark the set as changed and sparse resources can be rebound, so
+  // only plain images and memory are retained.
+  if(type == eResDeviceMemory)
+  {
+    // writes through a persistent map aren't tracked until it's unmapped
+    MemMapState *state = ((WrappedVkDeviceMemory *)res)->record->memMapState;
+
+    return state == NULL || state->mappedPtr == NULL;
+  }
+  else if(type == eResImage)
+  {
+    VkResourceRecord *record = ((WrappedVkImage *)res)->record;
+
+    if(record->sparseInfo)
+      return false;
+
+    // writes through resources aliasing the image only mark the memory it's bound to as changed
+    if(record->baseResource != ResourceId())
+    {
+      if(HasChangedSinceCapture(record->baseResource))
+        return false;
+
+      VkResourceRecord *memrecord = GetResourceRecord(record->baseResource);
+
+      if(memrecord == NULL || (memrecord->memMapState && memrecord->memMapState->mappedPtr))
+        return false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+ResourceId VulkanResourceManager::GetBackingResource(ResourceId id)
+{
+  // buffers and images point to the memory they're bound to, and views to their buffer's memory or
+  // their image. Writes through any of them change the contents of what they're bound to.
+  VkResourceRecord *record = GetResourceRecord(id);
+
+  return record ? record->baseResource : ResourceId();
+}
+
 bool VulkanResourceManager::Need_InitialStateChunk(WrappedVkRes *res)
 {
   return true;
@@ -591,9 +638,10 @@ bool VulkanResourceManager::Prepare_InitialState(WrappedVkRes *res)
   return m_Core->Prepare_InitialState(res);
 }
 
-uint32_t VulkanResourceManager::GetSize_InitialState(ResourceId id, WrappedVkRes *res)
+uint32_t VulkanResourceManager::GetSize_InitialState(ResourceId id, WrappedVkRes *res,
+                                                    const BlobStore *blobs)
 {
-  return m_Core->GetSize_InitialState(id, res);
+  return m_Core->GetSize_InitialState(id, res, blobs);
 }
 
 bool VulkanResourceManager::Serialise_InitialState(WriteSerialiser &ser, ResourceId resid,
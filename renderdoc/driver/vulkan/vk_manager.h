@@ -78,6 +78,17 @@ struct SparseImageInitState
 
 DECLARE_REFLECTION_STRUCT(SparseImageInitState);
 
+// a range of image or memory initial contents with a constant 32-bit value, which is stored and
+// applied as a fill instead of as data
+struct VkInitialContentsFill
+{
+  VkDeviceSize offset;
+  VkDeviceSize size;
+  uint32_t value;
+};
+
+DECLARE_REFLECTION_STRUCT(VkInitialContentsFill);
+
 // this struct is copied around and for that reason we explicitly keep it simple and POD. The
 // lifetime of the memory allocated is controlled by the resource manager - when preparing or
 // serialising, we explicitly set the initial contents, then when the whole system is done with them
@@ -121,6 +132,7 @@ struct VkInitialContents
     SAFE_DELETE_ARRAY(descriptorSlots);
     SAFE_DELETE_ARRAY(descriptorWrites);
     SAFE_DELETE_ARRAY(descriptorInfo);
+    SAFE_DELETE_ARRAY(fills);
 
     rm->ResourceTypeRelease(GetWrapped(buf));
     rm->ResourceTypeRelease(GetWrapped(img));
@@ -160,6 +172,14 @@ struct VkInitialContents
   MemoryAllocation mem;
   Tag tag;
 
+  // on replay, device memory contents can have constant ranges that are filled rather than copied.
+  // mem then only contains the data between the fills, packed together, out of contentsSize bytes.
+  // While capturing mem holds all contentsSize bytes, and the fills are found once when it's read
+  // back so that sizing and serialising the contents don't both have to scan it.
+  VkInitialContentsFill *fills;
+  uint32_t numFills;
+  VkDeviceSize contentsSize;
+
   // sparse resources need extra information. Which one is valid, depends on the value of type above
   union
   {
@@ -413,9 +433,11 @@ private:
 
   bool Force_InitialState(WrappedVkRes *res, bool prepare);
   bool AllowDeletedResource_InitialState() { return true; }
+  bool AllowRetain_InitialState(WrappedVkRes *res);
+  ResourceId GetBackingResource(ResourceId id);
   bool Need_InitialStateChunk(WrappedVkRes *res);
   bool Prepare_InitialState(WrappedVkRes *res);
-  uint32_t GetSize_InitialState(ResourceId id, WrappedVkRes *res);
+  uint32_t GetSize_InitialState(ResourceId id, WrappedVkRes *res, const BlobStore *blobs);
   bool Serialise_InitialState(WriteSerialiser &ser, ResourceId resid, WrappedVkRes *res);
   void Create_InitialState(ResourceId id, WrappedVkRes *live, bool hasData);
   void Apply_InitialState(WrappedVkRes *live, VkInitialContents initial);
@@ -0,0 +1,1249 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "vk_core.h"
+#include "vk_replay.h"
+#include "vk_shader_cache.h"
+
+#include "maths/formatpacking.h"
+
+// Pixel history is gathered in a single replay of the frame. For every event that touches the
+// target we copy the pixel (and the depth/stencil pixel, if a depth attachment is bound) into a
+// readback buffer before and after the event. Drawcalls are also run twice with occlusion queries:
+// once with a 'coverage' pipeline that has all tests and writes disabled, and then for real. Both
+// are scissored to the pixel, so the queries only count fragments at the pixel and the draw only
+// modifies the pixel - which is all we care about for the rest of the replay. The coverage run
+// must not have side effects, so it leaves out a fragment shader that writes to storage resources,
+// and is skipped entirely if an earlier stage does.
+//
+// Copies can't be recorded inside a render pass, so for events inside one we end the render pass
+// and resume it afterwards with a version that loads and stores all attachments. This is only
+// possible with single-subpass render passes recorded in primary command buffers, events in other
+// cases are skipped.
+
+// every snapshot gets a fixed-size slot in the readback buffer. The colour value goes at the start
+// (buffer offsets must be a multiple of the texel size, so the slot size is a multiple of every
+// texel size up to 32 bytes) with depth and stencil at fixed offsets after it.
+static const VkDeviceSize PixelSnapshotSize = 96;
+static const VkDeviceSize PixelSnapshotDepthOffset = 64;
+static const VkDeviceSize PixelSnapshotStencilOffset = 80;
+
+static VkImageAspectFlags FormatAspects(VkFormat fmt)
+{
+  if(IsDepthAndStencilFormat(fmt))
+    return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+  else if(IsStencilOnlyFormat(fmt))
+    return VK_IMAGE_ASPECT_STENCIL_BIT;
+  else if(IsDepthOrStencilFormat(fmt))
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+  return VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+static VkRect2D IntersectRect(const VkRect2D &a, const VkRect2D &b)
+{
+  int64_t x0 = RDCMAX(a.offset.x, b.offset.x);
+  int64_t y0 = RDCMAX(a.offset.y, b.offset.y);
+  int64_t x1 = RDCMIN(int64_t(a.offset.x) + a.extent.width, int64_t(b.offset.x) + b.extent.width);
+  int64_t y1 = RDCMIN(int64_t(a.offset.y) + a.extent.height, int64_t(b.offset.y) + b.extent.height);
+
+  VkRect2D ret = {{int32_t(x0), int32_t(y0)}, {0, 0}};
+  if(x1 > x0 && y1 > y0)
+  {
+    ret.extent.width = uint32_t(x1 - x0);
+    ret.extent.height = uint32_t(y1 - y0);
+  }
+
+  return ret;
+}
+
+// returns the layout each attachment is used in by the first subpass, or UNDEFINED if it's unused
+static std::vector<VkImageLayout> GetSubpassLayouts(const VulkanCreationInfo::RenderPass &rp)
+{
+  const VulkanCreationInfo::RenderPass::Subpass &sub = rp.subpasses[0];
+
+  std::vector<VkImageLayout> layouts(rp.attachments.size(), VK_IMAGE_LAYOUT_UNDEFINED);
+
+  for(size_t i = 0; i < sub.inputAttachments.size(); i++)
+    if(sub.inputAttachments[i] < layouts.size())
+      layouts[sub.inputAttachments[i]] = sub.inputLayouts[i];
+
+  for(size_t i = 0; i < sub.colorAttachments.size(); i++)
+  {
+    if(sub.colorAttachments[i] < layouts.size())
+      layouts[sub.colorAttachments[i]] = sub.colorLayouts[i];
+
+    // resolve attachment layouts aren't stored, but they can only be used as colour attachments
+    if(sub.resolveAttachments[i] < layouts.size())
+      layouts[sub.resolveAttachments[i]] = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  }
+
+  if(sub.depthstencilAttachment >= 0)
+    layouts[sub.depthstencilAttachment] = sub.depthstencilLayout;
+
+  return layouts;
+}
+
+// the layout an attachment is left in at the end of the render pass on replay. Presentable layouts
+// are replaced when the render pass is created, since nothing is presented on replay.
+static VkImageLayout GetReplayFinalLayout(const VkAttachmentDescription &att)
+{
+  VkImageLayout ret = att.finalLayout;
+  ReplacePresentableImageLayout(ret);
+  return ret;
+}
+
+struct VulkanPixelHistoryCallback : public VulkanDrawcallCallback
+{
+  struct EventResult
+  {
+    uint32_t eventId = 0;
+    // the callback saw this event and recorded snapshots for it
+    bool recorded = false;
+    // the occlusion queries were recorded around the drawcall
+    bool queried = false;
+    // the coverage query was recorded. If not, only the query with tests enabled is valid
+    bool coverageQueried = false;
+    bool directWrite = false;
+    bool scissorClipped = false;
+    bool depthTest = false;
+    bool stencilTest = false;
+    // the formats the snapshots were copied from, for decoding
+    VkFormat colourFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+  };
+
+  // an event can be listed several times with different usages, e.g. when the target is bound
+  // both as a colour target and as a storage image. Returns one result per event in event order,
+  // with the flags from all of its usages merged.
+  static std::vector<EventResult> MergeEvents(const vector<EventUsage> &events)
+  {
+    std::vector<EventResult> ret;
+    std::map<uint32_t, size_t> index;
+
+    for(const EventUsage &u : events)
+    {
+      auto it = index.find(u.eventId);
+      if(it == index.end())
+      {
+        it = index.insert(std::make_pair(u.eventId, ret.size())).first;
+        ret.push_back(EventResult());
+        ret.back().eventId = u.eventId;
+      }
+
+      if(u.usage >= ResourceUsage::VS_RWResource && u.usage <= ResourceUsage::All_RWResource)
+        ret[it->second].directWrite = true;
+    }
+
+    std::sort(ret.begin(), ret.end(),
+              [](const EventResult &a, const EventResult &b) { return a.eventId < b.eventId; });
+
+    return ret;
+  }
+
+  // each event has two snapshots and two queries. The snapshots are before and after the event,
+  // the queries are for coverage and with the tests enabled.
+  static size_t SnapshotSlot(size_t idx, bool post) { return idx * 2 + (post ? 1 : 0); }
+  static uint32_t QueryIndex(size_t idx, bool tested)
+  {
+    return uint32_t(idx * 2 + (tested ? 1 : 0));
+  }
+
+  // fills out the test results of a modification from the occlusion query results. occlusion[0]
+  // is only valid if the coverage query was recorded. Returns false if the event didn't touch the
+  // pixel and should be left out of the history.
+  static bool ClassifyResult(const EventResult &res, const uint64_t occlusion[2],
+                             PixelModification &mod)
+  {
+    mod.eventId = res.eventId;
+    mod.directShaderWrite = res.directWrite;
+
+    if(!res.queried)
+      return true;
+
+    // without the coverage query, a drawcall that didn't reach the pixel can't be told apart from
+    // one that failed its tests, so we have to assume the former.
+    const uint64_t coverage = res.coverageQueried ? occlusion[0] : occlusion[1];
+
+    // the drawcall didn't cover the pixel, even with every test disabled
+    if(coverage == 0 && !res.directWrite)
+      return false;
+
+    // we only have the one query with tests enabled, so we can't tell depth and stencil failures
+    // apart when both are enabled.
+    if(occlusion[1] == 0)
+    {
+      if(res.scissorClipped)
+        mod.scissorClipped = true;
+      else if(res.stencilTest && !res.depthTest)
+        mod.stencilTestFailed = true;
+      else if(res.depthTest)
+        mod.depthTestFailed = true;
+    }
+
+    return true;
+  }
+
+  VulkanPixelHistoryCallback(WrappedVulkan *vk, VulkanCreationInfo &creationInfo,
+                             ResourceId target, uint32_t x, uint32_t y, uint32_t mip,
+                             uint32_t slice, const std::vector<EventResult> &events,
+                             VkBuffer readback, VkQueryPool occlusionPool)
+      : m_pDriver(vk),
+        m_CreationInfo(creationInfo),
+        m_Target(target),
+        m_Mip(mip),
+        m_Slice(slice),
+        m_Readback(readback),
+        m_OcclusionPool(occlusionPool)
+  {
+    m_Pixel.offset.x = int32_t(x);
+    m_Pixel.offset.y = int32_t(y);
+    m_Pixel.extent.width = m_Pixel.extent.height = 1;
+
+    m_Results = events;
+    for(size_t i = 0; i < m_Results.size(); i++)
+      m_EventIndex[m_Results[i].eventId] = i;
+
+    if(m_pDriver->GetDeviceFeatures().occlusionQueryPrecise)
+      m_QueryFlags = VK_QUERY_CONTROL_PRECISE_BIT;
+
+    m_pDriver->SetDrawcallCB(this);
+  }
+  ~VulkanPixelHistoryCallback()
+  {
+    m_pDriver->SetDrawcallCB(NULL);
+
+    VkDevice dev = m_pDriver->GetDev();
+
+    for(auto it = m_PipelineCache.begin(); it != m_PipelineCache.end(); ++it)
+    {
+      m_pDriver->vkDestroyPipeline(dev, it->second.coverage, NULL);
+      m_pDriver->vkDestroyPipeline(dev, it->second.scissored, NULL);
+    }
+
+    for(auto it = m_ResumeRPs.begin(); it != m_ResumeRPs.end(); ++it)
+      ObjDisp(dev)->DestroyRenderPass(Unwrap(dev), it->second, NULL);
+  }
+
+  void PreDraw(uint32_t eid, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end())
+      return;
+
+    const size_t idx = it->second;
+    EventResult &res = m_Results[idx];
+
+    const WrappedVulkan::CmdBufferState &state = m_pDriver->GetCurrentCmdBufferState();
+
+    if(!CanInterruptRenderPass(eid, state) || state.pipeline == ResourceId())
+      return;
+
+    const VulkanCreationInfo::Pipeline &p = m_CreationInfo.m_Pipeline[state.pipeline];
+    const PipelineVariants &pipes = GetPipelines(state.pipeline);
+
+    res.recorded = true;
+    res.queried = true;
+    res.coverageQueried = (pipes.coverage != VK_NULL_HANDLE);
+    res.depthTest = p.depthTestEnable;
+    res.stencilTest = p.stencilTestEnable;
+
+    SnapshotInRenderPass(cmd, state, SnapshotSlot(idx, false), res);
+
+    // keep the application's scissors, to restore after we've overridden them
+    m_AppScissors = state.scissors;
+
+    res.scissorClipped = true;
+    for(uint32_t v = 0; v < p.viewportCount; v++)
+    {
+      const VkRect2D &scissor = p.dynamicStates[VK_DYNAMIC_STATE_SCISSOR]
+                                    ? (v < m_AppScissors.size() ? m_AppScissors[v] : m_Pixel)
+                                    : p.scissors[v];
+      if(IntersectRect(scissor, m_Pixel).extent.width > 0)
+        res.scissorClipped = false;
+    }
+
+    if(!res.coverageQueried)
+    {
+      // the drawcall has side effects before rasterization so it can only run once, for real
+      BindTestedPipeline(cmd, state.pipeline, p);
+      ObjDisp(cmd)->CmdBeginQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, true),
+                                  m_QueryFlags);
+      return;
+    }
+
+    // run the drawcall first with all tests disabled, to see if it covers the pixel at all
+    ObjDisp(cmd)->CmdBindPipeline(Unwrap(cmd), VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                  Unwrap(pipes.coverage));
+
+    if(p.dynamicStates[VK_DYNAMIC_STATE_SCISSOR])
+      SetScissors(cmd, p.viewportCount, NULL);
+
+    ObjDisp(cmd)->CmdBeginQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, false), m_QueryFlags);
+  }
+
+  bool PostDraw(uint32_t eid, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end() || !m_Results[it->second].queried)
+      return false;
+
+    const size_t idx = it->second;
+
+    const WrappedVulkan::CmdBufferState &state = m_pDriver->GetCurrentCmdBufferState();
+    const VulkanCreationInfo::Pipeline &p = m_CreationInfo.m_Pipeline[state.pipeline];
+
+    if(!m_Results[idx].coverageQueried)
+    {
+      ObjDisp(cmd)->CmdEndQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, true));
+      FinishDraw(cmd, state, p, idx);
+      return false;
+    }
+
+    ObjDisp(cmd)->CmdEndQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, false));
+
+    // then run the real drawcall, still restricted to the pixel
+    BindTestedPipeline(cmd, state.pipeline, p);
+
+    ObjDisp(cmd)->CmdBeginQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, true), m_QueryFlags);
+
+    return true;
+  }
+
+  void PostRedraw(uint32_t eid, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end() || !m_Results[it->second].queried)
+      return;
+
+    const size_t idx = it->second;
+
+    ObjDisp(cmd)->CmdEndQuery(Unwrap(cmd), m_OcclusionPool, QueryIndex(idx, true));
+
+    const WrappedVulkan::CmdBufferState &state = m_pDriver->GetCurrentCmdBufferState();
+    const VulkanCreationInfo::Pipeline &p = m_CreationInfo.m_Pipeline[state.pipeline];
+
+    FinishDraw(cmd, state, p, idx);
+  }
+
+  void PreDispatch(uint32_t eid, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end())
+      return;
+
+    m_Results[it->second].recorded = true;
+    m_Results[it->second].directWrite = true;
+
+    SnapshotOutsideRenderPass(cmd, SnapshotSlot(it->second, false), m_Results[it->second]);
+  }
+
+  bool PostDispatch(uint32_t eid, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it != m_EventIndex.end() && m_Results[it->second].recorded)
+      SnapshotOutsideRenderPass(cmd, SnapshotSlot(it->second, true), m_Results[it->second]);
+
+    return false;
+  }
+
+  void PostRedispatch(uint32_t eid, VkCommandBuffer cmd) override {}
+  void PreMisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end())
+      return;
+
+    const WrappedVulkan::CmdBufferState &state = m_pDriver->GetCurrentCmdBufferState();
+
+    // clears of attachments happen inside the render pass
+    if(state.renderPass != ResourceId())
+    {
+      if(!CanInterruptRenderPass(eid, state))
+        return;
+
+      m_Results[it->second].recorded = true;
+      SnapshotInRenderPass(cmd, state, SnapshotSlot(it->second, false), m_Results[it->second]);
+    }
+    else
+    {
+      m_Results[it->second].recorded = true;
+      SnapshotOutsideRenderPass(cmd, SnapshotSlot(it->second, false), m_Results[it->second]);
+    }
+  }
+
+  bool PostMisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd) override
+  {
+    auto it = m_EventIndex.find(eid);
+    if(it == m_EventIndex.end() || !m_Results[it->second].recorded)
+      return false;
+
+    const WrappedVulkan::CmdBufferState &state = m_pDriver->GetCurrentCmdBufferState();
+
+    if(state.renderPass != ResourceId())
+      SnapshotInRenderPass(cmd, state, SnapshotSlot(it->second, true), m_Results[it->second]);
+    else
+      SnapshotOutsideRenderPass(cmd, SnapshotSlot(it->second, true), m_Results[it->second]);
+
+    return false;
+  }
+
+  void PostRemisc(uint32_t eid, DrawFlags flags, VkCommandBuffer cmd) override {}
+  void PreEndCommandBuffer(VkCommandBuffer cmd) override {}
+  void AliasEvent(uint32_t primary, uint32_t alias) override
+  {
+    // we only get callbacks the first time a command buffer is recorded, so the snapshots for
+    // resubmitted command buffers would be those of the first submission. Leave them out.
+  }
+
+  struct PipelineVariants
+  {
+    // all tests and writes disabled, scissored to the pixel
+    VkPipeline coverage = VK_NULL_HANDLE;
+    // the original pipeline with its static scissors restricted to the pixel
+    VkPipeline scissored = VK_NULL_HANDLE;
+  };
+
+  struct CopySource
+  {
+    VkImage image = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageAspectFlags aspects = 0;
+    uint32_t mip = 0, slice = 0;
+    bool is3D = false;
+    // the layout the image is in, and the layout to leave it in after copying
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout restoreLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  };
+
+  bool CanInterruptRenderPass(uint32_t eid, const WrappedVulkan::CmdBufferState &state)
+  {
+    if(state.renderPass == ResourceId())
+    {
+      RDCWARN("Can't fetch pixel history for event %u in a secondary command buffer", eid);
+      return false;
+    }
+
+    const VulkanCreationInfo::RenderPass &rp = m_CreationInfo.m_RenderPass[state.renderPass];
+
+    if(rp.subpasses.size() != 1 || !rp.subpasses[0].multiviews.empty())
+    {
+      RDCWARN("Can't fetch pixel history for event %u in a multi-subpass or multiview render pass",
+              eid);
+      return false;
+    }
+
+    return true;
+  }
+
+  void FillTargetSource(CopySource &src, VkImageLayout layout, VkImageLayout restoreLayout)
+  {
+    const VulkanCreationInfo::Image &iminfo = m_CreationInfo.m_Image[m_Target];
+
+    src.image = m_pDriver->GetResourceManager()->GetCurrentHandle<VkImage>(m_Target);
+    src.format = iminfo.format;
+    src.aspects = FormatAspects(iminfo.format);
+    src.mip = m_Mip;
+    src.slice = m_Slice;
+    src.is3D = (iminfo.type == VK_IMAGE_TYPE_3D);
+    src.layout = layout;
+    src.restoreLayout = restoreLayout;
+  }
+
+  void SnapshotOutsideRenderPass(VkCommandBuffer cmd, size_t slot, EventResult &res)
+  {
+    const VulkanCreationInfo::Image &iminfo = m_CreationInfo.m_Image[m_Target];
+
+    VkImageLayout layout =
+        m_pDriver->GetCurrentImageLayout(cmd, m_Target, FormatAspects(iminfo.format), m_Mip,
+                                         iminfo.type == VK_IMAGE_TYPE_3D ? 0 : m_Slice);
+
+    CopySource src;
+    FillTargetSource(src, layout, layout);
+    CopyPixel(cmd, src, slot, res);
+  }
+
+  void SnapshotInRenderPass(VkCommandBuffer cmd, const WrappedVulkan::CmdBufferState &state,
+                            size_t slot, EventResult &res)
+  {
+    const VulkanCreationInfo::RenderPass &rp = m_CreationInfo.m_RenderPass[state.renderPass];
+    const VulkanCreationInfo::Framebuffer &fb = m_CreationInfo.m_Framebuffer[state.framebuffer];
+    const VulkanCreationInfo::Image &iminfo = m_CreationInfo.m_Image[m_Target];
+
+    std::vector<VkImageLayout> subpassLayouts = GetSubpassLayouts(rp);
+
+    CopySource target, depth;
+
+    // if the target isn't an attachment, it's in whatever layout it was last transitioned to
+    {
+      VkImageLayout layout = m_pDriver->GetCurrentImageLayout(
+          cmd, m_Target, FormatAspects(iminfo.format), m_Mip,
+          iminfo.type == VK_IMAGE_TYPE_3D ? 0 : m_Slice);
+      FillTargetSource(target, layout, layout);
+    }
+
+    // this ends whichever render pass was begun: the application's as created on replay, or one of
+    // our resume render passes. Both store every attachment regardless of the application's store
+    // ops (see ReplaceDiscardingAttachmentOps), so ending early doesn't leave any undefined.
+    ObjDisp(cmd)->CmdEndRenderPass(Unwrap(cmd));
+
+    // every attachment is now in its final layout, and needs to go back to the layout the subpass
+    // uses before we resume
+    std::vector<VkImageMemoryBarrier> barriers;
+
+    for(size_t a = 0; a < fb.attachments.size() && a < rp.attachments.size(); a++)
+    {
+      if(subpassLayouts[a] == VK_IMAGE_LAYOUT_UNDEFINED)
+        continue;
+
+      const VulkanCreationInfo::ImageView &view =
+          m_CreationInfo.m_ImageView[fb.attachments[a].view];
+
+      if(view.image == m_Target && m_Mip == view.range.baseMipLevel &&
+         m_Slice >= view.range.baseArrayLayer &&
+         m_Slice - view.range.baseArrayLayer < view.range.layerCount)
+      {
+        FillTargetSource(target, GetReplayFinalLayout(rp.attachments[a]), subpassLayouts[a]);
+        continue;
+      }
+
+      VkImage image = m_pDriver->GetResourceManager()->GetCurrentHandle<VkImage>(view.image);
+
+      // snapshot the depth attachment too, unless the target is itself a depth image
+      if(int32_t(a) == rp.subpasses[0].depthstencilAttachment &&
+         !IsDepthOrStencilFormat(iminfo.format) &&
+         m_CreationInfo.m_Image[view.image].samples == VK_SAMPLE_COUNT_1_BIT)
+      {
+        depth.image = image;
+        depth.format = view.format;
+        depth.aspects = FormatAspects(view.format);
+        depth.mip = view.range.baseMipLevel;
+        depth.slice = view.range.baseArrayLayer;
+        depth.layout = GetReplayFinalLayout(rp.attachments[a]);
+        depth.restoreLayout = subpassLayouts[a];
+        continue;
+      }
+
+      const VkImageLayout finalLayout = GetReplayFinalLayout(rp.attachments[a]);
+
+      if(finalLayout == subpassLayouts[a])
+        continue;
+
+      VkImageMemoryBarrier barrier = {
+          VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+          NULL,
+          VK_ACCESS_ALL_WRITE_BITS,
+          VK_ACCESS_ALL_READ_BITS | VK_ACCESS_ALL_WRITE_BITS,
+          finalLayout,
+          subpassLayouts[a],
+          VK_QUEUE_FAMILY_IGNORED,
+          VK_QUEUE_FAMILY_IGNORED,
+          Unwrap(image),
+          view.range,
+      };
+      barrier.subresourceRange.aspectMask = FormatAspects(view.format);
+      barriers.push_back(barrier);
+    }
+
+    if(!barriers.empty())
+      DoPipelineBarrier(cmd, (uint32_t)barriers.size(), barriers.data());
+
+    CopyPixel(cmd, target, slot, res);
+    if(depth.image != VK_NULL_HANDLE)
+      CopyPixel(cmd, depth, slot, res);
+
+    VkRenderPassBeginInfo rpbegin = {
+        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        NULL,
+        GetResumeRenderPass(state.renderPass),
+        Unwrap(m_pDriver->GetResourceManager()->GetCurrentHandle<VkFramebuffer>(state.framebuffer)),
+        {{0, 0}, {fb.width, fb.height}},
+        0,
+        NULL,
+    };
+    ObjDisp(cmd)->CmdBeginRenderPass(Unwrap(cmd), &rpbegin, VK_SUBPASS_CONTENTS_INLINE);
+  }
+
+  void CopyPixel(VkCommandBuffer cmd, const CopySource &src, size_t slot, EventResult &res)
+  {
+    VkImageMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        NULL,
+        VK_ACCESS_ALL_WRITE_BITS,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        src.layout,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        Unwrap(src.image),
+        {src.aspects, src.mip, 1, src.is3D ? 0 : src.slice, 1},
+    };
+
+    DoPipelineBarrier(cmd, 1, &barrier);
+
+    VkBufferImageCopy regions[2] = {};
+    uint32_t regionCount = 0;
+
+    for(VkImageAspectFlags aspect :
+        {VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_ASPECT_STENCIL_BIT})
+    {
+      if((src.aspects & aspect) == 0)
+        continue;
+
+      VkBufferImageCopy &region = regions[regionCount++];
+
+      region.bufferOffset = VkDeviceSize(slot) * PixelSnapshotSize;
+      if(aspect == VK_IMAGE_ASPECT_DEPTH_BIT)
+        region.bufferOffset += PixelSnapshotDepthOffset;
+      else if(aspect == VK_IMAGE_ASPECT_STENCIL_BIT)
+        region.bufferOffset += PixelSnapshotStencilOffset;
+
+      region.imageSubresource.aspectMask = aspect;
+      region.imageSubresource.mipLevel = src.mip;
+      region.imageSubresource.baseArrayLayer = src.is3D ? 0 : src.slice;
+      region.imageSubresource.layerCount = 1;
+      region.imageOffset.x = m_Pixel.offset.x;
+      region.imageOffset.y = m_Pixel.offset.y;
+      region.imageOffset.z = src.is3D ? int32_t(src.slice) : 0;
+      region.imageExtent.width = region.imageExtent.height = region.imageExtent.depth = 1;
+    }
+
+    ObjDisp(cmd)->CmdCopyImageToBuffer(Unwrap(cmd), Unwrap(src.image),
+                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Readback,
+                                       regionCount, regions);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_ALL_READ_BITS | VK_ACCESS_ALL_WRITE_BITS;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = src.restoreLayout;
+
+    DoPipelineBarrier(cmd, 1, &barrier);
+
+    if(src.aspects & VK_IMAGE_ASPECT_COLOR_BIT)
+      res.colourFormat = src.format;
+    else
+      res.depthFormat = src.format;
+  }
+
+  void SetScissors(VkCommandBuffer cmd, uint32_t count, const std::vector<VkRect2D> *scissors)
+  {
+    std::vector<VkRect2D> pixelScissors(count, m_Pixel);
+
+    if(scissors)
+    {
+      for(uint32_t i = 0; i < count && i < scissors->size(); i++)
+        pixelScissors[i] = IntersectRect(scissors->at(i), m_Pixel);
+    }
+
+    if(count > 0)
+      ObjDisp(cmd)->CmdSetScissor(Unwrap(cmd), 0, count, pixelScissors.data());
+  }
+
+  // binds the pipeline for the drawcall with tests enabled, restricted to the pixel
+  void BindTestedPipeline(VkCommandBuffer cmd, ResourceId pipeline,
+                          const VulkanCreationInfo::Pipeline &p)
+  {
+    if(p.dynamicStates[VK_DYNAMIC_STATE_SCISSOR])
+    {
+      ObjDisp(cmd)->CmdBindPipeline(
+          Unwrap(cmd), VK_PIPELINE_BIND_POINT_GRAPHICS,
+          Unwrap(m_pDriver->GetResourceManager()->GetCurrentHandle<VkPipeline>(pipeline)));
+
+      SetScissors(cmd, p.viewportCount, &m_AppScissors);
+    }
+    else
+    {
+      ObjDisp(cmd)->CmdBindPipeline(Unwrap(cmd), VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                    Unwrap(GetPipelines(pipeline).scissored));
+    }
+  }
+
+  // restores the application's pipeline and scissors after an instrumented drawcall, and takes
+  // the snapshot after it
+  void FinishDraw(VkCommandBuffer cmd, const WrappedVulkan::CmdBufferState &state,
+                  const VulkanCreationInfo::Pipeline &p, size_t idx)
+  {
+    ObjDisp(cmd)->CmdBindPipeline(
+        Unwrap(cmd), VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Unwrap(m_pDriver->GetResourceManager()->GetCurrentHandle<VkPipeline>(state.pipeline)));
+
+    // we overwrote every scissor up to the viewport count. Restore the ones the application set,
+    // and set any others to the whole framebuffer rather than leaving them at the pixel.
+    if(p.dynamicStates[VK_DYNAMIC_STATE_SCISSOR] && p.viewportCount > 0)
+    {
+      const VulkanCreationInfo::Framebuffer &fb = m_CreationInfo.m_Framebuffer[state.framebuffer];
+
+      std::vector<VkRect2D> scissors = m_AppScissors;
+      if(scissors.size() < p.viewportCount)
+        scissors.resize(p.viewportCount, {{0, 0}, {fb.width, fb.height}});
+
+      ObjDisp(cmd)->CmdSetScissor(Unwrap(cmd), 0, (uint32_t)scissors.size(), scissors.data());
+    }
+
+    SnapshotInRenderPass(cmd, state, SnapshotSlot(idx, true), m_Results[idx]);
+  }
+
+  VkRenderPass GetResumeRenderPass(ResourceId renderPass)
+  {
+    VkRenderPass &ret = m_ResumeRPs[renderPass];
+
+    if(ret != VK_NULL_HANDLE)
+      return ret;
+
+    const VulkanCreationInfo::RenderPass &rp = m_CreationInfo.m_RenderPass[renderPass];
+    const VulkanCreationInfo::RenderPass::Subpass &sub = rp.subpasses[0];
+
+    std::vector<VkImageLayout> subpassLayouts = GetSubpassLayouts(rp);
+
+    // load and store everything, starting in the subpass layouts and ending in the same final
+    // layouts as the replayed render pass so the application's transitions after it still line up.
+    std::vector<VkAttachmentDescription> atts = rp.attachments;
+    for(size_t a = 0; a < atts.size(); a++)
+    {
+      atts[a].finalLayout = GetReplayFinalLayout(atts[a]);
+      atts[a].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+      atts[a].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+      atts[a].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+      atts[a].stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+      atts[a].initialLayout = subpassLayouts[a] == VK_IMAGE_LAYOUT_UNDEFINED ? atts[a].finalLayout
+                                                                             : subpassLayouts[a];
+    }
+
+    std::vector<VkAttachmentReference> inputs, colours, resolves;
+    for(size_t i = 0; i < sub.inputAttachments.size(); i++)
+      inputs.push_back({sub.inputAttachments[i], sub.inputLayouts[i]});
+    for(size_t i = 0; i < sub.colorAttachments.size(); i++)
+    {
+      colours.push_back({sub.colorAttachments[i], sub.colorLayouts[i]});
+      resolves.push_back({sub.resolveAttachments[i], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    }
+
+    VkAttachmentReference depth = {VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
+    if(sub.depthstencilAttachment >= 0)
+      depth = {uint32_t(sub.depthstencilAttachment), sub.depthstencilLayout};
+
+    VkSubpassDescription subpass = {
+        0,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        (uint32_t)inputs.size(),
+        inputs.data(),
+        (uint32_t)colours.size(),
+        colours.data(),
+        resolves.data(),
+        &depth,
+        0,
+        NULL,
+    };
+
+    VkRenderPassCreateInfo rpinfo = {
+        VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        NULL,
+        0,
+        (uint32_t)atts.size(),
+        atts.data(),
+        1,
+        &subpass,
+        0,
+        NULL,
+    };
+
+    VkDevice dev = m_pDriver->GetDev();
+
+    VkResult vkr = ObjDisp(dev)->CreateRenderPass(Unwrap(dev), &rpinfo, NULL, &ret);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    return ret;
+  }
+
+  const PipelineVariants &GetPipelines(ResourceId pipeline)
+  {
+    auto it = m_PipelineCache.find(pipeline);
+    if(it != m_PipelineCache.end())
+      return it->second;
+
+    PipelineVariants &ret = m_PipelineCache[pipeline];
+
+    const VulkanCreationInfo::Pipeline &p = m_CreationInfo.m_Pipeline[pipeline];
+
+    // find which stages write to storage resources, and would have side effects if run again
+    bool preRasterWrites = false, fragmentWrites = false;
+    for(size_t i = 0; i < ARRAY_COUNT(p.shaders); i++)
+    {
+      if(p.shaders[i].refl == NULL || p.shaders[i].refl->readWriteResources.empty())
+        continue;
+
+      // shaders are indexed by stage bit
+      if((1U << i) == VK_SHADER_STAGE_FRAGMENT_BIT)
+        fragmentWrites = true;
+      else
+        preRasterWrites = true;
+    }
+
+    VkGraphicsPipelineCreateInfo pipeCreateInfo;
+    m_pDriver->GetShaderCache()->MakeGraphicsPipelineInfo(pipeCreateInfo, pipeline);
+
+    VkPipelineViewportStateCreateInfo *vp =
+        (VkPipelineViewportStateCreateInfo *)pipeCreateInfo.pViewportState;
+    VkRect2D *scissors = (VkRect2D *)vp->pScissors;
+
+    VkDevice dev = m_pDriver->GetDev();
+    VkResult vkr = VK_SUCCESS;
+
+    // with dynamic scissors we restrict the scissor with the original pipeline instead
+    if(!p.dynamicStates[VK_DYNAMIC_STATE_SCISSOR])
+    {
+      for(uint32_t i = 0; i < vp->scissorCount; i++)
+        scissors[i] = IntersectRect(p.scissors[i], m_Pixel);
+
+      vkr = m_pDriver->vkCreateGraphicsPipelines(dev, VK_NULL_HANDLE, 1, &pipeCreateInfo, NULL,
+                                                 &ret.scissored);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
+
+    // there's no way to run the stages before rasterization again without their side effects, so
+    // there's no coverage pipeline and the drawcall is only run once.
+    if(preRasterWrites)
+      return ret;
+
+    for(uint32_t i = 0; i < vp->scissorCount; i++)
+      scissors[i] = m_Pixel;
+
+    // without a fragment shader every rasterized sample still counts towards the query. This
+    // misses fragments the shader would discard, but doesn't repeat its storage writes.
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    if(fragmentWrites)
+    {
+      for(uint32_t i = 0; i < pipeCreateInfo.stageCount; i++)
+        if(pipeCreateInfo.pStages[i].stage != VK_SHADER_STAGE_FRAGMENT_BIT)
+          stages.push_back(pipeCreateInfo.pStages[i]);
+
+      pipeCreateInfo.stageCount = (uint32_t)stages.size();
+      pipeCreateInfo.pStages = stages.data();
+    }
+
+    // disable colour writes/blends
+    VkPipelineColorBlendStateCreateInfo *cb =
+        (VkPipelineColorBlendStateCreateInfo *)pipeCreateInfo.pColorBlendState;
+    for(uint32_t i = 0; i < cb->attachmentCount; i++)
+    {
+      VkPipelineColorBlendAttachmentState *att =
+          (VkPipelineColorBlendAttachmentState *)&cb->pAttachments[i];
+      att->blendEnable = false;
+      att->colorWriteMask = 0x0;
+    }
+
+    // disable depth/stencil testing and writes
+    VkPipelineDepthStencilStateCreateInfo *ds =
+        (VkPipelineDepthStencilStateCreateInfo *)pipeCreateInfo.pDepthStencilState;
+    ds->depthTestEnable = false;
+    ds->depthWriteEnable = false;
+    ds->stencilTestEnable = false;
+    ds->depthBoundsTestEnable = false;
+
+    vkr = m_pDriver->vkCreateGraphicsPipelines(dev, VK_NULL_HANDLE, 1, &pipeCreateInfo, NULL,
+                                               &ret.coverage);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    return ret;
+  }
+
+  WrappedVulkan *m_pDriver;
+  VulkanCreationInfo &m_CreationInfo;
+  ResourceId m_Target;
+  uint32_t m_Mip, m_Slice;
+  VkRect2D m_Pixel;
+  VkBuffer m_Readback;
+  VkQueryPool m_OcclusionPool;
+  VkQueryControlFlags m_QueryFlags = 0;
+
+  std::map<uint32_t, size_t> m_EventIndex;
+  std::vector<EventResult> m_Results;
+
+  // the application's dynamic scissors for the drawcall being instrumented
+  std::vector<VkRect2D> m_AppScissors;
+
+  std::map<ResourceId, PipelineVariants> m_PipelineCache;
+  std::map<ResourceId, VkRenderPass> m_ResumeRPs;
+};
+
+static void DecodeColour(VkFormat format, CompType typeHint, const byte *data, PixelValue &val)
+{
+  ResourceFormat fmt = MakeResourceFormat(format);
+
+  if(fmt.type == ResourceFormatType::Regular && typeHint != CompType::Typeless)
+    fmt.compType = typeHint;
+
+  if(fmt.type == ResourceFormatType::Regular &&
+     (fmt.compType == CompType::UInt || fmt.compType == CompType::SInt))
+  {
+    bool sint = (fmt.compType == CompType::SInt);
+
+    for(uint32_t c = 0; c < fmt.compCount && c < 4; c++)
+    {
+      const byte *comp = data + c * fmt.compByteWidth;
+
+      if(fmt.compByteWidth == 1)
+        val.uintValue[c] = sint ? uint32_t(int32_t(*(const int8_t *)comp)) : *comp;
+      else if(fmt.compByteWidth == 2)
+        val.uintValue[c] =
+            sint ? uint32_t(int32_t(*(const int16_t *)comp)) : *(const uint16_t *)comp;
+      else
+        val.uintValue[c] = *(const uint32_t *)comp;
+    }
+
+    return;
+  }
+
+  Vec4f col;
+  ConvertPixelsToFloat4(fmt, data, 1, 0, &col);
+
+  val.floatValue[0] = col.x;
+  val.floatValue[1] = col.y;
+  val.floatValue[2] = col.z;
+  val.floatValue[3] = col.w;
+}
+
+static void DecodeSnapshot(const VulkanPixelHistoryCallback::EventResult &res, CompType typeHint,
+                           const byte *slot, ModificationValue &val)
+{
+  if(res.colourFormat != VK_FORMAT_UNDEFINED)
+    DecodeColour(res.colourFormat, typeHint, slot, val.col);
+
+  // -1 marks values that aren't available
+  val.depth = -1.0f;
+  val.stencil = -1;
+
+  const byte *depth = slot + PixelSnapshotDepthOffset;
+
+  switch(res.depthFormat)
+  {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_D16_UNORM_S8_UINT: val.depth = float(*(const uint16_t *)depth) / 65535.0f; break;
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+      val.depth = float(*(const uint32_t *)depth & 0xffffff) / 16777215.0f;
+      break;
+    case VK_FORMAT_D32_SFLOAT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT: val.depth = *(const float *)depth; break;
+    default: break;
+  }
+
+  if(res.depthFormat != VK_FORMAT_UNDEFINED && IsStencilFormat(res.depthFormat))
+    val.stencil = slot[PixelSnapshotStencilOffset];
+}
+
+vector<PixelModification> VulkanReplay::PixelHistory(vector<EventUsage> events, ResourceId target,
+                                                     uint32_t x, uint32_t y, uint32_t slice,
+                                                     uint32_t mip, uint32_t sampleIdx,
+                                                     CompType typeHint)
+{
+  vector<PixelModification> history;
+
+  if(events.empty())
+    return history;
+
+  VulkanCreationInfo::Image &iminfo = m_pDriver->m_CreationInfo.m_Image[target];
+
+  if(iminfo.samples != VK_SAMPLE_COUNT_1_BIT)
+  {
+    RDCWARN("Pixel history isn't supported on multisampled images");
+    return history;
+  }
+
+  SCOPED_TIMER("VulkanReplay::PixelHistory");
+
+  VkDevice dev = m_pDriver->GetDev();
+  const VkLayerDispatchTable *vt = ObjDisp(dev);
+  VkResult vkr = VK_SUCCESS;
+
+  const std::vector<VulkanPixelHistoryCallback::EventResult> merged =
+      VulkanPixelHistoryCallback::MergeEvents(events);
+
+  // two snapshots and two queries per event: before and after, and coverage and passed
+  GPUBuffer readback;
+  readback.Create(m_pDriver, dev, merged.size() * 2 * PixelSnapshotSize, 1,
+                  GPUBuffer::eGPUBufferReadback);
+
+  VkQueryPoolCreateInfo occlusionPoolCreateInfo = {
+      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL, 0, VK_QUERY_TYPE_OCCLUSION,
+      uint32_t(merged.size() * 2), 0};
+
+  VkQueryPool occlusionPool = VK_NULL_HANDLE;
+  vkr = vt->CreateQueryPool(Unwrap(dev), &occlusionPoolCreateInfo, NULL, &occlusionPool);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+  VkCommandBuffer cmd = m_pDriver->GetNextCmd();
+
+  vkr = vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  vt->CmdResetQueryPool(Unwrap(cmd), occlusionPool, 0, uint32_t(merged.size() * 2));
+
+  vkr = vt->EndCommandBuffer(Unwrap(cmd));
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+#if ENABLED(SINGLE_FLUSH_VALIDATE)
+  m_pDriver->SubmitCmds();
+#endif
+
+  VulkanPixelHistoryCallback cb(m_pDriver, m_pDriver->m_CreationInfo, target, x, y, mip, slice,
+                                merged, Unwrap(readback.buf), occlusionPool);
+
+  m_pDriver->ReplayLog(0, merged.back().eventId, eReplay_Full);
+
+  cmd = m_pDriver->GetNextCmd();
+
+  vkr = vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  // wait for the copies to finish before reading on CPU
+  VkBufferMemoryBarrier bufBarrier = {
+      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      NULL,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+      VK_ACCESS_HOST_READ_BIT,
+      VK_QUEUE_FAMILY_IGNORED,
+      VK_QUEUE_FAMILY_IGNORED,
+      Unwrap(readback.buf),
+      0,
+      VK_WHOLE_SIZE,
+  };
+  DoPipelineBarrier(cmd, 1, &bufBarrier);
+
+  vkr = vt->EndCommandBuffer(Unwrap(cmd));
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  m_pDriver->SubmitCmds();
+  m_pDriver->FlushQ();
+
+  const byte *data = (const byte *)readback.Map();
+
+  for(size_t i = 0; i < cb.m_Results.size(); i++)
+  {
+    const VulkanPixelHistoryCallback::EventResult &res = cb.m_Results[i];
+
+    if(!res.recorded)
+      continue;
+
+    PixelModification mod;
+    RDCEraseEl(mod);
+
+    // only fetch queries that were recorded, the others will never become available
+    uint64_t occlusion[2] = {};
+    if(res.queried)
+    {
+      if(res.coverageQueried)
+        vkr = vt->GetQueryPoolResults(Unwrap(dev), occlusionPool,
+                                      VulkanPixelHistoryCallback::QueryIndex(i, false), 2,
+                                      sizeof(occlusion), occlusion, sizeof(uint64_t),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+      else
+        vkr = vt->GetQueryPoolResults(Unwrap(dev), occlusionPool,
+                                      VulkanPixelHistoryCallback::QueryIndex(i, true), 1,
+                                      sizeof(uint64_t), &occlusion[1], sizeof(uint64_t),
+                                      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
+
+    if(!VulkanPixelHistoryCallback::ClassifyResult(res, occlusion, mod))
+      continue;
+
+    DecodeSnapshot(res, typeHint,
+                   data + VulkanPixelHistoryCallback::SnapshotSlot(i, false) * PixelSnapshotSize,
+                   mod.preMod);
+    DecodeSnapshot(res, typeHint,
+                   data + VulkanPixelHistoryCallback::SnapshotSlot(i, true) * PixelSnapshotSize,
+                   mod.postMod);
+
+    // per-fragment shader outputs would need another replay per fragment, so report the final
+    // value. This is exact for a single opaque fragment.
+    mod.shaderOut = mod.postMod;
+
+    history.push_back(mod);
+  }
+
+  readback.Unmap();
+  readback.Destroy();
+
+  vt->DestroyQueryPool(Unwrap(dev), occlusionPool, NULL);
+
+  return history;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#undef None
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Vulkan pixel history event classification", "[vulkan][pixelhistory]")
+{
+  typedef VulkanPixelHistoryCallback::EventResult EventResult;
+
+  SECTION("Usages of the same event are merged")
+  {
+    vector<EventUsage> events = {
+        EventUsage(30, ResourceUsage::ColorTarget),
+        EventUsage(10, ResourceUsage::CopyDst),
+        EventUsage(20, ResourceUsage::PS_RWResource),
+        EventUsage(20, ResourceUsage::ColorTarget),
+        EventUsage(30, ResourceUsage::CS_RWResource),
+        EventUsage(40, ResourceUsage::Clear),
+    };
+
+    std::vector<EventResult> merged = VulkanPixelHistoryCallback::MergeEvents(events);
+
+    REQUIRE(merged.size() == 4);
+
+    CHECK(merged[0].eventId == 10);
+    CHECK(merged[1].eventId == 20);
+    CHECK(merged[2].eventId == 30);
+    CHECK(merged[3].eventId == 40);
+
+    // a storage write in any usage makes it a direct write, whichever order they're listed in
+    CHECK_FALSE(merged[0].directWrite);
+    CHECK(merged[1].directWrite);
+    CHECK(merged[2].directWrite);
+    CHECK_FALSE(merged[3].directWrite);
+
+    for(const EventResult &res : merged)
+      CHECK_FALSE(res.recorded);
+  };
+
+  SECTION("Snapshot slots and queries are ordered and distinct")
+  {
+    std::set<size_t> slots;
+    std::set<uint32_t> queries;
+
+    for(size_t i = 0; i < 8; i++)
+    {
+      size_t pre = VulkanPixelHistoryCallback::SnapshotSlot(i, false);
+      size_t post = VulkanPixelHistoryCallback::SnapshotSlot(i, true);
+
+      // the snapshot after an event comes straight after the one before it, and before the next
+      // event's snapshots
+      CHECK(post == pre + 1);
+      CHECK(VulkanPixelHistoryCallback::SnapshotSlot(i + 1, false) == post + 1);
+
+      slots.insert(pre);
+      slots.insert(post);
+      queries.insert(VulkanPixelHistoryCallback::QueryIndex(i, false));
+      queries.insert(VulkanPixelHistoryCallback::QueryIndex(i, true));
+    }
+
+    // everything fits in the two per event that are allocated
+    CHECK(slots.size() == 16);
+    CHECK(*slots.rbegin() == 15);
+    CHECK(queries.size() == 16);
+    CHECK(*queries.rbegin() == 15);
+  };
+
+  SECTION("Query results are classified")
+  {
+    EventResult res;
+    res.eventId = 5;
+    res.recorded = true;
+
+    PixelModification mod;
+
+    // events without queries, like clears and copies, are always included
+    RDCEraseEl(mod);
+    uint64_t none[2] = {0, 0};
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, none, mod));
+    CHECK(mod.eventId == 5);
+    CHECK_FALSE(mod.depthTestFailed);
+
+    res.queried = true;
+    res.coverageQueried = true;
+    res.depthTest = true;
+
+    // not covering the pixel leaves the event out
+    RDCEraseEl(mod);
+    CHECK_FALSE(VulkanPixelHistoryCallback::ClassifyResult(res, none, mod));
+
+    // unless it writes directly, which doesn't go through rasterization
+    res.directWrite = true;
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, none, mod));
+    CHECK(mod.directShaderWrite);
+    res.directWrite = false;
+
+    // covered and passed
+    uint64_t passed[2] = {1, 1};
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, passed, mod));
+    CHECK_FALSE(mod.depthTestFailed);
+    CHECK_FALSE(mod.stencilTestFailed);
+    CHECK_FALSE(mod.scissorClipped);
+
+    // covered but failed, attributed to the enabled test
+    uint64_t failed[2] = {1, 0};
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, failed, mod));
+    CHECK(mod.depthTestFailed);
+    CHECK_FALSE(mod.stencilTestFailed);
+
+    res.depthTest = false;
+    res.stencilTest = true;
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, failed, mod));
+    CHECK(mod.stencilTestFailed);
+    CHECK_FALSE(mod.depthTestFailed);
+
+    // the scissor takes precedence, since it's applied before the other tests
+    res.scissorClipped = true;
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, failed, mod));
+    CHECK(mod.scissorClipped);
+    CHECK_FALSE(mod.stencilTestFailed);
+    res.scissorClipped = false;
+
+    // without a coverage query the coverage value is ignored, and a failed draw can't be told
+    // apart from one that missed the pixel
+    res.coverageQueried = false;
+    uint64_t noCoverage[2] = {0, 1};
+    RDCEraseEl(mod);
+    CHECK(VulkanPixelHistoryCallback::ClassifyResult(res, noCoverage, mod));
+    CHECK_FALSE(mod.stencilTestFailed);
+
+    RDCEraseEl(mod);
+    CHECK_FALSE(VulkanPixelHistoryCallback::ClassifyResult(res, failed, mod));
+  };
+
+  SECTION("Presentable final layouts match the replayed render pass")
+  {
+    VkAttachmentDescription att = {};
+
+    att.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    CHECK(GetReplayFinalLayout(att) == VK_IMAGE_LAYOUT_GENERAL);
+
+    att.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    CHECK(GetReplayFinalLayout(att) == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  };
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -1066,6 +1066,8 @@ void VulkanReplay::ClearPostVSCache()
 {
   VkDevice dev = m_Device;
 
+  m_MeshPick.Invalidate();
+
   for(auto it = m_PostVSData.begin(); it != m_PostVSData.end(); ++it)
   {
     if(it->second.vsout.idxbuf != VK_NULL_HANDLE)
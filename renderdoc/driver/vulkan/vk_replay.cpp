@@ -49,6 +49,9 @@ VulkanReplay::VulkanReplay()
   m_Proxy = false;
 
   m_HighlightCache.driver = this;
+  m_MeshPick.driver = this;
+  // unprojected positions are in Vulkan's clip space with Y pointing down
+  m_MeshPick.flipUnprojectedY = true;
 
   m_OutputWinID = 1;
   m_ActiveWinID = 0;
@@ -3300,15 +3303,6 @@ void VulkanReplay::RemoveReplacement(ResourceId id)
   ClearPostVSCache();
 }
 
-vector<PixelModification> VulkanReplay::PixelHistory(vector<EventUsage> events, ResourceId target,
-                                                     uint32_t x, uint32_t y, uint32_t slice,
-                                                     uint32_t mip, uint32_t sampleIdx,
-                                                     CompType typeHint)
-{
-  VULKANNOTIMP("PixelHistory");
-  return vector<PixelModification>();
-}
-
 ShaderDebugTrace VulkanReplay::DebugVertex(uint32_t eventId, uint32_t vertid, uint32_t instid,
                                            uint32_t idx, uint32_t instOffset, uint32_t vertOffset)
 {
@@ -393,6 +393,7 @@ private:
   uint32_t m_DebugWidth, m_DebugHeight;
 
   HighlightCache m_HighlightCache;
+  MeshPickCache m_MeshPick;
 
   bool m_Proxy;
 
@@ -511,26 +512,6 @@ private:
     VkDescriptorSet DescSet = VK_NULL_HANDLE;
   } m_MeshRender;
 
-  struct VertexPicking
-  {
-    void Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool);
-    void Destroy(WrappedVulkan *driver);
-
-    static constexpr int MaxMeshPicks = 500;
-
-    GPUBuffer UBO;
-    GPUBuffer IB;
-    GPUBuffer IBUpload;
-    GPUBuffer VB;
-    GPUBuffer VBUpload;
-    uint32_t IBSize = 0, VBSize = 0;
-    GPUBuffer Result, ResultReadback;
-    VkDescriptorSetLayout DescSetLayout = VK_NULL_HANDLE;
-    VkDescriptorSet DescSet = VK_NULL_HANDLE;
-    VkPipelineLayout Layout = VK_NULL_HANDLE;
-    VkPipeline Pipeline = VK_NULL_HANDLE;
-  } m_VertexPick;
-
   struct PixelPicking
   {
     void Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool);
@@ -583,6 +564,18 @@ private:
 
   vector<CounterResult> FetchCountersAMD(const vector<GPUCounter> &counters);
 
+  // query pools used by FetchCounters, kept around so that repeated fetches (e.g. when gathering
+  // statistics over several runs) don't recreate them every time.
+  struct CounterQueryPools
+  {
+    void Destroy(WrappedVulkan *driver);
+
+    uint32_t size = 0;
+    VkQueryPool timeStamp = VK_NULL_HANDLE;
+    VkQueryPool occlusion = VK_NULL_HANDLE;
+    VkQueryPool pipeStats = VK_NULL_HANDLE;
+  } m_CounterPools;
+
   AMDCounters *m_pAMDCounters = NULL;
   AMDRGPControl *m_RGP = NULL;
 
@@ -823,6 +823,118 @@ uint32_t GetByteSize(uint32_t Width, uint32_t Height, uint32_t Depth, VkFormat F
   return ret;
 }
 
+void DescriptorSetData::AddBindFrameRef(ResourceId id, FrameRefType ref, bool hasSparse)
+{
+  if(id == ResourceId())
+  {
+    RDCERR("Unexpected NULL resource ID being added as a bind frame ref");
+    return;
+  }
+
+  pair<uint32_t, FrameRefType> &bindRef = bindFrameRefs[id];
+
+  if((bindRef.first & ~SPARSE_REF_BIT) == 0)
+  {
+    bindRef = std::make_pair(1 | (hasSparse ? SPARSE_REF_BIT : 0), ref);
+
+    if(hasSparse)
+      sparseRefCount++;
+
+    QueuePendingFrameRef(id);
+  }
+  else
+  {
+    // be conservative - mark refs as read before write if we see a write and a read ref on it
+    if(ref == eFrameRef_Write && bindRef.second == eFrameRef_Read)
+    {
+      bindRef.second = eFrameRef_ReadBeforeWrite;
+      QueuePendingFrameRef(id);
+    }
+    bindRef.first++;
+  }
+}
+
+void DescriptorSetData::RemoveBindFrameRef(ResourceId id)
+{
+  // ignore any NULL IDs - probably an object that was
+  // deleted since it was bound.
+  if(id == ResourceId())
+    return;
+
+  auto it = bindFrameRefs.find(id);
+
+  // in the case of re-used handles bound to descriptor sets,
+  // it's possible to try and remove a frameref on something we
+  // don't have (which means we'll have a corresponding stale ref)
+  // but this is harmless so we can ignore it.
+  if(it == bindFrameRefs.end())
+    return;
+
+  it->second.first--;
+
+  if((it->second.first & ~SPARSE_REF_BIT) == 0)
+  {
+    if(it->second.first & SPARSE_REF_BIT)
+      sparseRefCount--;
+
+    bindFrameRefs.erase(it);
+  }
+}
+
+void DescriptorSetData::QueuePendingFrameRef(ResourceId id)
+{
+  SCOPED_LOCK(frameRefLock);
+
+  // if the set has never been marked it will be marked in full, no need to queue anything
+  if(frameRefGeneration == 0)
+    return;
+
+  // once there are as many pending refs as refs in total, it's no cheaper to merge them than to
+  // re-mark the whole set. Fall back to that so the queue can't grow while not capturing
+  if(pendingFrameRefs.size() >= bindFrameRefs.size())
+  {
+    frameRefGeneration = 0;
+    pendingFrameRefs.clear();
+    return;
+  }
+
+  pendingFrameRefs.push_back(id);
+}
+
+void DescriptorSetData::GetUnmarkedFrameRefs(
+    uint32_t generation, std::vector<std::pair<ResourceId, FrameRefType> > &refs,
+    std::vector<ResourceId> &sparseRefs)
+{
+  SCOPED_LOCK(frameRefLock);
+
+  if(frameRefGeneration == generation && sparseRefCount == 0)
+  {
+    // only the refs added since we were last marked in this generation are needed. Refs that
+    // were removed in the meantime don't need to be marked at all
+    for(ResourceId id : pendingFrameRefs)
+    {
+      auto it = bindFrameRefs.find(id);
+      if(it != bindFrameRefs.end())
+        refs.push_back(std::make_pair(id, it->second.second));
+    }
+  }
+  else
+  {
+    refs.reserve(refs.size() + bindFrameRefs.size());
+
+    for(auto it = bindFrameRefs.begin(); it != bindFrameRefs.end(); ++it)
+    {
+      refs.push_back(std::make_pair(it->first, it->second.second));
+
+      if(it->second.first & SPARSE_REF_BIT)
+        sparseRefs.push_back(it->first);
+    }
+  }
+
+  pendingFrameRefs.clear();
+  frameRefGeneration = generation;
+}
+
 VkResourceRecord::~VkResourceRecord()
 {
   VkResourceType resType = Resource != NULL ? IdentifyTypeByPtr(Resource) : eResUnknown;
@@ -1087,3 +1199,302 @@ void SparseMapping::Update(uint32_t numBindings, const VkSparseMemoryBind *pBind
       opaquemappings.push_back(curRange);
   }
 }
+
+bool IdleCmdRecording::CaptureStarted()
+{
+  if(m_BoundaryCapture)
+  {
+    m_BoundaryCapture = false;
+    return false;
+  }
+
+  // everything from now on is fully recorded, including any command buffers begun during this
+  // capture and re-submitted in later ones.
+  m_AppControlled = true;
+  m_Pending = 0;
+  m_WaitedFrames = 0;
+  Atomic::CmpExch32(&m_Idle, 1, 0);
+  return true;
+}
+
+bool IdleCmdRecording::UpdateFrameBoundary(bool enabled, bool triggered)
+{
+  // consume whether any idle command buffers were submitted in the frame that just ended
+  bool idleSubmitted = Atomic::CmpExch32(&m_IdleSubmitted, 1, 0) == 1;
+
+  if(!enabled)
+  {
+    // record everything and capture immediately as normal
+    Atomic::CmpExch32(&m_Idle, 1, 0);
+    m_Pending = 0;
+    m_WaitedFrames = 0;
+    return triggered;
+  }
+
+  if(triggered)
+    m_Pending++;
+
+  if(m_Pending == 0)
+  {
+    // nothing to capture, stop serialising command buffers
+    Atomic::CmpExch32(&m_Idle, 0, 1);
+    return false;
+  }
+
+  // a capture is pending. If we were idle until now then everything in the frame that just ended
+  // was recorded idle, so arm recording and wait at least one whole frame.
+  if(Atomic::CmpExch32(&m_Idle, 1, 0) == 1)
+  {
+    m_WaitedFrames = 0;
+    return false;
+  }
+
+  if(idleSubmitted)
+  {
+    m_WaitedFrames++;
+
+    if(m_WaitedFrames == WarnWaitFrames)
+      RDCWARN(
+          "Capture has waited %u frames for command buffers recorded before it was triggered. "
+          "Command buffers that are re-submitted without being re-recorded can't be captured "
+          "with the low overhead idle option enabled.",
+          m_WaitedFrames);
+
+    return false;
+  }
+
+  m_Pending--;
+  m_WaitedFrames = 0;
+  return true;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#undef None
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Descriptor set frame refs are only gathered once per capture", "[vulkan]")
+{
+  // a bindless-sized set with far more descriptors than any single draw would touch
+  const size_t numRefs = 250000;
+
+  // IDs are allocated in increasing order, so the extra ones sort after all the bound ones
+  std::vector<ResourceId> ids(numRefs + 2);
+  for(ResourceId &id : ids)
+    id = ResourceIDGen::GetNewUniqueID();
+
+  DescriptorSetData set;
+
+  for(size_t i = 0; i < numRefs; i++)
+    set.AddBindFrameRef(ids[i], i % 4 == 0 ? eFrameRef_Write : eFrameRef_Read, false);
+
+  std::vector<std::pair<ResourceId, FrameRefType> > refs;
+  std::vector<ResourceId> sparseRefs;
+
+  SECTION("First submit in a capture gathers everything, later submits nothing")
+  {
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+    CHECK(refs.size() == numRefs);
+    CHECK(sparseRefs.empty());
+
+    for(int submit = 0; submit < 100; submit++)
+    {
+      refs.clear();
+      set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+      CHECK(refs.empty());
+    }
+
+    // a new capture needs everything again
+    refs.clear();
+    set.GetUnmarkedFrameRefs(2, refs, sparseRefs);
+    CHECK(refs.size() == numRefs);
+  };
+
+  SECTION("New and upgraded refs are merged in")
+  {
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+
+    // adding another reference to something already bound changes nothing
+    set.AddBindFrameRef(ids[4], eFrameRef_Read, false);
+    // a write to something only read before upgrades the ref
+    set.AddBindFrameRef(ids[5], eFrameRef_Write, false);
+    // entirely new refs, one of which is removed again before the submit
+    set.AddBindFrameRef(ids[numRefs], eFrameRef_Read, false);
+    set.AddBindFrameRef(ids[numRefs + 1], eFrameRef_Write, false);
+    set.RemoveBindFrameRef(ids[numRefs + 1]);
+
+    refs.clear();
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+
+    REQUIRE(refs.size() == 2);
+    CHECK(refs[0].first == ids[5]);
+    CHECK((refs[0].second == eFrameRef_ReadBeforeWrite));
+    CHECK(refs[1].first == ids[numRefs]);
+    CHECK((refs[1].second == eFrameRef_Read));
+
+    refs.clear();
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+    CHECK(refs.empty());
+  };
+
+  SECTION("Updates while not capturing don't accumulate")
+  {
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+
+    // rebind everything, as an application might do each frame outside of a capture
+    for(int frame = 0; frame < 3; frame++)
+    {
+      for(size_t i = 0; i < numRefs; i++)
+        set.RemoveBindFrameRef(ids[i]);
+      for(size_t i = 0; i < numRefs; i++)
+        set.AddBindFrameRef(ids[i], eFrameRef_Read, false);
+    }
+
+    refs.clear();
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+    CHECK(refs.size() == numRefs);
+  };
+
+  SECTION("Sets with sparse resources are always gathered in full")
+  {
+    set.AddBindFrameRef(ids[numRefs], eFrameRef_Read, true);
+
+    for(int submit = 0; submit < 3; submit++)
+    {
+      refs.clear();
+      sparseRefs.clear();
+      set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+      CHECK(refs.size() == numRefs + 1);
+      REQUIRE(sparseRefs.size() == 1);
+      CHECK(sparseRefs[0] == ids[numRefs]);
+    }
+
+    // once the sparse resource is unbound, everything left has already been marked
+    set.RemoveBindFrameRef(ids[numRefs]);
+
+    refs.clear();
+    set.GetUnmarkedFrameRefs(1, refs, sparseRefs);
+    CHECK(refs.empty());
+  };
+}
+
+TEST_CASE("Idle command buffer recording only captures settled frames", "[vulkan]")
+{
+  IdleCmdRecording idle;
+
+  SECTION("Disabled recording is never idle and captures immediately")
+  {
+    CHECK_FALSE(idle.FrameBoundary(false, false));
+    CHECK_FALSE(idle.IsIdle());
+
+    idle.MarkIdleSubmitted();
+    CHECK(idle.FrameBoundary(false, true));
+    CHECK_FALSE(idle.IsIdle());
+    CHECK(idle.GetPendingCaptures() == 0);
+  };
+
+  SECTION("Triggering arms recording and captures after one settled frame")
+  {
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK(idle.IsIdle());
+
+    // the frame during which the capture was triggered was recorded idle
+    idle.MarkIdleSubmitted();
+    CHECK_FALSE(idle.FrameBoundary(true, true));
+    CHECK_FALSE(idle.IsIdle());
+    CHECK(idle.GetPendingCaptures() == 1);
+
+    // one frame fully recorded, we can capture now
+    CHECK(idle.FrameBoundary(true, false));
+    CHECK_FALSE(idle.IsIdle());
+    CHECK(idle.GetPendingCaptures() == 0);
+
+    // after the captured frame, go back to idle
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK(idle.IsIdle());
+  };
+
+  SECTION("Captures wait while idle command buffers are still being submitted")
+  {
+    idle.FrameBoundary(true, false);
+    CHECK_FALSE(idle.FrameBoundary(true, true));
+
+    for(int frame = 0; frame < 3; frame++)
+    {
+      idle.MarkIdleSubmitted();
+      CHECK_FALSE(idle.FrameBoundary(true, false));
+      CHECK_FALSE(idle.IsIdle());
+    }
+
+    CHECK(idle.FrameBoundary(true, false));
+  };
+
+  SECTION("Multiple triggers capture consecutive frames")
+  {
+    idle.FrameBoundary(true, false);
+    CHECK_FALSE(idle.FrameBoundary(true, true));
+    idle.MarkIdleSubmitted();
+    CHECK_FALSE(idle.FrameBoundary(true, true));
+    CHECK(idle.GetPendingCaptures() == 2);
+
+    CHECK(idle.FrameBoundary(true, false));
+    CHECK(idle.FrameBoundary(true, false));
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK(idle.IsIdle());
+  };
+
+  SECTION("Discarded captures are retried")
+  {
+    idle.FrameBoundary(true, false);
+    idle.FrameBoundary(true, true);
+    CHECK(idle.FrameBoundary(true, false));
+
+    // the captured frame submitted an idle command buffer recorded in an earlier frame
+    idle.MarkIdleSubmitted();
+    idle.CaptureDiscarded();
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK_FALSE(idle.IsIdle());
+
+    CHECK(idle.FrameBoundary(true, false));
+  };
+
+  SECTION("Application captures leave idle recording for good")
+  {
+    idle.FrameBoundary(true, false);
+    CHECK(idle.IsIdle());
+
+    CHECK(idle.CaptureStarted());
+    CHECK_FALSE(idle.IsIdle());
+
+    // triggered captures are no longer deferred
+    idle.MarkIdleSubmitted();
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK_FALSE(idle.IsIdle());
+    CHECK(idle.FrameBoundary(true, true));
+    CHECK_FALSE(idle.CaptureStarted());
+    CHECK_FALSE(idle.IsIdle());
+  };
+
+  SECTION("Captures started at a frame boundary aren't application captures")
+  {
+    idle.FrameBoundary(true, false);
+    idle.FrameBoundary(true, true);
+    CHECK(idle.FrameBoundary(true, false));
+    CHECK_FALSE(idle.CaptureStarted());
+
+    CHECK_FALSE(idle.FrameBoundary(true, false));
+    CHECK(idle.IsIdle());
+  };
+
+  SECTION("Disabling drops pending captures")
+  {
+    idle.FrameBoundary(true, false);
+    idle.FrameBoundary(true, true);
+    CHECK_FALSE(idle.FrameBoundary(false, false));
+    CHECK_FALSE(idle.IsIdle());
+    CHECK(idle.GetPendingCaptures() == 0);
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -923,6 +923,50 @@ struct CmdBufferRecordingInfo
   set<VkDescriptorSet> boundDescSets;
 
   vector<VkResourceRecord *> subcmds;
+
+  // if true this command buffer was recorded while idle (see IdleCmdRecording), so only its state
+  // is tracked and none of its commands were serialised.
+  bool idle = false;
+};
+
+// With the low overhead idle capture option, command buffers recorded while no capture is pending
+// skip serialising their commands. This tracks whether recording is idle or armed, and decides at
+// each frame boundary whether a pending capture can begin - which is only once a whole frame has
+// gone by without any idle-recorded command buffers being submitted.
+struct IdleCmdRecording
+{
+  // how many frames a pending capture can wait before we warn that it's being held up
+  static const uint32_t WarnWaitFrames = 60;
+
+  // whether command buffers begun now should skip serialisation. Safe to call from any thread
+  bool IsIdle() const { return m_Idle != 0; }
+  // called whenever a command buffer recorded while idle is submitted. Safe to call from any thread
+  void MarkIdleSubmitted() { Atomic::CmpExch32(&m_IdleSubmitted, 0, 1); }
+  // called at each frame boundary with whether the option is enabled and whether a capture was
+  // triggered there. Returns true if a capture should begin with the next frame.
+  bool FrameBoundary(bool enabled, bool triggered)
+  {
+    m_BoundaryCapture = UpdateFrameBoundary(enabled && !m_AppControlled, triggered);
+    return m_BoundaryCapture;
+  }
+  // called whenever a capture starts. A capture that FrameBoundary didn't ask for was started by
+  // the application, which we can't defer or retry, so stop idling for good. Returns true if the
+  // capture was started by the application.
+  bool CaptureStarted();
+  // called when a capture was thrown away because it submitted idle-recorded command buffers, to
+  // retry it once recording has settled.
+  void CaptureDiscarded() { m_Pending++; }
+  uint32_t GetPendingCaptures() const { return m_Pending; }
+
+private:
+  bool UpdateFrameBoundary(bool enabled, bool triggered);
+
+  volatile int32_t m_Idle = 0;
+  volatile int32_t m_IdleSubmitted = 0;
+  uint32_t m_Pending = 0;
+  uint32_t m_WaitedFrames = 0;
+  bool m_BoundaryCapture = false;
+  bool m_AppControlled = false;
 };
 
 struct DescSetLayout;
@@ -950,6 +994,30 @@ struct DescriptorSetData
   // mapping information
   static const uint32_t SPARSE_REF_BIT = 0x80000000;
   map<ResourceId, pair<uint32_t, FrameRefType> > bindFrameRefs;
+
+  void AddBindFrameRef(ResourceId id, FrameRefType ref, bool hasSparse);
+  void RemoveBindFrameRef(ResourceId id);
+
+  // appends the bindFrameRefs which haven't yet been marked as frame referenced in the capture
+  // with the given generation, and the IDs of any with sparse mappings. Afterwards the set counts
+  // as fully marked in that generation, so until new refs are added subsequent calls return nothing
+  void GetUnmarkedFrameRefs(uint32_t generation,
+                            std::vector<std::pair<ResourceId, FrameRefType> > &refs,
+                            std::vector<ResourceId> &sparseRefs);
+
+private:
+  void QueuePendingFrameRef(ResourceId id);
+
+  // the capture generation when all bindFrameRefs were last marked, or 0 if they never have been.
+  // Refs added or upgraded since then are queued in pendingFrameRefs to be merged on next submit
+  uint32_t frameRefGeneration = 0;
+  std::vector<ResourceId> pendingFrameRefs;
+
+  // sparse mappings can change at any time, so sets containing any are always fully marked
+  uint32_t sparseRefCount = 0;
+
+  // the same set can be submitted on several queues at once
+  Threading::CriticalSection frameRefLock;
 };
 
 struct PipelineLayoutData
@@ -1021,51 +1089,15 @@ public:
     cmdInfo->imgbarriers.swap(bakedCommands->cmdInfo->imgbarriers);
     cmdInfo->subcmds.swap(bakedCommands->cmdInfo->subcmds);
     cmdInfo->sparse.swap(bakedCommands->cmdInfo->sparse);
+    bakedCommands->cmdInfo->idle = cmdInfo->idle;
   }
 
   void AddBindFrameRef(ResourceId id, FrameRefType ref, bool hasSparse = false)
   {
-    if(id == ResourceId())
-    {
-      RDCERR("Unexpected NULL resource ID being added as a bind frame ref");
-      return;
-    }
-
-    if((descInfo->bindFrameRefs[id].first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
-    {
-      descInfo->bindFrameRefs[id] =
-          std::make_pair(1 | (hasSparse ? DescriptorSetData::SPARSE_REF_BIT : 0), ref);
-    }
-    else
-    {
-      // be conservative - mark refs as read before write if we see a write and a read ref on it
-      if(ref == eFrameRef_Write && descInfo->bindFrameRefs[id].second == eFrameRef_Read)
-        descInfo->bindFrameRefs[id].second = eFrameRef_ReadBeforeWrite;
-      descInfo->bindFrameRefs[id].first++;
-    }
+    descInfo->AddBindFrameRef(id, ref, hasSparse);
   }
 
-  void RemoveBindFrameRef(ResourceId id)
-  {
-    // ignore any NULL IDs - probably an object that was
-    // deleted since it was bound.
-    if(id == ResourceId())
-      return;
-
-    auto it = descInfo->bindFrameRefs.find(id);
-
-    // in the case of re-used handles bound to descriptor sets,
-    // it's possible to try and remove a frameref on something we
-    // don't have (which means we'll have a corresponding stale ref)
-    // but this is harmless so we can ignore it.
-    if(it == descInfo->bindFrameRefs.end())
-      return;
-
-    it->second.first--;
-
-    if((it->second.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
-      descInfo->bindFrameRefs.erase(it);
-  }
+  void RemoveBindFrameRef(ResourceId id) { descInfo->RemoveBindFrameRef(id); }
 
   // we have a lot of 'cold' data in the resource record, as it can be accessed
   // through the wrapped objects without locking any lookup structures.
@@ -42,7 +42,6 @@ enum class BuiltinShader
   MeshVS,
   MeshGS,
   MeshFS,
-  MeshCS,
   OutlineFS,
   QuadResolveFS,
   QuadWriteFS,
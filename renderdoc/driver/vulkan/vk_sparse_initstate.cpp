@@ -359,7 +359,8 @@ bool WrappedVulkan::Prepare_SparseInitialState(WrappedVkImage *im)
   return true;
 }
 
-uint32_t WrappedVulkan::GetSize_SparseInitialState(ResourceId id, WrappedVkRes *res)
+uint32_t WrappedVulkan::GetSize_SparseInitialState(ResourceId id, WrappedVkRes *res,
+                                                   const BlobStore *blobs)
 {
   VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
   VkResourceType type = IdentifyTypeByPtr(record->Resource);
@@ -379,7 +380,8 @@ uint32_t WrappedVulkan::GetSize_SparseInitialState(ResourceId id, WrappedVkRes *
     ret += 8 + sizeof(MemIDOffset) * info.numUniqueMems;
 
     // the actual data
-    ret += uint32_t(info.totalSize + WriteSerialiser::GetChunkAlignment());
+    ret += uint32_t(BlobStore::GetSerialisedSize(blobs, info.totalSize) +
+                    WriteSerialiser::GetChunkAlignment());
 
     return ret;
   }
@@ -404,7 +406,8 @@ uint32_t WrappedVulkan::GetSize_SparseInitialState(ResourceId id, WrappedVkRes *
     ret += sizeof(MemIDOffset) * info.numUniqueMems;
 
     // the actual data
-    ret += uint32_t(info.totalSize + WriteSerialiser::GetChunkAlignment());
+    ret += uint32_t(BlobStore::GetSerialisedSize(blobs, info.totalSize) +
+                    WriteSerialiser::GetChunkAlignment());
 
     return ret;
   }
@@ -848,6 +848,10 @@ VkResult WrappedVulkan::vkBeginCommandBuffer(VkCommandBuffer commandBuffer,
     record->bakedCommands->cmdInfo->device = record->cmdInfo->device;
     record->bakedCommands->cmdInfo->allocInfo = record->cmdInfo->allocInfo;
 
+    // command buffers begun outside of a capture while no capture is pending only track state
+    record->cmdInfo->idle = IsBackgroundCapturing(m_State) && m_IdleRecording.IsIdle();
+
+    if(!record->cmdInfo->idle)
     {
       CACHE_THREAD_SERIALISER();
 
@@ -984,6 +988,7 @@ VkResult WrappedVulkan::vkEndCommandBuffer(VkCommandBuffer commandBuffer)
     // ensure that we have a matching begin
     RDCASSERT(record->bakedCommands);
 
+    if(!record->cmdInfo->idle)
     {
       CACHE_THREAD_SERIALISER();
       ser.SetDrawChunk();
@@ -1138,12 +1143,15 @@ void WrappedVulkan::vkCmdBeginRenderPass(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginRenderPass);
-    Serialise_vkCmdBeginRenderPass(ser, commandBuffer, pRenderPassBegin, contents);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginRenderPass);
+      Serialise_vkCmdBeginRenderPass(ser, commandBuffer, pRenderPassBegin, contents);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(pRenderPassBegin->renderPass), eFrameRef_Read);
 
     VkResourceRecord *fb = GetRecord(pRenderPassBegin->framebuffer);
@@ -1241,12 +1249,15 @@ void WrappedVulkan::vkCmdNextSubpass(VkCommandBuffer commandBuffer, VkSubpassCon
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdNextSubpass);
-    Serialise_vkCmdNextSubpass(ser, commandBuffer, contents);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdNextSubpass);
+      Serialise_vkCmdNextSubpass(ser, commandBuffer, contents);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -1324,12 +1335,15 @@ void WrappedVulkan::vkCmdEndRenderPass(VkCommandBuffer commandBuffer)
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndRenderPass);
-    Serialise_vkCmdEndRenderPass(ser, commandBuffer);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndRenderPass);
+      Serialise_vkCmdEndRenderPass(ser, commandBuffer);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkResourceRecord *fb = record->cmdInfo->framebuffer;
 
@@ -1377,6 +1391,10 @@ bool WrappedVulkan::Serialise_vkCmdBindPipeline(SerialiserType &ser, VkCommandBu
 
         ResourceId liveid = GetResID(pipeline);
 
+        // track the graphics pipeline for drawcall callbacks that need to restore it
+        if(pipelineBindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS)
+          m_BakedCmdBufferInfo[m_LastCmdBufferID].state.pipeline = liveid;
+
         if(IsPartialCmdBuf(m_LastCmdBufferID))
         {
           if(pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
@@ -1464,12 +1482,15 @@ void WrappedVulkan::vkCmdBindPipeline(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindPipeline);
-    Serialise_vkCmdBindPipeline(ser, commandBuffer, pipelineBindPoint, pipeline);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindPipeline);
+      Serialise_vkCmdBindPipeline(ser, commandBuffer, pipelineBindPoint, pipeline);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(pipeline), eFrameRef_Read);
   }
 }
@@ -1621,13 +1642,17 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindDescriptorSets);
-    Serialise_vkCmdBindDescriptorSets(ser, commandBuffer, pipelineBindPoint, layout, firstSet,
-                                      setCount, pDescriptorSets, dynamicOffsetCount, pDynamicOffsets);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindDescriptorSets);
+      Serialise_vkCmdBindDescriptorSets(ser, commandBuffer, pipelineBindPoint, layout, firstSet,
+                                        setCount, pDescriptorSets, dynamicOffsetCount,
+                                        pDynamicOffsets);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(layout), eFrameRef_Read);
     record->cmdInfo->boundDescSets.insert(pDescriptorSets, pDescriptorSets + setCount);
 
@@ -1728,13 +1753,16 @@ void WrappedVulkan::vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindVertexBuffers);
-    Serialise_vkCmdBindVertexBuffers(ser, commandBuffer, firstBinding, bindingCount, pBuffers,
-                                     pOffsets);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindVertexBuffers);
+      Serialise_vkCmdBindVertexBuffers(ser, commandBuffer, firstBinding, bindingCount, pBuffers,
+                                       pOffsets);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     for(uint32_t i = 0; i < bindingCount; i++)
     {
       record->MarkResourceFrameReferenced(GetResID(pBuffers[i]), eFrameRef_Read);
@@ -1808,12 +1836,15 @@ void WrappedVulkan::vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindIndexBuffer);
-    Serialise_vkCmdBindIndexBuffer(ser, commandBuffer, buffer, offset, indexType);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBindIndexBuffer);
+      Serialise_vkCmdBindIndexBuffer(ser, commandBuffer, buffer, offset, indexType);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
     if(GetRecord(buffer)->sparseInfo)
@@ -1875,12 +1906,15 @@ void WrappedVulkan::vkCmdUpdateBuffer(VkCommandBuffer commandBuffer, VkBuffer de
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdUpdateBuffer);
-    Serialise_vkCmdUpdateBuffer(ser, commandBuffer, destBuffer, destOffset, dataSize, pData);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdUpdateBuffer);
+      Serialise_vkCmdUpdateBuffer(ser, commandBuffer, destBuffer, destOffset, dataSize, pData);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkResourceRecord *buf = GetRecord(destBuffer);
 
@@ -1944,12 +1978,15 @@ void WrappedVulkan::vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dest
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdFillBuffer);
-    Serialise_vkCmdFillBuffer(ser, commandBuffer, destBuffer, destOffset, fillSize, data);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdFillBuffer);
+      Serialise_vkCmdFillBuffer(ser, commandBuffer, destBuffer, destOffset, fillSize, data);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkResourceRecord *buf = GetRecord(destBuffer);
 
@@ -2028,12 +2065,15 @@ void WrappedVulkan::vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipeline
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushConstants);
-    Serialise_vkCmdPushConstants(ser, commandBuffer, layout, stageFlags, start, length, values);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushConstants);
+      Serialise_vkCmdPushConstants(ser, commandBuffer, layout, stageFlags, start, length, values);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(layout), eFrameRef_Read);
   }
 }
@@ -2176,15 +2216,18 @@ void WrappedVulkan::vkCmdPipelineBarrier(
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPipelineBarrier);
-    Serialise_vkCmdPipelineBarrier(ser, commandBuffer, srcStageMask, destStageMask, dependencyFlags,
-                                   memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
-                                   pBufferMemoryBarriers, imageMemoryBarrierCount,
-                                   pImageMemoryBarriers);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPipelineBarrier);
+      Serialise_vkCmdPipelineBarrier(ser, commandBuffer, srcStageMask, destStageMask,
+                                     dependencyFlags, memoryBarrierCount, pMemoryBarriers,
+                                     bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                                     imageMemoryBarrierCount, pImageMemoryBarriers);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     if(imageMemoryBarrierCount > 0)
     {
@@ -2246,12 +2289,15 @@ void WrappedVulkan::vkCmdWriteTimestamp(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWriteTimestamp);
-    Serialise_vkCmdWriteTimestamp(ser, commandBuffer, pipelineStage, queryPool, query);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWriteTimestamp);
+      Serialise_vkCmdWriteTimestamp(ser, commandBuffer, pipelineStage, queryPool, query);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(queryPool), eFrameRef_Read);
   }
@@ -2315,13 +2361,16 @@ void WrappedVulkan::vkCmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, VkQ
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyQueryPoolResults);
-    Serialise_vkCmdCopyQueryPoolResults(ser, commandBuffer, queryPool, firstQuery, queryCount,
-                                        destBuffer, destOffset, destStride, flags);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyQueryPoolResults);
+      Serialise_vkCmdCopyQueryPoolResults(ser, commandBuffer, queryPool, firstQuery, queryCount,
+                                          destBuffer, destOffset, destStride, flags);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(queryPool), eFrameRef_Read);
 
     VkResourceRecord *buf = GetRecord(destBuffer);
@@ -2381,12 +2430,15 @@ void WrappedVulkan::vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool q
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginQuery);
-    Serialise_vkCmdBeginQuery(ser, commandBuffer, queryPool, query, flags);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginQuery);
+      Serialise_vkCmdBeginQuery(ser, commandBuffer, queryPool, query, flags);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(queryPool), eFrameRef_Read);
   }
 }
@@ -2433,12 +2485,15 @@ void WrappedVulkan::vkCmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPool que
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndQuery);
-    Serialise_vkCmdEndQuery(ser, commandBuffer, queryPool, query);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndQuery);
+      Serialise_vkCmdEndQuery(ser, commandBuffer, queryPool, query);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(queryPool), eFrameRef_Read);
   }
 }
@@ -2492,12 +2547,15 @@ void WrappedVulkan::vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPo
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResetQueryPool);
-    Serialise_vkCmdResetQueryPool(ser, commandBuffer, queryPool, firstQuery, queryCount);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResetQueryPool);
+      Serialise_vkCmdResetQueryPool(ser, commandBuffer, queryPool, firstQuery, queryCount);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(queryPool), eFrameRef_Read);
   }
 }
@@ -2754,12 +2812,15 @@ void WrappedVulkan::vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdExecuteCommands);
-    Serialise_vkCmdExecuteCommands(ser, commandBuffer, commandBufferCount, pCommandBuffers);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdExecuteCommands);
+      Serialise_vkCmdExecuteCommands(ser, commandBuffer, commandBufferCount, pCommandBuffers);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     for(uint32_t i = 0; i < commandBufferCount; i++)
     {
@@ -2841,12 +2902,15 @@ void WrappedVulkan::vkCmdDebugMarkerBeginEXT(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerBeginEXT);
-    Serialise_vkCmdDebugMarkerBeginEXT(ser, commandBuffer, pMarker);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerBeginEXT);
+      Serialise_vkCmdDebugMarkerBeginEXT(ser, commandBuffer, pMarker);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -2914,12 +2978,15 @@ void WrappedVulkan::vkCmdDebugMarkerEndEXT(VkCommandBuffer commandBuffer)
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerEndEXT);
-    Serialise_vkCmdDebugMarkerEndEXT(ser, commandBuffer);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerEndEXT);
+      Serialise_vkCmdDebugMarkerEndEXT(ser, commandBuffer);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -2982,12 +3049,15 @@ void WrappedVulkan::vkCmdDebugMarkerInsertEXT(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerInsertEXT);
-    Serialise_vkCmdDebugMarkerInsertEXT(ser, commandBuffer, pMarker);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDebugMarkerInsertEXT);
+      Serialise_vkCmdDebugMarkerInsertEXT(ser, commandBuffer, pMarker);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -3288,13 +3358,16 @@ void WrappedVulkan::vkCmdPushDescriptorSetKHR(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushDescriptorSetKHR);
-    Serialise_vkCmdPushDescriptorSetKHR(ser, commandBuffer, pipelineBindPoint, layout, set,
-                                        descriptorWriteCount, pDescriptorWrites);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushDescriptorSetKHR);
+      Serialise_vkCmdPushDescriptorSetKHR(ser, commandBuffer, pipelineBindPoint, layout, set,
+                                          descriptorWriteCount, pDescriptorWrites);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     for(uint32_t i = 0; i < descriptorWriteCount; i++)
     {
       const VkWriteDescriptorSet &write = pDescriptorWrites[i];
@@ -3544,13 +3617,16 @@ void WrappedVulkan::vkCmdPushDescriptorSetWithTemplateKHR(
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushDescriptorSetWithTemplateKHR);
-    Serialise_vkCmdPushDescriptorSetWithTemplateKHR(ser, commandBuffer, descriptorUpdateTemplate,
-                                                    layout, set, pData);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdPushDescriptorSetWithTemplateKHR);
+      Serialise_vkCmdPushDescriptorSetWithTemplateKHR(ser, commandBuffer, descriptorUpdateTemplate,
+                                                      layout, set, pData);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     for(size_t i = 0; i < frameRefs.size(); i++)
       record->MarkResourceFrameReferenced(frameRefs[i].first, frameRefs[i].second);
   }
@@ -3611,13 +3687,16 @@ void WrappedVulkan::vkCmdWriteBufferMarkerAMD(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWriteBufferMarkerAMD);
-    Serialise_vkCmdWriteBufferMarkerAMD(ser, commandBuffer, pipelineStage, dstBuffer, dstOffset,
-                                        marker);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWriteBufferMarkerAMD);
+      Serialise_vkCmdWriteBufferMarkerAMD(ser, commandBuffer, pipelineStage, dstBuffer, dstOffset,
+                                          marker);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     VkResourceRecord *buf = GetRecord(dstBuffer);
 
@@ -3692,12 +3771,15 @@ void WrappedVulkan::vkCmdBeginDebugUtilsLabelEXT(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginDebugUtilsLabelEXT);
-    Serialise_vkCmdBeginDebugUtilsLabelEXT(ser, commandBuffer, pLabelInfo);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBeginDebugUtilsLabelEXT);
+      Serialise_vkCmdBeginDebugUtilsLabelEXT(ser, commandBuffer, pLabelInfo);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -3765,12 +3847,15 @@ void WrappedVulkan::vkCmdEndDebugUtilsLabelEXT(VkCommandBuffer commandBuffer)
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndDebugUtilsLabelEXT);
-    Serialise_vkCmdEndDebugUtilsLabelEXT(ser, commandBuffer);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdEndDebugUtilsLabelEXT);
+      Serialise_vkCmdEndDebugUtilsLabelEXT(ser, commandBuffer);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -3833,12 +3918,15 @@ void WrappedVulkan::vkCmdInsertDebugUtilsLabelEXT(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdInsertDebugUtilsLabelEXT);
-    Serialise_vkCmdInsertDebugUtilsLabelEXT(ser, commandBuffer, pLabelInfo);
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdInsertDebugUtilsLabelEXT);
+      Serialise_vkCmdInsertDebugUtilsLabelEXT(ser, commandBuffer, pLabelInfo);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -3884,12 +3972,15 @@ void WrappedVulkan::vkCmdSetDeviceMask(VkCommandBuffer commandBuffer, uint32_t d
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDeviceMask);
-    Serialise_vkCmdSetDeviceMask(ser, commandBuffer, deviceMask);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDeviceMask);
+      Serialise_vkCmdSetDeviceMask(ser, commandBuffer, deviceMask);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
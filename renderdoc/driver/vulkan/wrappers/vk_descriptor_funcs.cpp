@@ -971,17 +971,17 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
       VkResourceRecord *setrecord = GetRecord(pDescriptorCopies[i].srcSet);
 
-      for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
-          refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
-      {
-        GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+      std::vector<std::pair<ResourceId, FrameRefType> > refs;
+      std::vector<ResourceId> sparseRefs;
+      setrecord->descInfo->GetUnmarkedFrameRefs(m_CaptureGeneration, refs, sparseRefs);
 
-        if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
-        {
-          VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->first);
+      GetResourceManager()->MarkResourcesFrameReferenced(refs);
 
-          GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
-        }
+      for(ResourceId id : sparseRefs)
+      {
+        VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
+
+        GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
       }
     }
   }
@@ -136,13 +136,17 @@ void WrappedVulkan::vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCoun
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDraw);
-    Serialise_vkCmdDraw(ser, commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDraw);
+      Serialise_vkCmdDraw(ser, commandBuffer, vertexCount, instanceCount, firstVertex,
+                          firstInstance);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -237,14 +241,17 @@ void WrappedVulkan::vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t ind
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexed);
-    Serialise_vkCmdDrawIndexed(ser, commandBuffer, indexCount, instanceCount, firstIndex,
-                               vertexOffset, firstInstance);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexed);
+      Serialise_vkCmdDrawIndexed(ser, commandBuffer, indexCount, instanceCount, firstIndex,
+                                 vertexOffset, firstInstance);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -610,13 +617,16 @@ void WrappedVulkan::vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer bu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndirect);
-    Serialise_vkCmdDrawIndirect(ser, commandBuffer, buffer, offset, count, stride);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndirect);
+      Serialise_vkCmdDrawIndirect(ser, commandBuffer, buffer, offset, count, stride);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
@@ -999,13 +1009,16 @@ void WrappedVulkan::vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBu
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexedIndirect);
-    Serialise_vkCmdDrawIndexedIndirect(ser, commandBuffer, buffer, offset, count, stride);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDrawIndexedIndirect);
+      Serialise_vkCmdDrawIndexedIndirect(ser, commandBuffer, buffer, offset, count, stride);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
@@ -1081,13 +1094,16 @@ void WrappedVulkan::vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uin
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatch);
-    Serialise_vkCmdDispatch(ser, commandBuffer, x, y, z);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatch);
+      Serialise_vkCmdDispatch(ser, commandBuffer, x, y, z);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -1178,13 +1194,16 @@ void WrappedVulkan::vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffe
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatchIndirect);
-    Serialise_vkCmdDispatchIndirect(ser, commandBuffer, buffer, offset);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatchIndirect);
+      Serialise_vkCmdDispatchIndirect(ser, commandBuffer, buffer, offset);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(buffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(buffer)->baseResource, eFrameRef_Read);
@@ -1298,14 +1317,17 @@ void WrappedVulkan::vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcIma
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBlitImage);
-    Serialise_vkCmdBlitImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
-                             destImageLayout, regionCount, pRegions, filter);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdBlitImage);
+      Serialise_vkCmdBlitImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
+                               destImageLayout, regionCount, pRegions, filter);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(srcImage), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcImage)->baseResource, eFrameRef_Read);
@@ -1422,14 +1444,17 @@ void WrappedVulkan::vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage src
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResolveImage);
-    Serialise_vkCmdResolveImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
-                                destImageLayout, regionCount, pRegions);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResolveImage);
+      Serialise_vkCmdResolveImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
+                                  destImageLayout, regionCount, pRegions);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(srcImage), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcImage)->baseResource, eFrameRef_Read);
@@ -1545,14 +1570,17 @@ void WrappedVulkan::vkCmdCopyImage(VkCommandBuffer commandBuffer, VkImage srcIma
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyImage);
-    Serialise_vkCmdCopyImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
-                             destImageLayout, regionCount, pRegions);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyImage);
+      Serialise_vkCmdCopyImage(ser, commandBuffer, srcImage, srcImageLayout, destImage,
+                               destImageLayout, regionCount, pRegions);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(srcImage), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcImage)->baseResource, eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetResID(destImage), eFrameRef_Write);
@@ -1657,14 +1685,17 @@ void WrappedVulkan::vkCmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuff
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyBufferToImage);
-    Serialise_vkCmdCopyBufferToImage(ser, commandBuffer, srcBuffer, destImage, destImageLayout,
-                                     regionCount, pRegions);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyBufferToImage);
+      Serialise_vkCmdCopyBufferToImage(ser, commandBuffer, srcBuffer, destImage, destImageLayout,
+                                       regionCount, pRegions);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     record->MarkResourceFrameReferenced(GetResID(srcBuffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcBuffer)->baseResource, eFrameRef_Read);
@@ -1772,14 +1803,17 @@ void WrappedVulkan::vkCmdCopyImageToBuffer(VkCommandBuffer commandBuffer, VkImag
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyImageToBuffer);
-    Serialise_vkCmdCopyImageToBuffer(ser, commandBuffer, srcImage, srcImageLayout, destBuffer,
-                                     regionCount, pRegions);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyImageToBuffer);
+      Serialise_vkCmdCopyImageToBuffer(ser, commandBuffer, srcImage, srcImageLayout, destBuffer,
+                                       regionCount, pRegions);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(srcImage), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcImage)->baseResource, eFrameRef_Read);
 
@@ -1895,13 +1929,16 @@ void WrappedVulkan::vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcB
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyBuffer);
-    Serialise_vkCmdCopyBuffer(ser, commandBuffer, srcBuffer, destBuffer, regionCount, pRegions);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdCopyBuffer);
+      Serialise_vkCmdCopyBuffer(ser, commandBuffer, srcBuffer, destBuffer, regionCount, pRegions);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(srcBuffer), eFrameRef_Read);
     record->MarkResourceFrameReferenced(GetRecord(srcBuffer)->baseResource, eFrameRef_Read);
 
@@ -2009,14 +2046,17 @@ void WrappedVulkan::vkCmdClearColorImage(VkCommandBuffer commandBuffer, VkImage
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearColorImage);
-    Serialise_vkCmdClearColorImage(ser, commandBuffer, image, imageLayout, pColor, rangeCount,
-                                   pRanges);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearColorImage);
+      Serialise_vkCmdClearColorImage(ser, commandBuffer, image, imageLayout, pColor, rangeCount,
+                                     pRanges);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(image), eFrameRef_Write);
     record->MarkResourceFrameReferenced(GetRecord(image)->baseResource, eFrameRef_Read);
     if(GetRecord(image)->sparseInfo)
@@ -2116,14 +2156,17 @@ void WrappedVulkan::vkCmdClearDepthStencilImage(VkCommandBuffer commandBuffer, V
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearDepthStencilImage);
-    Serialise_vkCmdClearDepthStencilImage(ser, commandBuffer, image, imageLayout, pDepthStencil,
-                                          rangeCount, pRanges);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearDepthStencilImage);
+      Serialise_vkCmdClearDepthStencilImage(ser, commandBuffer, image, imageLayout, pDepthStencil,
+                                            rangeCount, pRanges);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(image), eFrameRef_Write);
     record->MarkResourceFrameReferenced(GetRecord(image)->baseResource, eFrameRef_Read);
     if(GetRecord(image)->sparseInfo)
@@ -2262,14 +2305,17 @@ void WrappedVulkan::vkCmdClearAttachments(VkCommandBuffer commandBuffer, uint32_
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearAttachments);
-    Serialise_vkCmdClearAttachments(ser, commandBuffer, attachmentCount, pAttachments, rectCount,
-                                    pRects);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdClearAttachments);
+      Serialise_vkCmdClearAttachments(ser, commandBuffer, attachmentCount, pAttachments, rectCount,
+                                      pRects);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
 
     // image/attachments are referenced when the render pass is started and the framebuffer is
     // bound.
@@ -2362,14 +2408,17 @@ void WrappedVulkan::vkCmdDispatchBase(VkCommandBuffer commandBuffer, uint32_t ba
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    ser.SetDrawChunk();
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatchBase);
-    Serialise_vkCmdDispatchBase(ser, commandBuffer, baseGroupX, baseGroupY, baseGroupZ, groupCountX,
-                                groupCountY, groupCountZ);
+      ser.SetDrawChunk();
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdDispatchBase);
+      Serialise_vkCmdDispatchBase(ser, commandBuffer, baseGroupX, baseGroupY, baseGroupZ,
+                                  groupCountX, groupCountY, groupCountZ);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -84,12 +84,15 @@ void WrappedVulkan::vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t fir
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetViewport);
-    Serialise_vkCmdSetViewport(ser, commandBuffer, firstViewport, viewportCount, pViewports);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetViewport);
+      Serialise_vkCmdSetViewport(ser, commandBuffer, firstViewport, viewportCount, pViewports);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -117,6 +120,16 @@ bool WrappedVulkan::Serialise_vkCmdSetScissor(SerialiserType &ser, VkCommandBuff
       {
         commandBuffer = RerecordCmdBuf(m_LastCmdBufferID);
 
+        {
+          std::vector<VkRect2D> &scissors = m_BakedCmdBufferInfo[m_LastCmdBufferID].state.scissors;
+
+          if(scissors.size() < firstScissor + scissorCount)
+            scissors.resize(firstScissor + scissorCount);
+
+          for(uint32_t i = 0; i < scissorCount; i++)
+            scissors[firstScissor + i] = pScissors[i];
+        }
+
         if(IsPartialCmdBuf(m_LastCmdBufferID))
         {
           if(m_RenderState.scissors.size() < firstScissor + scissorCount)
@@ -152,12 +165,15 @@ void WrappedVulkan::vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firs
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetScissor);
-    Serialise_vkCmdSetScissor(ser, commandBuffer, firstScissor, scissorCount, pScissors);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetScissor);
+      Serialise_vkCmdSetScissor(ser, commandBuffer, firstScissor, scissorCount, pScissors);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -208,12 +224,15 @@ void WrappedVulkan::vkCmdSetLineWidth(VkCommandBuffer commandBuffer, float lineW
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetLineWidth);
-    Serialise_vkCmdSetLineWidth(ser, commandBuffer, lineWidth);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetLineWidth);
+      Serialise_vkCmdSetLineWidth(ser, commandBuffer, lineWidth);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -275,12 +294,16 @@ void WrappedVulkan::vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depth
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDepthBias);
-    Serialise_vkCmdSetDepthBias(ser, commandBuffer, depthBias, depthBiasClamp, slopeScaledDepthBias);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDepthBias);
+      Serialise_vkCmdSetDepthBias(ser, commandBuffer, depthBias, depthBiasClamp,
+                                  slopeScaledDepthBias);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -332,12 +355,15 @@ void WrappedVulkan::vkCmdSetBlendConstants(VkCommandBuffer commandBuffer, const
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetBlendConstants);
-    Serialise_vkCmdSetBlendConstants(ser, commandBuffer, blendConst);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetBlendConstants);
+      Serialise_vkCmdSetBlendConstants(ser, commandBuffer, blendConst);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -394,12 +420,15 @@ void WrappedVulkan::vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float min
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDepthBounds);
-    Serialise_vkCmdSetDepthBounds(ser, commandBuffer, minDepthBounds, maxDepthBounds);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetDepthBounds);
+      Serialise_vkCmdSetDepthBounds(ser, commandBuffer, minDepthBounds, maxDepthBounds);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -460,12 +489,15 @@ void WrappedVulkan::vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilCompareMask);
-    Serialise_vkCmdSetStencilCompareMask(ser, commandBuffer, faceMask, compareMask);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilCompareMask);
+      Serialise_vkCmdSetStencilCompareMask(ser, commandBuffer, faceMask, compareMask);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -526,12 +558,15 @@ void WrappedVulkan::vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilWriteMask);
-    Serialise_vkCmdSetStencilWriteMask(ser, commandBuffer, faceMask, writeMask);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilWriteMask);
+      Serialise_vkCmdSetStencilWriteMask(ser, commandBuffer, faceMask, writeMask);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -592,12 +627,15 @@ void WrappedVulkan::vkCmdSetStencilReference(VkCommandBuffer commandBuffer,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilReference);
-    Serialise_vkCmdSetStencilReference(ser, commandBuffer, faceMask, reference);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetStencilReference);
+      Serialise_vkCmdSetStencilReference(ser, commandBuffer, faceMask, reference);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
   }
 }
 
@@ -558,6 +558,11 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
   bool capframe = false;
   set<ResourceId> refdIDs;
 
+  // descriptor sets bound in this submit, and a scratch list of the refs to mark from them
+  set<VkResourceRecord *> refdDescSets;
+  std::vector<std::pair<ResourceId, FrameRefType> > descFrameRefs;
+  std::vector<ResourceId> descSparseRefs;
+
   VkResourceRecord *queueRecord = GetRecord(queue);
 
   for(uint32_t s = 0; s < submitCount; s++)
@@ -575,6 +580,14 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
                                             m_ImageLayouts);
       }
 
+      // command buffers recorded while idle have no serialised commands, so can't be captured
+      bool idleRecorded = record->bakedCommands->cmdInfo->idle;
+      for(VkResourceRecord *sub : record->bakedCommands->cmdInfo->subcmds)
+        idleRecorded |= sub->bakedCommands->cmdInfo->idle;
+
+      if(idleRecorded)
+        m_IdleRecording.MarkIdleSubmitted();
+
       // need to lock the whole section of code, not just the check on
       // m_State, as we also need to make sure we don't check the state,
       // start marking dirty resources then while we're doing so the
@@ -594,6 +607,9 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
               GetResourceManager()->MarkPendingDirty(*it);
           }
 
+          if(idleRecorded)
+            m_IdleCaptureDiscarded = true;
+
           capframe = true;
         }
         else
@@ -610,7 +626,11 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       if(capframe)
       {
         // for each bound descriptor set, mark it referenced as well as all resources currently
-        // bound to it
+        // bound to it. Sets that were already marked earlier in this capture only return the refs
+        // added since, so large bindless sets are only walked once per capture.
+        descFrameRefs.clear();
+        descSparseRefs.clear();
+
         for(auto it = record->bakedCommands->cmdInfo->boundDescSets.begin();
             it != record->bakedCommands->cmdInfo->boundDescSets.end(); ++it)
         {
@@ -618,19 +638,19 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
           VkResourceRecord *setrecord = GetRecord(*it);
 
-          for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
-              refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
-          {
-            refdIDs.insert(refit->first);
-            GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+          setrecord->descInfo->GetUnmarkedFrameRefs(m_CaptureGeneration, descFrameRefs,
+                                                    descSparseRefs);
 
-            if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
-            {
-              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->first);
+          refdDescSets.insert(setrecord);
+        }
 
-              GetResourceManager()->MarkSparseMapReferenced(sparserecord->sparseInfo);
-            }
-          }
+        GetResourceManager()->MarkResourcesFrameReferenced(descFrameRefs);
+
+        for(ResourceId id : descSparseRefs)
+        {
+          VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(id);
+
+          GetResourceManager()->MarkSparseMapReferenced(sparserecord->sparseInfo);
         }
 
         for(auto it = record->bakedCommands->cmdInfo->sparse.begin();
@@ -693,7 +713,16 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
       if(state.mapCoherent && state.mappedPtr && !state.mapFlushed)
       {
         // only need to flush memory that could affect this submitted batch of work
-        if(refdIDs.find(record->GetResourceID()) == refdIDs.end())
+        bool referenced = refdIDs.find(record->GetResourceID()) != refdIDs.end();
+
+        for(auto setit = refdDescSets.begin(); !referenced && setit != refdDescSets.end(); ++setit)
+        {
+          const map<ResourceId, pair<uint32_t, FrameRefType> > &bindRefs =
+              (*setit)->descInfo->bindFrameRefs;
+          referenced = bindRefs.find(record->GetResourceID()) != bindRefs.end();
+        }
+
+        if(!referenced)
         {
           RDCDEBUG("Map of memory %llu not referenced in this queue - not flushing",
                    record->GetResourceID());
@@ -653,12 +653,15 @@ void WrappedVulkan::vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event,
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetEvent);
-    Serialise_vkCmdSetEvent(ser, commandBuffer, event, stageMask);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdSetEvent);
+      Serialise_vkCmdSetEvent(ser, commandBuffer, event, stageMask);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(event), eFrameRef_Read);
   }
 }
@@ -710,12 +713,15 @@ void WrappedVulkan::vkCmdResetEvent(VkCommandBuffer commandBuffer, VkEvent event
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResetEvent);
-    Serialise_vkCmdResetEvent(ser, commandBuffer, event, stageMask);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdResetEvent);
+      Serialise_vkCmdResetEvent(ser, commandBuffer, event, stageMask);
 
-    record->AddChunk(scope.Get());
+      record->AddChunk(scope.Get());
+    }
     record->MarkResourceFrameReferenced(GetResID(event), eFrameRef_Read);
   }
 }
@@ -874,12 +880,18 @@ void WrappedVulkan::vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t even
   {
     VkResourceRecord *record = GetRecord(commandBuffer);
 
-    CACHE_THREAD_SERIALISER();
+    if(!record->cmdInfo->idle)
+    {
+      CACHE_THREAD_SERIALISER();
 
-    SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWaitEvents);
-    Serialise_vkCmdWaitEvents(ser, commandBuffer, eventCount, pEvents, srcStageMask, dstStageMask,
-                              memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
-                              pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
+      SCOPED_SERIALISE_CHUNK(VulkanChunk::vkCmdWaitEvents);
+      Serialise_vkCmdWaitEvents(ser, commandBuffer, eventCount, pEvents, srcStageMask, dstStageMask,
+                                memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
+                                pBufferMemoryBarriers, imageMemoryBarrierCount,
+                                pImageMemoryBarriers);
+
+      record->AddChunk(scope.Get());
+    }
 
     if(imageMemoryBarrierCount > 0)
     {
@@ -889,7 +901,6 @@ void WrappedVulkan::vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t even
                                            pImageMemoryBarriers);
     }
 
-    record->AddChunk(scope.Get());
     for(uint32_t i = 0; i < eventCount; i++)
       record->MarkResourceFrameReferenced(GetResID(pEvents[i]), eFrameRef_Read);
   }
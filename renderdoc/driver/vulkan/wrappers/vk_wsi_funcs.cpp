@@ -783,7 +783,14 @@ VkResult WrappedVulkan::vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR
   if(IsActiveCapturing(m_State) && !m_AppControlledCapture)
     RenderDoc::Inst().EndFrameCapture(LayerDisp(m_Instance), swapInfo.wndHandle);
 
-  if(RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter) && IsBackgroundCapturing(m_State))
+  bool trigger = RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter);
+
+  // with low overhead idle recording, a triggered capture may need to wait for command buffers
+  // recorded before it was triggered to stop being submitted
+  trigger = m_IdleRecording.FrameBoundary(RenderDoc::Inst().GetCaptureOptions().lowOverheadIdle,
+                                          trigger);
+
+  if(trigger && IsBackgroundCapturing(m_State))
   {
     RenderDoc::Inst().StartFrameCapture(LayerDisp(m_Instance), swapInfo.wndHandle);
 
@@ -167,4 +167,10 @@ inline float ConvertFromSRGB8(uint8_t comp)
 struct ResourceFormat;
 float ConvertComponent(const ResourceFormat &fmt, const byte *data);
 
+// converts count pixels spaced stride bytes apart to RGBA floats, with the same results as calling
+// ConvertComponent on each component. Missing components are 0, or 1 for alpha.
+void ConvertPixelsToFloat4(const ResourceFormat &fmt, const byte *data, size_t count,
+                           size_t stride, Vec4f *out);
+
+
 #include "half_convert.h"
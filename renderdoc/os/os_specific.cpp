@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #include "os/os_specific.h"
+#include <errno.h>
 #include <stdarg.h>
 #include "strings/string_utils.h"
 
@@ -193,6 +194,36 @@ string OSUtility::MakeMachineIdentString(uint64_t ident)
   return ret;
 }
 
+bool Network::Socket::SendFileBuffered(FILE *file, uint64_t offset, uint64_t length)
+{
+  uint64_t oldOffset = FileIO::ftell64(file);
+  FileIO::fseek64(file, offset, SEEK_SET);
+
+  std::vector<byte> buf((size_t)RDCMIN<uint64_t>(length, 1024 * 1024));
+
+  bool success = true;
+
+  while(success && length > 0)
+  {
+    uint32_t chunkSize = (uint32_t)RDCMIN<uint64_t>(length, buf.size());
+
+    if(FileIO::fread(buf.data(), 1, chunkSize, file) != chunkSize)
+    {
+      RDCWARN("Error reading file to send, errno %d", errno);
+      Shutdown();
+      success = false;
+      break;
+    }
+
+    success = SendDataBlocking(buf.data(), chunkSize);
+    length -= chunkSize;
+  }
+
+  FileIO::fseek64(file, oldOffset, SEEK_SET);
+
+  return success;
+}
+
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #include "3rdparty/catch/catch.hpp"
@@ -144,6 +144,9 @@ void JoinThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
 
+// number of logical processors available, always at least 1
+uint32_t NumberOfCores();
+
 // kind of windows specific, to handle this case:
 // http://blogs.msdn.com/b/oldnewthing/archive/2013/11/05/10463645.aspx
 void KeepModuleAlive();
@@ -170,10 +173,17 @@ public:
   bool IsRecvDataWaiting();
 
   bool SendDataBlocking(const void *buf, uint32_t length);
+  // sends length bytes of the file starting at offset, directly from the file where the platform
+  // allows it. The file's current position is left unchanged.
+  bool SendFileBlocking(FILE *file, uint64_t offset, uint64_t length);
   bool RecvDataBlocking(void *data, uint32_t length);
   bool RecvDataNonBlocking(void *data, uint32_t &length);
 
 private:
+  // the platform-independent part of SendFileBlocking: reads the file through a buffer and sends
+  // it with SendDataBlocking.
+  bool SendFileBuffered(FILE *file, uint64_t offset, uint64_t length);
+
   ptrdiff_t socket;
   uint32_t timeoutMS;
 };
@@ -23,6 +23,8 @@
  ******************************************************************************/
 
 #include <arpa/inet.h>
+#include <errno.h>
+#include <sys/sendfile.h>
 #include "os/os_specific.h"
 #include "os/posix/posix_network.h"
 
@@ -38,4 +40,18 @@ Socket *CreateServerSocket(const char * /* bindaddr */, uint16_t port, int queue
 {
   return CreateAbstractServerSocket(port, queuesize);
 }
+
+int64_t SendFileData(int socket, int fd, uint64_t offset, uint64_t length)
+{
+  // without a 64-bit off_t the offset may not be representable, so fall back to buffered sends
+  if(sizeof(off_t) < sizeof(uint64_t) && offset + length > 0x7fffffffULL)
+  {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  off_t offs = (off_t)offset;
+
+  return (int64_t)sendfile(socket, fd, &offs, (size_t)RDCMIN<uint64_t>(length, 0x7ffff000ULL));
+}
 };
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <errno.h>
 #include "os/os_specific.h"
 #include "os/posix/posix_network.h"
 
@@ -36,4 +37,11 @@ Socket *CreateServerSocket(const char *bindaddr, uint16_t port, int queuesize)
 {
   return CreateTCPServerSocket(bindaddr, port, queuesize);
 }
+
+int64_t SendFileData(int socket, int fd, uint64_t offset, uint64_t length)
+{
+  // not implemented, file data is sent through a buffer
+  errno = ENOSYS;
+  return -1;
+}
 };
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <sys/sendfile.h>
 #include "os/os_specific.h"
 #include "os/posix/posix_network.h"
 
@@ -36,4 +37,12 @@ Socket *CreateServerSocket(const char *bindaddr, uint16_t port, int queuesize)
 {
   return CreateTCPServerSocket(bindaddr, port, queuesize);
 }
+
+int64_t SendFileData(int socket, int fd, uint64_t offset, uint64_t length)
+{
+  off64_t offs = (off64_t)offset;
+
+  // sendfile transfers at most just under 2GB per call
+  return (int64_t)sendfile64(socket, fd, &offs, (size_t)RDCMIN<uint64_t>(length, 0x7ffff000ULL));
+}
 };
@@ -27,6 +27,7 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,6 +70,21 @@ static std::string errno_string(int err)
   return StringFormat::Fmt("Unknown error %d", err);
 }
 
+// sockets are kept non-blocking, so blocking operations wait for readiness here instead of toggling
+// the socket mode and timeouts on every call.
+static bool WaitForSocket(int socket, short events, uint32_t timeoutMS)
+{
+  pollfd pfd = {socket, events, 0};
+
+  int ret = 0;
+  do
+  {
+    ret = poll(&pfd, 1, (int)timeoutMS);
+  } while(ret < 0 && errno == EINTR);
+
+  return ret > 0;
+}
+
 namespace Network
 {
 void Init()
@@ -139,28 +155,22 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
 
   char *src = (char *)buf;
 
-  int flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
-
-  timeval oldtimeout = {0};
-  socklen_t len = sizeof(oldtimeout);
-  getsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (char *)&oldtimeout, &len);
-
-  timeval timeout = {0};
-  timeout.tv_sec = (timeoutMS / 1000);
-  timeout.tv_usec = (timeoutMS % 1000) * 1000;
-  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
-
   while(sent < length)
   {
     int ret = send(socket, src, length - sent, 0);
 
-    if(ret <= 0)
+    if(ret < 0)
     {
       int err = errno;
 
+      if(err == EINTR)
+        continue;
+
       if(err == EWOULDBLOCK || err == EAGAIN)
       {
+        if(WaitForSocket((int)socket, POLLOUT, timeoutMS))
+          continue;
+
         RDCWARN("Timeout in send");
         Shutdown();
         return false;
@@ -177,16 +187,64 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
     src += ret;
   }
 
-  flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
-
-  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
-
   RDCASSERT(sent == length);
 
   return true;
 }
 
+bool Socket::SendFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  int fd = fileno(file);
+
+  while(length > 0)
+  {
+    int64_t ret = SendFileData((int)socket, fd, offset, length);
+
+    if(ret < 0)
+    {
+      int err = errno;
+
+      if(err == EINTR)
+        continue;
+
+      if(err == EWOULDBLOCK || err == EAGAIN)
+      {
+        if(WaitForSocket((int)socket, POLLOUT, timeoutMS))
+          continue;
+
+        RDCWARN("Timeout in sendfile");
+        Shutdown();
+        return false;
+      }
+      else if(err == ENOSYS || err == EINVAL)
+      {
+        // no direct path for this platform or file, fall back to reading it through a buffer
+        break;
+      }
+      else
+      {
+        RDCWARN("sendfile: %s", errno_string(err).c_str());
+        Shutdown();
+        return false;
+      }
+    }
+    else if(ret == 0)
+    {
+      RDCWARN("File ended with %llu bytes left to send", length);
+      Shutdown();
+      return false;
+    }
+
+    offset += (uint64_t)ret;
+    length -= (uint64_t)ret;
+  }
+
+  if(length == 0)
+    return true;
+
+  return SendFileBuffered(file, offset, length);
+}
+
 bool Socket::IsRecvDataWaiting()
 {
   char dummy;
@@ -257,18 +315,6 @@ bool Socket::RecvDataBlocking(void *buf, uint32_t length)
 
   char *dst = (char *)buf;
 
-  int flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
-
-  timeval oldtimeout = {0};
-  socklen_t len = sizeof(oldtimeout);
-  getsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&oldtimeout, &len);
-
-  timeval timeout = {0};
-  timeout.tv_sec = (timeoutMS / 1000);
-  timeout.tv_usec = (timeoutMS % 1000) * 1000;
-  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
-
   while(received < length)
   {
     int ret = recv(socket, dst, length - received, 0);
@@ -278,12 +324,18 @@ bool Socket::RecvDataBlocking(void *buf, uint32_t length)
       Shutdown();
       return false;
     }
-    else if(ret <= 0)
+    else if(ret < 0)
     {
       int err = errno;
 
+      if(err == EINTR)
+        continue;
+
       if(err == EWOULDBLOCK || err == EAGAIN)
       {
+        if(WaitForSocket((int)socket, POLLIN, timeoutMS))
+          continue;
+
         RDCWARN("Timeout in recv");
         Shutdown();
         return false;
@@ -300,11 +352,6 @@ bool Socket::RecvDataBlocking(void *buf, uint32_t length)
     dst += ret;
   }
 
-  flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
-
-  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
-
   RDCASSERT(received == length);
 
   return true;
@@ -29,4 +29,8 @@ namespace Network
 uint32_t GetIPFromTCPSocket(int socket);
 Socket *CreateAbstractServerSocket(uint16_t port, int queuesize);
 Socket *CreateTCPServerSocket(const char *bindaddr, uint16_t port, int queuesize);
+
+// sends up to length bytes from fd at offset to the socket without copying through userspace.
+// Returns the number of bytes sent, or -1 with errno set - ENOSYS if there's no way to do this.
+int64_t SendFileData(int socket, int fd, uint64_t offset, uint64_t length);
 }
@@ -199,6 +199,12 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
   return true;
 }
 
+bool Socket::SendFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  // file data is always sent through a buffer here
+  return SendFileBuffered(file, offset, length);
+}
+
 bool Socket::IsRecvDataWaiting()
 {
   char dummy;
@@ -290,4 +290,11 @@ void Sleep(uint32_t milliseconds)
 {
   ::Sleep((DWORD)milliseconds);
 }
+
+uint32_t NumberOfCores()
+{
+  SYSTEM_INFO info = {};
+  GetSystemInfo(&info);
+  return RDCMAX(1U, (uint32_t)info.dwNumberOfProcessors);
+}
 };
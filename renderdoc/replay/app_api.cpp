@@ -187,6 +187,17 @@ static void TriggerMultiFrameCapture(uint32_t numFrames)
   RenderDoc::Inst().TriggerCapture(numFrames);
 }
 
+static void SetFrameTimeCaptureTrigger(float thresholdMs, float medianMultiplier,
+                                       uint32_t cooldownFrames, uint32_t maxCaptures)
+{
+  FrameTimeTrigger trigger;
+  trigger.thresholdMs = thresholdMs;
+  trigger.medianMultiplier = medianMultiplier;
+  trigger.cooldownFrames = cooldownFrames;
+  trigger.maxCaptures = maxCaptures;
+  RenderDoc::Inst().SetFrameTimeTrigger(trigger);
+}
+
 static uint32_t IsTargetControlConnected()
 {
   return RenderDoc::Inst().IsTargetControlConnected();
@@ -239,22 +250,22 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val);
 uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt);
 float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt);
 
-void RENDERDOC_CC GetAPIVersion_1_2_0(int *major, int *minor, int *patch)
+void RENDERDOC_CC GetAPIVersion_1_3_0(int *major, int *minor, int *patch)
 {
   if(major)
     *major = 1;
   if(minor)
-    *minor = 2;
+    *minor = 3;
   if(patch)
     *patch = 0;
 }
 
-RENDERDOC_API_1_2_0 api_1_2_0;
-void Init_1_2_0()
+RENDERDOC_API_1_3_0 api_1_3_0;
+void Init_1_3_0()
 {
-  RENDERDOC_API_1_2_0 &api = api_1_2_0;
+  RENDERDOC_API_1_3_0 &api = api_1_3_0;
 
-  api.GetAPIVersion = &GetAPIVersion_1_2_0;
+  api.GetAPIVersion = &GetAPIVersion_1_3_0;
 
   api.SetCaptureOptionU32 = &SetCaptureOptionU32;
   api.SetCaptureOptionF32 = &SetCaptureOptionF32;
@@ -291,6 +302,8 @@ void Init_1_2_0()
   api.TriggerMultiFrameCapture = &TriggerMultiFrameCapture;
 
   api.SetCaptureFileComments = &SetCaptureFileComments;
+
+  api.SetFrameTimeCaptureTrigger = &SetFrameTimeCaptureTrigger;
 }
 
 extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version version,
@@ -317,13 +330,14 @@ extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version ver
     ret = 1;                                                       \
   }
 
-  API_VERSION_HANDLE(1_0_0, 1_2_0);
-  API_VERSION_HANDLE(1_0_1, 1_2_0);
-  API_VERSION_HANDLE(1_0_2, 1_2_0);
-  API_VERSION_HANDLE(1_1_0, 1_2_0);
-  API_VERSION_HANDLE(1_1_1, 1_2_0);
-  API_VERSION_HANDLE(1_1_2, 1_2_0);
-  API_VERSION_HANDLE(1_2_0, 1_2_0);
+  API_VERSION_HANDLE(1_0_0, 1_3_0);
+  API_VERSION_HANDLE(1_0_1, 1_3_0);
+  API_VERSION_HANDLE(1_0_2, 1_3_0);
+  API_VERSION_HANDLE(1_1_0, 1_3_0);
+  API_VERSION_HANDLE(1_1_1, 1_3_0);
+  API_VERSION_HANDLE(1_1_2, 1_3_0);
+  API_VERSION_HANDLE(1_2_0, 1_3_0);
+  API_VERSION_HANDLE(1_3_0, 1_3_0);
 
 #undef API_VERSION_HANDLE
 
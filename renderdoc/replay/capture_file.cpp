@@ -29,6 +29,7 @@
 #include "replay/replay_controller.h"
 #include "serialise/rdcfile.h"
 #include "serialise/serialiser.h"
+#include "serialise/zstdio.h"
 #include "stb/stb_image.h"
 #include "stb/stb_image_resize.h"
 #include "stb/stb_image_write.h"
@@ -129,6 +130,7 @@ public:
 
   ReplayStatus Convert(const char *filename, const char *filetype, const SDFile *file,
                        RENDERDOC_ProgressCallback progress);
+  void SetCompressionDictionary(SectionType section, const bytebuf &dictionary, bool embed);
 
   rdcarray<CaptureFileFormat> GetCaptureFileFormats()
   {
@@ -183,6 +185,14 @@ private:
 
   SDFile m_StructuredData;
 
+  struct ConvertDictionary
+  {
+    bytebuf data;
+    bool embed;
+  };
+
+  std::map<SectionType, ConvertDictionary> m_ConvertDictionaries;
+
   std::string m_DriverName, m_Ident, m_ErrorString;
   ReplaySupport m_Support = ReplaySupport::Unsupported;
 };
@@ -446,6 +456,9 @@ ReplayStatus CaptureFile::Convert(const char *filename, const char *filetype, co
   output.SetData(m_RDC->GetDriver(), m_RDC->GetDriverName().c_str(), m_RDC->GetMachineIdent(),
                  &m_RDC->GetThumbnail());
 
+  for(auto it = m_ConvertDictionaries.begin(); it != m_ConvertDictionaries.end(); ++it)
+    output.SetCompressionDictionary(it->first, it->second.data, it->second.embed);
+
   output.Create(filename);
 
   if(output.ErrorCode() != ContainerError::NoError)
@@ -715,6 +728,15 @@ bytebuf CaptureFile::GetSectionContents(int index)
   return ret;
 }
 
+void CaptureFile::SetCompressionDictionary(SectionType section, const bytebuf &dictionary,
+                                           bool embed)
+{
+  if(dictionary.empty())
+    m_ConvertDictionaries.erase(section);
+  else
+    m_ConvertDictionaries[section] = {dictionary, embed};
+}
+
 bool CaptureFile::WriteSection(const SectionProperties &props, const bytebuf &contents)
 {
   StreamWriter *writer = m_RDC->WriteSection(props);
@@ -806,3 +828,61 @@ extern "C" RENDERDOC_API ICaptureFile *RENDERDOC_CC RENDERDOC_OpenCaptureFile()
 {
   return new CaptureFile();
 }
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_TrainCompressionDictionary(const rdcarray<rdcstr> &captures, SectionType section,
+                                     uint32_t maxSize, bytebuf &dictionary)
+{
+  ZSTDDictionaryTrainer trainer(maxSize);
+
+  bytebuf buf;
+  buf.resize(1024 * 1024);
+
+  for(const rdcstr &capture : captures)
+  {
+    RDCFile rdc;
+    rdc.Open(capture.c_str());
+
+    if(rdc.ErrorCode() != ContainerError::NoError)
+    {
+      RDCERR("Couldn't open '%s' to train dictionary", capture.c_str());
+      return ReplayStatus::FileIOFailed;
+    }
+
+    int idx = rdc.SectionIndex(section);
+
+    // not every capture has every section, that's fine
+    if(idx < 0)
+      continue;
+
+    StreamReader *reader = rdc.ReadSection(idx);
+
+    while(!reader->IsErrored() && !reader->AtEnd())
+    {
+      uint64_t chunkSize = RDCMIN(reader->GetSize() - reader->GetOffset(), (uint64_t)buf.size());
+      reader->Read(buf.data(), chunkSize);
+      trainer.AddSample(buf.data(), chunkSize);
+    }
+
+    bool errored = reader->IsErrored();
+
+    delete reader;
+
+    if(errored)
+    {
+      RDCERR("Error reading %s from '%s' to train dictionary", ToStr(section).c_str(),
+             capture.c_str());
+      return ReplayStatus::FileIOFailed;
+    }
+  }
+
+  dictionary = trainer.Train();
+
+  return ReplayStatus::Succeeded;
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC
+RENDERDOC_GetCompressionDictionaryFilename(const bytebuf &dictionary, rdcstr &name)
+{
+  name = CompressionDictionaryFilename(ZSTDDictionaryID(dictionary));
+}
@@ -50,6 +50,8 @@ int RENDERDOC_CC SetCaptureOptionU32(RENDERDOC_CaptureOption opt, uint32_t val)
       break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0); break;
+    case eRENDERDOC_Option_LowOverheadIdle: opts.lowOverheadIdle = (val != 0); break;
+    case eRENDERDOC_Option_RetainInitialContents: opts.retainInitialContents = (val != 0); break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -79,6 +81,10 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val)
       break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0.0f); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0.0f); break;
+    case eRENDERDOC_Option_LowOverheadIdle: opts.lowOverheadIdle = (val != 0.0f); break;
+    case eRENDERDOC_Option_RetainInitialContents:
+      opts.retainInitialContents = (val != 0.0f);
+      break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -115,6 +121,10 @@ uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1 : 0);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1 : 0);
+    case eRENDERDOC_Option_LowOverheadIdle:
+      return (RenderDoc::Inst().GetCaptureOptions().lowOverheadIdle ? 1 : 0);
+    case eRENDERDOC_Option_RetainInitialContents:
+      return (RenderDoc::Inst().GetCaptureOptions().retainInitialContents ? 1 : 0);
     default: break;
   }
 
@@ -151,6 +161,10 @@ float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1.0f : 0.0f);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1.0f : 0.0f);
+    case eRENDERDOC_Option_LowOverheadIdle:
+      return (RenderDoc::Inst().GetCaptureOptions().lowOverheadIdle ? 1.0f : 0.0f);
+    case eRENDERDOC_Option_RetainInitialContents:
+      return (RenderDoc::Inst().GetCaptureOptions().retainInitialContents ? 1.0f : 0.0f);
     default: break;
   }
 
@@ -171,4 +185,6 @@ CaptureOptions::CaptureOptions()
   refAllResources = false;
   captureAllCmdLists = false;
   debugOutputMute = true;
+  lowOverheadIdle = false;
+  retainInitialContents = false;
 }
@@ -111,10 +111,36 @@ void DoSerialise(SerialiserType &ser, CaptureOptions &el)
   SERIALISE_MEMBER(refAllResources);
   SERIALISE_MEMBER(captureAllCmdLists);
   SERIALISE_MEMBER(debugOutputMute);
+  SERIALISE_MEMBER(lowOverheadIdle);
+  SERIALISE_MEMBER(retainInitialContents);
 
   SIZE_CHECK(20);
 }
 
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, FrameTimeTrigger &el)
+{
+  SERIALISE_MEMBER(thresholdMs);
+  SERIALISE_MEMBER(medianMultiplier);
+  SERIALISE_MEMBER(cooldownFrames);
+  SERIALISE_MEMBER(maxCaptures);
+
+  SIZE_CHECK(16);
+}
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, FrameTimeTriggerStats &el)
+{
+  SERIALISE_MEMBER(framesObserved);
+  SERIALISE_MEMBER(capturesTriggered);
+  SERIALISE_MEMBER(medianFrameTime);
+  SERIALISE_MEMBER(lastTriggerFrameTime);
+  SERIALISE_MEMBER(lastTriggerMedian);
+  SERIALISE_MEMBER(armed);
+
+  SIZE_CHECK(24);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, ResourceFormat &el)
 {
@@ -378,18 +404,30 @@ void DoSerialise(SerialiserType &ser, LineColumnInfo &el)
   SIZE_CHECK(40);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ShaderVariableChange &el)
+{
+  SERIALISE_MEMBER(type);
+  SERIALISE_MEMBER(index);
+  SERIALISE_MEMBER(element);
+  SERIALISE_MEMBER(value);
+
+  SIZE_CHECK(200);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, ShaderDebugState &el)
 {
   SERIALISE_MEMBER(registers);
   SERIALISE_MEMBER(outputs);
   SERIALISE_MEMBER(indexableTemps);
+  SERIALISE_MEMBER(changes);
   SERIALISE_MEMBER(locals);
   SERIALISE_MEMBER(modified);
   SERIALISE_MEMBER(nextInstruction);
   SERIALISE_MEMBER(flags);
 
-  SIZE_CHECK(88);
+  SIZE_CHECK(104);
 }
 
 template <typename SerialiserType>
@@ -398,6 +436,7 @@ void DoSerialise(SerialiserType &ser, ShaderDebugTrace &el)
   SERIALISE_MEMBER(inputs);
   SERIALISE_MEMBER(constantBlocks);
   SERIALISE_MEMBER(states);
+  SERIALISE_MEMBER(keyframeInterval);
   SERIALISE_MEMBER(hasLocals);
   SERIALISE_MEMBER(lineInfo);
 
@@ -2125,6 +2164,8 @@ INSTANTIATE_SERIALISE_TYPE(PathEntry)
 INSTANTIATE_SERIALISE_TYPE(SectionProperties)
 INSTANTIATE_SERIALISE_TYPE(EnvironmentModification)
 INSTANTIATE_SERIALISE_TYPE(CaptureOptions)
+INSTANTIATE_SERIALISE_TYPE(FrameTimeTrigger)
+INSTANTIATE_SERIALISE_TYPE(FrameTimeTriggerStats)
 INSTANTIATE_SERIALISE_TYPE(ResourceFormat)
 INSTANTIATE_SERIALISE_TYPE(Bindpoint)
 INSTANTIATE_SERIALISE_TYPE(ShaderBindpointMapping)
@@ -2140,6 +2181,7 @@ INSTANTIATE_SERIALISE_TYPE(ShaderDebugInfo)
 INSTANTIATE_SERIALISE_TYPE(ShaderReflection)
 INSTANTIATE_SERIALISE_TYPE(ShaderVariable)
 INSTANTIATE_SERIALISE_TYPE(LocalVariableMapping);
+INSTANTIATE_SERIALISE_TYPE(ShaderVariableChange)
 INSTANTIATE_SERIALISE_TYPE(ShaderDebugState)
 INSTANTIATE_SERIALISE_TYPE(ShaderDebugTrace)
 INSTANTIATE_SERIALISE_TYPE(ResourceDescription)
@@ -24,9 +24,11 @@
  ******************************************************************************/
 
 #include "replay_controller.h"
+#include <algorithm>
 #include <string.h>
 #include <time.h>
 #include "common/dds_readwrite.h"
+#include "common/threading.h"
 #include "driver/ihv/amd/amd_isa.h"
 #include "driver/ihv/amd/amd_rgp.h"
 #include "jpeg-compressor/jpgd.h"
@@ -40,127 +42,310 @@
 #include "strings/string_utils.h"
 #include "tinyexr/tinyexr.h"
 
-float ConvertComponent(const ResourceFormat &fmt, const byte *data)
+#if ENABLED(RDOC_SSE2)
+#include <emmintrin.h>
+#endif
+
+typedef float (*ComponentConverter)(const byte *data);
+
+static float ConvertDoubleComponent(const byte *data)
+{
+  // we just downcast
+  return float(*(const double *)data);
+}
+
+static float ConvertUInt64Component(const byte *data)
+{
+  return float(*(const uint64_t *)data);
+}
+
+static float ConvertSInt64Component(const byte *data)
+{
+  return float(*(const int64_t *)data);
+}
+
+static float ConvertFloatComponent(const byte *data)
+{
+  return *(const float *)data;
+}
+
+static float ConvertUInt32Component(const byte *data)
+{
+  return float(*(const uint32_t *)data);
+}
+
+static float ConvertSInt32Component(const byte *data)
+{
+  return float(*(const int32_t *)data);
+}
+
+static float ConvertDepth24Component(const byte *data)
+{
+  // 24-bit depth is a weird edge case we need to assemble it by hand
+  const uint8_t *u8 = (const uint8_t *)data;
+
+  uint32_t depth = 0;
+  depth |= uint32_t(u8[1]);
+  depth |= uint32_t(u8[2]) << 8;
+  depth |= uint32_t(u8[3]) << 16;
+
+  return float(depth) / float(16777215.0f);
+}
+
+static float ConvertHalfComponent(const byte *data)
+{
+  return ConvertFromHalf(*(const uint16_t *)data);
+}
+
+static float ConvertUInt16Component(const byte *data)
+{
+  return float(*(const uint16_t *)data);
+}
+
+static float ConvertSInt16Component(const byte *data)
+{
+  return float(*(const int16_t *)data);
+}
+
+static float ConvertUNorm16Component(const byte *data)
+{
+  return float(*(const uint16_t *)data) / 65535.0f;
+}
+
+static float ConvertSNorm16Component(const byte *data)
+{
+  int16_t i16 = *(const int16_t *)data;
+
+  if(i16 == -32768)
+    return -1.0f;
+
+  return ((float)i16) / 32767.0f;
+}
+
+static float ConvertUInt8Component(const byte *data)
+{
+  return float(*(const uint8_t *)data);
+}
+
+static float ConvertSInt8Component(const byte *data)
+{
+  return float(*(const int8_t *)data);
+}
+
+static float ConvertUNorm8Component(const byte *data)
+{
+  return float(*(const uint8_t *)data) / 255.0f;
+}
+
+static float ConvertSRGB8Component(const byte *data)
+{
+  return SRGB8_lookuptable[*(const uint8_t *)data];
+}
+
+static float ConvertSNorm8Component(const byte *data)
+{
+  int8_t i8 = *(const int8_t *)data;
+
+  if(i8 == -128)
+    return -1.0f;
+
+  return ((float)i8) / 127.0f;
+}
+
+// resolve the conversion for a format once, so that loops over many components don't re-check the
+// format for every single one.
+static ComponentConverter GetComponentConverter(const ResourceFormat &fmt)
 {
   if(fmt.compByteWidth == 8)
   {
-    // we just downcast
-    const uint64_t *u64 = (const uint64_t *)data;
-    const int64_t *i64 = (const int64_t *)data;
-
     if(fmt.compType == CompType::Double || fmt.compType == CompType::Float)
-    {
-      return float(*(const double *)u64);
-    }
+      return &ConvertDoubleComponent;
     else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u64);
-    }
+      return &ConvertUInt64Component;
     else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i64);
-    }
+      return &ConvertSInt64Component;
   }
   else if(fmt.compByteWidth == 4)
   {
-    const uint32_t *u32 = (const uint32_t *)data;
-    const int32_t *i32 = (const int32_t *)data;
-
     if(fmt.compType == CompType::Float || fmt.compType == CompType::Depth)
-    {
-      return *(const float *)u32;
-    }
+      return &ConvertFloatComponent;
     else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u32);
-    }
+      return &ConvertUInt32Component;
     else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i32);
-    }
+      return &ConvertSInt32Component;
   }
   else if(fmt.compByteWidth == 3 && fmt.compType == CompType::Depth)
   {
-    // 24-bit depth is a weird edge case we need to assemble it by hand
-    const uint8_t *u8 = (const uint8_t *)data;
-
-    uint32_t depth = 0;
-    depth |= uint32_t(u8[1]);
-    depth |= uint32_t(u8[2]) << 8;
-    depth |= uint32_t(u8[3]) << 16;
-
-    return float(depth) / float(16777215.0f);
+    return &ConvertDepth24Component;
   }
   else if(fmt.compByteWidth == 2)
   {
-    const uint16_t *u16 = (const uint16_t *)data;
-    const int16_t *i16 = (const int16_t *)data;
-
     if(fmt.compType == CompType::Float)
-    {
-      return ConvertFromHalf(*u16);
-    }
+      return &ConvertHalfComponent;
     else if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
-    {
-      return float(*u16);
-    }
+      return &ConvertUInt16Component;
     else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
-    {
-      return float(*i16);
-    }
+      return &ConvertSInt16Component;
     // 16-bit depth is UNORM
     else if(fmt.compType == CompType::UNorm || fmt.compType == CompType::Depth)
-    {
-      return float(*u16) / 65535.0f;
-    }
+      return &ConvertUNorm16Component;
     else if(fmt.compType == CompType::SNorm)
-    {
-      float f = -1.0f;
+      return &ConvertSNorm16Component;
+  }
+  else if(fmt.compByteWidth == 1)
+  {
+    if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+      return &ConvertUInt8Component;
+    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+      return &ConvertSInt8Component;
+    else if(fmt.compType == CompType::UNorm)
+      return fmt.srgbCorrected ? &ConvertSRGB8Component : &ConvertUNorm8Component;
+    else if(fmt.compType == CompType::SNorm)
+      return &ConvertSNorm8Component;
+  }
 
-      if(*i16 == -32768)
-        f = -1.0f;
-      else
-        f = ((float)*i16) / 32767.0f;
+  return NULL;
+}
 
-      return f;
-    }
+float ConvertComponent(const ResourceFormat &fmt, const byte *data)
+{
+  ComponentConverter convert = GetComponentConverter(fmt);
+
+  if(convert)
+    return convert(data);
+
+  RDCERR("Unexpected format to convert from %u %u", fmt.compByteWidth, fmt.compType);
+
+  return 0.0f;
+}
+
+#if ENABLED(RDOC_SSE2)
+
+// converts groups of four RGBA8 UNORM pixels at a time, returns how many pixels were converted.
+// The remainder is left for the scalar loop. Integer to float conversion and division are exact
+// IEEE operations so this produces bit-identical results to ConvertUNorm8Component.
+static size_t ConvertRGBA8UNormSSE2(const byte *data, size_t count, Vec4f *out)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(255.0f);
+
+  size_t i = 0;
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128i pix = _mm_loadu_si128((const __m128i *)(data + i * 4));
+
+    __m128i lo16 = _mm_unpacklo_epi8(pix, zero);
+    __m128i hi16 = _mm_unpackhi_epi8(pix, zero);
+
+    float *dst = &out[i].x;
+
+    _mm_storeu_ps(dst + 0, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale));
+    _mm_storeu_ps(dst + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale));
+    _mm_storeu_ps(dst + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale));
+    _mm_storeu_ps(dst + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale));
   }
-  else if(fmt.compByteWidth == 1)
+
+  return i;
+}
+
+// as above for RGBA16 UNORM, two pixels at a time.
+static size_t ConvertRGBA16UNormSSE2(const byte *data, size_t count, Vec4f *out)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(65535.0f);
+
+  size_t i = 0;
+  for(; i + 2 <= count; i += 2)
   {
-    const uint8_t *u8 = (const uint8_t *)data;
-    const int8_t *i8 = (const int8_t *)data;
+    __m128i pix = _mm_loadu_si128((const __m128i *)(data + i * 8));
 
-    if(fmt.compType == CompType::UInt || fmt.compType == CompType::UScaled)
+    float *dst = &out[i].x;
+
+    _mm_storeu_ps(dst + 0, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(pix, zero)), scale));
+    _mm_storeu_ps(dst + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(pix, zero)), scale));
+  }
+
+  return i;
+}
+
+#endif
+
+void ConvertPixelsToFloat4(const ResourceFormat &fmt, const byte *data, size_t count,
+                           size_t stride, Vec4f *out)
+{
+  if(fmt.type == ResourceFormatType::R10G10B10A2)
+  {
+    if(fmt.compType == CompType::SNorm)
     {
-      return float(*u8);
+      for(size_t i = 0; i < count; i++)
+        out[i] = ConvertFromR10G10B10A2SNorm(*(const uint32_t *)(data + i * stride));
     }
-    else if(fmt.compType == CompType::SInt || fmt.compType == CompType::SScaled)
+    else
     {
-      return float(*i8);
+      for(size_t i = 0; i < count; i++)
+        out[i] = ConvertFromR10G10B10A2(*(const uint32_t *)(data + i * stride));
     }
-    else if(fmt.compType == CompType::UNorm)
+  }
+  else if(fmt.type == ResourceFormatType::R11G11B10)
+  {
+    for(size_t i = 0; i < count; i++)
     {
-      if(fmt.srgbCorrected)
-        return SRGB8_lookuptable[*u8];
-      else
-        return float(*u8) / 255.0f;
+      Vec3f vec = ConvertFromR11G11B10(*(const uint32_t *)(data + i * stride));
+      out[i] = Vec4f(vec.x, vec.y, vec.z, 1.0f);
     }
-    else if(fmt.compType == CompType::SNorm)
+  }
+  else
+  {
+    ComponentConverter convert = GetComponentConverter(fmt);
+
+    if(!convert)
     {
-      float f = -1.0f;
+      RDCERR("Unexpected format to convert from %u %u", fmt.compByteWidth, fmt.compType);
 
-      if(*i8 == -128)
-        f = -1.0f;
-      else
-        f = ((float)*i8) / 127.0f;
+      for(size_t i = 0; i < count; i++)
+        out[i] = Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
 
-      return f;
+      return;
     }
-  }
 
-  RDCERR("Unexpected format to convert from %u %u", fmt.compByteWidth, fmt.compType);
+    const uint32_t compCount = RDCMIN(fmt.compCount, (uint8_t)4);
+    const size_t compWidth = fmt.compByteWidth;
 
-  return 0.0f;
+    size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+    if(compCount == 4 && stride == compWidth * 4)
+    {
+      if(convert == &ConvertUNorm8Component)
+        i = ConvertRGBA8UNormSSE2(data, count, out);
+      else if(convert == &ConvertUNorm16Component)
+        i = ConvertRGBA16UNormSSE2(data, count, out);
+    }
+#endif
+
+    for(; i < count; i++)
+    {
+      const byte *src = data + i * stride;
+
+      Vec4f &dst = out[i];
+      dst = Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+
+      if(compCount >= 1)
+        dst.x = convert(src + compWidth * 0);
+      if(compCount >= 2)
+        dst.y = convert(src + compWidth * 1);
+      if(compCount >= 3)
+        dst.z = convert(src + compWidth * 2);
+      if(compCount >= 4)
+        dst.w = convert(src + compWidth * 3);
+    }
+  }
+
+  if(fmt.bgraOrder)
+  {
+    for(size_t i = 0; i < count; i++)
+      std::swap(out[i].x, out[i].z);
+  }
 }
 
 static void fileWriteFunc(void *context, void *data, int size)
@@ -168,6 +353,26 @@ static void fileWriteFunc(void *context, void *data, int size)
   FileIO::fwrite(data, 1, size, (FILE *)context);
 }
 
+// below this many pixels per thread it's not worth spinning up threads for per-pixel work
+static const uint32_t ParallelMinPixels = 64 * 1024;
+
+// copy an RGBA8 slice into a larger RGBA8 image at the given pixel offset
+static void CopySliceRows(byte *dst, uint32_t dstWidth, const byte *src, uint32_t sliceWidth,
+                          uint32_t sliceHeight, uint32_t xoffs, uint32_t yoffs)
+{
+  for(uint32_t y = 0; y < sliceHeight; y++)
+    memcpy(dst + ((y + yoffs) * dstWidth + xoffs) * 4, src + y * sliceWidth * 4, sliceWidth * 4);
+}
+
+static void DiscardAlpha(byte *rgba8, uint32_t numPixels)
+{
+  Threading::ParallelForRange(numPixels, ParallelMinPixels, [rgba8](uint32_t begin, uint32_t end) {
+    uint32_t *pix = (uint32_t *)rgba8;
+    for(uint32_t p = begin; p < end; p++)
+      pix[p] |= 0xff000000U;
+  });
+}
+
 ReplayController::ReplayController()
 {
   m_pDevice = NULL;
@@ -249,6 +454,93 @@ const PipeState &ReplayController::GetPipelineState()
   return m_PipeState;
 }
 
+// serialise a pipeline state flat, so that the states at different events can be compared
+template <typename State>
+static void FlattenPipelineState(const State &state, bytebuf &data)
+{
+  WriteSerialiser ser(new StreamWriter(StreamWriter::DefaultScratchSize), Ownership::Stream);
+
+  // writing only reads from the state
+  ser.Serialise("state", const_cast<State &>(state));
+
+  data.assign(ser.GetWriter()->GetData(), (size_t)ser.GetWriter()->GetOffset());
+}
+
+// copy the driver's current state for a snapshot, unless it's identical to the previous snapshot's
+// in which case that copy is shared.
+template <typename State>
+static const State *SnapshotPipelineState(const State *cur, const State *prev, bytebuf &curData,
+                                          const bytebuf &prevData, std::deque<State> &storage,
+                                          bool &changed)
+{
+  if(cur == NULL)
+    return NULL;
+
+  FlattenPipelineState(*cur, curData);
+
+  changed = (prev == NULL || !(curData == prevData));
+
+  if(!changed)
+    return prev;
+
+  storage.push_back(*cur);
+  return &storage.back();
+}
+
+rdcarray<PipelineStateSnapshot> ReplayController::GetPipelineStateSnapshots(
+    const rdcarray<uint32_t> &eventIds)
+{
+  m_SnapshotD3D11.clear();
+  m_SnapshotD3D12.clear();
+  m_SnapshotGL.clear();
+  m_SnapshotVulkan.clear();
+
+  rdcarray<PipelineStateSnapshot> ret;
+  ret.reserve(eventIds.size());
+
+  PipelineStateSnapshot prev;
+  bytebuf prevData, curData;
+
+  for(uint32_t eventId : eventIds)
+  {
+    // only the state is needed, so the draw itself isn't replayed and no outputs are updated
+    m_pDevice->ReplayLog(eventId, eReplay_WithoutDraw);
+    m_pDevice->SavePipelineState();
+
+    PipelineStateSnapshot snap;
+    snap.eventId = eventId;
+
+    switch(m_APIProps.pipelineType)
+    {
+      case GraphicsAPI::D3D11:
+        snap.d3d11 = SnapshotPipelineState(m_pDevice->GetD3D11PipelineState(), prev.d3d11, curData,
+                                           prevData, m_SnapshotD3D11, snap.changed);
+        break;
+      case GraphicsAPI::D3D12:
+        snap.d3d12 = SnapshotPipelineState(m_pDevice->GetD3D12PipelineState(), prev.d3d12, curData,
+                                           prevData, m_SnapshotD3D12, snap.changed);
+        break;
+      case GraphicsAPI::OpenGL:
+        snap.gl = SnapshotPipelineState(m_pDevice->GetGLPipelineState(), prev.gl, curData, prevData,
+                                        m_SnapshotGL, snap.changed);
+        break;
+      case GraphicsAPI::Vulkan:
+        snap.vulkan = SnapshotPipelineState(m_pDevice->GetVulkanPipelineState(), prev.vulkan,
+                                            curData, prevData, m_SnapshotVulkan, snap.changed);
+        break;
+    }
+
+    ret.push_back(snap);
+    prev = snap;
+    prevData.swap(curData);
+  }
+
+  // put the replay, outputs and current state back where they were
+  SetFrameEvent(m_EventID, true);
+
+  return ret;
+}
+
 rdcarray<rdcstr> ReplayController::GetDisassemblyTargets()
 {
   rdcarray<rdcstr> ret;
@@ -508,6 +800,159 @@ rdcarray<CounterResult> ReplayController::FetchCounters(const rdcarray<GPUCounte
   return m_pDevice->FetchCounters(counterArray);
 }
 
+static double CounterValueToDouble(const CounterDescription &desc, const CounterValue &val,
+                                   bool &valid)
+{
+  // drivers return all bits set or a negative duration for queries that failed
+  if(desc.resultType == CompType::Float)
+  {
+    double ret = desc.resultByteWidth == 8 ? val.d : double(val.f);
+    valid = (ret >= 0.0);
+    return ret;
+  }
+
+  if(desc.resultByteWidth == 8)
+  {
+    valid = (val.u64 != ~0ULL);
+    return double(val.u64);
+  }
+
+  valid = (val.u32 != ~0U);
+  return double(val.u32);
+}
+
+rdcarray<CounterStatistics> ReplayController::FetchCounterStatistics(
+    const rdcarray<GPUCounter> &counters, uint32_t warmupRuns, uint32_t measuredRuns)
+{
+  rdcarray<CounterStatistics> ret;
+
+  if(counters.empty() || measuredRuns == 0)
+  {
+    RDCERR("Invalid parameters to FetchCounterStatistics - %u counters and %u measured runs",
+           (uint32_t)counters.size(), measuredRuns);
+    return ret;
+  }
+
+  std::vector<GPUCounter> counterArray(counters.begin(), counters.end());
+
+  std::map<GPUCounter, CounterDescription> descs;
+  for(GPUCounter c : counterArray)
+    descs[c] = m_pDevice->DescribeCounter(c);
+
+  // the first runs are only to get caches, clocks and the like into a steady state
+  for(uint32_t i = 0; i < warmupRuns; i++)
+    m_pDevice->FetchCounters(counterArray);
+
+  // CounterResult only compares eventId and counter, so we can use it as the key directly
+  std::map<CounterResult, std::vector<double>> values;
+
+  for(uint32_t i = 0; i < measuredRuns; i++)
+  {
+    std::vector<CounterResult> results = m_pDevice->FetchCounters(counterArray);
+
+    for(const CounterResult &r : results)
+    {
+      bool valid = false;
+      double val = CounterValueToDouble(descs[r.counter], r.value, valid);
+
+      std::vector<double> &samples = values[r];
+      if(valid)
+        samples.push_back(val);
+    }
+  }
+
+  ret.reserve(values.size());
+
+  for(auto it = values.begin(); it != values.end(); ++it)
+  {
+    std::vector<double> &samples = it->second;
+
+    CounterStatistics stats;
+    stats.eventId = it->first.eventId;
+    stats.counter = it->first.counter;
+    stats.runs = (uint32_t)samples.size();
+
+    if(!samples.empty())
+    {
+      std::sort(samples.begin(), samples.end());
+
+      size_t count = samples.size();
+
+      stats.minimum = samples[0];
+
+      if(count % 2 == 1)
+        stats.median = samples[count / 2];
+      else
+        stats.median = (samples[count / 2 - 1] + samples[count / 2]) * 0.5;
+
+      double sum = 0.0;
+      for(double v : samples)
+        sum += v;
+      stats.mean = sum / double(count);
+
+      if(count > 1)
+      {
+        double variance = 0.0;
+        for(double v : samples)
+          variance += (v - stats.mean) * (v - stats.mean);
+        stats.stddev = sqrt(variance / double(count - 1));
+      }
+    }
+
+    ret.push_back(stats);
+  }
+
+  return ret;
+}
+
+void ReplayController::SetReplayProfiling(bool enabled)
+{
+  RenderDoc::Inst().GetReplayProfiler().SetEnabled(enabled);
+}
+
+ReplayProfile ReplayController::GetReplayProfile()
+{
+  const ReplayProfiler &profiler = RenderDoc::Inst().GetReplayProfiler();
+
+  ReplayProfile ret;
+
+  double secsPerTick = 1.0 / (Timing::GetTickFrequency() * 1000.0);
+
+  for(auto it = profiler.GetChunkTotals().begin(); it != profiler.GetChunkTotals().end(); ++it)
+  {
+    ReplayProfileEntry entry;
+    entry.name = profiler.GetChunkName(it->first);
+    entry.count = it->second.count;
+    entry.totalTime = double(it->second.ticks) * secsPerTick;
+    entry.maxTime = double(it->second.maxTicks) * secsPerTick;
+    ret.chunks.push_back(entry);
+
+    ret.totalTime += entry.totalTime;
+  }
+
+  std::sort(ret.chunks.begin(), ret.chunks.end(),
+            [](const ReplayProfileEntry &a, const ReplayProfileEntry &b) {
+              return a.totalTime > b.totalTime;
+            });
+
+  for(auto it = profiler.GetEventTotals().begin(); it != profiler.GetEventTotals().end(); ++it)
+  {
+    ReplayProfileEntry entry;
+    entry.eventId = it->first;
+    entry.count = it->second.count;
+    entry.totalTime = double(it->second.ticks) * secsPerTick;
+    entry.maxTime = double(it->second.maxTicks) * secsPerTick;
+    ret.events.push_back(entry);
+  }
+
+  return ret;
+}
+
+ReplayStatus ReplayController::ExportReplayProfile(const char *path)
+{
+  return exportChromeReplayProfile(path, RenderDoc::Inst().GetReplayProfiler());
+}
+
 rdcarray<GPUCounter> ReplayController::EnumerateCounters()
 {
   return m_pDevice->EnumerateCounters();
@@ -610,7 +1055,97 @@ bytebuf ReplayController::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint
   return ret;
 }
 
+struct ReplayController::SaveTextureData
+{
+  SaveTextureData() = default;
+  ~SaveTextureData()
+  {
+    for(byte *b : subdata)
+      delete[] b;
+  }
+
+  // no copying, we own the subresource data
+  SaveTextureData(const SaveTextureData &) = delete;
+  SaveTextureData &operator=(const SaveTextureData &) = delete;
+
+  TextureSave sd;
+  TextureDescription td;
+  std::vector<byte *> subdata;
+  uint32_t rowPitch = 0;
+  uint32_t numMips = 1;
+  uint32_t numSlices = 1;
+  bool singleSlice = false;
+};
+
 bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
+{
+  SaveTextureData data;
+
+  if(!FetchTextureForSave(saveData, data))
+    return false;
+
+  return EncodeTextureForSave(data, path);
+}
+
+bool ReplayController::SaveTextures(const rdcarray<TextureSave> &saveData,
+                                    const rdcarray<rdcstr> &paths)
+{
+  if(saveData.size() != paths.size())
+  {
+    RDCERR("Mismatched number of textures (%d) and paths (%d) to save", saveData.count(),
+           paths.count());
+    return false;
+  }
+
+  bool success = true;
+
+  // the readback has to happen here on the replay thread, but the conversion and encoding can
+  // happen on another thread, so we encode each texture while reading back the next. Only one
+  // texture is encoded at once to bound how much data we hold on to.
+  Threading::ThreadHandle encodeThread = 0;
+  bool encodeSuccess = true;
+
+  for(size_t i = 0; i < saveData.size(); i++)
+  {
+    SaveTextureData *data = new SaveTextureData;
+
+    bool fetched = FetchTextureForSave(saveData[i], *data);
+
+    if(encodeThread)
+    {
+      Threading::JoinThread(encodeThread);
+      Threading::CloseThread(encodeThread);
+      encodeThread = 0;
+      success &= encodeSuccess;
+    }
+
+    if(!fetched)
+    {
+      RDCERR("Couldn't fetch texture data to save to %s", paths[i].c_str());
+      success = false;
+      delete data;
+      continue;
+    }
+
+    const char *path = paths[i].c_str();
+
+    encodeThread = Threading::CreateThread([data, path, &encodeSuccess]() {
+      encodeSuccess = EncodeTextureForSave(*data, path);
+      delete data;
+    });
+  }
+
+  if(encodeThread)
+  {
+    Threading::JoinThread(encodeThread);
+    Threading::CloseThread(encodeThread);
+    success &= encodeSuccess;
+  }
+
+  return success;
+}
+
+bool ReplayController::FetchTextureForSave(const TextureSave &saveData, SaveTextureData &data)
 {
   TextureSave sd = saveData;    // mutable copy
   ResourceId liveid = m_pDevice->GetLiveID(sd.resourceId);
@@ -623,8 +1158,6 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
   TextureDescription td = m_pDevice->GetTexture(liveid);
 
-  bool success = false;
-
   // clamp sample/mip/slice indices
   if(td.msSamp == 1)
   {
@@ -771,7 +1304,7 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     // otherwise take all mips, as by default
   }
 
-  vector<byte *> subdata;
+  std::vector<byte *> &subdata = data.subdata;
 
   bool downcast = false;
 
@@ -879,10 +1412,6 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       if(data.empty())
       {
         RDCERR("Couldn't get bytes for mip %u, slice %u", mip, slice);
-
-        for(size_t i = 0; i < subdata.size(); i++)
-          delete[] subdata[i];
-
         return false;
       }
 
@@ -941,7 +1470,26 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     }
   }
 
-  // should have been handled above, but verify incoming data is RGBA8
+  data.sd = sd;
+  data.td = td;
+  data.rowPitch = rowPitch;
+  data.numMips = numMips;
+  data.numSlices = numSlices;
+  data.singleSlice = singleSlice;
+
+  return true;
+}
+
+bool ReplayController::EncodeTextureForSave(SaveTextureData &data, const char *path)
+{
+  const TextureSave &sd = data.sd;
+  TextureDescription &td = data.td;
+  std::vector<byte *> &subdata = data.subdata;
+  uint32_t &rowPitch = data.rowPitch;
+
+  bool success = false;
+
+  // should have been handled when fetching, but verify incoming data is RGBA8
   if(sd.slice.slicesAsGrid && td.format.compByteWidth == 1 && td.format.compCount == 4)
   {
     uint32_t sliceWidth = td.width;
@@ -958,34 +1506,25 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
     memset(combinedData, 0, td.width * td.height * td.format.compCount);
 
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
-      uint32_t gridx = (uint32_t)i % sd.slice.sliceGridWidth;
-      uint32_t gridy = (uint32_t)i / sd.slice.sliceGridWidth;
-
-      uint32_t yoffs = gridy * sliceHeight;
-      uint32_t xoffs = gridx * sliceWidth;
-
-      for(uint32_t y = 0; y < sliceHeight; y++)
+    Threading::ParallelForRange((uint32_t)subdata.size(), 1, [&](uint32_t begin, uint32_t end) {
+      for(uint32_t i = begin; i < end; i++)
       {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * 4 + 0];
-          uint32_t *dstpix = (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * 4 + 0];
+        uint32_t gridx = i % sd.slice.sliceGridWidth;
+        uint32_t gridy = i / sd.slice.sliceGridWidth;
 
-          *dstpix = *srcpix;
-        }
-      }
+        CopySliceRows(combinedData, td.width, subdata[i], sliceWidth, sliceHeight,
+                      gridx * sliceWidth, gridy * sliceHeight);
 
-      delete[] subdata[i];
-    }
+        delete[] subdata[i];
+      }
+    });
 
     subdata.resize(1);
     subdata[0] = combinedData;
     rowPitch = td.width * 4;
   }
 
-  // should have been handled above, but verify incoming data is RGBA8 and 6 slices
+  // should have been handled when fetching, but verify incoming data is RGBA8 and 6 slices
   if(sd.slice.cubeCruciform && td.format.compByteWidth == 1 && td.format.compCount == 4 &&
      subdata.size() == 6)
   {
@@ -1014,27 +1553,18 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
     */
 
-    uint32_t gridx[6] = {2, 0, 1, 1, 1, 3};
-    uint32_t gridy[6] = {1, 1, 0, 2, 1, 1};
-
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
-      uint32_t yoffs = gridy[i] * sliceHeight;
-      uint32_t xoffs = gridx[i] * sliceWidth;
+    const uint32_t gridx[6] = {2, 0, 1, 1, 1, 3};
+    const uint32_t gridy[6] = {1, 1, 0, 2, 1, 1};
 
-      for(uint32_t y = 0; y < sliceHeight; y++)
+    Threading::ParallelForRange((uint32_t)subdata.size(), 1, [&](uint32_t begin, uint32_t end) {
+      for(uint32_t i = begin; i < end; i++)
       {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * 4 + 0];
-          uint32_t *dstpix = (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * 4 + 0];
+        CopySliceRows(combinedData, td.width, subdata[i], sliceWidth, sliceHeight,
+                      gridx[i] * sliceWidth, gridy[i] * sliceHeight);
 
-          *dstpix = *srcpix;
-        }
+        delete[] subdata[i];
       }
-
-      delete[] subdata[i];
-    }
+    });
 
     subdata.resize(1);
     subdata[0] = combinedData;
@@ -1043,29 +1573,39 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
 
   int numComps = td.format.compCount;
 
+  const uint32_t width = td.width;
+  const uint32_t minRows = RDCMAX(1U, ParallelMinPixels / width);
+
   // if we want a grayscale image of one channel, splat it across all channels
   // and set alpha to full
   if(sd.channelExtract >= 0 && td.format.type == ResourceFormatType::Regular &&
      td.format.compByteWidth == 1 && (uint32_t)sd.channelExtract < td.format.compCount)
   {
-    uint32_t cc = td.format.compCount;
+    const uint32_t cc = td.format.compCount;
+    const uint32_t channel = (uint32_t)sd.channelExtract;
+    byte *pixels = subdata[0];
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
+    Threading::ParallelForRange(td.height, minRows, [=](uint32_t begin, uint32_t end) {
+      if(cc == 4)
+      {
+        // RGBA8 is by far the common case, write whole pixels at once
+        uint32_t *pix = (uint32_t *)(pixels + begin * width * 4);
+        for(uint32_t p = 0; p < (end - begin) * width; p++)
+        {
+          uint32_t c = (pix[p] >> (channel * 8)) & 0xff;
+          pix[p] = c | (c << 8) | (c << 16) | 0xff000000U;
+        }
+        return;
+      }
+
+      for(uint32_t p = begin * width; p < end * width; p++)
       {
-        subdata[0][(y * td.width + x) * cc + 0] =
-            subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 2)
-          subdata[0][(y * td.width + x) * cc + 1] =
-              subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 3)
-          subdata[0][(y * td.width + x) * cc + 2] =
-              subdata[0][(y * td.width + x) * cc + sd.channelExtract];
-        if(cc >= 4)
-          subdata[0][(y * td.width + x) * cc + 3] = 255;
+        byte *pix = pixels + p * cc;
+        byte c = pix[channel];
+        for(uint32_t i = 0; i < cc; i++)
+          pix[i] = c;
       }
-    }
+    });
   }
 
   // handle formats that don't support alpha
@@ -1073,46 +1613,64 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     byte *nonalpha = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
+    // the background colours are constant, so gamma correct them once up front rather than per
+    // pixel, and look up the normalised value of each byte from a table.
+    float unorm[256];
+    for(int i = 0; i < 256; i++)
+      unorm[i] = float(i) / 255.0f;
+
+    Vec4f background[2] = {
+        Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z), Vec4f(),
+    };
+    if(sd.alpha == AlphaMapping::BlendToCheckerboard)
     {
-      for(uint32_t x = 0; x < td.width; x++)
+      background[0] = RenderDoc::Inst().DarkCheckerboardColor();
+      background[1] = RenderDoc::Inst().LightCheckerboardColor();
+    }
+    else
+    {
+      background[1] = background[0];
+    }
+
+    for(Vec4f &col : background)
+    {
+      col.x = powf(col.x, 1.0f / 2.2f);
+      col.y = powf(col.y, 1.0f / 2.2f);
+      col.z = powf(col.z, 1.0f / 2.2f);
+    }
+
+    const byte *src = subdata[0];
+    const bool blend = (sd.alpha != AlphaMapping::Discard);
+
+    Threading::ParallelForRange(td.height, minRows, [&](uint32_t begin, uint32_t end) {
+      for(uint32_t y = begin; y < end; y++)
       {
-        byte r = subdata[0][(y * td.width + x) * 4 + 0];
-        byte g = subdata[0][(y * td.width + x) * 4 + 1];
-        byte b = subdata[0][(y * td.width + x) * 4 + 2];
-        byte a = subdata[0][(y * td.width + x) * 4 + 3];
+        const byte *srcRow = src + y * width * 4;
+        byte *dstRow = nonalpha + y * width * 3;
 
-        if(sd.alpha != AlphaMapping::Discard)
+        if(!blend)
         {
-          Vec4f col = Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z);
-          if(sd.alpha == AlphaMapping::BlendToCheckerboard)
+          for(uint32_t x = 0; x < width; x++)
           {
-            bool lightSquare = ((x / 64) % 2) == ((y / 64) % 2);
-            col = lightSquare ? RenderDoc::Inst().LightCheckerboardColor()
-                              : RenderDoc::Inst().DarkCheckerboardColor();
+            dstRow[x * 3 + 0] = srcRow[x * 4 + 0];
+            dstRow[x * 3 + 1] = srcRow[x * 4 + 1];
+            dstRow[x * 3 + 2] = srcRow[x * 4 + 2];
           }
+          continue;
+        }
 
-          col.x = powf(col.x, 1.0f / 2.2f);
-          col.y = powf(col.y, 1.0f / 2.2f);
-          col.z = powf(col.z, 1.0f / 2.2f);
-
-          FloatVector pixel = FloatVector(float(r) / 255.0f, float(g) / 255.0f, float(b) / 255.0f,
-                                          float(a) / 255.0f);
+        for(uint32_t x = 0; x < width; x++)
+        {
+          const Vec4f &col = background[((x / 64) % 2) == ((y / 64) % 2) ? 1 : 0];
 
-          pixel.x = pixel.x * pixel.w + col.x * (1.0f - pixel.w);
-          pixel.y = pixel.y * pixel.w + col.y * (1.0f - pixel.w);
-          pixel.z = pixel.z * pixel.w + col.z * (1.0f - pixel.w);
+          float a = unorm[srcRow[x * 4 + 3]];
 
-          r = byte(pixel.x * 255.0f);
-          g = byte(pixel.y * 255.0f);
-          b = byte(pixel.z * 255.0f);
+          dstRow[x * 3 + 0] = byte((unorm[srcRow[x * 4 + 0]] * a + col.x * (1.0f - a)) * 255.0f);
+          dstRow[x * 3 + 1] = byte((unorm[srcRow[x * 4 + 1]] * a + col.y * (1.0f - a)) * 255.0f);
+          dstRow[x * 3 + 2] = byte((unorm[srcRow[x * 4 + 2]] * a + col.z * (1.0f - a)) * 255.0f);
         }
-
-        nonalpha[(y * td.width + x) * 3 + 0] = r;
-        nonalpha[(y * td.width + x) * 3 + 1] = g;
-        nonalpha[(y * td.width + x) * 3 + 2] = b;
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1128,22 +1686,22 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
   {
     byte *rg0 = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
-      {
-        byte r = subdata[0][(y * td.width + x) * 2 + 0];
-        byte g = subdata[0][(y * td.width + x) * 2 + 1];
+    const byte *src = subdata[0];
 
-        rg0[(y * td.width + x) * 3 + 0] = r;
-        rg0[(y * td.width + x) * 3 + 1] = g;
-        rg0[(y * td.width + x) * 3 + 2] = 0;
+    // if we're greyscaling the image, then keep the greyscale here.
+    const bool grey = (sd.channelExtract >= 0);
 
-        // if we're greyscaling the image, then keep the greyscale here.
-        if(sd.channelExtract >= 0)
-          rg0[(y * td.width + x) * 3 + 2] = r;
+    Threading::ParallelForRange(td.height, minRows, [=](uint32_t begin, uint32_t end) {
+      for(uint32_t p = begin * width; p < end * width; p++)
+      {
+        byte r = src[p * 2 + 0];
+        byte g = src[p * 2 + 1];
+
+        rg0[p * 3 + 0] = r;
+        rg0[p * 3 + 1] = g;
+        rg0[p * 3 + 2] = grey ? r : 0;
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1170,12 +1728,12 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       ddsData.height = td.height;
       ddsData.depth = td.depth;
       ddsData.format = td.format;
-      ddsData.mips = numMips;
-      ddsData.slices = numSlices / td.depth;
+      ddsData.mips = data.numMips;
+      ddsData.slices = data.numSlices / td.depth;
       ddsData.subdata = &subdata[0];
-      ddsData.cubemap = td.cubemap && numSlices == 6;
+      ddsData.cubemap = td.cubemap && data.numSlices == 6;
 
-      if(singleSlice)
+      if(data.singleSlice)
         ddsData.depth = ddsData.slices = 1;
 
       success = write_dds_to_file(f, ddsData);
@@ -1192,8 +1750,8 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     else if(sd.destType == FileType::PNG)
     {
       // discard alpha if requested
-      for(uint32_t p = 0; sd.alpha == AlphaMapping::Discard && p < td.width * td.height; p++)
-        subdata[0][p * 4 + 3] = 255;
+      if(sd.alpha == AlphaMapping::Discard && numComps == 4)
+        DiscardAlpha(subdata[0], td.width * td.height);
 
       int ret = stbi_write_png_to_func(fileWriteFunc, (void *)f, td.width, td.height, numComps,
                                        subdata[0], rowPitch);
@@ -1205,8 +1763,8 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     else if(sd.destType == FileType::TGA)
     {
       // discard alpha if requested
-      for(uint32_t p = 0; sd.alpha == AlphaMapping::Discard && p < td.width * td.height; p++)
-        subdata[0][p * 4 + 3] = 255;
+      if(sd.alpha == AlphaMapping::Discard && numComps == 4)
+        DiscardAlpha(subdata[0], td.width * td.height);
 
       int ret = stbi_write_tga_to_func(fileWriteFunc, (void *)f, td.width, td.height, numComps,
                                        subdata[0]);
@@ -1269,104 +1827,73 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
       if(saveFmt.compType == CompType::Depth && pixStride == 3)
         pixStride = 4;
 
-      for(uint32_t y = 0; y < td.height; y++)
-      {
-        for(uint32_t x = 0; x < td.width; x++)
-        {
-          float r = 0.0f;
-          float g = 0.0f;
-          float b = 0.0f;
-          float a = 1.0f;
-
-          if(saveFmt.type == ResourceFormatType::R10G10B10A2)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec4f vec = ConvertFromR10G10B10A2(*u32);
-
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = vec.w;
-
-            srcData += 4;
-          }
-          else if(saveFmt.type == ResourceFormatType::R11G11B10)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec3f vec = ConvertFromR11G11B10(*u32);
-
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = 1.0f;
-
-            srcData += 4;
-          }
-          else
-          {
-            if(saveFmt.compCount >= 1)
-              r = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 0);
-            if(saveFmt.compCount >= 2)
-              g = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 1);
-            if(saveFmt.compCount >= 3)
-              b = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 2);
-            if(saveFmt.compCount >= 4)
-              a = ConvertComponent(saveFmt, srcData + saveFmt.compByteWidth * 3);
-
-            srcData += pixStride;
-          }
+      // packed formats are always 4 bytes per pixel
+      if(saveFmt.type == ResourceFormatType::R10G10B10A2 ||
+         saveFmt.type == ResourceFormatType::R11G11B10)
+        pixStride = 4;
 
-          if(saveFmt.bgraOrder)
-            std::swap(r, b);
+      Threading::ParallelForRange(td.height, minRows, [&](uint32_t begin, uint32_t end) {
+        std::vector<Vec4f> row(width);
 
-          // HDR can't represent negative values
-          if(sd.destType == FileType::HDR)
-          {
-            r = RDCMAX(r, 0.0f);
-            g = RDCMAX(g, 0.0f);
-            b = RDCMAX(b, 0.0f);
-            a = RDCMAX(a, 0.0f);
-          }
-
-          if(sd.channelExtract == 0)
-          {
-            g = b = r;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 1)
-          {
-            r = b = g;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 2)
-          {
-            r = g = b;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 3)
-          {
-            r = g = b = a;
-            a = 1.0f;
-          }
+        for(uint32_t y = begin; y < end; y++)
+        {
+          ConvertPixelsToFloat4(saveFmt, srcData + y * width * pixStride, width, pixStride,
+                                row.data());
 
-          if(fldata)
+          for(uint32_t x = 0; x < width; x++)
           {
-            fldata[(y * td.width + x) * 4 + 0] = r;
-            fldata[(y * td.width + x) * 4 + 1] = g;
-            fldata[(y * td.width + x) * 4 + 2] = b;
-            fldata[(y * td.width + x) * 4 + 3] = a;
-          }
-          else
-          {
-            abgr[0][(y * td.width + x)] = a;
-            abgr[1][(y * td.width + x)] = b;
-            abgr[2][(y * td.width + x)] = g;
-            abgr[3][(y * td.width + x)] = r;
+            float r = row[x].x;
+            float g = row[x].y;
+            float b = row[x].z;
+            float a = row[x].w;
+
+            // HDR can't represent negative values
+            if(sd.destType == FileType::HDR)
+            {
+              r = RDCMAX(r, 0.0f);
+              g = RDCMAX(g, 0.0f);
+              b = RDCMAX(b, 0.0f);
+              a = RDCMAX(a, 0.0f);
+            }
+
+            if(sd.channelExtract == 0)
+            {
+              g = b = r;
+              a = 1.0f;
+            }
+            if(sd.channelExtract == 1)
+            {
+              r = b = g;
+              a = 1.0f;
+            }
+            if(sd.channelExtract == 2)
+            {
+              r = g = b;
+              a = 1.0f;
+            }
+            if(sd.channelExtract == 3)
+            {
+              r = g = b = a;
+              a = 1.0f;
+            }
+
+            if(fldata)
+            {
+              fldata[(y * width + x) * 4 + 0] = r;
+              fldata[(y * width + x) * 4 + 1] = g;
+              fldata[(y * width + x) * 4 + 2] = b;
+              fldata[(y * width + x) * 4 + 3] = a;
+            }
+            else
+            {
+              abgr[0][(y * width + x)] = a;
+              abgr[1][(y * width + x)] = b;
+              abgr[2][(y * width + x)] = g;
+              abgr[3][(y * width + x)] = r;
+            }
           }
         }
-      }
+      });
 
       if(sd.destType == FileType::HDR)
       {
@@ -1434,9 +1961,6 @@ bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path
     FileIO::fclose(f);
   }
 
-  for(size_t i = 0; i < subdata.size(); i++)
-    delete[] subdata[i];
-
   return success;
 }
 
@@ -1952,3 +2476,259 @@ void ReplayController::FetchPipelineState()
   m_PipeState.SetStates(m_APIProps, m_D3D11PipelineState, m_D3D12PipelineState, m_GLPipelineState,
                         m_VulkanPipelineState);
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+#include "3rdparty/catch/catch.hpp"
+
+static bool BitIdentical(float a, float b)
+{
+  return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static void CheckBatchMatchesScalar(const ResourceFormat &fmt, const std::vector<byte> &data,
+                                    size_t count)
+{
+  const size_t stride = fmt.compCount * fmt.compByteWidth;
+
+  std::vector<Vec4f> batch(count);
+  ConvertPixelsToFloat4(fmt, data.data(), count, stride, batch.data());
+
+  for(size_t i = 0; i < count; i++)
+  {
+    const byte *src = data.data() + i * stride;
+
+    float expected[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    for(uint32_t c = 0; c < fmt.compCount; c++)
+      expected[c] = ConvertComponent(fmt, src + c * fmt.compByteWidth);
+
+    if(fmt.bgraOrder)
+      std::swap(expected[0], expected[2]);
+
+    CHECK(BitIdentical(batch[i].x, expected[0]));
+    CHECK(BitIdentical(batch[i].y, expected[1]));
+    CHECK(BitIdentical(batch[i].z, expected[2]));
+    CHECK(BitIdentical(batch[i].w, expected[3]));
+  }
+}
+
+TEST_CASE("Batch pixel conversion matches per-component conversion", "[formatpacking]")
+{
+  // enough pixels to exercise both the vectorised body and the scalar tail
+  const size_t count = 37;
+
+  std::vector<byte> data(count * 4 * 8);
+  for(size_t i = 0; i < data.size(); i++)
+    data[i] = byte((i * 97 + 13) & 0xff);
+
+  ResourceFormat fmt;
+  fmt.type = ResourceFormatType::Regular;
+
+  SECTION("8-bit formats")
+  {
+    fmt.compByteWidth = 1;
+
+    for(uint8_t comps = 1; comps <= 4; comps++)
+    {
+      fmt.compCount = comps;
+
+      for(CompType t : {CompType::UNorm, CompType::SNorm, CompType::UInt, CompType::SInt})
+      {
+        fmt.compType = t;
+        CheckBatchMatchesScalar(fmt, data, count);
+      }
+
+      fmt.compType = CompType::UNorm;
+      fmt.srgbCorrected = true;
+      CheckBatchMatchesScalar(fmt, data, count);
+      fmt.srgbCorrected = false;
+    }
+
+    fmt.compCount = 4;
+    fmt.bgraOrder = true;
+    CheckBatchMatchesScalar(fmt, data, count);
+  };
+
+  SECTION("16-bit formats")
+  {
+    fmt.compByteWidth = 2;
+
+    for(uint8_t comps = 1; comps <= 4; comps++)
+    {
+      fmt.compCount = comps;
+
+      for(CompType t : {CompType::UNorm, CompType::SNorm, CompType::UInt, CompType::SInt,
+                        CompType::Float, CompType::Depth})
+      {
+        fmt.compType = t;
+        CheckBatchMatchesScalar(fmt, data, count);
+      }
+    }
+  };
+
+  SECTION("32-bit and 64-bit formats")
+  {
+    // avoid NaN patterns, which won't compare meaningfully
+    std::vector<byte> floatData(count * 4 * 8);
+    for(size_t i = 0; i < floatData.size() / sizeof(float); i++)
+      ((float *)floatData.data())[i] = float(i) * 0.37f - 10.0f;
+
+    fmt.compCount = 4;
+    fmt.compByteWidth = 4;
+
+    for(CompType t : {CompType::UInt, CompType::SInt})
+    {
+      fmt.compType = t;
+      CheckBatchMatchesScalar(fmt, data, count);
+    }
+
+    fmt.compType = CompType::Float;
+    CheckBatchMatchesScalar(fmt, floatData, count);
+
+    fmt.compByteWidth = 8;
+    fmt.compCount = 2;
+
+    for(CompType t : {CompType::UInt, CompType::SInt})
+    {
+      fmt.compType = t;
+      CheckBatchMatchesScalar(fmt, data, count);
+    }
+  };
+
+  SECTION("Packed formats")
+  {
+    std::vector<Vec4f> batch(count);
+
+    fmt.type = ResourceFormatType::R10G10B10A2;
+    ConvertPixelsToFloat4(fmt, data.data(), count, 4, batch.data());
+
+    for(size_t i = 0; i < count; i++)
+    {
+      Vec4f expected = ConvertFromR10G10B10A2(((const uint32_t *)data.data())[i]);
+      CHECK(BitIdentical(batch[i].x, expected.x));
+      CHECK(BitIdentical(batch[i].y, expected.y));
+      CHECK(BitIdentical(batch[i].z, expected.z));
+      CHECK(BitIdentical(batch[i].w, expected.w));
+    }
+
+    fmt.type = ResourceFormatType::R11G11B10;
+    ConvertPixelsToFloat4(fmt, data.data(), count, 4, batch.data());
+
+    for(size_t i = 0; i < count; i++)
+    {
+      Vec3f expected = ConvertFromR11G11B10(((const uint32_t *)data.data())[i]);
+      CHECK(BitIdentical(batch[i].x, expected.x));
+      CHECK(BitIdentical(batch[i].y, expected.y));
+      CHECK(BitIdentical(batch[i].z, expected.z));
+      CHECK(batch[i].w == 1.0f);
+    }
+  };
+};
+
+TEST_CASE("Shader debug traces reconstruct states from keyframes", "[shaderdebug]")
+{
+  // simulate a simple register file being written each step, recording both the full states and
+  // a keyframed trace with the changes in between.
+  std::vector<ShaderDebugState> full;
+
+  ShaderDebugState cur;
+  cur.registers.resize(4);
+  cur.outputs.resize(2);
+  cur.indexableTemps.resize(1);
+  cur.indexableTemps[0].members.resize(8);
+  cur.nextInstruction = 0;
+  cur.flags = ShaderEvents::NoEvent;
+
+  ShaderDebugTrace trace;
+  trace.keyframeInterval = 5;
+
+  for(uint32_t step = 0; step < 23; step++)
+  {
+    if(step > 0)
+    {
+      cur.changes.clear();
+      cur.nextInstruction = step;
+
+      ShaderVariableChange change;
+      change.type = RegisterType::Temporary;
+      change.index = step % 4;
+      change.value = ShaderVariable("r", float(step), 1.0f, 2.0f, 3.0f);
+      cur.registers[change.index] = change.value;
+      cur.changes.push_back(change);
+
+      if(step % 3 == 0)
+      {
+        change.type = RegisterType::IndexedTemporary;
+        change.index = 0;
+        change.element = step % 8;
+        change.value = ShaderVariable("x", 0U, step, 0U, 0U);
+        cur.indexableTemps[0].members[change.element] = change.value;
+        cur.changes.push_back(change);
+      }
+
+      if(step % 7 == 0)
+      {
+        change.type = RegisterType::Output;
+        change.index = 1;
+        change.element = 0;
+        change.value = ShaderVariable("o", -float(step), 0.0f, 0.0f, 0.0f);
+        cur.outputs[change.index] = change.value;
+        cur.changes.push_back(change);
+      }
+    }
+
+    full.push_back(cur);
+
+    if(step % trace.keyframeInterval == 0)
+    {
+      // keyframes don't list their changes, since they have the full contents
+      full.back().changes.clear();
+      trace.states.push_back(full.back());
+    }
+    else
+    {
+      ShaderDebugState delta;
+      delta.changes = cur.changes;
+      delta.nextInstruction = cur.nextInstruction;
+      delta.flags = cur.flags;
+      trace.states.push_back(delta);
+    }
+  }
+
+  // access in a scattered order, each state should be independent of the last one fetched
+  for(int32_t i = 0; i < (int32_t)full.size(); i++)
+  {
+    int32_t step = (i * 7) % (int32_t)full.size();
+    ShaderDebugState state = trace.GetState(step);
+
+    bool identical = (state == full[step]);
+    CHECK(identical);
+  }
+
+  CHECK(trace.GetState(-1).registers.empty());
+  CHECK(trace.GetState((int32_t)full.size()).registers.empty());
+
+  // stepping forward only needs each step's changes applied to the previous state
+  ShaderDebugState walk;
+  for(int32_t step = 0; step < trace.states.count(); step++)
+  {
+    const ShaderDebugState &s = trace.states[step];
+
+    if(step % trace.keyframeInterval == 0)
+    {
+      walk.registers = s.registers;
+      walk.outputs = s.outputs;
+      walk.indexableTemps = s.indexableTemps;
+    }
+    else
+    {
+      walk.ApplyChanges(s.changes);
+    }
+
+    bool identical = (walk.registers == full[step].registers &&
+                      walk.outputs == full[step].outputs &&
+                      walk.indexableTemps == full[step].indexableTemps);
+    CHECK(identical);
+  }
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
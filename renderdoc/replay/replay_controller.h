@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <deque>
 #include <set>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
@@ -141,6 +142,7 @@ public:
   const GLPipe::State *GetGLPipelineState();
   const VKPipe::State *GetVulkanPipelineState();
   const PipeState &GetPipelineState();
+  rdcarray<PipelineStateSnapshot> GetPipelineStateSnapshots(const rdcarray<uint32_t> &eventIds);
 
   rdcarray<rdcstr> GetDisassemblyTargets();
   rdcstr DisassembleShader(ResourceId pipeline, const ShaderReflection *refl, const char *target);
@@ -162,6 +164,11 @@ public:
   const rdcarray<DrawcallDescription> &GetDrawcalls();
   void AddFakeMarkers();
   rdcarray<CounterResult> FetchCounters(const rdcarray<GPUCounter> &counters);
+  void SetReplayProfiling(bool enabled);
+  ReplayProfile GetReplayProfile();
+  ReplayStatus ExportReplayProfile(const char *path);
+  rdcarray<CounterStatistics> FetchCounterStatistics(const rdcarray<GPUCounter> &counters,
+                                                     uint32_t warmupRuns, uint32_t measuredRuns);
   rdcarray<GPUCounter> EnumerateCounters();
   CounterDescription DescribeCounter(GPUCounter counterID);
   const rdcarray<TextureDescription> &GetTextures();
@@ -188,6 +195,7 @@ public:
   bytebuf GetTextureData(ResourceId buff, uint32_t arrayIdx, uint32_t mip);
 
   bool SaveTexture(const TextureSave &saveData, const char *path);
+  bool SaveTextures(const rdcarray<TextureSave> &saveData, const rdcarray<rdcstr> &paths);
 
   rdcarray<ShaderVariable> GetCBufferVariableContents(ResourceId shader, const char *entryPoint,
                                                       uint32_t cbufslot, ResourceId buffer,
@@ -212,6 +220,12 @@ private:
   bool ContainsMarker(const rdcarray<DrawcallDescription> &draws);
   bool PassEquivalent(const DrawcallDescription &a, const DrawcallDescription &b);
 
+  // texture saving is split into the readback, which must happen on the replay thread, and the
+  // CPU-side conversion and encoding, which can run on any thread.
+  struct SaveTextureData;
+  bool FetchTextureForSave(const TextureSave &saveData, SaveTextureData &data);
+  static bool EncodeTextureForSave(SaveTextureData &data, const char *path);
+
   IReplayDriver *GetDevice() { return m_pDevice; }
   FrameRecord m_FrameRecord;
   vector<DrawcallDescription *> m_Drawcalls;
@@ -230,6 +244,13 @@ private:
   const VKPipe::State *m_VulkanPipelineState;
   PipeState m_PipeState;
 
+  // copies of the states handed out by GetPipelineStateSnapshots. deques so that pointers to them
+  // stay valid as more are added.
+  std::deque<D3D11Pipe::State> m_SnapshotD3D11;
+  std::deque<D3D12Pipe::State> m_SnapshotD3D12;
+  std::deque<GLPipe::State> m_SnapshotGL;
+  std::deque<VKPipe::State> m_SnapshotVulkan;
+
   std::vector<ReplayOutput *> m_Outputs;
 
   rdcarray<ResourceDescription> m_Resources;
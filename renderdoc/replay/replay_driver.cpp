@@ -23,6 +23,10 @@
  ******************************************************************************/
 
 #include "replay_driver.h"
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+#include "maths/camera.h"
 #include "maths/formatpacking.h"
 #include "serialise/serialiser.h"
 
@@ -231,71 +235,43 @@ FloatVector HighlightCache::InterpretVertex(const byte *data, uint32_t vert,
                                             uint32_t vertexByteStride, const ResourceFormat &fmt,
                                             const byte *end, bool &valid)
 {
-  FloatVector ret(0.0f, 0.0f, 0.0f, 1.0f);
+  FloatVector ret;
+  InterpretVertices(data, vert, 1, vertexByteStride, fmt, end, &ret, valid);
+  return ret;
+}
 
-  data += vert * vertexByteStride;
+void HighlightCache::InterpretVertices(const byte *data, uint32_t first, uint32_t count,
+                                       uint32_t vertexByteStride, const ResourceFormat &fmt,
+                                       const byte *end, FloatVector *out, bool &valid)
+{
+  RDCCOMPILE_ASSERT(sizeof(FloatVector) == sizeof(Vec4f), "FloatVector must alias Vec4f");
 
-  float *out = &ret.x;
+  uint64_t vertSize = uint64_t(fmt.compCount) * fmt.compByteWidth;
+  if(fmt.type == ResourceFormatType::R10G10B10A2 || fmt.type == ResourceFormatType::R11G11B10)
+    vertSize = 4;
 
-  if(fmt.type == ResourceFormatType::R10G10B10A2)
-  {
-    if(data + 4 >= end)
-    {
-      valid = false;
-      return ret;
-    }
+  const uint64_t available = end > data ? uint64_t(end - data) : 0;
+  const uint64_t offset = uint64_t(first) * vertexByteStride;
 
-    Vec4f v;
-    if(fmt.compType == CompType::SNorm)
-      v = ConvertFromR10G10B10A2SNorm(*(const uint32_t *)data);
+  // work out how many of the vertices lie entirely within the data, the rest are invalid
+  uint32_t inRange = 0;
+  if(offset + vertSize <= available)
+  {
+    if(vertexByteStride == 0)
+      inRange = count;
     else
-      v = ConvertFromR10G10B10A2(*(const uint32_t *)data);
-    ret.x = v.x;
-    ret.y = v.y;
-    ret.z = v.z;
-    ret.w = v.w;
-    return ret;
+      inRange = (uint32_t)RDCMIN(uint64_t(count),
+                                 (available - offset - vertSize) / vertexByteStride + 1);
   }
-  else if(fmt.type == ResourceFormatType::R11G11B10)
-  {
-    if(data + 4 >= end)
-    {
-      valid = false;
-      return ret;
-    }
 
-    Vec3f v = ConvertFromR11G11B10(*(const uint32_t *)data);
-    ret.x = v.x;
-    ret.y = v.y;
-    ret.z = v.z;
-    return ret;
-  }
+  if(inRange > 0)
+    ConvertPixelsToFloat4(fmt, data + offset, inRange, vertexByteStride, (Vec4f *)out);
 
-  if(data + fmt.compCount * fmt.compByteWidth > end)
+  for(uint32_t i = inRange; i < count; i++)
   {
+    out[i] = FloatVector(0.0f, 0.0f, 0.0f, 1.0f);
     valid = false;
-    return ret;
-  }
-
-  for(uint32_t i = 0; i < fmt.compCount; i++)
-  {
-    *out = ConvertComponent(fmt, data);
-
-    data += fmt.compByteWidth;
-    out++;
-  }
-
-  if(fmt.bgraOrder)
-  {
-    FloatVector reversed;
-    reversed.x = ret.z;
-    reversed.y = ret.y;
-    reversed.z = ret.x;
-    reversed.w = ret.w;
-    return reversed;
   }
-
-  return ret;
 }
 
 uint64_t inthash(uint64_t val, uint64_t seed)
@@ -748,3 +724,832 @@ bool HighlightCache::FetchHighlightPositions(const MeshDisplay &cfg, FloatVector
 
   return valid;
 }
+
+// matches the maximum screen-space distance from the mouse that a point can be picked at
+static const float MeshPickPointRadius = 35.0f;
+
+// maximum number of primitives stored in a BVH leaf
+static const uint32_t MeshPickLeafSize = 4;
+
+static FloatVector MulVec4(const Matrix4f &m, const FloatVector &v)
+{
+  return FloatVector(m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+                     m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+                     m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+                     m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+}
+
+static bool IsFinite(const FloatVector &v)
+{
+  return isfinite(v.x) && isfinite(v.y) && isfinite(v.z) && isfinite(v.w);
+}
+
+// Moller-Trumbore ray/triangle test. Backfacing triangles are still picked, but only hits in front
+// of the ray origin count.
+static bool TriangleRayIntersect(const Vec3f &A, const Vec3f &B, const Vec3f &C,
+                                 const Vec3f &rayPos, const Vec3f &rayDir, float &t)
+{
+  Vec3f v0v1 = B - A;
+  Vec3f v0v2 = C - A;
+  Vec3f pvec = rayDir.Cross(v0v2);
+  float det = v0v1.Dot(pvec);
+
+  if(det == 0.0f)
+    return false;
+
+  float invDet = 1.0f / det;
+
+  Vec3f tvec = rayPos - A;
+  Vec3f qvec = tvec.Cross(v0v1);
+  float u = tvec.Dot(pvec) * invDet;
+  float v = rayDir.Dot(qvec) * invDet;
+
+  if(u < 0.0f || u > 1.0f || v < 0.0f || u + v > 1.0f)
+    return false;
+
+  t = v0v2.Dot(qvec) * invDet;
+
+  return t > 0.0f;
+}
+
+void MeshPickCache::Build(Topology topo, bool unproject, uint32_t numIndices,
+                          const std::vector<uint32_t> &indices, uint32_t firstVert,
+                          const std::vector<FloatVector> &verts)
+{
+  nodes.clear();
+  prims.clear();
+
+  // fetch the position for a given index in the mesh, returns false if it's invalid or a restart
+  auto fetch = [&](uint32_t i, FloatVector &pos) {
+    if(i >= numIndices)
+      return false;
+
+    uint32_t idx = i;
+    if(!indices.empty())
+      idx = i < indices.size() ? indices[i] : ~0U;
+
+    if(idx < firstVert || idx - firstVert >= verts.size())
+      return false;
+
+    pos = verts[idx - firstVert];
+
+    if(unproject && flipUnprojectedY)
+      pos.y = -pos.y;
+
+    return IsFinite(pos);
+  };
+
+  // triangles are enumerated as first + stride * i for each corner, except for fans which always
+  // start at the first vertex.
+  uint32_t numTris = 0, stride = 1;
+  uint32_t corners[3] = {0, 1, 2};
+
+  triangles = true;
+
+  switch(topo)
+  {
+    case Topology::TriangleList:
+      numTris = numIndices / 3;
+      stride = 3;
+      break;
+    case Topology::TriangleStrip:
+    case Topology::TriangleFan: numTris = numIndices >= 3 ? numIndices - 2 : 0; break;
+    case Topology::TriangleList_Adj:
+      numTris = numIndices / 6;
+      stride = 6;
+      corners[1] = 2;
+      corners[2] = 4;
+      break;
+    case Topology::TriangleStrip_Adj:
+      numTris = numIndices >= 6 ? (numIndices - 4) / 2 : 0;
+      stride = 2;
+      corners[1] = 2;
+      corners[2] = 4;
+      break;
+    default:    // points, lines, patchlists, unknown
+      triangles = false;
+      break;
+  }
+
+  if(triangles)
+  {
+    prims.reserve(numTris);
+
+    for(uint32_t t = 0; t < numTris; t++)
+    {
+      Prim p;
+      bool valid = true;
+
+      for(int c = 0; c < 3 && valid; c++)
+      {
+        p.vertid[c] = corners[c] + stride * t;
+        if(topo == Topology::TriangleFan && c == 0)
+          p.vertid[c] = 0;
+
+        valid = fetch(p.vertid[c], p.pos[c]);
+
+        // unprojected positions are picked in the space after the perspective divide
+        if(unproject)
+        {
+          float invw = 1.0f / p.pos[c].w;
+          p.pos[c] = FloatVector(p.pos[c].x * invw, p.pos[c].y * invw, p.pos[c].z * invw, 1.0f);
+          valid = valid && IsFinite(p.pos[c]);
+        }
+        else
+        {
+          p.pos[c].w = 1.0f;
+        }
+      }
+
+      if(valid)
+        prims.push_back(p);
+    }
+  }
+  else
+  {
+    prims.reserve(numIndices);
+
+    // points, lines and patches are all picked by their vertices. The full xyzw is kept since the
+    // projection happens at pick time.
+    for(uint32_t i = 0; i < numIndices; i++)
+    {
+      Prim p;
+      p.vertid[0] = p.vertid[1] = p.vertid[2] = i;
+
+      if(fetch(i, p.pos[0]))
+      {
+        p.pos[1] = p.pos[2] = p.pos[0];
+        prims.push_back(p);
+      }
+    }
+  }
+
+  if(prims.empty())
+    return;
+
+  // a median split tree has around 2N/leafsize nodes
+  nodes.reserve(prims.size() * 2 / MeshPickLeafSize + 1);
+  BuildNode(0, (uint32_t)prims.size());
+}
+
+uint32_t MeshPickCache::BuildNode(uint32_t first, uint32_t count)
+{
+  uint32_t nodeIdx = (uint32_t)nodes.size();
+  nodes.push_back(Node());
+
+  FloatVector bmin(FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX);
+  FloatVector bmax(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+  FloatVector cmin = bmin, cmax = bmax;
+
+  for(uint32_t i = first; i < first + count; i++)
+  {
+    const Prim &p = prims[i];
+
+    for(int c = 0; c < 3; c++)
+    {
+      bmin = FloatVector(RDCMIN(bmin.x, p.pos[c].x), RDCMIN(bmin.y, p.pos[c].y),
+                         RDCMIN(bmin.z, p.pos[c].z), RDCMIN(bmin.w, p.pos[c].w));
+      bmax = FloatVector(RDCMAX(bmax.x, p.pos[c].x), RDCMAX(bmax.y, p.pos[c].y),
+                         RDCMAX(bmax.z, p.pos[c].z), RDCMAX(bmax.w, p.pos[c].w));
+    }
+
+    Vec3f centroid = (Vec3f(p.pos[0].x, p.pos[0].y, p.pos[0].z) +
+                      Vec3f(p.pos[1].x, p.pos[1].y, p.pos[1].z) +
+                      Vec3f(p.pos[2].x, p.pos[2].y, p.pos[2].z)) *
+                     (1.0f / 3.0f);
+
+    cmin = FloatVector(RDCMIN(cmin.x, centroid.x), RDCMIN(cmin.y, centroid.y),
+                       RDCMIN(cmin.z, centroid.z), 0.0f);
+    cmax = FloatVector(RDCMAX(cmax.x, centroid.x), RDCMAX(cmax.y, centroid.y),
+                       RDCMAX(cmax.z, centroid.z), 0.0f);
+  }
+
+  nodes[nodeIdx].bmin = bmin;
+  nodes[nodeIdx].bmax = bmax;
+
+  if(count <= MeshPickLeafSize)
+  {
+    nodes[nodeIdx].first = first;
+    nodes[nodeIdx].count = count;
+    nodes[nodeIdx].rightChild = 0;
+    return nodeIdx;
+  }
+
+  // split at the median of the primitive centroids along the longest axis
+  int axis = 0;
+  float extentX = cmax.x - cmin.x, extentY = cmax.y - cmin.y, extentZ = cmax.z - cmin.z;
+  if(extentY > extentX && extentY >= extentZ)
+    axis = 1;
+  else if(extentZ > extentX && extentZ > extentY)
+    axis = 2;
+
+  uint32_t half = count / 2;
+
+  std::nth_element(prims.begin() + first, prims.begin() + first + half,
+                   prims.begin() + first + count, [axis](const Prim &a, const Prim &b) {
+                     const float *pa[3] = {&a.pos[0].x, &a.pos[1].x, &a.pos[2].x};
+                     const float *pb[3] = {&b.pos[0].x, &b.pos[1].x, &b.pos[2].x};
+                     return pa[0][axis] + pa[1][axis] + pa[2][axis] <
+                            pb[0][axis] + pb[1][axis] + pb[2][axis];
+                   });
+
+  BuildNode(first, half);
+  uint32_t right = BuildNode(first + half, count - half);
+
+  nodes[nodeIdx].first = 0;
+  nodes[nodeIdx].count = 0;
+  nodes[nodeIdx].rightChild = right;
+
+  return nodeIdx;
+}
+
+uint32_t MeshPickCache::PickTriangle(const Vec3f &rayPos, const Vec3f &rayDir) const
+{
+  if(!triangles || nodes.empty())
+    return ~0U;
+
+  Vec3f invDir(1.0f / rayDir.x, 1.0f / rayDir.y, 1.0f / rayDir.z);
+
+  float closestT = FLT_MAX;
+  uint32_t ret = ~0U;
+
+  // the tree is balanced so this is far deeper than needed for 2^32 primitives
+  uint32_t stack[64];
+  int stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while(stackSize > 0)
+  {
+    uint32_t nodeIdx = stack[--stackSize];
+    const Node &n = nodes[nodeIdx];
+
+    // slab test against the node's bounds, clipped to the closest hit so far
+    float tmin = 0.0f, tmax = closestT;
+    const float *bmin = &n.bmin.x, *bmax = &n.bmax.x;
+    const float *pos = &rayPos.x, *inv = &invDir.x;
+    for(int a = 0; a < 3 && tmin <= tmax; a++)
+    {
+      float t0 = (bmin[a] - pos[a]) * inv[a];
+      float t1 = (bmax[a] - pos[a]) * inv[a];
+      if(t0 > t1)
+        std::swap(t0, t1);
+      // NaNs from a zero direction component on the slab plane leave the range unchanged
+      tmin = t0 > tmin ? t0 : tmin;
+      tmax = t1 < tmax ? t1 : tmax;
+    }
+
+    if(tmin > tmax)
+      continue;
+
+    if(n.count == 0)
+    {
+      stack[stackSize++] = n.rightChild;
+      stack[stackSize++] = nodeIdx + 1;
+      continue;
+    }
+
+    for(uint32_t i = n.first; i < n.first + n.count; i++)
+    {
+      const Prim &p = prims[i];
+
+      Vec3f v[3] = {
+          Vec3f(p.pos[0].x, p.pos[0].y, p.pos[0].z), Vec3f(p.pos[1].x, p.pos[1].y, p.pos[1].z),
+          Vec3f(p.pos[2].x, p.pos[2].y, p.pos[2].z),
+      };
+
+      float t = 0.0f;
+      if(!TriangleRayIntersect(v[0], v[1], v[2], rayPos, rayDir, t) || t >= closestT)
+        continue;
+
+      closestT = t;
+
+      // return the vertex that was closest to the triangle/ray intersection point
+      Vec3f hit = rayPos + rayDir * t;
+      float dist0 = (v[0] - hit).Length();
+      float dist1 = (v[1] - hit).Length();
+      float dist2 = (v[2] - hit).Length();
+
+      ret = p.vertid[0];
+      if(dist1 < dist0 && dist1 < dist2)
+        ret = p.vertid[1];
+      else if(dist2 < dist0 && dist2 < dist1)
+        ret = p.vertid[2];
+    }
+  }
+
+  return ret;
+}
+
+uint32_t MeshPickCache::PickPoint(const Matrix4f &mvp, bool unproject, Vec2f coords,
+                                  Vec2f viewport) const
+{
+  if(triangles || nodes.empty())
+    return ~0U;
+
+  float closestLen = MeshPickPointRadius, closestDepth = 0.0f;
+  uint32_t ret = ~0U;
+
+  uint32_t stack[64];
+  int stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while(stackSize > 0)
+  {
+    uint32_t nodeIdx = stack[--stackSize];
+    const Node &n = nodes[nodeIdx];
+
+    // project all corners of the xyzw bounds to find a conservative screen-space rect. The
+    // projection is linear, or a perspective divide which keeps the image inside the projected
+    // corners as long as no corner is behind the eye, so those nodes are always visited.
+    bool conservative = false;
+    Vec2f smin(FLT_MAX, FLT_MAX), smax(-FLT_MAX, -FLT_MAX);
+    for(int c = 0; c < 16 && !conservative; c++)
+    {
+      FloatVector corner((c & 1) ? n.bmax.x : n.bmin.x, (c & 2) ? n.bmax.y : n.bmin.y,
+                         (c & 4) ? n.bmax.z : n.bmin.z, (c & 8) ? n.bmax.w : n.bmin.w);
+      FloatVector wpos = MulVec4(mvp, corner);
+
+      if(unproject)
+      {
+        if(wpos.w <= 0.0f)
+        {
+          conservative = true;
+          break;
+        }
+
+        wpos.x /= wpos.w;
+        wpos.y /= wpos.w;
+      }
+
+      float sx = (wpos.x + 1.0f) * 0.5f * viewport.x;
+      float sy = (1.0f - wpos.y) * 0.5f * viewport.y;
+
+      smin = Vec2f(RDCMIN(smin.x, sx), RDCMIN(smin.y, sy));
+      smax = Vec2f(RDCMAX(smax.x, sx), RDCMAX(smax.y, sy));
+    }
+
+    if(!conservative)
+    {
+      float dx = RDCMAX(RDCMAX(smin.x - coords.x, coords.x - smax.x), 0.0f);
+      float dy = RDCMAX(RDCMAX(smin.y - coords.y, coords.y - smax.y), 0.0f);
+
+      if(dx * dx + dy * dy > closestLen * closestLen)
+        continue;
+    }
+
+    if(n.count == 0)
+    {
+      stack[stackSize++] = n.rightChild;
+      stack[stackSize++] = nodeIdx + 1;
+      continue;
+    }
+
+    for(uint32_t i = n.first; i < n.first + n.count; i++)
+    {
+      const Prim &p = prims[i];
+
+      FloatVector wpos = MulVec4(mvp, p.pos[0]);
+
+      if(unproject)
+      {
+        wpos.x /= wpos.w;
+        wpos.y /= wpos.w;
+        wpos.z /= wpos.w;
+      }
+
+      float dx = (wpos.x + 1.0f) * 0.5f * viewport.x - coords.x;
+      float dy = (1.0f - wpos.y) * 0.5f * viewport.y - coords.y;
+      float len = sqrtf(dx * dx + dy * dy);
+
+      if(len >= MeshPickPointRadius)
+        continue;
+
+      // We need to keep the picking order consistent when multiple vertices have the identical
+      // position (e.g. if UVs or normals are different), so tie-break on depth then vertex.
+      if(ret == ~0U || len < closestLen || (len == closestLen && wpos.z < closestDepth) ||
+         (len == closestLen && wpos.z == closestDepth && p.vertid[0] < ret))
+      {
+        closestLen = len;
+        closestDepth = wpos.z;
+        ret = p.vertid[0];
+      }
+    }
+  }
+
+  return ret;
+}
+
+uint32_t MeshPickCache::PickVertex(uint32_t eventId, int32_t width, int32_t height,
+                                   const MeshDisplay &cfg, uint32_t x, uint32_t y)
+{
+  const MeshFormat &fmt = cfg.position;
+
+  uint64_t newKey = 5381;
+
+  // hash all the properties of cfg that affect the positions being picked
+  newKey = inthash(eventId, newKey);
+  newKey = inthash((uint64_t)cfg.type, newKey);
+  newKey = inthash(cfg.curInstance, newKey);
+  newKey = inthash(cfg.curView, newKey);
+  newKey = inthash(fmt.indexResourceId, newKey);
+  newKey = inthash(fmt.indexByteOffset, newKey);
+  newKey = inthash(fmt.indexByteStride, newKey);
+  newKey = inthash((uint64_t)fmt.baseVertex, newKey);
+  newKey = inthash(fmt.vertexResourceId, newKey);
+  newKey = inthash(fmt.vertexByteOffset, newKey);
+  newKey = inthash(fmt.vertexByteStride, newKey);
+  newKey = inthash((uint64_t)fmt.format.type, newKey);
+  newKey = inthash((uint64_t)fmt.format.compType, newKey);
+  newKey = inthash(fmt.format.compCount, newKey);
+  newKey = inthash(fmt.format.compByteWidth, newKey);
+  newKey = inthash(fmt.format.bgraOrder ? 1U : 0U, newKey);
+  newKey = inthash((uint64_t)fmt.topology, newKey);
+  newKey = inthash(fmt.numIndices, newKey);
+  newKey = inthash(fmt.unproject ? 1U : 0U, newKey);
+
+  if(cacheKey != newKey)
+  {
+    cacheKey = newKey;
+
+    std::vector<uint32_t> indices;
+
+    uint32_t minIndex = 0;
+    uint32_t maxIndex = fmt.numIndices > 0 ? fmt.numIndices - 1 : 0;
+
+    if(fmt.indexByteStride && fmt.indexResourceId != ResourceId())
+    {
+      bytebuf idxdata;
+      driver->GetBufferData(fmt.indexResourceId, fmt.indexByteOffset,
+                            uint64_t(fmt.numIndices) * fmt.indexByteStride, idxdata);
+
+      uint8_t *idx8 = (uint8_t *)idxdata.data();
+      uint16_t *idx16 = (uint16_t *)idxdata.data();
+      uint32_t *idx32 = (uint32_t *)idxdata.data();
+
+      uint32_t numIndices = RDCMIN(fmt.numIndices, uint32_t(idxdata.size() / fmt.indexByteStride));
+
+      uint32_t primRestart = 0;
+      if(IsStrip(fmt.topology))
+      {
+        if(fmt.indexByteStride == 1)
+          primRestart = 0xff;
+        else if(fmt.indexByteStride == 2)
+          primRestart = 0xffff;
+        else
+          primRestart = 0xffffffff;
+      }
+
+      uint32_t idxclamp = 0;
+      if(fmt.baseVertex < 0)
+        idxclamp = uint32_t(-fmt.baseVertex);
+
+      indices.resize(numIndices);
+
+      minIndex = ~0U;
+      maxIndex = 0;
+
+      for(uint32_t i = 0; i < numIndices; i++)
+      {
+        uint32_t idx = 0;
+        if(fmt.indexByteStride == 1)
+          idx = idx8[i];
+        else if(fmt.indexByteStride == 2)
+          idx = idx16[i];
+        else
+          idx = idx32[i];
+
+        if(primRestart && idx == primRestart)
+        {
+          indices[i] = ~0U;
+          continue;
+        }
+
+        if(idx < idxclamp)
+          idx = 0;
+        else if(fmt.baseVertex < 0)
+          idx -= idxclamp;
+        else if(fmt.baseVertex > 0)
+          idx += fmt.baseVertex;
+
+        minIndex = RDCMIN(idx, minIndex);
+        maxIndex = RDCMAX(idx, maxIndex);
+
+        indices[i] = idx;
+      }
+    }
+
+    // unpack and linearise the data. The index buffer may refer to vertices past the start of the
+    // vertex buffer, so we only convert the range between the min and max index.
+    std::vector<FloatVector> verts;
+
+    bytebuf vbdata;
+    driver->GetBufferData(fmt.vertexResourceId, fmt.vertexByteOffset, 0, vbdata);
+
+    const byte *data = vbdata.data();
+    const byte *dataEnd = data + vbdata.size();
+
+    // clamp maxIndex to upper bound in case we got invalid indices
+    uint32_t numVerts = uint32_t(vbdata.size() / RDCMAX(1U, fmt.vertexByteStride));
+
+    if(numVerts > 0 && minIndex <= maxIndex)
+    {
+      maxIndex = RDCMIN(maxIndex, numVerts - 1);
+
+      verts.reserve(maxIndex - minIndex + 1);
+
+      for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
+      {
+        bool valid = true;
+        FloatVector pos = HighlightCache::InterpretVertex(data, idx, fmt.vertexByteStride,
+                                                          fmt.format, dataEnd, valid);
+        // vertices are contiguous, so once we run off the end there are no more valid ones
+        if(!valid)
+          break;
+
+        verts.push_back(pos);
+      }
+    }
+
+    Build(fmt.topology, fmt.unproject, fmt.numIndices, indices, minIndex, verts);
+  }
+
+  if(nodes.empty())
+    return ~0U;
+
+  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(width) / float(height));
+
+  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
+  Matrix4f pickMVP = projMat.Mul(camMat);
+
+  Matrix4f pickMVPProj;
+  if(fmt.unproject)
+  {
+    // the derivation of the projection matrix might not be right (hell, it could be an
+    // orthographic projection). But it'll be close enough likely.
+    Matrix4f guessProj =
+        fmt.farPlane != FLT_MAX
+            ? Matrix4f::Perspective(cfg.fov, fmt.nearPlane, fmt.farPlane, cfg.aspect)
+            : Matrix4f::ReversePerspective(cfg.fov, fmt.nearPlane, cfg.aspect);
+
+    if(cfg.ortho)
+      guessProj = Matrix4f::Orthographic(fmt.nearPlane, fmt.farPlane);
+
+    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
+  }
+
+  if(!triangles)
+    return PickPoint(fmt.unproject ? pickMVPProj : pickMVP, fmt.unproject,
+                     Vec2f((float)x, (float)y), Vec2f((float)width, (float)height));
+
+  Vec3f rayPos;
+  Vec3f rayDir;
+  // convert mouse pos to world space ray
+  {
+    Matrix4f inversePickMVP = pickMVP.Inverse();
+
+    float pickX = ((float)x) / ((float)width);
+    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
+
+    float pickY = ((float)y) / ((float)height);
+    // flip the Y axis
+    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
+
+    Vec3f cameraToWorldNearPosition =
+        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
+
+    Vec3f cameraToWorldFarPosition =
+        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
+
+    Vec3f testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
+    testDir.Normalise();
+
+    // Calculate the ray direction first in the regular way (above), so we can use the
+    // the output for testing if the ray we are picking is negative or not. This is similar
+    // to checking against the forward direction of the camera, but more robust
+    if(fmt.unproject)
+    {
+      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
+
+      Vec3f nearPosProj =
+          inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
+
+      Vec3f farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
+
+      rayDir = (farPosProj - nearPosProj);
+      rayDir.Normalise();
+
+      if(testDir.z < 0)
+      {
+        rayDir = -rayDir;
+      }
+      rayPos = nearPosProj;
+    }
+    else
+    {
+      rayDir = testDir;
+      rayPos = cameraToWorldNearPosition;
+    }
+  }
+
+  return PickTriangle(rayPos, rayDir);
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Check mesh picking BVH", "[meshpick]")
+{
+  MeshPickCache cache;
+
+  // deterministic pseudo-random values in [0, 1)
+  uint32_t seed = 12345;
+  auto rnd = [&seed]() {
+    seed = seed * 1664525U + 1013904223U;
+    return float(seed >> 8) / float(1 << 24);
+  };
+
+  SECTION("Triangle picks match a brute force search")
+  {
+    const uint32_t N = 40;
+
+    std::vector<FloatVector> verts;
+    for(uint32_t y = 0; y <= N; y++)
+      for(uint32_t x = 0; x <= N; x++)
+        verts.push_back(FloatVector(float(x), float(y), rnd() * 4.0f, 1.0f));
+
+    std::vector<uint32_t> indices;
+    for(uint32_t y = 0; y < N; y++)
+    {
+      for(uint32_t x = 0; x < N; x++)
+      {
+        uint32_t i = y * (N + 1) + x;
+        uint32_t quad[6] = {i, i + 1, i + N + 1, i + 1, i + N + 2, i + N + 1};
+        indices.insert(indices.end(), quad, quad + 6);
+      }
+    }
+
+    cache.Build(Topology::TriangleList, false, (uint32_t)indices.size(), indices, 0, verts);
+
+    for(int r = 0; r < 500; r++)
+    {
+      Vec3f rayPos(rnd() * N, rnd() * N, -10.0f);
+      Vec3f rayDir(rnd() - 0.5f, rnd() - 0.5f, 4.0f);
+      rayDir.Normalise();
+
+      float closestT = FLT_MAX;
+      uint32_t expected = ~0U;
+      for(size_t t = 0; t + 2 < indices.size(); t += 3)
+      {
+        Vec3f v[3];
+        for(int c = 0; c < 3; c++)
+          v[c] = Vec3f(verts[indices[t + c]].x, verts[indices[t + c]].y, verts[indices[t + c]].z);
+
+        float hitT = 0.0f;
+        if(TriangleRayIntersect(v[0], v[1], v[2], rayPos, rayDir, hitT) && hitT < closestT)
+        {
+          closestT = hitT;
+          Vec3f hit = rayPos + rayDir * hitT;
+          float d[3] = {(v[0] - hit).Length(), (v[1] - hit).Length(), (v[2] - hit).Length()};
+          expected = uint32_t(t);
+          if(d[1] < d[0] && d[1] < d[2])
+            expected = uint32_t(t + 1);
+          else if(d[2] < d[0] && d[2] < d[1])
+            expected = uint32_t(t + 2);
+        }
+      }
+
+      CHECK(cache.PickTriangle(rayPos, rayDir) == expected);
+    }
+
+    // a ray pointing away from the mesh never hits
+    CHECK(cache.PickTriangle(Vec3f(5.0f, 5.0f, -10.0f), Vec3f(0.0f, 0.0f, -1.0f)) == ~0U);
+
+    // points can't be picked on a triangle mesh
+    CHECK(cache.PickPoint(Matrix4f::Identity(), false, Vec2f(), Vec2f(1.0f, 1.0f)) == ~0U);
+  };
+
+  SECTION("Strip restarts don't form triangles")
+  {
+    std::vector<FloatVector> verts = {
+        FloatVector(0.0f, 0.0f, 0.0f, 1.0f), FloatVector(1.0f, 0.0f, 0.0f, 1.0f),
+        FloatVector(0.0f, 1.0f, 0.0f, 1.0f), FloatVector(5.0f, 0.0f, 0.0f, 1.0f),
+        FloatVector(6.0f, 0.0f, 0.0f, 1.0f), FloatVector(5.0f, 1.0f, 0.0f, 1.0f),
+    };
+    std::vector<uint32_t> indices = {0, 1, 2, ~0U, 3, 4, 5};
+
+    cache.Build(Topology::TriangleStrip, false, (uint32_t)indices.size(), indices, 0, verts);
+
+    Vec3f dir(0.0f, 0.0f, 1.0f);
+
+    // hits on either side of the restart, closest to the first vertex of each
+    CHECK(cache.PickTriangle(Vec3f(0.1f, 0.1f, -1.0f), dir) == 0);
+    CHECK(cache.PickTriangle(Vec3f(5.1f, 0.1f, -1.0f), dir) == 4);
+
+    // the gap between the two would only be covered by triangles spanning the restart
+    CHECK(cache.PickTriangle(Vec3f(2.5f, 0.1f, -1.0f), dir) == ~0U);
+  };
+
+  SECTION("Point picks match a brute force search")
+  {
+    std::vector<FloatVector> verts;
+    for(int i = 0; i < 5000; i++)
+      verts.push_back(FloatVector(rnd() * 2.0f - 1.0f, rnd() * 2.0f - 1.0f, rnd(), 1.0f));
+
+    cache.Build(Topology::PointList, false, (uint32_t)verts.size(), {}, 0, verts);
+
+    Matrix4f mvp = Matrix4f::Identity();
+    Vec2f viewport(800.0f, 600.0f);
+
+    for(int r = 0; r < 200; r++)
+    {
+      Vec2f coords(rnd() * viewport.x, rnd() * viewport.y);
+
+      float closestLen = FLT_MAX, closestDepth = 0.0f;
+      uint32_t expected = ~0U;
+      for(uint32_t i = 0; i < verts.size(); i++)
+      {
+        float dx = (verts[i].x + 1.0f) * 0.5f * viewport.x - coords.x;
+        float dy = (1.0f - verts[i].y) * 0.5f * viewport.y - coords.y;
+        float len = sqrtf(dx * dx + dy * dy);
+
+        if(len >= MeshPickPointRadius)
+          continue;
+
+        if(len < closestLen || (len == closestLen && verts[i].z < closestDepth))
+        {
+          closestLen = len;
+          closestDepth = verts[i].z;
+          expected = i;
+        }
+      }
+
+      CHECK(cache.PickPoint(mvp, false, coords, viewport) == expected);
+    }
+
+    // and far off-screen nothing is picked
+    CHECK(cache.PickPoint(mvp, false, Vec2f(-1000.0f, -1000.0f), viewport) == ~0U);
+  };
+};
+
+TEST_CASE("Batched vertex interpretation", "[meshpick]")
+{
+  ResourceFormat fmt;
+  fmt.type = ResourceFormatType::Regular;
+  fmt.compType = CompType::Float;
+  fmt.compByteWidth = 4;
+  fmt.compCount = 3;
+
+  // five vertices with a 16 byte stride, where the last one is cut short
+  std::vector<float> floats;
+  for(int i = 0; i < 18; i++)
+    floats.push_back(float(i));
+
+  const byte *data = (const byte *)floats.data();
+  const byte *end = data + floats.size() * sizeof(float);
+
+  SECTION("Batch matches single vertex interpretation")
+  {
+    FloatVector batch[4];
+    bool batchValid = true;
+    HighlightCache::InterpretVertices(data, 0, 4, 16, fmt, end, batch, batchValid);
+    CHECK(batchValid);
+
+    for(uint32_t i = 0; i < 4; i++)
+    {
+      bool valid = true;
+      FloatVector single = HighlightCache::InterpretVertex(data, i, 16, fmt, end, valid);
+      CHECK(valid);
+
+      CHECK(batch[i].x == single.x);
+      CHECK(batch[i].y == single.y);
+      CHECK(batch[i].z == single.z);
+      CHECK(batch[i].w == single.w);
+
+      CHECK(batch[i].x == float(i * 4 + 0));
+      CHECK(batch[i].y == float(i * 4 + 1));
+      CHECK(batch[i].z == float(i * 4 + 2));
+      CHECK(batch[i].w == 1.0f);
+    }
+  };
+
+  SECTION("Vertices past the end are invalid")
+  {
+    FloatVector batch[6];
+    bool valid = true;
+    HighlightCache::InterpretVertices(data, 2, 6, 16, fmt, end, batch, valid);
+    CHECK_FALSE(valid);
+
+    CHECK(batch[0].x == 8.0f);
+    CHECK(batch[1].x == 12.0f);
+
+    for(int i = 2; i < 6; i++)
+    {
+      CHECK(batch[i].x == 0.0f);
+      CHECK(batch[i].y == 0.0f);
+      CHECK(batch[i].z == 0.0f);
+      CHECK(batch[i].w == 1.0f);
+    }
+  };
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -27,6 +27,7 @@
 
 #include "api/replay/renderdoc_replay.h"
 #include "core/core.h"
+#include "maths/matrix.h"
 #include "maths/vec.h"
 
 struct FrameRecord
@@ -258,6 +259,66 @@ struct HighlightCache
   static FloatVector InterpretVertex(const byte *data, uint32_t vert, uint32_t vertexByteStride,
                                      const ResourceFormat &fmt, const byte *end, bool &valid);
 
+  // converts count consecutive vertices starting at first in one batch. Vertices that don't lie
+  // entirely within [data, end) are set to (0, 0, 0, 1) and clear valid.
+  static void InterpretVertices(const byte *data, uint32_t first, uint32_t count,
+                                uint32_t vertexByteStride, const ResourceFormat &fmt,
+                                const byte *end, FloatVector *out, bool &valid);
+
   FloatVector InterpretVertex(const byte *data, uint32_t vert, const MeshDisplay &cfg,
                               const byte *end, bool useidx, bool &valid);
+};
+
+// CPU-side cache for picking vertices in the mesh viewer. The positions for the mesh are fetched
+// and unpacked once per (event, stage, instance) and stored in a BVH over triangles or points, so
+// repeated clicks on the same mesh only cost a tree traversal.
+struct MeshPickCache
+{
+  IRemoteDriver *driver = NULL;
+
+  // negate Y on unprojected positions before picking, for APIs with a flipped clip space
+  bool flipUnprojectedY = false;
+
+  uint32_t PickVertex(uint32_t eventId, int32_t width, int32_t height, const MeshDisplay &cfg,
+                      uint32_t x, uint32_t y);
+
+  // must be called whenever the data at an event could change, e.g. shader replacements
+  void Invalidate() { cacheKey = 0; }
+
+  // builds the BVH from already unpacked positions. indices is the remapped index list (with ~0U
+  // for strip restarts) or empty for non-indexed draws, verts holds every vertex from firstVert.
+  void Build(Topology topo, bool unproject, uint32_t numIndices,
+             const std::vector<uint32_t> &indices, uint32_t firstVert,
+             const std::vector<FloatVector> &verts);
+
+  // returns the index into the mesh's index list of the vertex nearest to the closest hit, or ~0U
+  uint32_t PickTriangle(const Vec3f &rayPos, const Vec3f &rayDir) const;
+
+  // returns the index into the mesh's index list of the vertex nearest the screen co-ords, or ~0U
+  uint32_t PickPoint(const Matrix4f &mvp, bool unproject, Vec2f coords, Vec2f viewport) const;
+
+private:
+  struct Node
+  {
+    FloatVector bmin, bmax;
+    // for leaves, the range of primitives. Otherwise count is 0 and the right child is at
+    // rightChild, with the left child immediately following this node.
+    uint32_t first, count, rightChild;
+  };
+
+  // one per primitive in BVH order. For triangles the three picked positions, for points the
+  // single position in xyzw.
+  struct Prim
+  {
+    FloatVector pos[3];
+    uint32_t vertid[3];
+  };
+
+  uint32_t BuildNode(uint32_t first, uint32_t count);
+
+  uint64_t cacheKey = 0;
+  bool triangles = false;
+
+  std::vector<Node> nodes;
+  std::vector<Prim> prims;
 };
\ No newline at end of file
@@ -0,0 +1,235 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "blobstore.h"
+#include "lz4io.h"
+#include "zstd/xxhash.h"
+
+/*
+
+ Blob store section format:
+
+ uint64_t numBlobs;
+ Blob
+ {
+   uint64_t hash; // XXH64 of the uncompressed data, with the first seed that didn't collide
+   uint64_t size; // uncompressed byte size
+   uint64_t offset; // byte offset of the compressed data, relative to the start of data below
+   uint64_t compressedSize; // byte size of the compressed data
+ } blobs[numBlobs];
+ byte data[]; // each blob LZ4 compressed independently
+
+*/
+
+uint64_t BlobStore::Add(const byte *data, uint64_t size)
+{
+  uint64_t hash = 0;
+
+  // the hash alone doesn't guarantee the contents are identical. On a collision rehash with the
+  // next seed, the same data always probes the same sequence so duplicates are still found.
+  for(uint64_t seed = 0;; seed++)
+  {
+    hash = XXH64(data, (size_t)size, seed);
+
+    auto it = m_Blobs.find(hash);
+    if(it == m_Blobs.end())
+      break;
+
+    if(it->second.size == size && Matches(it->second, data))
+    {
+      m_DuplicateBytes += size;
+      return hash;
+    }
+
+    RDCWARN("Blob hash collision on %016llx, rehashing %llu bytes", hash, size);
+  }
+
+  StreamWriter compressed(StreamWriter::DefaultScratchSize);
+
+  {
+    StreamWriter writer(new LZ4Compressor(&compressed, Ownership::Nothing), Ownership::Stream);
+    writer.Write(data, size);
+    writer.Finish();
+  }
+
+  Blob &blob = m_Blobs[hash];
+  blob.size = size;
+  blob.offset = m_Data.size();
+  blob.compressedSize = compressed.GetOffset();
+
+  m_Data.append(compressed.GetData(), (size_t)compressed.GetOffset());
+
+  return hash;
+}
+
+bool BlobStore::Matches(const Blob &blob, const byte *data) const
+{
+  StreamReader reader(new LZ4Decompressor(new StreamReader(m_Data.data() + blob.offset,
+                                                           blob.compressedSize),
+                                          Ownership::Stream),
+                      blob.size, Ownership::Stream);
+
+  // compare in blocks so we never need to decompress the whole blob at once
+  byte block[16 * 1024];
+
+  for(uint64_t offs = 0; offs < blob.size; offs += sizeof(block))
+  {
+    uint64_t len = RDCMIN(blob.size - offs, (uint64_t)sizeof(block));
+
+    reader.Read(block, len);
+
+    if(reader.IsErrored() || memcmp(block, data + offs, (size_t)len) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+bool BlobStore::Merge(const BlobStore &other)
+{
+  bytebuf data;
+
+  for(auto it = other.m_Blobs.begin(); it != other.m_Blobs.end(); ++it)
+  {
+    auto existing = m_Blobs.find(it->first);
+    if(existing == m_Blobs.end())
+      continue;
+
+    data.resize((size_t)it->second.size);
+
+    if(existing->second.size != it->second.size ||
+       !other.Fetch(it->first, data.data(), data.size()) || !Matches(existing->second, data.data()))
+    {
+      RDCWARN("Blob hash collision on %016llx while merging blob stores", it->first);
+      return false;
+    }
+  }
+
+  for(auto it = other.m_Blobs.begin(); it != other.m_Blobs.end(); ++it)
+  {
+    if(m_Blobs.find(it->first) != m_Blobs.end())
+    {
+      m_DuplicateBytes += it->second.size;
+      continue;
+    }
+
+    // blobs are compressed independently, so the compressed data can be copied as-is
+    Blob &blob = m_Blobs[it->first];
+    blob.size = it->second.size;
+    blob.offset = m_Data.size();
+    blob.compressedSize = it->second.compressedSize;
+
+    m_Data.append(other.m_Data.data() + it->second.offset, (size_t)it->second.compressedSize);
+  }
+
+  return true;
+}
+
+bool BlobStore::Contains(uint64_t hash, uint64_t size) const
+{
+  auto it = m_Blobs.find(hash);
+  return it != m_Blobs.end() && it->second.size == size;
+}
+
+bool BlobStore::Fetch(uint64_t hash, byte *dest, uint64_t size) const
+{
+  auto it = m_Blobs.find(hash);
+  if(it == m_Blobs.end() || it->second.size != size)
+  {
+    RDCERR("Blob %016llx of %llu bytes is missing", hash, size);
+    return false;
+  }
+
+  const Blob &blob = it->second;
+
+  StreamReader reader(new LZ4Decompressor(new StreamReader(m_Data.data() + blob.offset,
+                                                           blob.compressedSize),
+                                          Ownership::Stream),
+                      blob.size, Ownership::Stream);
+
+  reader.Read(dest, size);
+
+  return !reader.IsErrored();
+}
+
+bool BlobStore::Write(StreamWriter &writer) const
+{
+  writer.Write((uint64_t)m_Blobs.size());
+
+  for(auto it = m_Blobs.begin(); it != m_Blobs.end(); ++it)
+  {
+    writer.Write(it->first);
+    writer.Write(it->second.size);
+    writer.Write(it->second.offset);
+    writer.Write(it->second.compressedSize);
+  }
+
+  writer.Write(m_Data.data(), m_Data.size());
+
+  return !writer.IsErrored();
+}
+
+bool BlobStore::Read(StreamReader &reader)
+{
+  m_Blobs.clear();
+  m_Data.clear();
+
+  uint64_t numBlobs = 0;
+  reader.Read(numBlobs);
+
+  // each blob needs at least its index entry
+  if(numBlobs > reader.GetSize() / (sizeof(uint64_t) * 4))
+  {
+    RDCERR("Invalid blob count %llu", numBlobs);
+    return false;
+  }
+
+  for(uint64_t i = 0; i < numBlobs && !reader.IsErrored(); i++)
+  {
+    uint64_t hash = 0;
+    Blob blob;
+    reader.Read(hash);
+    reader.Read(blob.size);
+    reader.Read(blob.offset);
+    reader.Read(blob.compressedSize);
+    m_Blobs[hash] = blob;
+  }
+
+  if(reader.IsErrored())
+    return false;
+
+  m_Data.resize(size_t(reader.GetSize() - reader.GetOffset()));
+  reader.Read(m_Data.data(), m_Data.size());
+
+  for(auto it = m_Blobs.begin(); it != m_Blobs.end(); ++it)
+  {
+    if(it->second.offset + it->second.compressedSize > m_Data.size())
+    {
+      RDCERR("Blob %016llx is out of bounds", it->first);
+      return false;
+    }
+  }
+
+  return !reader.IsErrored();
+}
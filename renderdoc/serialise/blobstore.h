@@ -0,0 +1,82 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <map>
+#include "streamio.h"
+
+// A content addressed store for large byte buffers. When a serialiser has a blob store set, any
+// byte buffer of at least MinimumSize is stored here once by hash and only a reference to it is
+// serialised, so identical buffers like zero-filled initial contents or repeated texture data are
+// only stored once. A serialiser reading with the same store expands the references transparently.
+//
+// Each blob is LZ4 compressed on its own as it's added, so that only compressed data is held in
+// memory while writing and any blob can be decompressed independently when reading.
+class BlobStore
+{
+public:
+  static const uint64_t MinimumSize = 4 * 1024;
+
+  // set on a serialised byte buffer's length to indicate it's a reference to a blob, followed by
+  // the blob's hash instead of the data.
+  static const uint64_t ReferenceFlag = 0x8000000000000000ULL;
+
+  // the number of bytes a byte buffer of this size occupies inline in a chunk when serialised with
+  // the given store, for chunk size estimates. Buffers moved to the store only leave their hash.
+  static uint64_t GetSerialisedSize(const BlobStore *blobs, uint64_t size)
+  {
+    return blobs && size >= MinimumSize ? sizeof(uint64_t) : size;
+  }
+
+  // adds the data to the store if it isn't already present and returns the hash identifying it.
+  // This always succeeds, if a different blob already has the same hash the data is rehashed with
+  // a different seed until it's found or a free hash is reached.
+  uint64_t Add(const byte *data, uint64_t size);
+  // adds all of the other store's blobs to this one. Returns false without adding anything if any
+  // of them has the same hash as a different blob already here.
+  bool Merge(const BlobStore &other);
+  bool Contains(uint64_t hash, uint64_t size) const;
+  // decompresses a blob into dest, which must be large enough to hold it
+  bool Fetch(uint64_t hash, byte *dest, uint64_t size) const;
+
+  bool IsEmpty() const { return m_Blobs.empty(); }
+  uint64_t GetDuplicateBytes() const { return m_DuplicateBytes; }
+  bool Write(StreamWriter &writer) const;
+  bool Read(StreamReader &reader);
+
+private:
+  struct Blob
+  {
+    uint64_t size;
+    uint64_t offset;
+    uint64_t compressedSize;
+  };
+
+  bool Matches(const Blob &blob, const byte *data) const;
+
+  std::map<uint64_t, Blob> m_Blobs;
+  bytebuf m_Data;
+  uint64_t m_DuplicateBytes = 0;
+};
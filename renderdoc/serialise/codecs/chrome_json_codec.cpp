@@ -24,6 +24,7 @@
 
 #include <utility>
 #include "common/common.h"
+#include "common/timing.h"
 #include "serialise/rdcfile.h"
 
 ReplayStatus exportChrome(const char *filename, const RDCFile &rdc, const SDFile &structData,
@@ -92,6 +93,60 @@ ReplayStatus exportChrome(const char *filename, const RDCFile &rdc, const SDFile
   return ReplayStatus::Succeeded;
 }
 
+ReplayStatus exportChromeReplayProfile(const char *filename, const ReplayProfiler &profiler)
+{
+  FILE *f = FileIO::fopen(filename, "w");
+
+  if(!f)
+    return ReplayStatus::FileIOFailed;
+
+  std::vector<ReplayProfiler::Sample> samples = profiler.GetSamples();
+
+  if(profiler.GetDroppedSamples() > 0)
+    RDCWARN("Replay profile only contains the last %llu samples, %llu older samples were dropped",
+            (uint64_t)samples.size(), profiler.GetDroppedSamples());
+
+  std::string str;
+
+  // use the same layout as the capture export above, so the two can be compared side by side.
+  str = R"({
+  "displayTimeUnit": "ns",
+  "traceEvents": [)";
+
+  uint64_t base = samples.empty() ? 0 : samples[0].startTick;
+  double microsPerTick = 1000.0 / Timing::GetTickFrequency();
+
+  bool first = true;
+
+  for(const ReplayProfiler::Sample &sample : samples)
+  {
+    if(!first)
+      str += ",";
+
+    first = false;
+
+    // all replay happens on one thread, so every sample goes on the same track
+    const char *category = sample.eventId == 0 ? "Initial Contents" : "Replay";
+
+    str += StringFormat::Fmt(
+        R"(
+    { "name": "%s", "cat": "%s", "ph": "X", "ts": %.3f, "dur": %.3f, "pid": 5, "tid": 1,
+      "args": { "eventId": %u } })",
+        profiler.GetChunkName(sample.chunkID).c_str(), category,
+        double(sample.startTick - base) * microsPerTick,
+        double(sample.endTick - sample.startTick) * microsPerTick, sample.eventId);
+  }
+
+  // end trace events
+  str += "\n  ]\n}";
+
+  FileIO::fwrite(str.data(), 1, str.size(), f);
+
+  FileIO::fclose(f);
+
+  return ReplayStatus::Succeeded;
+}
+
 static ConversionRegistration XMLConversionRegistration(
     &exportChrome,
     {
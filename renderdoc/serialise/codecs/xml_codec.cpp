@@ -24,6 +24,7 @@
 
 #include <utility>
 #include "common/common.h"
+#include "common/threading.h"
 #include "serialise/rdcfile.h"
 
 #include "3rdparty/miniz/miniz.h"
@@ -50,6 +51,10 @@ inline float StructuredProgress(float progress)
   return 0.2f + 0.8f * progress;
 }
 
+// the document is written and read piece by piece, so the enclosing tags are written by hand
+static const char *XMLHeader = "<?xml version=\"1.0\"?>\n<rdc>\n";
+static const char *XMLFooter = "\t</chunks>\n</rdc>\n";
+
 struct xml_file_writer : pugi::xml_writer
 {
   StreamWriter stream;
@@ -61,6 +66,103 @@ struct xml_file_writer : pugi::xml_writer
   void write(const void *data, size_t size) { stream.Write(data, size); }
 };
 
+struct xml_string_writer : pugi::xml_writer
+{
+  std::string text;
+
+  void write(const void *data, size_t size) { text.append((const char *)data, size); }
+};
+
+// reads the document incrementally, so that only a window of it is in memory at once. Offsets are
+// all relative to the current read position. The exported document never contains a raw '<' outside
+// of markup, so elements can be located by searching for their tags without a full parse.
+struct xml_stream_reader
+{
+  xml_stream_reader(StreamReader &reader) : stream(reader) {}
+  StreamReader &stream;
+
+  // make sure at least count bytes after the current position are available, returns false if the
+  // stream ended first
+  bool Ensure(size_t count)
+  {
+    while(text.size() - pos < count)
+    {
+      if(!ReadMore())
+        return false;
+    }
+
+    return true;
+  }
+
+  // find str at or after offs, or return std::string::npos if it's not in the rest of the stream
+  size_t Find(const char *str, size_t offs)
+  {
+    size_t len = strlen(str);
+
+    for(;;)
+    {
+      size_t idx = text.find(str, pos + offs);
+      if(idx != std::string::npos)
+        return idx - pos;
+
+      // resume the search where a match could still start in the new data
+      size_t avail = text.size() - pos;
+      offs = avail >= len ? RDCMAX(offs, avail - len + 1) : offs;
+
+      if(!ReadMore())
+        return std::string::npos;
+    }
+  }
+
+  bool StartsWith(const char *str)
+  {
+    size_t len = strlen(str);
+    return Ensure(len) && text.compare(pos, len, str) == 0;
+  }
+
+  void SkipWhitespace()
+  {
+    while(Ensure(1) && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' ||
+                        text[pos] == '\n'))
+      pos++;
+  }
+
+  const char *Data() { return text.c_str() + pos; }
+  void Consume(size_t count) { pos += count; }
+  float Progress()
+  {
+    return float(stream.GetOffset()) / float(RDCMAX<uint64_t>(1, stream.GetSize()));
+  }
+
+private:
+  bool ReadMore()
+  {
+    uint64_t remaining = stream.GetSize() - stream.GetOffset();
+
+    if(remaining == 0 || stream.IsErrored())
+      return false;
+
+    // discard what's been consumed before reading more
+    text.erase(0, pos);
+    pos = 0;
+
+    size_t oldSize = text.size();
+    size_t readSize = (size_t)RDCMIN<uint64_t>(remaining, 1024 * 1024);
+
+    text.resize(oldSize + readSize);
+    if(!stream.Read(&text[oldSize], readSize))
+    {
+      text.resize(oldSize);
+      return false;
+    }
+
+    return true;
+  }
+
+  std::string text;
+  size_t pos = 0;
+};
+
 // avoid &, <, and > since they throw off the ascii alignment
 static constexpr bool IsXMLPrintable(const char c)
 {
@@ -265,16 +367,68 @@ static void Obj2XML(pugi::xml_node &parent, SDObject &child)
   }
 }
 
+// the most chunks printed to text ahead of the file writing. Only this many chunks' printed text is
+// held in memory at once.
+static const size_t XMLChunkWindow = 4096;
+
+static void Chunk2XML(pugi::xml_writer &writer, SDChunk *chunk)
+{
+  pugi::xml_document doc;
+
+  pugi::xml_node xChunk = doc.append_child("chunk");
+
+  xChunk.append_attribute("id") = chunk->metadata.chunkID;
+  xChunk.append_attribute("name") = chunk->name.c_str();
+  xChunk.append_attribute("length") = chunk->metadata.length;
+  if(chunk->metadata.threadID)
+    xChunk.append_attribute("threadID") = chunk->metadata.threadID;
+  if(chunk->metadata.timestampMicro)
+    xChunk.append_attribute("timestamp") = chunk->metadata.timestampMicro;
+  if(chunk->metadata.durationMicro >= 0)
+    xChunk.append_attribute("duration") = chunk->metadata.durationMicro;
+  if(!chunk->metadata.callstack.empty())
+  {
+    pugi::xml_node stack = xChunk.append_child("callstack");
+
+    for(size_t i = 0; i < chunk->metadata.callstack.size(); i++)
+    {
+      stack.append_child("address").text() = chunk->metadata.callstack[i];
+    }
+  }
+
+  if(chunk->metadata.flags & SDChunkFlags::OpaqueChunk)
+  {
+    xChunk.append_attribute("opaque") = true;
+
+    RDCASSERT(!chunk->data.children.empty());
+    pugi::xml_node opaque = xChunk.append_child("buffer");
+    opaque.append_attribute("byteLength") = chunk->data.children[0]->type.byteSize;
+    opaque.text() = chunk->data.children[0]->data.basic.u;
+  }
+  else
+  {
+    for(size_t o = 0; o < chunk->data.children.size(); o++)
+      Obj2XML(xChunk, *chunk->data.children[o]);
+  }
+
+  xChunk.print(writer, "\t", pugi::format_default, pugi::encoding_auto, 2);
+}
+
 static ReplayStatus Structured2XML(const char *filename, const RDCFile &file, uint64_t version,
-                                   const StructuredChunkList &chunks,
+                                   const StructuredChunkList &chunks, uint32_t numThreads,
                                    RENDERDOC_ProgressCallback progress)
 {
-  pugi::xml_document doc;
+  // we write the document out piece by piece rather than building the whole tree in memory. Each
+  // piece is a small standalone document printed at the depth it would have in the full tree, so
+  // the output is the same as it would be if the tree was saved at once.
+  xml_file_writer writer(filename);
 
-  pugi::xml_node xRoot = doc.append_child("rdc");
+  writer.stream.Write(XMLHeader, strlen(XMLHeader));
 
   {
-    pugi::xml_node xHeader = xRoot.append_child("header");
+    pugi::xml_document doc;
+
+    pugi::xml_node xHeader = doc.append_child("header");
 
     pugi::xml_node xDriver = xHeader.append_child("driver");
     xDriver.append_attribute("id") = (uint32_t)file.GetDriver();
@@ -293,6 +447,8 @@ static ReplayStatus Structured2XML(const char *filename, const RDCFile &file, ui
       xThumbnail.append_attribute("height") = th.height;
       xThumbnail.text() = "thumb.jpg";
     }
+
+    xHeader.print(writer, "\t", pugi::format_default, pugi::encoding_auto, 1);
   }
 
   if(progress)
@@ -308,7 +464,9 @@ static ReplayStatus Structured2XML(const char *filename, const RDCFile &file, ui
 
     StreamReader *reader = file.ReadSection(i);
 
-    pugi::xml_node xSection = xRoot.append_child("section");
+    pugi::xml_document doc;
+
+    pugi::xml_node xSection = doc.append_child("section");
 
     if(props.flags & SectionFlags::ASCIIStored)
       xSection.append_attribute("ascii");
@@ -335,72 +493,114 @@ static ReplayStatus Structured2XML(const char *filename, const RDCFile &file, ui
     if(props.flags & SectionFlags::ASCIIStored)
     {
       // insert the contents literally
-      data.text().set((char *)contents.data());
+      data.text().set(std::string(contents.begin(), contents.end()).c_str());
     }
     else
     {
       // encode to simple hex. Not efficient, but easy.
       std::string hexdata;
-      hexdata.reserve(contents.size() * 2);
       HexEncode(contents, hexdata);
       data.text().set(hexdata.c_str());
     }
 
     delete reader;
+
+    xSection.print(writer, "\t", pugi::format_default, pugi::encoding_auto, 1);
   }
 
   if(progress)
     progress(StructuredProgress(0.2f));
 
-  pugi::xml_node xChunks = xRoot.append_child("chunks");
+  std::string chunksTag = StringFormat::Fmt("\t<chunks version=\"%llu\">\n", version);
+  writer.stream.Write(chunksTag.c_str(), chunksTag.size());
 
-  xChunks.append_attribute("version") = version;
+  // chunks are printed into a ring of slots, so at most one window of printed text is held at
+  // once. Workers claim the next unprinted chunk as long as its slot has been written out, since
+  // chunk sizes vary a lot. The calling thread writes slots out in order, and prints chunks itself
+  // whenever the next one to write isn't ready yet.
+  const int32_t numChunks = (int32_t)chunks.size();
+  const int32_t window = (int32_t)XMLChunkWindow;
 
-  for(size_t c = 0; c < chunks.size(); c++)
-  {
-    pugi::xml_node xChunk = xChunks.append_child("chunk");
-    SDChunk *chunk = chunks[c];
+  std::vector<xml_string_writer> printed;
+  printed.resize(RDCMIN(XMLChunkWindow, chunks.size()));
 
-    xChunk.append_attribute("id") = chunk->metadata.chunkID;
-    xChunk.append_attribute("name") = chunk->name.c_str();
-    xChunk.append_attribute("length") = chunk->metadata.length;
-    if(chunk->metadata.threadID)
-      xChunk.append_attribute("threadID") = chunk->metadata.threadID;
-    if(chunk->metadata.timestampMicro)
-      xChunk.append_attribute("timestamp") = chunk->metadata.timestampMicro;
-    if(chunk->metadata.durationMicro >= 0)
-      xChunk.append_attribute("duration") = chunk->metadata.durationMicro;
-    if(!chunk->metadata.callstack.empty())
+  std::vector<int32_t> ready;
+  ready.resize(printed.size());
+
+  int32_t next = 0;
+  int32_t written = 0;
+  int32_t aborted = 0;
+
+  // returns the index of a chunk this thread now owns, or -1 if none can be claimed right now
+  auto claim = [&]() -> int32_t {
+    for(;;)
     {
-      pugi::xml_node stack = xChunk.append_child("callstack");
+      int32_t idx = Atomic::CmpExch32(&next, 0, 0);
+      if(idx >= numChunks || idx >= Atomic::CmpExch32(&written, 0, 0) + window)
+        return -1;
+      if(Atomic::CmpExch32(&next, idx, idx + 1) == idx)
+        return idx;
+    }
+  };
 
-      for(size_t i = 0; i < chunk->metadata.callstack.size(); i++)
+  auto print = [&](int32_t idx) {
+    Chunk2XML(printed[idx % window], chunks[idx]);
+    Atomic::Inc32(&ready[idx % window]);
+  };
+
+  ReplayStatus status = ReplayStatus::Succeeded;
+
+  Threading::ParallelForRange(numThreads, 1, [&](uint32_t begin, uint32_t) {
+    if(begin > 0)
+    {
+      while(Atomic::CmpExch32(&next, 0, 0) < numChunks && Atomic::CmpExch32(&aborted, 0, 0) == 0)
       {
-        stack.append_child("address").text() = chunk->metadata.callstack[i];
+        int32_t idx = claim();
+        if(idx >= 0)
+          print(idx);
+        else
+          Threading::Sleep(0);
       }
+
+      return;
     }
 
-    if(chunk->metadata.flags & SDChunkFlags::OpaqueChunk)
+    for(int32_t i = 0; i < numChunks;)
     {
-      xChunk.append_attribute("opaque") = true;
+      int32_t slot = i % window;
 
-      RDCASSERT(!chunk->data.children.empty());
-      pugi::xml_node opaque = xChunk.append_child("buffer");
-      opaque.append_attribute("byteLength") = chunk->data.children[0]->type.byteSize;
-      opaque.text() = chunk->data.children[0]->data.basic.u;
-    }
-    else
-    {
-      for(size_t o = 0; o < chunk->data.children.size(); o++)
-        Obj2XML(xChunk, *chunk->data.children[o]);
+      if(Atomic::CmpExch32(&ready[slot], 1, 0) == 0)
+      {
+        int32_t idx = claim();
+        if(idx >= 0)
+          print(idx);
+        else
+          Threading::Sleep(0);
+        continue;
+      }
+
+      writer.stream.Write(printed[slot].text.c_str(), printed[slot].text.size());
+      std::string().swap(printed[slot].text);
+
+      if(writer.stream.IsErrored())
+      {
+        status = ReplayStatus::FileIOFailed;
+        Atomic::Inc32(&aborted);
+        return;
+      }
+
+      i++;
+      Atomic::Inc32(&written);
+
+      if(progress)
+        progress(StructuredProgress(0.2f + 0.8f * (float(i) / float(numChunks))));
     }
+  });
 
-    if(progress)
-      progress(StructuredProgress(0.2f + 0.8f * (float(c) / float(chunks.size()))));
-  }
+  if(status != ReplayStatus::Succeeded)
+    return status;
 
-  xml_file_writer writer(filename);
-  doc.save(writer);
+  writer.stream.Write(XMLFooter, strlen(XMLFooter));
 
   return writer.stream.IsErrored() ? ReplayStatus::FileIOFailed : ReplayStatus::Succeeded;
 }
@@ -498,13 +698,35 @@ static SDObject *XML2Obj(pugi::xml_node &obj)
   return ret;
 }
 
-static ReplayStatus XML2Structured(const char *xml, const bytebuf &thumbBytes,
+static ReplayStatus XML2Structured(StreamReader &reader, const bytebuf &thumbBytes,
                                    const StructuredBufferList &buffers, RDCFile *rdc,
                                    uint64_t &version, StructuredChunkList &chunks,
                                    RENDERDOC_ProgressCallback progress)
 {
+  xml_stream_reader xml(reader);
+
+  // parse everything up to the start of the chunks as one document. This contains the header and
+  // sections, which are small compared to the chunks.
+  size_t chunksStart = xml.Find("<chunks", 0);
+  size_t chunksTagEnd =
+      chunksStart == std::string::npos ? std::string::npos : xml.Find(">", chunksStart);
+
+  if(chunksTagEnd == std::string::npos)
+  {
+    RDCERR("Malformed document, expected chunks node");
+    return ReplayStatus::FileCorrupted;
+  }
+
+  // if the chunks tag isn't self-closing, close it so the prefix is a complete document
+  bool noChunks = (xml.Data()[chunksTagEnd - 1] == '/');
+
+  std::string prefix(xml.Data(), chunksTagEnd + 1);
+  prefix += noChunks ? "</rdc>" : "</chunks></rdc>";
+
+  xml.Consume(chunksTagEnd + 1);
+
   pugi::xml_document doc;
-  doc.load_string(xml);
+  doc.load_buffer(prefix.c_str(), prefix.size());
 
   pugi::xml_node root = doc.child("rdc");
 
@@ -656,13 +878,40 @@ static ReplayStatus XML2Structured(const char *xml, const bytebuf &thumbBytes,
 
   version = xChunks.attribute("version").as_ullong();
 
-  size_t chunkIdx = 0;
-  size_t numChunks = std::distance(xChunks.begin(), xChunks.end());
-
-  for(pugi::xml_node xChunk = xChunks.first_child(); xChunk; xChunk = xChunk.next_sibling())
+  while(!noChunks)
   {
-    if(strcmp(xChunk.name(), "chunk"))
+    xml.SkipWhitespace();
+
+    if(xml.StartsWith("</chunks"))
+      break;
+
+    if(!xml.StartsWith("<chunk ") && !xml.StartsWith("<chunk>") && !xml.StartsWith("<chunk/"))
+    {
+      RDCERR("Malformed document, expected chunk node");
+      return ReplayStatus::FileCorrupted;
+    }
+
+    // find the end of this chunk, either the end of a self-closing tag or the closing tag
+    size_t chunkEnd = xml.Find(">", 0);
+    if(chunkEnd != std::string::npos && xml.Data()[chunkEnd - 1] != '/')
+    {
+      chunkEnd = xml.Find("</chunk>", chunkEnd);
+      if(chunkEnd != std::string::npos)
+        chunkEnd += strlen("</chunk>") - 1;
+    }
+
+    if(chunkEnd == std::string::npos)
+    {
+      RDCERR("Malformed document, unterminated chunk node");
       return ReplayStatus::FileCorrupted;
+    }
+
+    pugi::xml_document chunkDoc;
+    chunkDoc.load_buffer(xml.Data(), chunkEnd + 1);
+
+    xml.Consume(chunkEnd + 1);
+
+    pugi::xml_node xChunk = chunkDoc.first_child();
 
     SDChunk *chunk = new SDChunk(xChunk.attribute("name").as_string());
 
@@ -678,12 +927,8 @@ static ReplayStatus XML2Structured(const char *xml, const bytebuf &thumbBytes,
     pugi::xml_node callstack = xChunk.child("callstack");
     if(callstack)
     {
-      size_t i = 0;
       for(pugi::xml_node address = callstack.first_child(); address; address = address.next_sibling())
-      {
         chunk->metadata.callstack.push_back(address.text().as_ullong());
-        i++;
-      }
     }
 
     if(xChunk.attribute("opaque"))
@@ -700,15 +945,19 @@ static ReplayStatus XML2Structured(const char *xml, const bytebuf &thumbBytes,
     else
     {
       for(pugi::xml_node child = xChunk.first_child(); child; child = child.next_sibling())
+      {
+        // the callstack is metadata, processed above
+        if(child == callstack)
+          continue;
+
         chunk->data.children.push_back(XML2Obj(child));
+      }
     }
 
     chunks.push_back(chunk);
 
     if(progress)
-      progress(StructuredProgress(0.2f + 0.8f * (float(chunkIdx) / float(numChunks))));
-
-    chunkIdx++;
+      progress(StructuredProgress(0.2f + 0.8f * xml.Progress()));
   }
 
   return ReplayStatus::Succeeded;
@@ -778,9 +1027,8 @@ static bool ZIP2Buffers(const std::string &filename, bytebuf &thumbBytes,
       mz_zip_archive_file_stat zstat;
       mz_zip_reader_file_stat(&zip, i, &zstat);
 
-      size_t sz = 0;
-
-      byte *buf = (byte *)mz_zip_reader_extract_to_heap(&zip, i, &sz, 0);
+      // decompress straight into the destination rather than via a temporary heap allocation
+      bytebuf *dst = NULL;
 
       if(strcmp(zstat.m_filename, "thumb.jpg"))
       {
@@ -789,13 +1037,20 @@ static bool ZIP2Buffers(const std::string &filename, bytebuf &thumbBytes,
         if(bufname < (int)buffers.size())
         {
           buffers[bufname] = new bytebuf;
-          buffers[bufname]->assign(buf, sz);
+          dst = buffers[bufname];
         }
       }
       else
       {
         // we store the thumbnail separately
-        thumbBytes.assign(buf, sz);
+        dst = &thumbBytes;
+      }
+
+      if(dst)
+      {
+        dst->resize((size_t)zstat.m_uncomp_size);
+        if(!mz_zip_reader_extract_to_mem(&zip, i, dst->data(), dst->size(), 0))
+          RDCERR("Failed to extract %s from zip", zstat.m_filename);
       }
 
       if(progress)
@@ -822,12 +1077,7 @@ ReplayStatus importXMLZ(const char *filename, StreamReader &reader, RDCFile *rdc
     }
   }
 
-  uint64_t len = reader.GetSize();
-  char *buf = new char[(size_t)len + 1];
-  reader.Read(buf, (size_t)len);
-  buf[len] = 0;
-
-  return XML2Structured(buf, thumbBytes, structData.buffers, rdc, structData.version,
+  return XML2Structured(reader, thumbBytes, structData.buffers, rdc, structData.version,
                         structData.chunks, progress);
 }
 
@@ -839,13 +1089,15 @@ ReplayStatus exportXMLZ(const char *filename, const RDCFile &rdc, const SDFile &
   if(ret != ReplayStatus::Succeeded)
     return ret;
 
-  return Structured2XML(filename, rdc, structData.version, structData.chunks, progress);
+  return Structured2XML(filename, rdc, structData.version, structData.chunks,
+                        Threading::NumberOfCores(), progress);
 }
 
 ReplayStatus exportXMLOnly(const char *filename, const RDCFile &rdc, const SDFile &structData,
                            RENDERDOC_ProgressCallback progress)
 {
-  return Structured2XML(filename, rdc, structData.version, structData.chunks, progress);
+  return Structured2XML(filename, rdc, structData.version, structData.chunks,
+                        Threading::NumberOfCores(), progress);
 }
 
 static ConversionRegistration XMLZIPConversionRegistration(
@@ -864,4 +1116,244 @@ static ConversionRegistration XMLOnlyConversionRegistration(
         R"(Stores the structured data in an xml tree, with large buffer data omitted - that makes it
 easier to work with but it cannot then be imported.)",
         false,
-    });
\ No newline at end of file
+    });
+#if ENABLED(ENABLE_UNIT_TESTS)
+#include "3rdparty/catch/catch.hpp"
+
+static void CheckObjectsMatch(const SDObject &a, const SDObject &b)
+{
+  CHECK(a.name == b.name);
+  CHECK(a.type.basetype == b.type.basetype);
+  CHECK(a.type.flags == b.type.flags);
+  // the size is only stored for types where it's not implied
+  if(a.type.basetype == SDBasic::UnsignedInteger || a.type.basetype == SDBasic::SignedInteger ||
+     a.type.basetype == SDBasic::Float || a.type.basetype == SDBasic::Resource ||
+     a.type.basetype == SDBasic::Buffer)
+    CHECK(a.type.byteSize == b.type.byteSize);
+  CHECK(a.data.str == b.data.str);
+  CHECK(a.data.basic.u == b.data.basic.u);
+
+  REQUIRE(a.data.children.size() == b.data.children.size());
+  for(size_t i = 0; i < a.data.children.size(); i++)
+    CheckObjectsMatch(*a.data.children[i], *b.data.children[i]);
+}
+
+TEST_CASE("Round-trip structured data through XML+ZIP", "[xml]")
+{
+  std::string xmlPath = FileIO::GetTempFolderFilename() + "renderdoc_xml_test.zip.xml";
+  std::string zipPath = xmlPath.substr(0, xmlPath.size() - 4);
+
+  RDCFile rdc;
+  rdc.SetData(RDCDriver::Vulkan, "Vulkan", 0x123456789ULL, NULL);
+
+  const std::string notes = "Some notes, with <markup> & \"entities\" in them";
+  std::vector<byte> binarySection;
+  for(int i = 0; i < 1000; i++)
+    binarySection.push_back(byte(i * 13));
+
+  {
+    SectionProperties props;
+    props.name = "renderdoc/ui/notes";
+    props.type = SectionType::Notes;
+    props.flags = SectionFlags::ASCIIStored;
+    props.version = 1;
+
+    StreamWriter *w = rdc.WriteSection(props);
+    w->Write(notes.c_str(), notes.size());
+    w->Finish();
+    delete w;
+
+    props.name = "renderdoc/internal/resolvedb";
+    props.type = SectionType::ResolveDatabase;
+    props.flags = SectionFlags::NoFlags;
+    props.version = 2;
+
+    w = rdc.WriteSection(props);
+    w->Write(binarySection.data(), binarySection.size());
+    w->Finish();
+    delete w;
+  }
+
+  SDFile structData;
+  structData.version = 0x42;
+
+  bytebuf *buf = new bytebuf;
+  for(int i = 0; i < 100000; i++)
+    buf->push_back(byte(i ^ (i >> 8)));
+  structData.buffers.push_back(buf);
+
+  // enough chunks that the document is read over several windows, and one chunk bigger than the
+  // window on its own.
+  const size_t numChunks = 5000;
+  for(size_t c = 0; c < numChunks; c++)
+  {
+    SDChunk *chunk = new SDChunk(StringFormat::Fmt("Chunk %zu", c).c_str());
+
+    chunk->metadata.chunkID = uint32_t(c + 1);
+    chunk->metadata.length = uint32_t(c * 3);
+    chunk->metadata.threadID = 77;
+    chunk->metadata.timestampMicro = c * 100;
+    chunk->metadata.durationMicro = 5;
+
+    if(c == 10)
+    {
+      chunk->metadata.callstack.push_back(0x1000);
+      chunk->metadata.callstack.push_back(0x2000);
+    }
+
+    std::string str = StringFormat::Fmt("<string %zu> & such ", c);
+    while(str.size() < 300)
+      str += str;
+    if(c == numChunks / 2)
+      str.resize(3 * 1024 * 1024, 'x');
+
+    chunk->data.children.push_back(makeSDUInt32("index", uint32_t(c)));
+    chunk->data.children.push_back(makeSDString("text", str.c_str()));
+    chunk->data.children.push_back(makeSDInt64("negative", -int64_t(c)));
+    chunk->data.children.push_back(makeSDBool("odd", (c % 2) == 1));
+
+    SDObject *s = makeSDStruct("info", "Info");
+    s->data.children.push_back(makeSDEnum("mode", 3));
+    s->data.children.push_back(makeSDResourceId("id", ResourceId()));
+    chunk->data.children.push_back(s);
+
+    if(c == 20)
+    {
+      SDObject *b = new SDObject("data", "Byte Buffer");
+      b->type.basetype = SDBasic::Buffer;
+      b->type.byteSize = buf->size();
+      b->data.basic.u = 0;
+      chunk->data.children.push_back(b);
+    }
+
+    structData.chunks.push_back(chunk);
+  }
+
+  ReplayStatus status = exportXMLZ(xmlPath.c_str(), rdc, structData, NULL);
+  REQUIRE(status == ReplayStatus::Succeeded);
+
+  RDCFile rdc2;
+  SDFile structData2;
+
+  {
+    StreamReader reader(FileIO::fopen(xmlPath.c_str(), "rb"));
+    status = importXMLZ(xmlPath.c_str(), reader, &rdc2, structData2, NULL);
+  }
+
+  REQUIRE(status == ReplayStatus::Succeeded);
+
+  CHECK(rdc2.GetDriver() == RDCDriver::Vulkan);
+  CHECK(rdc2.GetDriverName() == "Vulkan");
+  CHECK(rdc2.GetMachineIdent() == 0x123456789ULL);
+
+  REQUIRE(rdc2.NumSections() == 2);
+
+  {
+    int idx = rdc2.SectionIndex(SectionType::Notes);
+    REQUIRE(idx >= 0);
+    CHECK(rdc2.GetSectionProperties(idx).version == 1);
+
+    StreamReader *r = rdc2.ReadSection(idx);
+    std::string readNotes;
+    readNotes.resize((size_t)r->GetSize());
+    r->Read(&readNotes[0], readNotes.size());
+    delete r;
+
+    CHECK(readNotes == notes);
+
+    idx = rdc2.SectionIndex(SectionType::ResolveDatabase);
+    REQUIRE(idx >= 0);
+    CHECK(rdc2.GetSectionProperties(idx).version == 2);
+
+    r = rdc2.ReadSection(idx);
+    std::vector<byte> readBinary;
+    readBinary.resize((size_t)r->GetSize());
+    r->Read(readBinary.data(), readBinary.size());
+    delete r;
+
+    CHECK(readBinary == binarySection);
+  }
+
+  CHECK(structData2.version == structData.version);
+
+  REQUIRE(structData2.buffers.size() == 1);
+  CHECK(*structData2.buffers[0] == *structData.buffers[0]);
+
+  REQUIRE(structData2.chunks.size() == numChunks);
+  for(size_t c = 0; c < numChunks; c++)
+  {
+    SDChunk *a = structData.chunks[c];
+    SDChunk *b = structData2.chunks[c];
+
+    CHECK(a->metadata.chunkID == b->metadata.chunkID);
+    CHECK(a->metadata.length == b->metadata.length);
+    CHECK(a->metadata.threadID == b->metadata.threadID);
+    CHECK(a->metadata.timestampMicro == b->metadata.timestampMicro);
+    CHECK(a->metadata.durationMicro == b->metadata.durationMicro);
+    CHECK(a->metadata.callstack == b->metadata.callstack);
+
+    CheckObjectsMatch(*a, *b);
+  }
+
+  FileIO::Delete(xmlPath.c_str());
+  FileIO::Delete(zipPath.c_str());
+}
+
+TEST_CASE("Parallel XML export matches serial export", "[xml]")
+{
+  std::string serialPath = FileIO::GetTempFolderFilename() + "renderdoc_xml_serial.xml";
+  std::string parallelPath = FileIO::GetTempFolderFilename() + "renderdoc_xml_parallel.xml";
+
+  RDCFile rdc;
+  rdc.SetData(RDCDriver::Vulkan, "Vulkan", 0x123456789ULL, NULL);
+
+  SDFile structData;
+  structData.version = 0x42;
+
+  // enough chunks to wrap around the window a few times, and chunks of very different sizes so the
+  // threads finish out of order.
+  const size_t numChunks = XMLChunkWindow * 2 + 123;
+  for(size_t c = 0; c < numChunks; c++)
+  {
+    SDChunk *chunk = new SDChunk(StringFormat::Fmt("Chunk %zu", c).c_str());
+
+    chunk->metadata.chunkID = uint32_t(c + 1);
+    chunk->metadata.timestampMicro = c * 100;
+
+    SDObject *arr = makeSDArray("values");
+    for(size_t i = 0; i < (c % 97) * (c % 13); i++)
+      arr->data.children.push_back(makeSDUInt32("$el", uint32_t(c * i)));
+    chunk->data.children.push_back(arr);
+
+    chunk->data.children.push_back(makeSDString("text", StringFormat::Fmt("<%zu> &", c).c_str()));
+
+    structData.chunks.push_back(chunk);
+  }
+
+  ReplayStatus status =
+      Structured2XML(serialPath.c_str(), rdc, structData.version, structData.chunks, 1, NULL);
+  REQUIRE(status == ReplayStatus::Succeeded);
+
+  status =
+      Structured2XML(parallelPath.c_str(), rdc, structData.version, structData.chunks, 8, NULL);
+  REQUIRE(status == ReplayStatus::Succeeded);
+
+  auto readFile = [](const std::string &path) {
+    StreamReader reader(FileIO::fopen(path.c_str(), "rb"));
+    std::vector<byte> ret;
+    ret.resize((size_t)reader.GetSize());
+    reader.Read(ret.data(), ret.size());
+    return ret;
+  };
+
+  std::vector<byte> serialData = readFile(serialPath);
+  std::vector<byte> parallelData = readFile(parallelPath);
+
+  CHECK(!serialData.empty());
+  CHECK((serialData == parallelData));
+
+  FileIO::Delete(serialPath.c_str());
+  FileIO::Delete(parallelPath.c_str());
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
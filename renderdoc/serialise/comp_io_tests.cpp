@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "lz4io.h"
+#include "rdcfile.h"
 #include "serialiser.h"
 #include "zstdio.h"
 
@@ -190,4 +191,219 @@ TEST_CASE("Test ZSTD compression/decompression", "[streamio][zstd]")
   delete[] randomData;
 };
 
+// generates data similar to a set of captures of the same program - the same structures recurring
+// between otherwise unrelated data.
+static bytebuf GenerateDictionaryTestData(const std::vector<bytebuf> &records, size_t size)
+{
+  bytebuf ret;
+
+  while(ret.size() < size)
+  {
+    const bytebuf &rec = records[rand() % records.size()];
+    ret.append(rec.data(), rec.size());
+
+    byte noise[8];
+    for(byte &b : noise)
+      b = rand() & 0xff;
+    ret.append(noise, sizeof(noise));
+  }
+
+  ret.resize(size);
+
+  return ret;
+}
+
+static uint64_t CompressDictionaryTestData(const bytebuf &data, const bytebuf *dict)
+{
+  StreamWriter buf(StreamWriter::DefaultScratchSize);
+
+  StreamWriter writer(new ZSTDCompressor(&buf, Ownership::Nothing, dict), Ownership::Stream);
+  writer.Write(data.data(), data.size());
+  writer.Finish();
+
+  CHECK_FALSE(writer.IsErrored());
+
+  StreamReader reader(new ZSTDDecompressor(new StreamReader(buf.GetData(), buf.GetOffset()),
+                                           Ownership::Stream, dict),
+                      data.size(), Ownership::Stream);
+
+  bytebuf readData;
+  readData.resize(data.size());
+  reader.Read(readData.data(), readData.size());
+
+  CHECK_FALSE(reader.IsErrored());
+  CHECK(reader.AtEnd());
+  CHECK_FALSE(memcmp(readData.data(), data.data(), data.size()));
+
+  return buf.GetOffset();
+}
+
+static uint32_t ReadRDCFileVersion(const std::string &filename)
+{
+  std::vector<byte> contents;
+  FileIO::slurp(filename.c_str(), contents);
+
+  // the version follows the 64-bit magic number
+  uint32_t version = 0;
+  if(contents.size() >= sizeof(uint64_t) + sizeof(version))
+    memcpy(&version, contents.data() + sizeof(uint64_t), sizeof(version));
+  return version;
+}
+
+TEST_CASE("Test ZSTD dictionary training and compression", "[streamio][zstd]")
+{
+  std::vector<bytebuf> records;
+  records.resize(256);
+
+  for(bytebuf &rec : records)
+  {
+    rec.resize(64 + (rand() % 384));
+    for(byte &b : rec)
+      b = rand() & 0xff;
+  }
+
+  ZSTDDictionaryTrainer trainer(112 * 1024);
+
+  // feed the samples in awkward sizes so segments span samples
+  for(int i = 0; i < 16; i++)
+  {
+    bytebuf sample = GenerateDictionaryTestData(records, 256 * 1024);
+
+    for(size_t offs = 0; offs < sample.size(); offs += 1000)
+      trainer.AddSample(sample.data() + offs, RDCMIN(sample.size() - offs, (size_t)1000));
+  }
+
+  bytebuf dict = trainer.Train();
+
+  CHECK(dict.size() > 0);
+  CHECK(dict.size() <= 112 * 1024);
+
+  bytebuf data = GenerateDictionaryTestData(records, 64 * 1024);
+
+  uint64_t plainSize = CompressDictionaryTestData(data, NULL);
+  uint64_t dictSize = CompressDictionaryTestData(data, &dict);
+
+  // the records rarely repeat within the data itself, so only the dictionary can find them
+  CHECK(dictSize < plainSize / 2);
+
+  SECTION("RDC files without dictionaries")
+  {
+    std::string filename = FileIO::GetTempFolderFilename() + "rdcfile_nodict_test.rdc";
+
+    {
+      RDCFile rdc;
+      rdc.SetData(RDCDriver::Unknown, "test", 0, NULL);
+      rdc.Create(filename.c_str());
+
+      REQUIRE((rdc.ErrorCode() == ContainerError::NoError));
+
+      SectionProperties props;
+      props.type = SectionType::FrameCapture;
+      props.flags = SectionFlags::ZstdCompressed;
+
+      StreamWriter *writer = rdc.WriteSection(props);
+      writer->Write(data.data(), data.size());
+      writer->Finish();
+      delete writer;
+    }
+
+    // files that don't need the dictionary table can still be opened by older builds
+    CHECK(ReadRDCFileVersion(filename) == uint32_t(RDCFile::V1_0_VERSION));
+
+    {
+      RDCFile rdc;
+      rdc.Open(filename.c_str());
+
+      CHECK((rdc.ErrorCode() == ContainerError::NoError));
+    }
+
+    FileIO::Delete(filename.c_str());
+  }
+
+  SECTION("RDC files with dictionaries")
+  {
+    std::string filename = FileIO::GetTempFolderFilename() + "rdcfile_dict_test.rdc";
+    std::string dictDir = FileIO::GetTempFolderFilename();
+    std::string dictFilename = dictDir + CompressionDictionaryFilename(ZSTDDictionaryID(dict));
+
+    bool embed = true;
+
+    SECTION("Embedded") { embed = true; }
+    SECTION("Referenced") { embed = false; }
+
+    {
+      RDCFile rdc;
+      rdc.SetData(RDCDriver::Unknown, "test", 0, NULL);
+      rdc.SetCompressionDictionary(SectionType::FrameCapture, dict, embed);
+      rdc.Create(filename.c_str());
+
+      REQUIRE((rdc.ErrorCode() == ContainerError::NoError));
+
+      SectionProperties props;
+      props.type = SectionType::FrameCapture;
+      props.flags = SectionFlags::ZstdCompressed;
+
+      StreamWriter *writer = rdc.WriteSection(props);
+      writer->Write(data.data(), data.size());
+      writer->Finish();
+      CHECK_FALSE(writer->IsErrored());
+      delete writer;
+    }
+
+    // older builds can't decode these sections, so the file version is raised for them to reject it
+    CHECK(ReadRDCFileVersion(filename) == uint32_t(RDCFile::DICTIONARY_VERSION));
+
+    RenderDoc::Inst().SetConfigSetting("capture.compressionDictionaryPaths", "");
+    FileIO::Delete(dictFilename.c_str());
+
+    if(!embed)
+    {
+      // the dictionary can't be found, so the section can't be read
+      RDCFile rdc;
+      rdc.Open(filename.c_str());
+
+      REQUIRE((rdc.ErrorCode() == ContainerError::NoError));
+      CHECK(rdc.GetCompressionDictionary(SectionType::FrameCapture) == NULL);
+
+      StreamReader *reader = rdc.ReadSection(0);
+      CHECK(reader->IsErrored());
+      delete reader;
+
+      FileIO::dump(dictFilename.c_str(), dict.data(), dict.size());
+      RenderDoc::Inst().SetConfigSetting("capture.compressionDictionaryPaths", dictDir);
+    }
+
+    {
+      RDCFile rdc;
+      rdc.Open(filename.c_str());
+
+      REQUIRE((rdc.ErrorCode() == ContainerError::NoError));
+      REQUIRE(rdc.NumSections() == 1);
+
+      const SectionProperties &props = rdc.GetSectionProperties(0);
+      bool usesDict(props.flags & SectionFlags::ZstdDictionary);
+      CHECK(usesDict);
+      CHECK(props.uncompressedSize == data.size());
+
+      // the dictionary is stored in the header, the section is compressed just as above
+      CHECK(props.compressedSize == dictSize);
+
+      StreamReader *reader = rdc.ReadSection(0);
+
+      bytebuf readData;
+      readData.resize(data.size());
+      reader->Read(readData.data(), readData.size());
+
+      CHECK_FALSE(reader->IsErrored());
+      CHECK_FALSE(memcmp(readData.data(), data.data(), data.size()));
+
+      delete reader;
+    }
+
+    RenderDoc::Inst().SetConfigSetting("capture.compressionDictionaryPaths", "");
+    FileIO::Delete(dictFilename.c_str());
+    FileIO::Delete(filename.c_str());
+  }
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -27,6 +27,7 @@
 #include "3rdparty/stb/stb_image.h"
 #include "api/replay/version.h"
 #include "common/dds_readwrite.h"
+#include "strings/string_utils.h"
 #include "lz4io.h"
 #include "zstdio.h"
 
@@ -48,7 +49,7 @@ bool is_exr_file(FILE *f)
 /*
 
  -----------------------------
- File format for version 0x100:
+ File format for version 0x101:
 
  RDCHeader
  {
@@ -72,6 +73,17 @@ bool is_exr_file(FILE *f)
    uint8_t driverNameLength; // length in bytes of the driver name including null terminator
    char driverName[ driverNameLength ]; // the driver name in ASCII. Useful if the current
                                         // implementation doesn't recognise the driver ID above
+
+   // only present in version 0x101 and later
+   uint32_t dictionaryCount; // number of zstd compression dictionaries below
+   Dictionary
+   {
+     uint64_t dictionaryID; // hash of the dictionary contents
+     uint32_t sectionType; // section type that is compressed with this dictionary
+     uint32_t dictionaryLength; // byte length of the dictionary below. If 0 the dictionary is only
+                                // referenced by ID and isn't embedded in the file
+     byte dictionaryData[ dictionaryLength ];
+   } dictionaries[ dictionaryCount ];
  }
 
  1 or more sections:
@@ -178,6 +190,18 @@ struct CaptureMetaData
   char driverName[1] = {0};
 };
 
+struct BinaryDictionary
+{
+  // hash of the dictionary contents, used to find it when it isn't embedded
+  uint64_t dictionaryID;
+  // the section type whose zstd compressed sections use this dictionary
+  SectionType sectionType;
+  // byte length of the embedded dictionary data. If 0 the dictionary is only referenced
+  uint32_t dictionaryLength;
+
+  // byte data[dictionaryLength];
+};
+
 struct BinarySectionHeader
 {
   // 0x0
@@ -218,6 +242,35 @@ struct BinarySectionHeader
     return;                       \
   }
 
+std::string CompressionDictionaryFilename(uint64_t id)
+{
+  return StringFormat::Fmt("%016llx.rdcdict", id);
+}
+
+static bytebuf LoadReferencedDictionary(uint64_t id)
+{
+  std::vector<std::string> paths;
+  split(RenderDoc::Inst().GetConfigSetting("capture.compressionDictionaryPaths"), paths, ';');
+
+  std::string filename = CompressionDictionaryFilename(id);
+
+  for(const std::string &path : paths)
+  {
+    std::vector<byte> data;
+    if(!FileIO::slurp((path + "/" + filename).c_str(), data))
+      continue;
+
+    bytebuf ret(data);
+    if(ZSTDDictionaryID(ret) == id)
+      return ret;
+
+    RDCWARN("Compression dictionary '%s' in %s doesn't match its ID", filename.c_str(),
+            path.c_str());
+  }
+
+  return bytebuf();
+}
+
 RDCFile::~RDCFile()
 {
   if(m_File)
@@ -315,7 +368,7 @@ void RDCFile::Init(StreamReader &reader)
 
   m_SerVer = header.version;
 
-  if(m_SerVer != SERIALISE_VERSION)
+  if(m_SerVer < V1_0_VERSION || m_SerVer > SERIALISE_VERSION)
   {
     if(header.version < V1_0_VERSION)
     {
@@ -397,6 +450,58 @@ void RDCFile::Init(StreamReader &reader)
   delete[] thumbData;
   delete[] driverName;
 
+  if(m_SerVer >= DICTIONARY_VERSION)
+  {
+    uint32_t numDictionaries = 0;
+    reader.Read(numDictionaries);
+
+    for(uint32_t i = 0; i < numDictionaries && !reader.IsErrored(); i++)
+    {
+      BinaryDictionary dictHeader;
+      reader.Read(dictHeader);
+
+      if(reader.IsErrored())
+        break;
+
+      // same sanity limit as the thumbnail, trained dictionaries are ~100KB
+      if(dictHeader.dictionaryLength > 10 * 1024 * 1024)
+      {
+        RETURNERROR(ContainerError::Corrupt, "Dictionary byte length invalid: %u",
+                    dictHeader.dictionaryLength);
+      }
+
+      CompressionDictionary &dict = m_Dictionaries[dictHeader.sectionType];
+      dict.id = dictHeader.dictionaryID;
+      dict.embedded = dictHeader.dictionaryLength > 0;
+
+      if(dict.embedded)
+      {
+        dict.data.resize(dictHeader.dictionaryLength);
+        reader.Read(dict.data.data(), dict.data.size());
+
+        if(!reader.IsErrored() && ZSTDDictionaryID(dict.data) != dict.id)
+        {
+          RETURNERROR(ContainerError::Corrupt, "Embedded dictionary for %s is corrupt",
+                      ToStr(dictHeader.sectionType).c_str());
+        }
+      }
+      else
+      {
+        dict.data = LoadReferencedDictionary(dict.id);
+
+        // not fatal - only the sections compressed with this dictionary are unreadable
+        if(dict.data.empty())
+          RDCWARN("Couldn't find compression dictionary %016llx used for %s", dict.id,
+                  ToStr(dictHeader.sectionType).c_str());
+      }
+    }
+
+    if(reader.IsErrored())
+    {
+      RETURNERROR(ContainerError::FileIO, "I/O error reading compression dictionaries");
+    }
+  }
+
   if(reader.GetOffset() > header.headerLength)
   {
     RETURNERROR(ContainerError::FileIO, "I/O error seeking to end of header");
@@ -620,6 +725,34 @@ void RDCFile::SetData(RDCDriver driver, const char *driverName, uint64_t machine
   }
 }
 
+void RDCFile::SetCompressionDictionary(SectionType type, const bytebuf &dictionary, bool embed)
+{
+  if(m_File)
+  {
+    RDCERR("Compression dictionaries must be set before the file header is written.");
+    return;
+  }
+
+  if(dictionary.empty())
+  {
+    m_Dictionaries.erase(type);
+    return;
+  }
+
+  CompressionDictionary &dict = m_Dictionaries[type];
+  dict.id = ZSTDDictionaryID(dictionary);
+  dict.embedded = embed;
+  dict.data = dictionary;
+}
+
+const bytebuf *RDCFile::GetCompressionDictionary(SectionType type) const
+{
+  auto it = m_Dictionaries.find(type);
+  if(it == m_Dictionaries.end() || it->second.data.empty())
+    return NULL;
+  return &it->second.data;
+}
+
 void RDCFile::Create(const char *filename)
 {
   m_File = FileIO::fopen(filename, "wb");
@@ -637,6 +770,10 @@ void RDCFile::Create(const char *filename)
 
   FileHeader header;    // automagically initialised with correct data apart from length
 
+  // only files that need the dictionary table are written with the version that added it
+  if(m_Dictionaries.empty())
+    header.version = V1_0_VERSION;
+
   BinaryThumbnail thumbHeader = {0};
 
   thumbHeader.width = m_Thumb.width;
@@ -651,6 +788,19 @@ void RDCFile::Create(const char *filename)
   header.headerLength = sizeof(FileHeader) + offsetof(BinaryThumbnail, data) + thumbHeader.length +
                         offsetof(CaptureMetaData, driverName) + meta.driverNameLength;
 
+  // only write a dictionary table when there are dictionaries, so files without any are unchanged
+  if(!m_Dictionaries.empty())
+  {
+    header.headerLength += sizeof(uint32_t);
+
+    for(auto it = m_Dictionaries.begin(); it != m_Dictionaries.end(); ++it)
+    {
+      header.headerLength += sizeof(BinaryDictionary);
+      if(it->second.embedded)
+        header.headerLength += (uint32_t)it->second.data.size();
+    }
+  }
+
   {
     StreamWriter writer(m_File, Ownership::Nothing);
 
@@ -664,6 +814,22 @@ void RDCFile::Create(const char *filename)
 
     writer.Write(m_DriverName.c_str(), meta.driverNameLength);
 
+    if(!m_Dictionaries.empty())
+    {
+      writer.Write((uint32_t)m_Dictionaries.size());
+
+      for(auto it = m_Dictionaries.begin(); it != m_Dictionaries.end(); ++it)
+      {
+        BinaryDictionary dictHeader;
+        dictHeader.dictionaryID = it->second.id;
+        dictHeader.sectionType = it->first;
+        dictHeader.dictionaryLength = it->second.embedded ? (uint32_t)it->second.data.size() : 0;
+
+        writer.Write(dictHeader);
+        writer.Write(it->second.data.data(), dictHeader.dictionaryLength);
+      }
+    }
+
     if(writer.IsErrored())
     {
       RETURNERROR(ContainerError::FileIO, "Error writing file header");
@@ -721,6 +887,18 @@ StreamReader *RDCFile::ReadSection(int index) const
 
   const SectionProperties &props = m_Sections[index];
   SectionLocation offsetSize = m_SectionLocations[index];
+
+  // a newer version may have stored the section in a way we can't decode
+  const SectionFlags knownFlags = SectionFlags::ASCIIStored | SectionFlags::LZ4Compressed |
+                                  SectionFlags::ZstdCompressed | SectionFlags::ZstdDictionary;
+
+  if(props.flags & ~knownFlags)
+  {
+    RDCERR("Section %s is stored with unsupported flags %x.", props.name.c_str(),
+           (uint32_t)props.flags);
+    return new StreamReader(StreamReader::InvalidStream);
+  }
+
   FileIO::fseek64(m_File, offsetSize.dataOffset, SEEK_SET);
 
   StreamReader *fileReader = new StreamReader(m_File, offsetSize.diskLength, Ownership::Nothing);
@@ -736,7 +914,22 @@ StreamReader *RDCFile::ReadSection(int index) const
   }
   else if(props.flags & SectionFlags::ZstdCompressed)
   {
-    compReader = new StreamReader(new ZSTDDecompressor(fileReader, Ownership::Stream),
+    const bytebuf *dict = NULL;
+
+    if(props.flags & SectionFlags::ZstdDictionary)
+    {
+      dict = GetCompressionDictionary(props.type);
+
+      if(dict == NULL)
+      {
+        RDCERR("Section %s is compressed with a dictionary that isn't available.",
+               props.name.c_str());
+        delete fileReader;
+        return new StreamReader(StreamReader::InvalidStream);
+      }
+    }
+
+    compReader = new StreamReader(new ZSTDDecompressor(fileReader, Ownership::Stream, dict),
                                   props.uncompressedSize, Ownership::Stream);
   }
 
@@ -801,6 +994,18 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
   std::string name = props.name;
   SectionType type = props.type;
 
+  // use the dictionary for this section type if there is one, regardless of where the properties
+  // came from. The flag may be set on properties copied from another file's section.
+  SectionFlags flags = props.flags & ~SectionFlags::ZstdDictionary;
+  const bytebuf *dict = NULL;
+
+  if(flags & SectionFlags::ZstdCompressed)
+  {
+    dict = GetCompressionDictionary(type);
+    if(dict)
+      flags |= SectionFlags::ZstdDictionary;
+  }
+
   // normalise names for known sections
   if(type != SectionType::Unknown && type < SectionType::Count)
     name = ToStr(type);
@@ -1031,7 +1236,7 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
                                 // sectionVersion
                                 props.version,
                                 // sectionFlags
-                                props.flags,
+                                flags,
                                 // sectionNameLength
                                 uint32_t(name.length() + 1)};
 
@@ -1059,14 +1264,15 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
   }
   else if(props.flags & SectionFlags::ZstdCompressed)
   {
-    compWriter =
-        new StreamWriter(new ZSTDCompressor(fileWriter, Ownership::Stream), Ownership::Stream);
+    compWriter = new StreamWriter(new ZSTDCompressor(fileWriter, Ownership::Stream, dict),
+                                  Ownership::Stream);
   }
 
   uint64_t dataOffset = FileIO::ftell64(m_File);
 
   m_CurrentWritingProps = props;
   m_CurrentWritingProps.name = name;
+  m_CurrentWritingProps.flags = flags;
 
   // register a destroy callback to tidy up the section at the end
   fileWriter->AddCloseCallback([this, type, name, headerOffset, dataOffset, fileWriter, compWriter]() {
@@ -1128,6 +1334,51 @@ StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
   return compWriter ? compWriter : fileWriter;
 }
 
+BlobStore *RDCFile::GetBlobStore()
+{
+  if(!m_BlobsLoaded)
+  {
+    m_BlobsLoaded = true;
+
+    int index = SectionIndex(SectionType::BlobStore);
+
+    if(index >= 0)
+    {
+      StreamReader *reader = ReadSection(index);
+
+      if(reader->IsErrored() || !m_Blobs.Read(*reader))
+        RDCERR("Failed to read blob store section");
+
+      delete reader;
+    }
+  }
+
+  return &m_Blobs;
+}
+
+void RDCFile::WriteBlobStore()
+{
+  if(m_Blobs.IsEmpty())
+    return;
+
+  // blobs are already individually compressed
+  SectionProperties props = {};
+  props.type = SectionType::BlobStore;
+  props.version = 1;
+  StreamWriter *writer = WriteSection(props);
+
+  m_Blobs.Write(*writer);
+
+  writer->Finish();
+
+  if(writer->IsErrored())
+    RDCERR("Failed to write blob store section");
+  else
+    RDCLOG("Blob store saved %llu bytes of duplicated data", m_Blobs.GetDuplicateBytes());
+
+  delete writer;
+}
+
 FILE *RDCFile::StealImageFileHandle(std::string &filename)
 {
   if(m_Driver != RDCDriver::Image)
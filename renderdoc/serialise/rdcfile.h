@@ -25,6 +25,7 @@
 #pragma once
 
 #include "core/core.h"
+#include "blobstore.h"
 #include "streamio.h"
 
 enum class ContainerError
@@ -38,6 +39,9 @@ enum class ContainerError
 
 extern const char *SectionTypeNames[];
 
+// the filename a compression dictionary is looked for under when it's referenced but not embedded
+std::string CompressionDictionaryFilename(uint64_t id);
+
 struct RDCThumb
 {
   const byte *pixels = NULL;
@@ -52,12 +56,16 @@ public:
   // version number of overall file format or chunk organisation. If the contents/meaning/order of
   // chunks have changed this does not need to be bumped, there are version numbers within each
   // API that interprets the stream that can be bumped.
-  static const uint32_t SERIALISE_VERSION = 0x00000100;
+  static const uint32_t SERIALISE_VERSION = 0x00000101;
 
   // this must never be changed - files before this were in the v0.x series and didn't have embedded
   // version numbers
   static const uint32_t V1_0_VERSION = 0x00000100;
 
+  // added the table of compression dictionaries to the header. Files that don't use any are still
+  // written as V1_0_VERSION so that older builds can open them.
+  static const uint32_t DICTIONARY_VERSION = 0x00000101;
+
   ~RDCFile();
 
   // opens an existing file for read and/or modification. Error if file doesn't exist
@@ -70,6 +78,11 @@ public:
   void SetData(RDCDriver driver, const char *driverName, uint64_t machineIdent,
                const RDCThumb *thumb);
 
+  // Sets a trained zstd dictionary to use for any zstd compressed sections of the given type. Must
+  // be called before Create(). If the dictionary isn't embedded only its ID is written, and it must
+  // be found in one of the capture.compressionDictionaryPaths when the file is read.
+  void SetCompressionDictionary(SectionType type, const bytebuf &dictionary, bool embed);
+
   // creates a new file with current properties, file will be overwritten if it already exists
   void Create(const char *filename);
 
@@ -79,6 +92,7 @@ public:
   const std::string &GetDriverName() const { return m_DriverName; }
   uint64_t GetMachineIdent() const { return m_MachineIdent; }
   const RDCThumb &GetThumbnail() const { return m_Thumb; }
+  const bytebuf *GetCompressionDictionary(SectionType type) const;
   int SectionIndex(SectionType type) const;
   int SectionIndex(const char *name) const;
   int NumSections() const { return int(m_Sections.size()); }
@@ -86,6 +100,12 @@ public:
   StreamReader *ReadSection(int index) const;
   StreamWriter *WriteSection(const SectionProperties &props);
 
+  // large byte buffers shared by serialisers reading or writing this file's sections. When reading
+  // it's loaded from the file on first use, when writing it must be written out with
+  // WriteBlobStore() once all other serialisation is done.
+  BlobStore *GetBlobStore();
+  void WriteBlobStore();
+
   // Only valid if GetDriver returns RDCDriver::Image, passes over the underlying FILE * for use
   // loading the image directly, since the RDC container isn't there to read from a section.
   FILE *StealImageFileHandle(std::string &filename);
@@ -106,6 +126,18 @@ private:
   uint64_t m_MachineIdent = 0;
   RDCThumb m_Thumb;
 
+  struct CompressionDictionary
+  {
+    uint64_t id = 0;
+    bool embedded = true;
+    bytebuf data;
+  };
+
+  std::map<SectionType, CompressionDictionary> m_Dictionaries;
+
+  BlobStore m_Blobs;
+  bool m_BlobsLoaded = false;
+
   ContainerError m_Error = ContainerError::NoError;
   std::string m_ErrorString;
 
@@ -378,12 +378,13 @@ void Serialiser<SerialiserMode::Writing>::EndChunk()
     {
       uint64_t numPadBytes = m_ChunkMetadata.length - writtenLength;
 
-      // need to write some padding bytes so that the length is accurate
-      for(uint64_t i = 0; i < numPadBytes; i++)
-      {
-        byte padByte = 0xbb;
-        m_Write->Write(padByte);
-      }
+      // need to write some padding bytes so that the length is accurate. This can be large when
+      // byte buffers were moved to the blob store, so write it in blocks
+      byte padBytes[256];
+      memset(padBytes, 0xbb, sizeof(padBytes));
+
+      for(uint64_t i = 0; i < numPadBytes; i += sizeof(padBytes))
+        m_Write->Write(padBytes, RDCMIN(numPadBytes - i, (uint64_t)sizeof(padBytes)));
 
       RDCDEBUG("Chunk estimated at %u bytes, actual length %llu. Added %llu bytes padding.",
                m_ChunkMetadata.length, writtenLength, numPadBytes);
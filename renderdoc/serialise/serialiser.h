@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
+#include "blobstore.h"
 #include "streamio.h"
 
 // function to deallocate anything from a serialise. Default impl
@@ -123,6 +124,9 @@ public:
   void *GetUserData() { return m_pUserData; }
   void SetUserData(void *userData) { m_pUserData = userData; }
   void SetStringDatabase(std::set<std::string> *db) { m_ExtStringDB = db; }
+  // large byte buffers are stored in/expanded from this store instead of inline in the stream
+  void SetBlobStore(BlobStore *blobs) { m_Blobs = blobs; }
+  BlobStore *GetBlobStore() const { return m_Blobs; }
   // jumps to the byte after the current chunk, can be called any time after BeginChunk
   void SkipCurrentChunk();
 
@@ -227,15 +231,39 @@ public:
     if(IsWriting() && el == NULL)
       byteSize = 0;
 
+    // large buffers are stored once in the blob store and only referenced here by hash. This
+    // always happens when there's a store, so chunk size estimates can count only the hash.
+    uint64_t serialisedSize = byteSize;
+    uint64_t blobHash = 0;
+    if(IsWriting() && m_Blobs && byteSize >= BlobStore::MinimumSize)
+    {
+      blobHash = m_Blobs->Add(el, byteSize);
+      serialisedSize |= BlobStore::ReferenceFlag;
+    }
+
+    {
+      m_InternalElement = true;
+      DoSerialise(*this, serialisedSize);
+      m_InternalElement = false;
+    }
+
+    bool blobRef = (serialisedSize & BlobStore::ReferenceFlag) != 0;
+
+    byteSize = serialisedSize & ~BlobStore::ReferenceFlag;
+
+    if(blobRef)
     {
       m_InternalElement = true;
-      DoSerialise(*this, byteSize);
+      DoSerialise(*this, blobHash);
       m_InternalElement = false;
     }
 
     if(IsReading())
     {
-      VerifyArraySize(byteSize);
+      if(blobRef)
+        blobRef = VerifyBlobReference(blobHash, byteSize);
+      else
+        VerifyArraySize(byteSize);
     }
 
     if(ExportStructure())
@@ -262,18 +290,23 @@ public:
     {
       if(IsWriting())
       {
-        // ensure byte alignment
-        m_Write->AlignTo<ChunkAlignment>();
+        // blob references have their data in the blob store, nothing to write inline
+        if(!blobRef)
+        {
+          // ensure byte alignment
+          m_Write->AlignTo<ChunkAlignment>();
 
-        if(el)
-          m_Write->Write(el, byteSize);
-        else
-          RDCASSERT(byteSize == 0);
+          if(el)
+            m_Write->Write(el, byteSize);
+          else
+            RDCASSERT(byteSize == 0);
+        }
       }
       else if(IsReading())
       {
-        // ensure byte alignment
-        m_Read->AlignTo<ChunkAlignment>();
+        // ensure byte alignment, unless the data is in the blob store
+        if(!blobRef)
+          m_Read->AlignTo<ChunkAlignment>();
 
 // Coverity is unable to tie this allocation together with the automatic scoped deallocation in the
 // ScopedDeseralise* classes. We can verify with e.g. valgrind that there are no leaks, so to keep
@@ -299,7 +332,15 @@ public:
         }
 #endif
 
-        m_Read->Read(el, byteSize);
+        if(blobRef)
+        {
+          if(el && !m_Blobs->Fetch(blobHash, el, byteSize))
+            InvalidateReadStream();
+        }
+        else
+        {
+          m_Read->Read(el, byteSize);
+        }
       }
     }
 
@@ -1216,8 +1257,6 @@ public:
       m_InternalElement = false;
     }
 
-    size_t byteSize = (size_t)totalSize;
-
     byte *structBuf = NULL;
 
     if(ExportStructure())
@@ -1267,7 +1306,7 @@ public:
       if(totalSize % (uint64_t)bufSize > 0)
         numBufs++;
 
-      byte *buf = new byte[byteSize];
+      byte *buf = new byte[(size_t)bufSize];
 
       if(progress)
         progress(0.0001f);
@@ -1559,19 +1598,37 @@ private:
       RDCERR("Reading invalid array or byte buffer - %llu larger than total stream size %llu.",
              count, size);
 
-      // if we owned the previous stream, delete it
-      if(m_Ownership == Ownership::Stream)
-        delete m_Read;
-
-      // replace our stream with an invalid one so all subsequent reads fail
-      m_Read = new StreamReader(StreamReader::InvalidStream);
-      m_Ownership = Ownership::Stream;
+      InvalidateReadStream();
 
       // set the count to 0
       count = 0;
     }
   }
 
+  bool VerifyBlobReference(uint64_t hash, uint64_t &size)
+  {
+    if(m_Blobs && m_Blobs->Contains(hash, size))
+      return true;
+
+    RDCERR("Reading byte buffer referencing missing blob %016llx of %llu bytes.", hash, size);
+
+    InvalidateReadStream();
+
+    size = 0;
+    return false;
+  }
+
+  void InvalidateReadStream()
+  {
+    // if we owned the previous stream, delete it
+    if(m_Ownership == Ownership::Stream)
+      delete m_Read;
+
+    // replace our stream with an invalid one so all subsequent reads fail
+    m_Read = new StreamReader(StreamReader::InvalidStream);
+    m_Ownership = Ownership::Stream;
+  }
+
   void *m_pUserData = NULL;
   uint64_t m_Version = 0;
 
@@ -1606,6 +1663,9 @@ private:
   // external storage - so the string storage can persist after the lifetime of the serialiser
   std::set<std::string> *m_ExtStringDB = NULL;
 
+  // external storage for large byte buffers, if set
+  BlobStore *m_Blobs = NULL;
+
   const char *StringDB(const std::string &s)
   {
     if(m_ExtStringDB)
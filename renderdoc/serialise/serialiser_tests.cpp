@@ -1317,4 +1317,288 @@ TEST_CASE("Read/write complex types", "[serialiser][structured]")
   delete buf;
 };
 
+TEST_CASE("Chunk size estimates account for blob references", "[serialiser][blobs]")
+{
+  bytebuf data;
+  data.resize((size_t)BlobStore::MinimumSize * 16);
+
+  BlobStore blobs;
+
+  CHECK(BlobStore::GetSerialisedSize(NULL, data.size()) == data.size());
+  CHECK(BlobStore::GetSerialisedSize(&blobs, 64) == 64);
+  CHECK(BlobStore::GetSerialisedSize(&blobs, data.size()) == sizeof(uint64_t));
+
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  {
+    WriteSerialiser ser(buf, Ownership::Nothing);
+
+    ser.SetBlobStore(&blobs);
+
+    uint64_t size = 64 + BlobStore::GetSerialisedSize(&blobs, data.size()) +
+                    WriteSerialiser::GetChunkAlignment();
+
+    SCOPED_SERIALISE_CHUNK(5, size);
+
+    byte *a = data.data();
+    ser.Serialise("data", a, data.size());
+  }
+
+  // the chunk is only padded up to the estimate, not the size of the data in the store
+  CHECK(buf->GetOffset() < 256);
+
+  delete buf;
+};
+
+TEST_CASE("Blob hash collisions are stored under a different hash", "[serialiser][blobs]")
+{
+  bytebuf zeroes, pattern;
+  zeroes.resize((size_t)BlobStore::MinimumSize * 4);
+  pattern.resize(zeroes.size());
+
+  for(size_t i = 0; i < pattern.size(); i++)
+    pattern[i] = byte(i * 7);
+
+  uint64_t zeroHash = 0;
+  {
+    BlobStore tmp;
+    zeroHash = tmp.Add(zeroes.data(), zeroes.size());
+  }
+
+  // fake a collision by writing a store holding the pattern under the zeroes' hash
+  BlobStore colliding;
+  {
+    BlobStore patternStore;
+    patternStore.Add(pattern.data(), pattern.size());
+
+    StreamWriter writer(StreamWriter::DefaultScratchSize);
+    REQUIRE(patternStore.Write(writer));
+
+    bytebuf section;
+    section.append(writer.GetData(), (size_t)writer.GetOffset());
+
+    // the first blob's hash follows the blob count
+    memcpy(section.data() + sizeof(uint64_t), &zeroHash, sizeof(zeroHash));
+
+    StreamReader reader(section.data(), section.size());
+    REQUIRE(colliding.Read(reader));
+  }
+
+  REQUIRE(colliding.Contains(zeroHash, pattern.size()));
+
+  uint64_t hash = colliding.Add(zeroes.data(), zeroes.size());
+  CHECK(hash != zeroHash);
+
+  // adding it again finds it under the same hash
+  CHECK(colliding.Add(zeroes.data(), zeroes.size()) == hash);
+  CHECK(colliding.GetDuplicateBytes() == zeroes.size());
+
+  bytebuf fetched;
+  fetched.resize(zeroes.size());
+
+  REQUIRE(colliding.Fetch(hash, fetched.data(), fetched.size()));
+  CHECK(fetched == zeroes);
+
+  REQUIRE(colliding.Fetch(zeroHash, fetched.data(), fetched.size()));
+  CHECK(fetched == pattern);
+
+  // the colliding buffer is still only referenced, so it stays within the chunk size estimate
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  {
+    WriteSerialiser ser(buf, Ownership::Nothing);
+
+    ser.SetBlobStore(&colliding);
+
+    uint64_t size = 64 + BlobStore::GetSerialisedSize(&colliding, zeroes.size()) +
+                    WriteSerialiser::GetChunkAlignment();
+
+    SCOPED_SERIALISE_CHUNK(5, size);
+
+    byte *a = zeroes.data();
+    ser.Serialise("data", a, zeroes.size());
+  }
+
+  CHECK(buf->GetOffset() < 256);
+
+  delete buf;
+};
+
+TEST_CASE("Read/write byte buffers through a blob store", "[serialiser][blobs]")
+{
+  const uint64_t bigSize = BlobStore::MinimumSize * 16;
+
+  bytebuf zeroes, pattern, small;
+  zeroes.resize((size_t)bigSize);
+  pattern.resize((size_t)bigSize);
+  small.resize(64);
+
+  for(size_t i = 0; i < pattern.size(); i++)
+    pattern[i] = byte((i * 7) ^ (i >> 8));
+  for(size_t i = 0; i < small.size(); i++)
+    small[i] = byte(i);
+
+  const int numChunks = 4;
+
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+  BlobStore blobs;
+
+  {
+    WriteSerialiser ser(buf, Ownership::Nothing);
+
+    ser.SetBlobStore(&blobs);
+
+    for(int i = 0; i < numChunks; i++)
+    {
+      SCOPED_SERIALISE_CHUNK(5);
+
+      byte *a = zeroes.data();
+      byte *b = pattern.data();
+      byte *c = small.data();
+
+      ser.Serialise("zeroes", a, bigSize);
+      ser.Serialise("pattern", b, bigSize);
+      ser.Serialise("small", c, small.size());
+    }
+
+    REQUIRE_FALSE(ser.IsErrored());
+  }
+
+  // only the small buffers and the references are written inline
+  CHECK(buf->GetOffset() < bigSize);
+  CHECK(blobs.GetDuplicateBytes() == bigSize * 2 * (numChunks - 1));
+
+  // round-trip the store through its section format. Each buffer is only stored once
+  StreamWriter blobWriter(StreamWriter::DefaultScratchSize);
+  REQUIRE(blobs.Write(blobWriter));
+  CHECK(blobWriter.GetOffset() < bigSize * 2);
+
+  BlobStore readBlobs;
+  {
+    StreamReader reader(blobWriter.GetData(), blobWriter.GetOffset());
+    REQUIRE(readBlobs.Read(reader));
+  }
+
+  SECTION("Read with the blob store")
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+    ser.SetBlobStore(&readBlobs);
+
+    for(int i = 0; i < numChunks; i++)
+    {
+      REQUIRE(ser.ReadChunk<uint32_t>() == 5);
+
+      byte *a = NULL, *b = NULL, *c = NULL;
+
+      ser.Serialise("zeroes", a, bigSize, SerialiserFlags::AllocateMemory);
+      ser.Serialise("pattern", b, bigSize, SerialiserFlags::AllocateMemory);
+      ser.Serialise("small", c, small.size(), SerialiserFlags::AllocateMemory);
+
+      ser.EndChunk();
+
+      REQUIRE_FALSE(ser.IsErrored());
+
+      REQUIRE(a);
+      REQUIRE(b);
+      REQUIRE(c);
+      CHECK(memcmp(a, zeroes.data(), zeroes.size()) == 0);
+      CHECK(memcmp(b, pattern.data(), pattern.size()) == 0);
+      CHECK(memcmp(c, small.data(), small.size()) == 0);
+
+      FreeAlignedBuffer(a);
+      FreeAlignedBuffer(b);
+      FreeAlignedBuffer(c);
+    }
+
+    CHECK(ser.GetReader()->AtEnd());
+  }
+
+  SECTION("Merging blob stores")
+  {
+    BlobStore merged;
+
+    merged.Add(zeroes.data(), zeroes.size());
+
+    REQUIRE(merged.Merge(readBlobs));
+
+    // the zeroes were already present, only the pattern is added
+    CHECK(merged.GetDuplicateBytes() == bigSize);
+
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+    ser.SetBlobStore(&merged);
+
+    REQUIRE(ser.ReadChunk<uint32_t>() == 5);
+
+    byte *a = NULL, *b = NULL;
+
+    ser.Serialise("zeroes", a, bigSize, SerialiserFlags::AllocateMemory);
+    ser.Serialise("pattern", b, bigSize, SerialiserFlags::AllocateMemory);
+
+    REQUIRE_FALSE(ser.IsErrored());
+
+    REQUIRE(a);
+    REQUIRE(b);
+    CHECK(memcmp(a, zeroes.data(), zeroes.size()) == 0);
+    CHECK(memcmp(b, pattern.data(), pattern.size()) == 0);
+
+    FreeAlignedBuffer(a);
+    FreeAlignedBuffer(b);
+  }
+
+  SECTION("Structured export expands blob references")
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+    ser.SetBlobStore(&readBlobs);
+
+    ChunkLookup testChunkLoop = [](uint32_t) -> std::string { return "TestChunk"; };
+
+    ser.ConfigureStructuredExport(testChunkLoop, true);
+
+    ser.ReadChunk<uint32_t>();
+
+    byte *a = NULL, *b = NULL;
+
+    ser.Serialise("zeroes", a, bigSize);
+    ser.Serialise("pattern", b, bigSize);
+
+    ser.EndChunk();
+
+    REQUIRE_FALSE(ser.IsErrored());
+
+    const SDFile &structData = ser.GetStructuredFile();
+
+    REQUIRE(structData.chunks.size() == 1);
+
+    const SDObject &chunk = *structData.chunks[0];
+
+    REQUIRE(chunk.data.children.size() == 2);
+    CHECK(chunk.data.children[1]->type.basetype == SDBasic::Buffer);
+    CHECK(chunk.data.children[1]->type.byteSize == bigSize);
+
+    size_t bufIndex = (size_t)chunk.data.children[1]->data.basic.u;
+
+    REQUIRE(bufIndex < structData.buffers.size());
+    CHECK(*structData.buffers[bufIndex] == pattern);
+  }
+
+  SECTION("Reading without the blob store fails")
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+
+    ser.ReadChunk<uint32_t>();
+
+    byte *a = NULL;
+
+    ser.Serialise("zeroes", a, bigSize, SerialiserFlags::AllocateMemory);
+
+    CHECK(ser.IsErrored());
+    CHECK(a == NULL);
+  }
+
+  delete buf;
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
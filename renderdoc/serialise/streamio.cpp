@@ -492,6 +492,59 @@ void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_Progre
 {
   uint64_t totalSize = reader->GetSize();
 
+  // a file going to a socket can be sent directly without copying it through our buffers
+  if(writer->m_Sock && reader->m_File)
+  {
+    // first send anything that's already been read into the reader's buffer. The file position is
+    // always just past the last byte that was buffered.
+    uint64_t buffered = RDCMIN(reader->Available(), reader->GetSize() - reader->GetOffset());
+    buffered = RDCMIN(buffered, totalSize);
+
+    uint64_t fileOffset = FileIO::ftell64(reader->m_File);
+
+    if(progress)
+      progress(0.0001f);
+
+    writer->Write(reader->m_BufferHead, buffered);
+    reader->Read(NULL, buffered);
+
+    totalSize -= buffered;
+
+    if(!writer->FlushSocketData())
+      return;
+
+    // send in large chunks only so that we can report progress
+    const uint64_t FileChunkSize = 16 * 1024 * 1024;
+
+    uint64_t remaining = totalSize;
+
+    while(remaining > 0)
+    {
+      uint64_t chunkSize = RDCMIN(FileChunkSize, remaining);
+
+      if(!writer->m_Sock->SendFileBlocking(reader->m_File, fileOffset, chunkSize))
+      {
+        writer->HandleError();
+        return;
+      }
+
+      writer->m_WriteSize += chunkSize;
+      fileOffset += chunkSize;
+      remaining -= chunkSize;
+
+      if(progress)
+        progress(float(totalSize - remaining) / float(totalSize));
+    }
+
+    // the file's position wasn't moved, so skip the reader past everything we sent
+    reader->SkipBytes(totalSize);
+
+    if(progress)
+      progress(1.0f);
+
+    return;
+  }
+
   // copy 1MB at a time
   const uint64_t StreamIOChunkSize = 1024 * 1024;
 
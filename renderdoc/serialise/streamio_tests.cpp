@@ -303,6 +303,84 @@ TEST_CASE("Test stream I/O operations over the network", "[streamio][network]")
     CHECK(writer.IsErrored());
   };
 
+  SECTION("Transfer file contents")
+  {
+    std::string filename = FileIO::GetTempFolderFilename() + "renderdoc_streamio_test.bin";
+
+    // larger than the file reader's window, and not a multiple of any chunk size
+    std::vector<byte> contents(3 * 1024 * 1024 + 123);
+    for(size_t i = 0; i < contents.size(); i++)
+      contents[i] = byte((i * 7) ^ (i >> 9));
+
+    {
+      FILE *f = FileIO::fopen(filename.c_str(), "wb");
+      REQUIRE(f);
+      FileIO::fwrite(contents.data(), 1, contents.size(), f);
+      FileIO::fclose(f);
+    }
+
+    StreamWriter writer(sender, Ownership::Nothing);
+    StreamReader reader(receiver, Ownership::Nothing);
+
+    StreamReader fileReader(FileIO::fopen(filename.c_str(), "rb"));
+
+    REQUIRE_FALSE(fileReader.IsErrored());
+
+    std::vector<byte> receivedContents(contents.size());
+    uint32_t receivedHeader = 0, receivedFooter = 0;
+
+    volatile int32_t threadA = 0, threadB = 0;
+
+    Threading::ThreadHandle recvThread = Threading::CreateThread([&]() {
+      reader.Read(receivedHeader);
+      reader.Read(receivedContents.data(), receivedContents.size());
+      reader.Read(receivedFooter);
+
+      Atomic::Inc32(&threadA);
+    });
+
+    Threading::ThreadHandle sendThread = Threading::CreateThread([&]() {
+      // data buffered in the writer must be sent before the file contents
+      writer.Write<uint32_t>(0xf00dcafe);
+      StreamTransfer(&writer, &fileReader, NULL);
+      writer.Write<uint32_t>(0xdeadbeef);
+      writer.Flush();
+
+      Atomic::Inc32(&threadB);
+    });
+
+    // wait up to 5 seconds for the threads to exit
+    for(int i = 0; i < 5000 / 50; i++)
+    {
+      Threading::Sleep(50);
+      if(threadA && threadB)
+        break;
+    }
+
+    REQUIRE(threadA);
+    REQUIRE(threadB);
+
+    Threading::JoinThread(sendThread);
+    Threading::CloseThread(sendThread);
+
+    Threading::JoinThread(recvThread);
+    Threading::CloseThread(recvThread);
+
+    CHECK_FALSE(writer.IsErrored());
+    CHECK_FALSE(reader.IsErrored());
+    CHECK_FALSE(fileReader.IsErrored());
+
+    CHECK(writer.GetOffset() == contents.size() + sizeof(uint32_t) * 2);
+    CHECK(fileReader.GetOffset() == contents.size());
+    CHECK(fileReader.AtEnd());
+
+    CHECK(receivedHeader == 0xf00dcafe);
+    CHECK(receivedFooter == 0xdeadbeef);
+    CHECK(receivedContents == contents);
+
+    FileIO::Delete(filename.c_str());
+  };
+
   delete sender;
   delete receiver;
   delete server;
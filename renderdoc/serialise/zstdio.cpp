@@ -24,11 +24,176 @@
 
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstdio.h"
+#include <algorithm>
+#include <queue>
+#include "zstd/xxhash.h"
 
 static const uint64_t zstdBlockSize = 128 * 1024;
 static const uint64_t compressBlockSize = ZSTD_compressBound(zstdBlockSize);
+static const int zstdCompressionLevel = 7;
 
-ZSTDCompressor::ZSTDCompressor(StreamWriter *write, Ownership own) : Compressor(write, own)
+uint64_t ZSTDDictionaryID(const bytebuf &dictionary)
+{
+  return XXH64(dictionary.data(), dictionary.size(), 0);
+}
+
+ZSTDDictionaryTrainer::ZSTDDictionaryTrainer(uint32_t maxDictSize)
+{
+  m_MaxDictSize = maxDictSize;
+
+  // keep enough candidates to have a reasonable choice for each segment in the dictionary
+  m_MaxCandidates = RDCMAX(1U, maxDictSize / SegmentSize) * 16;
+
+  m_Counts.resize(1U << CountTableBits);
+  m_Candidates.reserve(m_MaxCandidates * SegmentSize);
+}
+
+static uint32_t HashDmer(const byte *dmer, uint32_t bits)
+{
+  uint64_t val;
+  memcpy(&val, dmer, sizeof(val));
+  return uint32_t((val * 0xCF1BBCDCB7A56463ULL) >> (64 - bits));
+}
+
+void ZSTDDictionaryTrainer::AddSample(const void *data, uint64_t numBytes)
+{
+  const byte *src = (const byte *)data;
+
+  // finish off any segment left partially filled by the last sample
+  if(m_PartialSize > 0)
+  {
+    uint32_t partialBytes = (uint32_t)RDCMIN(uint64_t(SegmentSize - m_PartialSize), numBytes);
+    memcpy(m_Partial + m_PartialSize, src, partialBytes);
+
+    m_PartialSize += partialBytes;
+    numBytes -= partialBytes;
+    src += partialBytes;
+
+    if(m_PartialSize < SegmentSize)
+      return;
+
+    AddSegment(m_Partial);
+    m_PartialSize = 0;
+  }
+
+  while(numBytes >= SegmentSize)
+  {
+    AddSegment(src);
+    numBytes -= SegmentSize;
+    src += SegmentSize;
+  }
+
+  memcpy(m_Partial, src, (size_t)numBytes);
+  m_PartialSize = (uint32_t)numBytes;
+}
+
+void ZSTDDictionaryTrainer::AddSegment(const byte *segment)
+{
+  // count every d-mer in the segment. Runs of the same d-mer (e.g. zero-filled memory) are only
+  // counted once, they compress perfectly well without any help from the dictionary.
+  uint32_t prev = ~0U;
+  for(uint32_t i = 0; i + DmerSize <= SegmentSize; i++)
+  {
+    uint32_t hash = HashDmer(segment + i, CountTableBits);
+    if(hash != prev && m_Counts[hash] != ~0U)
+      m_Counts[hash]++;
+    prev = hash;
+  }
+
+  // reservoir sample the segment as a dictionary candidate
+  m_SeenSegments++;
+
+  size_t slot = m_Candidates.size() / SegmentSize;
+
+  if(slot >= m_MaxCandidates)
+  {
+    // xorshift, we don't need anything better and this keeps training deterministic
+    m_Random ^= m_Random << 13;
+    m_Random ^= m_Random >> 7;
+    m_Random ^= m_Random << 17;
+
+    slot = size_t(m_Random % m_SeenSegments);
+
+    if(slot >= m_MaxCandidates)
+      return;
+
+    memcpy(m_Candidates.data() + slot * SegmentSize, segment, SegmentSize);
+  }
+  else
+  {
+    m_Candidates.append(segment, SegmentSize);
+  }
+}
+
+uint64_t ZSTDDictionaryTrainer::ScoreSegment(const byte *segment,
+                                             std::vector<uint32_t> &dmers) const
+{
+  dmers.clear();
+  for(uint32_t i = 0; i + DmerSize <= SegmentSize; i++)
+    dmers.push_back(HashDmer(segment + i, CountTableBits));
+
+  // each distinct d-mer only contributes once, repeating it within the dictionary doesn't help
+  std::sort(dmers.begin(), dmers.end());
+  dmers.erase(std::unique(dmers.begin(), dmers.end()), dmers.end());
+
+  uint64_t score = 0;
+  for(uint32_t hash : dmers)
+    score += m_Counts[hash];
+  return score;
+}
+
+bytebuf ZSTDDictionaryTrainer::Train()
+{
+  const uint32_t numCandidates = uint32_t(m_Candidates.size() / SegmentSize);
+
+  std::vector<uint32_t> dmers;
+  dmers.reserve(SegmentSize);
+
+  // scores only ever decrease as d-mers get covered, so we can pick lazily: a candidate popped off
+  // the queue is re-scored and only accepted if it still beats the next best stale score.
+  std::priority_queue<std::pair<uint64_t, uint32_t>> queue;
+  for(uint32_t i = 0; i < numCandidates; i++)
+    queue.push(std::make_pair(ScoreSegment(m_Candidates.data() + i * SegmentSize, dmers), i));
+
+  std::vector<uint32_t> picked;
+  uint32_t dictSize = 0;
+
+  while(!queue.empty() && dictSize + SegmentSize <= m_MaxDictSize)
+  {
+    std::pair<uint64_t, uint32_t> best = queue.top();
+    queue.pop();
+
+    const byte *segment = m_Candidates.data() + best.second * SegmentSize;
+    uint64_t score = ScoreSegment(segment, dmers);
+
+    if(score == 0)
+      continue;
+
+    if(!queue.empty() && score < queue.top().first)
+    {
+      queue.push(std::make_pair(score, best.second));
+      continue;
+    }
+
+    picked.push_back(best.second);
+    dictSize += SegmentSize;
+
+    for(uint32_t hash : dmers)
+      m_Counts[hash] = 0;
+  }
+
+  // zstd finds matches at small offsets more cheaply, so the most valuable segments go at the end
+  // of the dictionary, nearest to the data being compressed.
+  bytebuf ret;
+  ret.reserve(dictSize);
+  for(size_t i = picked.size(); i > 0; i--)
+    ret.append(m_Candidates.data() + picked[i - 1] * SegmentSize, SegmentSize);
+
+  return ret;
+}
+
+ZSTDCompressor::ZSTDCompressor(StreamWriter *write, Ownership own, const bytebuf *dictionary)
+    : Compressor(write, own)
 {
   m_Page = AllocAlignedBuffer(zstdBlockSize);
   m_CompressBuffer = AllocAlignedBuffer(compressBlockSize);
@@ -36,11 +201,16 @@ ZSTDCompressor::ZSTDCompressor(StreamWriter *write, Ownership own) : Compressor(
   m_PageOffset = 0;
 
   m_Stream = ZSTD_createCStream();
+
+  // the dictionary is digested once up front, rather than for every page
+  if(dictionary && !dictionary->empty())
+    m_Dict = ZSTD_createCDict(dictionary->data(), dictionary->size(), zstdCompressionLevel);
 }
 
 ZSTDCompressor::~ZSTDCompressor()
 {
   ZSTD_freeCStream(m_Stream);
+  ZSTD_freeCDict(m_Dict);
 
   FreeAlignedBuffer(m_Page);
   FreeAlignedBuffer(m_CompressBuffer);
@@ -145,7 +315,8 @@ bool ZSTDCompressor::FlushPage()
 
 bool ZSTDCompressor::CompressZSTDFrame(ZSTD_inBuffer &in, ZSTD_outBuffer &out)
 {
-  size_t err = ZSTD_initCStream(m_Stream, 7);
+  size_t err = m_Dict ? ZSTD_initCStream_usingCDict(m_Stream, m_Dict)
+                      : ZSTD_initCStream(m_Stream, zstdCompressionLevel);
 
   if(ZSTD_isError(err))
   {
@@ -194,7 +365,8 @@ bool ZSTDCompressor::CompressZSTDFrame(ZSTD_inBuffer &in, ZSTD_outBuffer &out)
   return true;
 }
 
-ZSTDDecompressor::ZSTDDecompressor(StreamReader *read, Ownership own) : Decompressor(read, own)
+ZSTDDecompressor::ZSTDDecompressor(StreamReader *read, Ownership own, const bytebuf *dictionary)
+    : Decompressor(read, own)
 {
   m_Page = AllocAlignedBuffer(zstdBlockSize);
   m_CompressBuffer = AllocAlignedBuffer(compressBlockSize);
@@ -203,11 +375,15 @@ ZSTDDecompressor::ZSTDDecompressor(StreamReader *read, Ownership own) : Decompre
   m_PageLength = 0;
 
   m_Stream = ZSTD_createDStream();
+
+  if(dictionary && !dictionary->empty())
+    m_Dict = ZSTD_createDDict(dictionary->data(), dictionary->size());
 }
 
 ZSTDDecompressor::~ZSTDDecompressor()
 {
   ZSTD_freeDStream(m_Stream);
+  ZSTD_freeDDict(m_Dict);
   FreeAlignedBuffer(m_Page);
   FreeAlignedBuffer(m_CompressBuffer);
 }
@@ -303,7 +479,7 @@ bool ZSTDDecompressor::FillPage()
     return false;
   }
 
-  size_t err = ZSTD_initDStream(m_Stream);
+  size_t err = m_Dict ? ZSTD_initDStream_usingDDict(m_Stream, m_Dict) : ZSTD_initDStream(m_Stream);
 
   if(ZSTD_isError(err))
   {
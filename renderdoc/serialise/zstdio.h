@@ -27,10 +27,49 @@
 #include "zstd/zstd.h"
 #include "streamio.h"
 
+// identifies a compression dictionary by its contents, so files can reference a dictionary that
+// isn't embedded in them.
+uint64_t ZSTDDictionaryID(const bytebuf &dictionary);
+
+// builds a raw content dictionary from a stream of sample data. Data is cut into fixed size
+// segments, the frequency of every short substring (d-mer) is counted across all data, and a
+// bounded random reservoir of segments is kept as candidates. Training then greedily picks the
+// candidates covering the most frequent d-mers not already covered, similar to zstd's COVER
+// algorithm but with memory use independent of the amount of sample data.
+class ZSTDDictionaryTrainer
+{
+public:
+  ZSTDDictionaryTrainer(uint32_t maxDictSize);
+
+  // can be called repeatedly with successive pieces of the same or different streams
+  void AddSample(const void *data, uint64_t numBytes);
+  bytebuf Train();
+
+private:
+  static const uint32_t SegmentSize = 256;
+  static const uint32_t DmerSize = 8;
+  static const uint32_t CountTableBits = 20;
+
+  void AddSegment(const byte *segment);
+  uint64_t ScoreSegment(const byte *segment, std::vector<uint32_t> &dmers) const;
+
+  uint32_t m_MaxDictSize;
+  uint32_t m_MaxCandidates;
+  uint64_t m_SeenSegments = 0;
+  uint64_t m_Random = 0x9E3779B97F4A7C15ULL;
+
+  std::vector<uint32_t> m_Counts;
+  bytebuf m_Candidates;
+
+  byte m_Partial[SegmentSize];
+  uint32_t m_PartialSize = 0;
+};
+
 class ZSTDCompressor : public Compressor
 {
 public:
-  ZSTDCompressor(StreamWriter *write, Ownership own);
+  // if a dictionary is given it's copied, so it doesn't need to outlive the compressor
+  ZSTDCompressor(StreamWriter *write, Ownership own, const bytebuf *dictionary = NULL);
   ~ZSTDCompressor();
 
   bool Write(const void *data, uint64_t numBytes);
@@ -46,12 +85,14 @@ private:
   uint64_t m_PageOffset;
 
   ZSTD_CStream *m_Stream;
+  ZSTD_CDict *m_Dict = NULL;
 };
 
 class ZSTDDecompressor : public Decompressor
 {
 public:
-  ZSTDDecompressor(StreamReader *read, Ownership own);
+  // if a dictionary is given it's copied, so it doesn't need to outlive the decompressor
+  ZSTDDecompressor(StreamReader *read, Ownership own, const bytebuf *dictionary = NULL);
   ~ZSTDDecompressor();
 
   bool Recompress(Compressor *comp);
@@ -66,4 +107,5 @@ private:
   uint64_t m_PageLength;
 
   ZSTD_DStream *m_Stream;
+  ZSTD_DDict *m_Dict = NULL;
 };
@@ -1142,6 +1142,228 @@ struct EmbeddedSectionCommand : public Command
   }
 };
 
+struct CompressionDictionaryCommand : public Command
+{
+  bool m_Train = false;
+  CompressionDictionaryCommand(const GlobalEnvironment &env, bool train) : Command(env)
+  {
+    m_Train = train;
+  }
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc> [<capture.rdc> ...]");
+    parser.add<std::string>("section", 's', "The section to use the dictionary for.", false,
+                            "renderdoc/internal/framecapture");
+    parser.add<std::string>(
+        "dictionary-paths", 0,
+        "Directories to search for dictionaries referenced by captures, separated by ;", false);
+
+    if(m_Train)
+    {
+      parser.add<std::string>("output", 'o',
+                              "The file to write the dictionary to. Defaults to the name it will "
+                              "be referenced by in the current directory.",
+                              false);
+      parser.add<uint32_t>("size", 0, "The maximum dictionary size in bytes.", false, 112640);
+    }
+    else
+    {
+      parser.add<std::string>("dictionary", 'd', "The dictionary file to compress with.", true);
+      parser.add("reference", 0,
+                 "Only reference the dictionary instead of embedding it in each capture.");
+    }
+  }
+  virtual const char *Description()
+  {
+    if(m_Train)
+      return "Train a compression dictionary on a set of captures.";
+    else
+      return "Recompress captures in-place with a compression dictionary.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  static uint64_t FileSize(const std::string &filename)
+  {
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+      return 0;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fclose(f);
+    return len < 0 ? 0 : (uint64_t)len;
+  }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: this command requires at least one capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return 1;
+    }
+
+    RENDERDOC_InitGlobalEnv(m_Env, rdcarray<rdcstr>());
+
+    if(parser.exist("dictionary-paths"))
+      RENDERDOC_SetConfigSetting("capture.compressionDictionaryPaths",
+                                 parser.get<std::string>("dictionary-paths").c_str());
+
+    std::string sectionName = parser.get<std::string>("section");
+    SectionType section = SectionType::Unknown;
+
+    for(SectionType s : values<SectionType>())
+    {
+      if(ToStr(s) == sectionName)
+      {
+        section = s;
+        break;
+      }
+    }
+
+    if(section == SectionType::Unknown)
+    {
+      std::cerr << "'" << sectionName << "' is not a known section." << std::endl;
+      return 1;
+    }
+
+    bytebuf dict;
+    rdcstr dictName;
+
+    if(m_Train)
+    {
+      ReplayStatus status = RENDERDOC_TrainCompressionDictionary(
+          convertArgs(rest), section, parser.get<uint32_t>("size"), dict);
+
+      if(status != ReplayStatus::Succeeded || dict.empty())
+      {
+        std::cerr << "Couldn't train dictionary: " << ToStr(status) << std::endl;
+        return 1;
+      }
+
+      RENDERDOC_GetCompressionDictionaryFilename(dict, dictName);
+
+      std::string file = parser.get<std::string>("output");
+      if(file.empty())
+        file = dictName.c_str();
+
+      FILE *f = fopen(file.c_str(), "wb");
+
+      if(!f)
+      {
+        std::cerr << "Couldn't open destination file '" << file << "'" << std::endl;
+        return 1;
+      }
+
+      fwrite(dict.data(), 1, dict.size(), f);
+      fclose(f);
+
+      std::cout << "Wrote " << dict.size() << " byte dictionary trained on " << rest.size()
+                << " captures to '" << file << "'. Captures referencing it will look for it as '"
+                << dictName.c_str() << "'." << std::endl;
+
+      return 0;
+    }
+
+    std::string file = parser.get<std::string>("dictionary");
+
+    {
+      FILE *f = fopen(file.c_str(), "rb");
+
+      if(!f)
+      {
+        std::cerr << "Couldn't open dictionary file '" << file << "'" << std::endl;
+        return 1;
+      }
+
+      dict.resize((size_t)FileSize(file));
+      size_t read = fread(dict.data(), 1, dict.size(), f);
+      fclose(f);
+
+      if(read != dict.size() || dict.empty())
+      {
+        std::cerr << "I/O error reading from '" << file << "'" << std::endl;
+        return 1;
+      }
+    }
+
+    RENDERDOC_GetCompressionDictionaryFilename(dict, dictName);
+
+    bool embed = !parser.exist("reference");
+
+    uint64_t totalBefore = 0, totalAfter = 0;
+
+    for(const std::string &rdc : rest)
+    {
+      ICaptureFile *capfile = RENDERDOC_OpenCaptureFile();
+
+      ReplayStatus status = capfile->OpenFile(rdc.c_str(), "rdc", NULL);
+
+      if(status == ReplayStatus::Succeeded)
+      {
+        int idx = capfile->FindSectionByName(sectionName.c_str());
+
+        // the frame capture is always recompressed with zstd, other sections keep their
+        // compression so only ones already stored with zstd can use the dictionary
+        if(idx < 0)
+        {
+          std::cerr << "'" << rdc << "' has no section called '" << sectionName << "'"
+                    << std::endl;
+          capfile->Shutdown();
+          return 1;
+        }
+        else if(section != SectionType::FrameCapture &&
+                !(capfile->GetSectionProperties(idx).flags & SectionFlags::ZstdCompressed))
+        {
+          std::cerr << "Section '" << sectionName << "' in '" << rdc
+                    << "' isn't zstd compressed, so can't use a dictionary" << std::endl;
+          capfile->Shutdown();
+          return 1;
+        }
+
+        capfile->SetCompressionDictionary(section, dict, embed);
+        status = capfile->Convert((rdc + ".tmp").c_str(), "rdc", NULL, NULL);
+      }
+
+      // close the file before replacing it
+      capfile->Shutdown();
+
+      if(status != ReplayStatus::Succeeded)
+      {
+        remove((rdc + ".tmp").c_str());
+        std::cerr << "Couldn't recompress '" << rdc << "': " << ToStr(status) << std::endl;
+        return 1;
+      }
+
+      uint64_t before = FileSize(rdc);
+      uint64_t after = FileSize(rdc + ".tmp");
+
+      // replace the original in one step, so it's never lost if this fails
+      if(!RenameOverFile(rdc + ".tmp", rdc))
+      {
+        remove((rdc + ".tmp").c_str());
+        std::cerr << "Couldn't replace '" << rdc << "' with the recompressed capture" << std::endl;
+        return 1;
+      }
+
+      totalBefore += before;
+      totalAfter += after;
+
+      std::cout << "Recompressed '" << rdc << "' from " << before << " to " << after << " bytes."
+                << std::endl;
+    }
+
+    std::cout << "Recompressed " << rest.size() << " captures from " << totalBefore << " to "
+              << totalAfter << " bytes." << std::endl;
+
+    if(!embed)
+      std::cout << "The captures reference the dictionary as '" << dictName.c_str() << "'."
+                << std::endl;
+
+    return 0;
+  }
+};
+
 REPLAY_PROGRAM_MARKER()
 
 int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
@@ -1179,6 +1401,8 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
     add_command("convert", new ConvertCommand(env));
     add_command("embed", new EmbeddedSectionCommand(env, false));
     add_command("extract", new EmbeddedSectionCommand(env, true));
+    add_command("train-dict", new CompressionDictionaryCommand(env, true));
+    add_command("recompress", new CompressionDictionaryCommand(env, false));
 
     if(argv.size() <= 1)
     {
@@ -1252,6 +1476,10 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
               "Capturing Option: Include all live resources, not just those used by a frame.");
       cmd.add("opt-capture-all-cmd-lists", 0,
               "Capturing Option: In D3D11, record all command lists from application start.");
+      cmd.add("opt-low-overhead-idle", 0,
+              "Capturing Option: In Vulkan, defer command buffer recording until a capture.");
+      cmd.add("opt-retain-initial-contents", 0,
+              "Capturing Option: In Vulkan, re-use unchanged initial contents between captures.");
     }
 
     cmd.parse_check(argv, true);
@@ -1281,6 +1509,10 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
         opts.refAllResources = true;
       if(cmd.exist("opt-capture-all-cmd-lists"))
         opts.captureAllCmdLists = true;
+      if(cmd.exist("opt-low-overhead-idle"))
+        opts.lowOverheadIdle = true;
+      if(cmd.exist("opt-retain-initial-contents"))
+        opts.retainInitialContents = true;
 
       opts.delayForDebugger = (uint32_t)cmd.get<int>("opt-delay-for-debugger");
     }
@@ -59,3 +59,5 @@ void DisplayRendererPreview(IReplayController *renderer, TextureDisplay &display
                             uint32_t height);
 WindowingData DisplayRemoteServerPreview(bool active, const rdcarray<WindowingSystem> &systems);
 void Daemonise();
+// replace the file at 'to' with 'from', leaving 'to' untouched if it fails
+bool RenameOverFile(const std::string &from, const std::string &to);
@@ -29,6 +29,7 @@
 #include <limits.h>
 #include <locale.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -51,6 +52,12 @@ void Daemonise()
   daemon(1, 0);
 }
 
+bool RenameOverFile(const std::string &from, const std::string &to)
+{
+  // rename atomically replaces any existing file
+  return rename(from.c_str(), to.c_str()) == 0;
+}
+
 struct VulkanRegisterCommand : public Command
 {
   VulkanRegisterCommand(const GlobalEnvironment &env) : Command(env) {}
@@ -128,6 +128,12 @@ void Daemonise()
   // nothing really to do, windows version of renderdoccmd is already 'detached'
 }
 
+bool RenameOverFile(const std::string &from, const std::string &to)
+{
+  return MoveFileExW(conv(from).c_str(), conv(to).c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+}
+
 WindowingData DisplayRemoteServerPreview(bool active, const rdcarray<WindowingSystem> &systems)
 {
   static WindowingData remoteServerPreview = {WindowingSystem::Unknown};